@@ -270,6 +270,8 @@ if(MS_BUILD_GRPC)
       DESTINATION ${INSTALL_LIB_DIR} RENAME libmindspore_upb.so.15 COMPONENT mindspore)
     install(FILES ${grpc_LIBPATH}/libmindspore_address_sorting.so.15.0.0
       DESTINATION ${INSTALL_LIB_DIR} RENAME libmindspore_address_sorting.so.15 COMPONENT mindspore)
+    install(FILES ${zlib_LIBPATH}/libz.so.1.2.11
+      DESTINATION ${INSTALL_LIB_DIR} RENAME libz.so.1 COMPONENT mindspore)
 endif()
 
 if(CMAKE_SYSTEM_NAME MATCHES "Windows")
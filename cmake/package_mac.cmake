@@ -107,6 +107,8 @@ if(MS_BUILD_GRPC)
         DESTINATION ${INSTALL_LIB_DIR} RENAME libmindspore_upb.15.dylib COMPONENT mindspore)
     install(FILES ${grpc_LIBPATH}/libmindspore_address_sorting.15.0.0.dylib
         DESTINATION ${INSTALL_LIB_DIR} RENAME libmindspore_address_sorting.15.dylib COMPONENT mindspore)
+    install(FILES ${zlib_LIBPATH}/libz.1.2.11.dylib
+        DESTINATION ${INSTALL_LIB_DIR} RENAME libz.1.dylib COMPONENT mindspore)
 endif()
 
 if(ENABLE_MINDDATA)
@@ -0,0 +1,92 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_INCLUDE_API_MODEL_PARALLEL_RUNNER_H
+#define MINDSPORE_INCLUDE_API_MODEL_PARALLEL_RUNNER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "include/api/status.h"
+#include "include/api/types.h"
+#include "include/api/context.h"
+#include "include/api/dual_abi_helper.h"
+
+namespace mindspore {
+class ModelPool;
+
+/// \brief RunnerConfig defines the configuration of ModelParallelRunner.
+struct RunnerConfig {
+  /// \brief The context of every worker, the thread num of it is the thread num of one worker. If the core list is
+  /// not set, each worker is bound to its own group of contiguous cores.
+  std::shared_ptr<Context> context = nullptr;
+  /// \brief The number of workers, 0 means the number of cores divided by the thread num of one worker.
+  int32_t workers_num = 0;
+  /// \brief The max number of queued requests that a worker merges into one inference along the first dimension, 1
+  /// means dynamic batching is disabled. Only the requests whose inputs have the same data types and the same shapes
+  /// except the first dimension are merged.
+  int32_t max_batch_size = 1;
+};
+
+/// \brief The ModelParallelRunner class serves one model from many threads. It loads the model once per worker from
+/// the same mapped file, so the weights are shared, and dispatches the requests to the idle workers. Only valid for
+/// Lite.
+class MS_API ModelParallelRunner {
+ public:
+  ModelParallelRunner() = default;
+  ~ModelParallelRunner() = default;
+  ModelParallelRunner(const ModelParallelRunner &) = delete;
+  void operator=(const ModelParallelRunner &) = delete;
+
+  /// \brief Build the workers of the model.
+  ///
+  /// \param[in] model_path Define the model path, only ModelType::kMindIR is supported.
+  /// \param[in] runner_config Define the config used to create the workers.
+  ///
+  /// \return Status.
+  inline Status Init(const std::string &model_path, const std::shared_ptr<RunnerConfig> &runner_config = nullptr);
+
+  /// \brief Obtains all input tensors of the model, which only describe the names, data types and shapes.
+  ///
+  /// \return The vector that includes all input tensors.
+  std::vector<MSTensor> GetInputs();
+
+  /// \brief Obtains all output tensors of the model, which only describe the names, data types and shapes.
+  ///
+  /// \return The vector that includes all output tensors.
+  std::vector<MSTensor> GetOutputs();
+
+  /// \brief Inference model, it can be called by many threads at the same time.
+  ///
+  /// \param[in] inputs A vector where model inputs are arranged in sequence.
+  /// \param[out] outputs Which is a pointer to a vector. The model outputs are copied into the container in sequence.
+  /// \param[in] before CallBack before predict.
+  /// \param[in] after CallBack after predict.
+  ///
+  /// \return Status.
+  Status Predict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
+                 const MSKernelCallBack &before = nullptr, const MSKernelCallBack &after = nullptr);
+
+ private:
+  Status Init(const std::vector<char> &model_path, const std::shared_ptr<RunnerConfig> &runner_config);
+
+  std::shared_ptr<ModelPool> model_pool_ = nullptr;
+};
+
+Status ModelParallelRunner::Init(const std::string &model_path, const std::shared_ptr<RunnerConfig> &runner_config) {
+  return Init(StringToChar(model_path), runner_config);
+}
+}  // namespace mindspore
+#endif  // MINDSPORE_INCLUDE_API_MODEL_PARALLEL_RUNNER_H
@@ -22,6 +22,9 @@
 
 #include "utils/profile.h"
 #include "runtime/framework/actor/actor_common.h"
+#ifndef ENABLE_SECURITY
+#include "profiler/device/cpu/cpu_profiling.h"
+#endif
 
 namespace mindspore {
 namespace kernel {
@@ -180,6 +183,27 @@ ActorThreadPool *GetActorMgrInnerThreadPool() {
   return thread_pool;
 }
 
+namespace {
+void LaunchOnThreadPool(ActorThreadPool *thread_pool, const Func &func, Content content, size_t task_num) {
+#ifndef ENABLE_SECURITY
+  // Trace each sub-task under the kernel launching them when the profiler is on.
+  const auto &profiler_inst = profiler::cpu::CPUProfiler::GetInstance();
+  if (profiler_inst != nullptr && profiler_inst->GetEnableFlag()) {
+    auto op_id = profiler_inst->CurrentOpId();
+    auto traced_func = [&func, &profiler_inst, op_id](void *cdata, int task_id, float lhs_scale, float rhs_scale) {
+      auto start = profiler::cpu::CPUProfiler::TraceTime();
+      auto ret = func(cdata, task_id, lhs_scale, rhs_scale);
+      profiler_inst->RecordSubTask(op_id, task_id, start);
+      return ret;
+    };
+    (void)thread_pool->ParallelLaunch(traced_func, content, task_num);
+    return;
+  }
+#endif
+  (void)thread_pool->ParallelLaunch(func, content, task_num);
+}
+}  // namespace
+
 // Use threadpool of mindrt
 void ParallelLaunch(const CTask &task, size_t count, float block_size, Content content) {
   if (count == 0) {
@@ -203,7 +227,7 @@ void ParallelLaunch(const CTask &task, size_t count, float block_size, Content c
     task(start, end);
     return common::SUCCESS;
   };
-  (void)thread_pool->ParallelLaunch(func, content, task_num);
+  LaunchOnThreadPool(thread_pool, func, content, task_num);
 }
 
 void ParallelLaunch(const std::vector<common::Task> &tasks, Content content) {
@@ -218,7 +242,7 @@ void ParallelLaunch(const std::vector<common::Task> &tasks, Content content) {
     tasks[task_id]();
     return common::SUCCESS;
   };
-  (void)thread_pool->ParallelLaunch(func, content, task_num);
+  LaunchOnThreadPool(thread_pool, func, content, task_num);
 }
 
 void ParallelLaunchAutoSearch(const CTask &task, size_t count, Content content,
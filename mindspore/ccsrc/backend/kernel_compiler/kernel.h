@@ -15,6 +15,7 @@
  */
 #ifndef MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_KERNEL_H_
 #define MINDSPORE_CCSRC_BACKEND_KERNEL_COMPILER_KERNEL_H_
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
@@ -214,6 +215,9 @@ class KernelMod {
   void SetStream(void *stream) { stream_ = stream; }
   void *GetStream() const { return stream_; }
   void SetAtomicCleanNodes(const std::vector<CNodePtr> &atomic_clean_node) { atomic_clean_nodes_ = atomic_clean_node; }
+  // Id of the op of the kernel in the trace of the CPU profiler, resolved at the first profiled launch.
+  uint32_t profiler_op_id() const { return profiler_op_id_; }
+  void set_profiler_op_id(uint32_t op_id) { profiler_op_id_ = op_id; }
 
  protected:
   void InferShape();
@@ -236,6 +240,7 @@ class KernelMod {
   std::vector<AddressPtr> workspaces_addr_;
   std::vector<AddressPtr> outputs_addr_;
   std::set<uint32_t> depend_list_;
+  uint32_t profiler_op_id_{UINT32_MAX};
 };
 using KernelModPtr = std::shared_ptr<KernelMod>;
 }  // namespace kernel
@@ -16,6 +16,7 @@
 
 #include "backend/optimizer/mem_reuse/mem_dynamic_allocator.h"
 #include <string>
+#include <sstream>
 #include "utils/ms_utils.h"
 #include "utils/convert_utils.h"
 #include "utils/log_adapter.h"
@@ -29,6 +30,17 @@ constexpr size_t kGBToByte = 1024 << 20;
 // The smallest memory request size, if it is smaller than this size, the device memory request may fail
 // Set experience value to 10M
 const size_t kMinimumAllocMem = 10 << 20;
+// The maximum size in MB of the freed memory kept by the size class cache, the cache is disabled by default
+static const char kMemCacheSizeEnv[] = "MS_DEV_MEMPOOL_CACHE_SIZE";
+constexpr size_t kMBToByte = 1 << 20;
+
+DynamicMemPoolBestFit::DynamicMemPoolBestFit()
+    : persistent_mem_(std::make_shared<MemStatusManager>()), common_mem_(std::make_shared<MemStatusManager>()) {
+  auto cache_size = common::GetEnv(kMemCacheSizeEnv);
+  if (!cache_size.empty() && std::all_of(cache_size.begin(), cache_size.end(), ::isdigit)) {
+    mem_cache_size_ = std::stoull(cache_size) * kMBToByte;
+  }
+}
 
 DynamicMemPoolBestFit::~DynamicMemPoolBestFit() {
   persistent_mem_->clear();
@@ -38,11 +50,30 @@ DynamicMemPoolBestFit::~DynamicMemPoolBestFit() {
 DeviceMemPtr DynamicMemPoolBestFit::AllocTensorMem(size_t size, bool from_persistent_mem) {
   size_t align_size = AlignMemorySize(size);
   std::lock_guard<std::mutex> locker(mutex_);
+  // Reuse the memory buf freed with the same size first, which needs neither split nor combine.
+  DeviceMemPtr device_addr = FindCachedMemBuf(align_size, from_persistent_mem);
   // Find the idle memory buf by tensor size, if not find, then add new memory block and memory buf.
-  DeviceMemPtr device_addr = FindIdleMemBuf(align_size, from_persistent_mem);
+  if (!device_addr) {
+    device_addr = FindIdleMemBuf(align_size, from_persistent_mem);
+  }
+  // The cached memory buf may be combined into an idle memory buf big enough, which is better than a new block.
+  if (!device_addr && FlushMemBufCache(from_persistent_mem ? persistent_mem_ : common_mem_)) {
+    device_addr = FindIdleMemBuf(align_size, from_persistent_mem);
+  }
   if (!device_addr) {
     device_addr = AddMemBlockAndMemBuf(align_size, from_persistent_mem);
   }
+  if (!device_addr) {
+    // Give back all the cached memory buf before running out of memory.
+    bool flushed = FlushMemBufCache(common_mem_);
+    flushed = FlushMemBufCache(persistent_mem_) || flushed;
+    if (flushed) {
+      device_addr = FindIdleMemBuf(align_size, from_persistent_mem);
+    }
+    if (flushed && !device_addr) {
+      device_addr = FindIdleMemBuf(align_size, !from_persistent_mem);
+    }
+  }
   if (!device_addr) {
     DumpDynamicMemPoolInfo();
   }
@@ -96,6 +127,82 @@ size_t DynamicMemPoolBestFit::AlignMemorySize(size_t size) const {
   return ((size + DYNAMIC_MEM_ALIGN_SIZE - 1) / DYNAMIC_MEM_ALIGN_SIZE) * DYNAMIC_MEM_ALIGN_SIZE;
 }
 
+DeviceMemPtr DynamicMemPoolBestFit::FindCachedMemBuf(size_t size, bool from_persistent_mem) {
+  if (size > DYNAMIC_MEM_CACHE_MAX_BUF_SIZE) {
+    return nullptr;
+  }
+  auto mem_mng = common_mem_;
+  if (from_persistent_mem) {
+    mem_mng = persistent_mem_;
+  }
+  MS_EXCEPTION_IF_NULL(mem_mng);
+  const auto &iter = mem_mng->cached_mem_buf_map_.find(size);
+  if (iter == mem_mng->cached_mem_buf_map_.end()) {
+    return nullptr;
+  }
+  auto mem_buf = iter->second;
+  MS_EXCEPTION_IF_NULL(mem_buf);
+  if (mem_buf->status_ != kMemBufCached) {
+    MS_LOG(EXCEPTION) << "Find the mem_buf is not cached, alloc_size[" << size << "] mem_buf_address["
+                      << mem_buf->device_addr_ << "].";
+  }
+  mem_buf->status_ = kMemBufUsed;
+  (void)mem_mng->cached_mem_buf_map_.erase(iter);
+  mem_mng->cached_mem_size_ -= mem_buf->size_;
+  // Memory statistics
+  mem_mng->mps_.total_used_mem_size_ += mem_buf->size_;
+  if (mem_mng->mps_.total_used_mem_size_ > mem_mng->mps_.used_mem_peak_size_) {
+    mem_mng->mps_.used_mem_peak_size_ = mem_mng->mps_.total_used_mem_size_;
+  }
+  return mem_buf->device_addr_;
+}
+
+bool DynamicMemPoolBestFit::CacheMemBuf(const DynamicMemBlockPtr &mem_block, const DeviceMemPtr &device_addr,
+                                        const MemStatusManagerPtr &mem_mng) {
+  MS_EXCEPTION_IF_NULL(mem_block);
+  MS_EXCEPTION_IF_NULL(device_addr);
+  const auto &iter = mem_block->block_all_mem_buf_map_.find(device_addr);
+  if (iter == mem_block->block_all_mem_buf_map_.end()) {
+    MS_LOG(EXCEPTION) << "Can't find the device address[" << device_addr << "].";
+  }
+  auto mem_buf = iter->second;
+  MS_EXCEPTION_IF_NULL(mem_buf);
+  // Only the memory buf of an aligned small size can be hit by the later alloc.
+  if (mem_buf->status_ != kMemBufUsed || mem_buf->size_ > DYNAMIC_MEM_CACHE_MAX_BUF_SIZE ||
+      mem_buf->size_ % DYNAMIC_MEM_ALIGN_SIZE != 0 || mem_mng->cached_mem_size_ + mem_buf->size_ > mem_cache_size_) {
+    return false;
+  }
+  if (mem_mng->mps_.total_used_mem_size_ < mem_buf->size_) {
+    MS_LOG(EXCEPTION) << "The total used mem size is less than the size of membuf.";
+  }
+  mem_buf->status_ = kMemBufCached;
+  mem_mng->mps_.total_used_mem_size_ -= mem_buf->size_;
+  mem_mng->cached_mem_size_ += mem_buf->size_;
+  (void)mem_mng->cached_mem_buf_map_.emplace(mem_buf->size_, mem_buf);
+  return true;
+}
+
+bool DynamicMemPoolBestFit::FlushMemBufCache(const MemStatusManagerPtr &mem_mng) {
+  MS_EXCEPTION_IF_NULL(mem_mng);
+  if (mem_mng->cached_mem_buf_map_.empty()) {
+    return false;
+  }
+  SizeMapMemBuf cached_mem_buf_map;
+  cached_mem_buf_map.swap(mem_mng->cached_mem_buf_map_);
+  mem_mng->cached_mem_size_ = 0;
+  for (const auto &iter : cached_mem_buf_map) {
+    const auto &mem_buf = iter.second;
+    MS_EXCEPTION_IF_NULL(mem_buf);
+    const auto &mem_block = FindMemBlock(mem_buf->device_addr_, mem_mng);
+    MS_EXCEPTION_IF_NULL(mem_block);
+    // Free the cached memory buf as if it is used, the neighbor cached memory buf is combined in its own turn.
+    mem_buf->status_ = kMemBufUsed;
+    mem_mng->mps_.total_used_mem_size_ += mem_buf->size_;
+    CombineMemBuf(mem_block, mem_buf->device_addr_, mem_mng);
+  }
+  return true;
+}
+
 DeviceMemPtr DynamicMemPoolBestFit::FindIdleMemBuf(size_t size, bool from_persistent_mem) {
   auto mem_mng = common_mem_;
   if (from_persistent_mem) {
@@ -138,6 +245,18 @@ void DynamicMemPoolBestFit::SetMemAllocUintSize(size_t common_size, size_t persi
   MS_LOG(INFO) << "Set mem alloc unit size, common " << common_size << " persistent " << persist_size;
 }
 
+void DynamicMemPoolBestFit::SetMemCacheSize(size_t cache_size) {
+  std::lock_guard<std::mutex> locker(mutex_);
+  mem_cache_size_ = cache_size;
+  if (common_mem_->cached_mem_size_ > cache_size) {
+    (void)FlushMemBufCache(common_mem_);
+  }
+  if (persistent_mem_->cached_mem_size_ > cache_size) {
+    (void)FlushMemBufCache(persistent_mem_);
+  }
+  MS_LOG(INFO) << "Set mem cache size " << cache_size;
+}
+
 void DynamicMemPoolBestFit::SetMemPoolBlockSize(size_t available_device_mem_size) {
   auto ms_context = MsContext::GetInstance();
   MS_EXCEPTION_IF_NULL(ms_context);
@@ -301,8 +420,10 @@ void DynamicMemPoolBestFit::FreeTensorMem(const DeviceMemPtr &device_addr) {
       MS_LOG(DEBUG) << "Can't find the mem_block of the device address[" << device_addr << "].";
       return;
     }
-    CombineMemBuf(mem_block, device_addr, persistent_mem_);
-  } else {
+    if (!CacheMemBuf(mem_block, device_addr, persistent_mem_)) {
+      CombineMemBuf(mem_block, device_addr, persistent_mem_);
+    }
+  } else if (!CacheMemBuf(mem_block, device_addr, common_mem_)) {
     CombineMemBuf(mem_block, device_addr, common_mem_);
   }
 }
@@ -388,35 +509,67 @@ void DynamicMemPoolBestFit::ReleaseDeviceRes() {
         device_addr = nullptr;
       }
     }
-    mem_mng->mem_block_list_.clear();
-    mem_mng->idle_mem_buf_map_.clear();
+    mem_mng->clear();
   };
   fn(common_mem_);
   fn(persistent_mem_);
 }
 
+DynamicMemPoolReport DynamicMemPoolBestFit::MemPoolReport(bool from_persistent_mem) {
+  std::lock_guard<std::mutex> locker(mutex_);
+  return GenMemPoolReport(from_persistent_mem ? persistent_mem_ : common_mem_);
+}
+
+DynamicMemPoolReport DynamicMemPoolBestFit::GenMemPoolReport(const MemStatusManagerPtr &mem_mng) const {
+  MS_EXCEPTION_IF_NULL(mem_mng);
+  DynamicMemPoolReport report;
+  report.total_mem_size_ = mem_mng->mps_.total_mem_size_;
+  report.used_mem_size_ = mem_mng->mps_.total_used_mem_size_;
+  report.used_mem_peak_size_ = mem_mng->mps_.used_mem_peak_size_;
+  report.cached_mem_size_ = mem_mng->cached_mem_size_;
+  for (const auto &mem_block : mem_mng->mem_block_list_) {
+    size_t idle_size = 0;
+    for (const auto &iter : mem_block->block_all_mem_buf_map_) {
+      if (iter.second->status_ == kMemBufIdle) {
+        idle_size += iter.second->size_;
+      }
+    }
+    report.block_idle_mem_size_.push_back(idle_size);
+  }
+  for (const auto &iter : mem_mng->idle_mem_buf_map_) {
+    report.idle_mem_size_ += iter.first;
+  }
+  report.idle_mem_buf_count_ = mem_mng->idle_mem_buf_map_.size();
+  if (report.idle_mem_size_ > 0) {
+    // The idle memory buf map is sorted by size.
+    report.max_idle_mem_buf_size_ = mem_mng->idle_mem_buf_map_.rbegin()->first;
+    report.fragmentation_ =
+      1.0 - static_cast<double>(report.max_idle_mem_buf_size_) / static_cast<double>(report.idle_mem_size_);
+  }
+  return report;
+}
+
+std::string DynamicMemPoolReport::ToString() const {
+  std::ostringstream buf;
+  buf << "block counts " << block_idle_mem_size_.size();
+  for (size_t i = 0; i < block_idle_mem_size_.size(); ++i) {
+    buf << ", block[" << i << "] idle size " << block_idle_mem_size_[i];
+  }
+  buf << ". Total allocated mem " << total_mem_size_ << ", peak used mem " << used_mem_peak_size_ << ", in used mem "
+      << used_mem_size_ << ", cached mem " << cached_mem_size_ << ", total idle mem " << idle_mem_size_
+      << ", idle mem buf counts " << idle_mem_buf_count_ << ", max idle mem buf size " << max_idle_mem_buf_size_
+      << ", fragmentation " << fragmentation_;
+  return buf.str();
+}
+
 void DynamicMemPoolBestFit::DumpDynamicMemPoolInfo() {
-  auto fn = [](const MemStatusManagerPtr &mem_mng, const std::string &mem_type) {
+  auto fn = [this](const MemStatusManagerPtr &mem_mng, const std::string &mem_type) {
     if (mem_mng->mem_block_list_.empty()) {
       return;
     }
-    std::ostringstream buf;
-    for (size_t i = 0; i < mem_mng->mem_block_list_.size(); ++i) {
-      size_t idle_size = 0;
-      for (auto mb = mem_mng->mem_block_list_[i]->block_all_mem_buf_map_.begin();
-           mb != mem_mng->mem_block_list_[i]->block_all_mem_buf_map_.end(); ++mb) {
-        if (mb->second->status_ == kMemBufIdle) {
-          idle_size += mb->second->size_;
-        }
-      }
-      buf << ", block[" << i << "] idle size " << idle_size;
-    }
     // Dump all the memory buf info
-    MS_LOG(WARNING) << mem_type << "pool info: block size " << mem_mng->unit_size_ << ", block counts "
-                    << mem_mng->mem_block_list_.size() << buf.str() << ". Total allocated mem "
-                    << mem_mng->mps_.total_mem_size_ << ", peak used mem " << mem_mng->mps_.used_mem_peak_size_
-                    << ", in used mem " << mem_mng->mps_.total_used_mem_size_ << ", total idle mem "
-                    << mem_mng->mps_.total_mem_size_ - mem_mng->mps_.total_used_mem_size_;
+    MS_LOG(WARNING) << mem_type << " pool info: block size " << mem_mng->unit_size_ << ", "
+                    << GenMemPoolReport(mem_mng).ToString();
   };
   fn(common_mem_, std::string(kCommonMem));
   fn(persistent_mem_, std::string(kPersistentParamMem));
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <map>
+#include <string>
 #include <vector>
 #include <algorithm>
 #include <utility>
@@ -29,8 +30,8 @@ namespace mindspore {
 namespace device {
 using DeviceMemPtr = void(*);
 
-// The status of memory buf.
-enum DynamicMemBufStatus : int { kMemBufIdle, kMemBufUsed };
+// The status of memory buf, a cached memory buf is freed by the user but kept for the next alloc of the same size.
+enum DynamicMemBufStatus : int { kMemBufIdle, kMemBufUsed, kMemBufCached };
 
 // Alloc memory aligned according to 512 bytes.
 static const size_t DYNAMIC_MEM_ALIGN_SIZE = 512;
@@ -38,6 +39,9 @@ static const size_t DYNAMIC_MEM_ALIGN_SIZE = 512;
 // The minimum unit size (1G) of memory block used for dynamic extend.
 static const size_t DYNAMIC_MEM_ALLOC_UNIT_SIZE = 1024 << 20;
 
+// The maximum size (1M) of memory buf kept by the size class cache.
+static const size_t DYNAMIC_MEM_CACHE_MAX_BUF_SIZE = 1 << 20;
+
 // The Comparator of device address from small to large.
 struct DeviceAddrCmp {
   bool operator()(const DeviceMemPtr &addr1, const DeviceMemPtr &addr2) const { return addr1 < addr2; }
@@ -93,18 +97,39 @@ struct MemStatusManager {
   std::vector<DynamicMemBlockPtr> mem_block_list_;
   // The map of all idle memory buf by size.
   SizeMapMemBuf idle_mem_buf_map_;
+  // The map of all cached memory buf by size, which are neither split nor combined.
+  SizeMapMemBuf cached_mem_buf_map_;
+  size_t cached_mem_size_{0};
   void clear() {
     mem_block_list_.clear();
     idle_mem_buf_map_.clear();
+    cached_mem_buf_map_.clear();
+    cached_mem_size_ = 0;
   }
 };
 using MemStatusManagerPtr = std::shared_ptr<MemStatusManager>;
 
+// The statistics of the persistent or common memory of the pool, to find out why the memory runs out.
+struct DynamicMemPoolReport {
+  // Memory allocated from device, which never shrinks until the device resource is released
+  size_t total_mem_size_{0};
+  size_t used_mem_size_{0};
+  size_t used_mem_peak_size_{0};
+  size_t cached_mem_size_{0};
+  size_t idle_mem_size_{0};
+  size_t idle_mem_buf_count_{0};
+  // The largest memory that can be allocated without adding memory block
+  size_t max_idle_mem_buf_size_{0};
+  // The ratio of the idle memory outside the largest idle memory buf, 0 means no fragmentation.
+  double fragmentation_{0};
+  std::vector<size_t> block_idle_mem_size_;
+  std::string ToString() const;
+};
+
 // The main class of dynamic memory pool.
 class DynamicMemPoolBestFit {
  public:
-  DynamicMemPoolBestFit()
-      : persistent_mem_(std::make_shared<MemStatusManager>()), common_mem_(std::make_shared<MemStatusManager>()) {}
+  DynamicMemPoolBestFit();
   virtual ~DynamicMemPoolBestFit();
 
   // The main program entry of memory alloc.
@@ -123,6 +148,10 @@ class DynamicMemPoolBestFit {
   void SetMemAllocUintSize(size_t common_size, size_t persist_size = DYNAMIC_MEM_ALLOC_UNIT_SIZE);
   // Set mem pool block size
   void SetMemPoolBlockSize(size_t available_device_mem_size);
+  // Set the maximum size of the freed memory kept by the size class cache, 0 disables the cache.
+  void SetMemCacheSize(size_t cache_size);
+  // Get the fragmentation and watermark statistics of the persistent or common memory.
+  DynamicMemPoolReport MemPoolReport(bool from_persistent_mem = false);
   size_t TotalMemStatistics() const {
     return common_mem_->mps_.total_mem_size_ + persistent_mem_->mps_.total_mem_size_;
   }
@@ -147,6 +176,13 @@ class DynamicMemPoolBestFit {
   virtual size_t CalMemBlockAllocSize(size_t size, bool from_persistent_mem);
 
  private:
+  // Find the cached memory buf by aligned size when memory alloc.
+  DeviceMemPtr FindCachedMemBuf(size_t size, bool from_persistent_mem);
+  // Cache the memory buf instead of combining it when memory free, return false if it can't be cached.
+  bool CacheMemBuf(const DynamicMemBlockPtr &mem_block, const DeviceMemPtr &device_addr,
+                   const MemStatusManagerPtr &mem_mng);
+  // Combine all the cached memory buf, return false if there is no cached memory buf.
+  bool FlushMemBufCache(const MemStatusManagerPtr &mem_mng);
   // Find the idle memory buf by aligned size when memory alloc.
   DeviceMemPtr FindIdleMemBuf(size_t size, bool from_persistent_mem);
   // Add the memory block and memory buf when memory alloc not find the idle memory buf.
@@ -164,6 +200,8 @@ class DynamicMemPoolBestFit {
                      const MemStatusManagerPtr &mem_mng);
   // Erase the idle memory buf by size and device address when idle memory buf is combined.
   void EraseIdleMemBuf(size_t size, const DeviceMemPtr &device_addr, const MemStatusManagerPtr &mem_mng);
+  // Collect the statistics of memory block and memory buf.
+  DynamicMemPoolReport GenMemPoolReport(const MemStatusManagerPtr &mem_mng) const;
   // Display the information of memory block and memory buf.
   void DumpDynamicMemPoolInfo();
 
@@ -174,6 +212,8 @@ class DynamicMemPoolBestFit {
   // In the graph mode, the unit size set in the context will be modified through the FetchMemUnitSize function, so it
   // needs to be changed back after that
   size_t config_unit_size_{DYNAMIC_MEM_ALLOC_UNIT_SIZE};
+  // The maximum size of the freed memory kept by the size class cache of persistent or common memory.
+  size_t mem_cache_size_{0};
 };
 }  // namespace device
 }  // namespace mindspore
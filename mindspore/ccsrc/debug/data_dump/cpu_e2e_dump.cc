@@ -63,6 +63,8 @@ void CPUE2eDump::DumpRunIter(const KernelGraphPtr &graph, uint32_t rank_id) {
   fout << std::to_string(json_parser.cur_dump_iter()) + "\n";
   fout.close();
   ChangeFileMode(file_name, S_IRUSR);
+  // The step is done, its files are all written once it is recorded.
+  json_parser.FlushDumpWriter();
 }
 
 void CPUE2eDump::DumpCNodeInputs(const CNodePtr &node, const std::string &dump_path) {
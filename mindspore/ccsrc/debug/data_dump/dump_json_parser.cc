@@ -43,6 +43,13 @@ constexpr auto kStatisticDump = "statistic";
 constexpr auto kTensorDump = "tensor";
 constexpr auto kFullDump = "full";
 constexpr auto kFileFormat = "file_format";
+constexpr auto kAsyncWrite = "async_write";
+constexpr auto kStagingSize = "staging_size";
+constexpr auto kWriteThreads = "write_threads";
+constexpr auto kFullPolicy = "full_policy";
+constexpr uint32_t kDefaultStagingSize = 1024;  // MB
+constexpr uint32_t kDefaultWriteThreads = 2;
+constexpr size_t kMegaByte = 1024 * 1024;
 constexpr auto kDumpInputAndOutput = 0;
 constexpr auto kDumpInputOnly = 1;
 constexpr auto kDumpOutputOnly = 2;
@@ -119,6 +126,9 @@ void DumpJsonParser::Parse() {
   ParseE2eDumpSetting(j);
   ParseCommonDumpSetting(j);
   JudgeDumpEnabled();
+  if (e2e_dump_enabled_ && async_write_) {
+    dump_writer_ = std::make_unique<DumpWriter>(staging_size_ * kMegaByte, write_threads_, full_policy_);
+  }
 }
 
 void WriteJsonFile(const std::string &file_path, const std::ifstream &json_file) {
@@ -207,6 +217,15 @@ bool DumpJsonParser::DumpEnabledForIter() const {
 
 bool DumpJsonParser::DumpToFile(const std::string &filename, const void *data, size_t len, const ShapeVector &shape,
                                 TypeId type) {
+  auto &dump_writer = GetInstance().dump_writer_;
+  if (dump_writer != nullptr) {
+    return dump_writer->Write(filename, data, len, shape, type);
+  }
+  return WriteNpyFile(filename, data, len, shape, type);
+}
+
+bool DumpJsonParser::WriteNpyFile(const std::string &filename, const void *data, size_t len, const ShapeVector &shape,
+                                  TypeId type) {
   if (filename.empty() || data == nullptr || len == 0) {
     MS_LOG(ERROR) << "Incorrect parameter.";
     return false;
@@ -237,6 +256,17 @@ bool DumpJsonParser::DumpToFile(const std::string &filename, const void *data, s
   return true;
 }
 
+void DumpJsonParser::FlushDumpWriter() {
+  if (dump_writer_ != nullptr) {
+    dump_writer_->Flush();
+  }
+}
+
+void DumpJsonParser::Finalize() {
+  FlushDumpWriter();
+  dump_writer_ = nullptr;
+}
+
 void DumpJsonParser::ParseCommonDumpSetting(const nlohmann::json &content) {
   // async_dump is enabled by default, if e2e dump is enabled it will override this
   auto context = MsContext::GetInstance();
@@ -295,6 +325,7 @@ void DumpJsonParser::ParseE2eDumpSetting(const nlohmann::json &content) {
     MS_LOG(WARNING) << "Deprecated: Synchronous dump mode is deprecated and will be removed in a future release";
   }
   trans_flag_ = ParseEnable(*trans_flag);
+  ParseAsyncWrite(*e2e_dump_setting);  // Pass in the whole json string to parse because the fields are optional.
 }
 
 void CheckJsonUnsignedType(const nlohmann::json &content, const std::string &key) {
@@ -536,6 +567,49 @@ void DumpJsonParser::ParseFileFormat(const nlohmann::json &content) {
   }
 }
 
+void DumpJsonParser::ParseAsyncWrite(const nlohmann::json &content) {
+  async_write_ = false;
+  staging_size_ = kDefaultStagingSize;
+  write_threads_ = kDefaultWriteThreads;
+  full_policy_ = DumpWriter::BLOCK_WHEN_FULL;
+  auto iter = content.find(kAsyncWrite);
+  if (iter == content.end()) {
+    return;
+  }
+  if (!iter->is_boolean()) {
+    MS_LOG(EXCEPTION) << "Dump Json Parse Failed. 'async_write' should be boolean type";
+  }
+  async_write_ = *iter;
+  iter = content.find(kStagingSize);
+  if (iter != content.end()) {
+    CheckJsonUnsignedType(*iter, kStagingSize);
+    staging_size_ = *iter;
+    if (staging_size_ == 0) {
+      MS_LOG(EXCEPTION) << "Dump Json Parse Failed. staging_size should be greater than 0 MB";
+    }
+  }
+  iter = content.find(kWriteThreads);
+  if (iter != content.end()) {
+    CheckJsonUnsignedType(*iter, kWriteThreads);
+    write_threads_ = *iter;
+    if (write_threads_ == 0) {
+      MS_LOG(EXCEPTION) << "Dump Json Parse Failed. write_threads should be greater than 0";
+    }
+  }
+  iter = content.find(kFullPolicy);
+  if (iter != content.end()) {
+    CheckJsonStringType(*iter, kFullPolicy);
+    std::string full_policy = *iter;
+    const std::map<std::string, DumpWriter::FullPolicy> str_to_policy_enum = {
+      {"block", DumpWriter::BLOCK_WHEN_FULL}, {"drop", DumpWriter::DROP_WHEN_FULL}};
+    if (str_to_policy_enum.find(full_policy) == str_to_policy_enum.end()) {
+      MS_LOG(EXCEPTION) << "Dump Json Parse Failed. 'full_policy' should be either 'block' or 'drop', but got: "
+                        << full_policy;
+    }
+    full_policy_ = str_to_policy_enum.at(full_policy);
+  }
+}
+
 void DumpJsonParser::JsonConfigToString() {
   std::string cur_config;
   cur_config.append("dump_mode:");
@@ -552,6 +626,8 @@ void DumpJsonParser::JsonConfigToString() {
   cur_config.append(std::to_string(static_cast<int>(e2e_dump_enabled_)));
   cur_config.append(" async_dump_enable:");
   cur_config.append(std::to_string(static_cast<int>(async_dump_enabled_)));
+  cur_config.append(" async_write:");
+  cur_config.append(std::to_string(static_cast<int>(async_write_)));
   MS_LOG(INFO) << cur_config;
 }
 
@@ -19,12 +19,14 @@
 
 #include <string>
 #include <map>
+#include <memory>
 #include <set>
 #include <mutex>
 #include <vector>
 #include "nlohmann/json.hpp"
 #include "utils/ms_utils.h"
 #include "backend/session/kernel_graph.h"
+#include "debug/data_dump/dump_writer.h"
 namespace mindspore {
 class DumpJsonParser {
  public:
@@ -34,8 +36,16 @@ class DumpJsonParser {
   }
 
   void Parse();
+  // Write a npy file, on the dump writer threads if async_write is set in e2e_dump_settings.
   static bool DumpToFile(const std::string &filename, const void *data, size_t len, const ShapeVector &shape,
                          TypeId type);
+  // Write a npy file on the calling thread.
+  static bool WriteNpyFile(const std::string &filename, const void *data, size_t len, const ShapeVector &shape,
+                           TypeId type);
+  // Wait until the files queued on the dump writer are written.
+  void FlushDumpWriter();
+  // Write the files queued on the dump writer and stop its threads.
+  void Finalize();
   void CopyDumpJsonToDir(uint32_t rank_id);
   void CopyHcclJsonToDir(uint32_t rank_id);
   void CopyMSCfgJsonToDir(uint32_t rank_id);
@@ -57,8 +67,14 @@ class DumpJsonParser {
   std::string net_name() const { return net_name_; }
   uint32_t op_debug_mode() const { return op_debug_mode_; }
   bool trans_flag() const { return trans_flag_; }
+  bool async_write() const { return async_write_; }
+  const DumpWriter *dump_writer() const { return dump_writer_.get(); }
   uint32_t cur_dump_iter() const { return cur_dump_iter_; }
-  void UpdateDumpIter() { ++cur_dump_iter_; }
+  // The files of the step are all written before the next step is dumped.
+  void UpdateDumpIter() {
+    FlushDumpWriter();
+    ++cur_dump_iter_;
+  }
   bool FileFormatIsNpy() const { return file_format_ == JsonFileFormat::FORMAT_NPY; }
   bool GetIterDumpFlag() const;
   bool DumpEnabledForIter() const;
@@ -96,6 +112,11 @@ class DumpJsonParser {
   bool trans_flag_{false};
   uint32_t cur_dump_iter_{0};
   bool already_parsed_{false};
+  bool async_write_{false};
+  uint32_t staging_size_{0};  // MB
+  uint32_t write_threads_{0};
+  DumpWriter::FullPolicy full_policy_{DumpWriter::BLOCK_WHEN_FULL};
+  std::unique_ptr<DumpWriter> dump_writer_;
 
   // Save graphs for dump.
   std::vector<session::KernelGraph *> graphs_;
@@ -117,6 +138,7 @@ class DumpJsonParser {
   bool ParseEnable(const nlohmann::json &content);
   void ParseOpDebugMode(const nlohmann::json &content);
   void ParseFileFormat(const nlohmann::json &content);
+  void ParseAsyncWrite(const nlohmann::json &content);
 
   void JudgeDumpEnabled();
   void JsonConfigToString();
@@ -0,0 +1,196 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "debug/data_dump/dump_writer.h"
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include "debug/data_dump/dump_json_parser.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+DumpWriter::DumpWriter(size_t staging_bytes, size_t num_threads, FullPolicy policy)
+    : staging_bytes_(staging_bytes), policy_(policy) {
+  num_threads = std::max<size_t>(num_threads, 1);
+  for (size_t i = 0; i < num_threads; ++i) {
+    (void)threads_.emplace_back(&DumpWriter::Run, this);
+  }
+}
+
+DumpWriter::~DumpWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  task_cond_.notify_all();
+  for (auto &thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  MS_LOG(INFO) << "Dump writer stopped, queued: " << num_queued_ << ", written: " << num_written_
+               << ", dropped: " << num_dropped_ << ", blocked: " << num_blocked_ << ", failed: " << num_failed_;
+}
+
+bool DumpWriter::Write(const std::string &filename, const void *data, size_t len, const ShapeVector &shape,
+                       TypeId type) {
+  if (filename.empty() || data == nullptr || len == 0) {
+    MS_LOG(ERROR) << "Incorrect parameter.";
+    return false;
+  }
+  if (len > staging_bytes_) {
+    bool ret = WriteFile(filename, data, len, shape, type);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ret ? ++num_written_ : ++num_failed_;
+    return ret;
+  }
+  Task task;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!TakeBuffer(len, &task.buffer)) {
+      if (policy_ == DROP_WHEN_FULL) {
+        if (num_dropped_++ == num_reported_dropped_) {
+          first_unreported_drop_ = filename;
+        }
+        return true;
+      }
+      ++num_blocked_;
+      space_cond_.wait(lock, [this, len, &task]() { return TakeBuffer(len, &task.buffer); });
+    }
+  }
+  // The copy is done out of the lock, the buffer is accounted for already.
+  (void)std::copy_n(static_cast<const uint8_t *>(data), len, task.buffer.data.get());
+  task.filename = filename;
+  task.len = len;
+  task.shape = shape;
+  task.type = type;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+    ++num_queued_;
+  }
+  task_cond_.notify_one();
+  return true;
+}
+
+void DumpWriter::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_cond_.wait(lock, [this]() { return tasks_.empty() && num_running_ == 0; });
+  if (num_dropped_ > num_reported_dropped_) {
+    MS_LOG(WARNING) << (num_dropped_ - num_reported_dropped_) << " tensors are not dumped because the dump staging "
+                    << "buffers of " << staging_bytes_ << " bytes are full, first dropped: " << first_unreported_drop_;
+    num_reported_dropped_ = num_dropped_;
+    first_unreported_drop_.clear();
+  }
+}
+
+size_t DumpWriter::num_queued() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_queued_;
+}
+
+size_t DumpWriter::num_written() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_written_;
+}
+
+size_t DumpWriter::num_dropped() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_dropped_;
+}
+
+size_t DumpWriter::num_blocked() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_blocked_;
+}
+
+size_t DumpWriter::num_failed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_failed_;
+}
+
+void DumpWriter::Run() {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_cond_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        // Only stop once all the queued files are written.
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+      ++num_running_;
+    }
+    bool ret = WriteFile(task.filename, task.buffer.data.get(), task.len, task.shape, task.type);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ret ? ++num_written_ : ++num_failed_;
+      GiveBackBuffer(std::move(task.buffer));
+      --num_running_;
+    }
+    space_cond_.notify_all();
+    idle_cond_.notify_all();
+  }
+}
+
+bool DumpWriter::TakeBuffer(size_t len, Buffer *buffer) {
+  // The smallest free buffer that is large enough.
+  auto best = free_buffers_.end();
+  for (auto it = free_buffers_.begin(); it != free_buffers_.end(); ++it) {
+    if (it->capacity >= len && (best == free_buffers_.end() || it->capacity < best->capacity)) {
+      best = it;
+    }
+  }
+  if (best != free_buffers_.end()) {
+    *buffer = std::move(*best);
+    (void)free_buffers_.erase(best);
+    cached_bytes_ -= buffer->capacity;
+    used_bytes_ += buffer->capacity;
+    return true;
+  }
+  if (used_bytes_ + cached_bytes_ + len > staging_bytes_) {
+    // None of the free buffers fits, release them to make room for a new one.
+    free_buffers_.clear();
+    cached_bytes_ = 0;
+  }
+  if (used_bytes_ + len > staging_bytes_) {
+    return false;
+  }
+  // Left uninitialized, the tensor is copied over it.
+  buffer->data = std::unique_ptr<uint8_t[]>(new uint8_t[len]);
+  buffer->capacity = len;
+  used_bytes_ += len;
+  return true;
+}
+
+void DumpWriter::GiveBackBuffer(Buffer &&buffer) {
+  used_bytes_ -= buffer.capacity;
+  cached_bytes_ += buffer.capacity;
+  free_buffers_.push_back(std::move(buffer));
+}
+
+bool DumpWriter::WriteFile(const std::string &filename, const void *data, size_t len, const ShapeVector &shape,
+                           TypeId type) {
+  // Writing a file throws on errors, which must not escape the writer threads.
+  try {
+    return DumpJsonParser::WriteNpyFile(filename, data, len, shape, type);
+  } catch (const std::exception &e) {
+    MS_LOG(ERROR) << "Write dump file " << filename << " failed, error: " << e.what();
+  }
+  return false;
+}
+}  // namespace mindspore
@@ -0,0 +1,103 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_MINDSPORE_CCSRC_DEBUG_DATA_DUMP_DUMP_WRITER_H_
+#define MINDSPORE_MINDSPORE_CCSRC_DEBUG_DATA_DUMP_DUMP_WRITER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/ms_utils.h"
+#include "mindspore/core/utils/shape_utils.h"
+#include "mindspore/core/ir/dtype/type_id.h"
+
+namespace mindspore {
+// Writes the npy files of an e2e dump on background threads, so that the execution thread only copies the tensor
+// into a staging buffer. The staging buffers are bounded by staging_bytes, the freed ones are kept for the next
+// tensors while they fit. When the staging buffers are full the writer either blocks the caller until a file is
+// written or drops the tensor, and counts both. The dropped tensors are reported by one warning at each Flush. A
+// tensor larger than all the staging buffers is written by the caller.
+class DumpWriter {
+ public:
+  enum FullPolicy { BLOCK_WHEN_FULL = 0, DROP_WHEN_FULL = 1 };
+
+  DumpWriter(size_t staging_bytes, size_t num_threads, FullPolicy policy);
+  // Write all the queued files, then stop the threads.
+  ~DumpWriter();
+  DISABLE_COPY_AND_ASSIGN(DumpWriter)
+
+  // Queue a npy file with a copy of data. Return false if the tensor can't be written, a tensor dropped because the
+  // staging buffers are full is not a failure, it is only counted.
+  bool Write(const std::string &filename, const void *data, size_t len, const ShapeVector &shape, TypeId type);
+  // Wait until all the queued files are written, and report the tensors dropped since the last flush.
+  void Flush();
+
+  size_t num_queued() const;
+  size_t num_written() const;
+  size_t num_dropped() const;
+  size_t num_blocked() const;
+  size_t num_failed() const;
+
+ private:
+  struct Buffer {
+    std::unique_ptr<uint8_t[]> data;
+    size_t capacity{0};
+  };
+  struct Task {
+    std::string filename;
+    Buffer buffer;
+    size_t len{0};
+    ShapeVector shape;
+    TypeId type{kTypeUnknown};
+  };
+
+  void Run();
+  // Take a staging buffer of at least len bytes, return false if there is no room. The mutex must be held.
+  bool TakeBuffer(size_t len, Buffer *buffer);
+  // Give back a staging buffer. The mutex must be held.
+  void GiveBackBuffer(Buffer &&buffer);
+  static bool WriteFile(const std::string &filename, const void *data, size_t len, const ShapeVector &shape,
+                        TypeId type);
+
+  const size_t staging_bytes_;
+  const FullPolicy policy_;
+  mutable std::mutex mutex_;
+  std::condition_variable task_cond_;
+  std::condition_variable space_cond_;
+  std::condition_variable idle_cond_;
+  std::deque<Task> tasks_;
+  std::vector<Buffer> free_buffers_;
+  size_t used_bytes_{0};    // capacity of the buffers queued or being written
+  size_t cached_bytes_{0};  // capacity of the free buffers
+  size_t num_running_{0};
+  bool stop_{false};
+  std::vector<std::thread> threads_;
+
+  size_t num_queued_{0};
+  size_t num_written_{0};
+  size_t num_dropped_{0};
+  size_t num_blocked_{0};
+  size_t num_failed_{0};
+  size_t num_reported_dropped_{0};
+  std::string first_unreported_drop_;
+};
+}  // namespace mindspore
+#endif  // MINDSPORE_MINDSPORE_CCSRC_DEBUG_DATA_DUMP_DUMP_WRITER_H_
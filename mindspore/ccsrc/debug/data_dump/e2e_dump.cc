@@ -452,6 +452,8 @@ void E2eDump::DumpRunIter(const KernelGraphPtr &graph, uint32_t rank_id) {
   }
   fout.close();
   ChangeFileMode(file_name, S_IRUSR);
+  // The step is done, its files are all written once it is recorded.
+  json_parser.FlushDumpWriter();
 }
 
 void E2eDump::DumpData(const session::KernelGraph *graph, uint32_t rank_id, const Debugger *debugger) {
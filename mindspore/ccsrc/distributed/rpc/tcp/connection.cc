@@ -16,6 +16,9 @@
 
 #include "distributed/rpc/tcp/connection.h"
 
+#ifdef __linux__
+#include <linux/errqueue.h>
+#endif
 #include <memory>
 #include <utility>
 
@@ -43,6 +46,18 @@ void SocketEventHandler(int fd, uint32_t events, void *context) {
     }
     return;
   }
+  // The completions of the MSG_ZEROCOPY sends are queued on the error queue of the socket. Some kernels raise EPOLLERR
+  // for them, which is only an error of the connection if the socket has a pending error. Others don't, so they are
+  // also read at the other events and sends of the connection.
+  if ((events & EPOLLERR) || conn->zerocopy_checked) {
+    std::lock_guard<std::mutex> lock(conn->send_mutex);
+    conn->ReapZeroCopyCompletions();
+    int so_error = 0;
+    socklen_t len = sizeof(so_error);
+    if ((events & EPOLLERR) && getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_error, &len) == 0 && so_error == 0) {
+      events &= ~static_cast<uint32_t>(EPOLLERR);
+    }
+  }
   // Handle write event.
   if (events & EPOLLOUT) {
     (void)conn->recv_event_loop->UpdateEpollEvent(fd, EPOLLIN | EPOLLHUP | EPOLLERR);
@@ -117,7 +132,6 @@ Connection::Connection()
       send_event_loop(nullptr),
       recv_event_loop(nullptr),
       send_metrics(new SendMetrics()),
-      send_message(nullptr),
       recv_message(nullptr),
       recv_state(kMsgHeader),
       total_recv_len(0),
@@ -138,15 +152,6 @@ Connection::Connection()
   recv_kernel_msg.msg_iov = recv_io_vec;
   recv_kernel_msg.msg_iovlen = RECV_MSG_IO_VEC_LEN;
 
-  // Initialize the send message header.
-  for (unsigned int i = 0; i < BUSMAGIC_LEN; i++) {
-    if (i < sizeof(RPC_MAGICID) - 1) {
-      send_msg_header.magic[i] = RPC_MAGICID[i];
-    } else {
-      send_msg_header.magic[i] = '\0';
-    }
-  }
-
   // Initialize the send kernel message structure.
   send_kernel_msg.msg_control = nullptr;
   send_kernel_msg.msg_controllen = 0;
@@ -154,7 +159,7 @@ Connection::Connection()
   send_kernel_msg.msg_name = nullptr;
   send_kernel_msg.msg_namelen = 0;
   send_kernel_msg.msg_iov = send_io_vec;
-  send_kernel_msg.msg_iovlen = SEND_MSG_IO_VEC_LEN;
+  send_kernel_msg.msg_iovlen = 0;
 }
 
 int Connection::Initialize() {
@@ -216,9 +221,8 @@ void Connection::Close() {
     }
   }
 
-  if (total_send_len != 0 && send_message != nullptr) {
-    delete send_message;
-  }
+  std::lock_guard<std::mutex> lock(send_mutex);
+  ClearSendMessages();
 
   MessageBase *tmpMsg = nullptr;
   while (!send_message_queue.empty()) {
@@ -261,6 +265,8 @@ int Connection::ReceiveMessage(IOMgr::MessageHandler msgHandler) {
       Connection::conn_mutex.unlock();
     }
   }
+  recv_event_loop->AddRecvBytes(sizeof(MessageHeader) + recv_msg_header.name_len + recv_msg_header.to_len +
+                                recv_msg_header.from_len + recv_msg_header.body_len);
   std::unique_ptr<MessageBase> msg(recv_message);
   recv_message = nullptr;
 
@@ -274,10 +280,11 @@ int Connection::ReceiveMessage(IOMgr::MessageHandler msgHandler) {
 }
 
 void Connection::CheckMessageType() {
-  std::lock_guard<std::mutex> lock(Connection::conn_mutex);
+  // Only the event loop of the connection sets the type, there's no need to lock for the connections already checked.
   if (recv_message_type != ParseType::kUnknown) {
     return;
   }
+  std::lock_guard<std::mutex> lock(Connection::conn_mutex);
 
   std::string magic_id = "";
   magic_id.resize(sizeof(RPC_MAGICID) - 1);
@@ -330,68 +337,153 @@ std::string Connection::GenerateHttpMessage(MessageBase *msg) {
   return postLine + userAgentLine + fromLine + connectLine + hostLine + commonEndLine;
 }
 
-void Connection::FillSendMessage(MessageBase *msg, const std::string &advertiseUrl, bool isHttpKmsg, int index) {
-  index = 0;
-  if (msg->type == MessageBase::Type::KMSG) {
-    if (!isHttpKmsg) {
-      send_to = msg->to;
-      send_from = msg->from.Name() + "@" + advertiseUrl;
-
-      send_msg_header.name_len = htonl(static_cast<uint32_t>(msg->name.size()));
-      send_msg_header.to_len = htonl(static_cast<uint32_t>(send_to.size()));
-      send_msg_header.from_len = htonl(static_cast<uint32_t>(send_from.size()));
-      send_msg_header.body_len = htonl(static_cast<uint32_t>(msg->body.size()));
-
-      send_io_vec[index].iov_base = &send_msg_header;
-      send_io_vec[index].iov_len = sizeof(send_msg_header);
-      ++index;
-      send_io_vec[index].iov_base = const_cast<char *>(msg->name.data());
-      send_io_vec[index].iov_len = msg->name.size();
-      ++index;
-      send_io_vec[index].iov_base = const_cast<char *>(send_to.data());
-      send_io_vec[index].iov_len = send_to.size();
-      ++index;
-      send_io_vec[index].iov_base = const_cast<char *>(send_from.data());
-      send_io_vec[index].iov_len = send_from.size();
-      ++index;
-      send_io_vec[index].iov_base = const_cast<char *>(msg->body.data());
-      send_io_vec[index].iov_len = msg->body.size();
-      ++index;
-      send_kernel_msg.msg_iov = send_io_vec;
-      send_kernel_msg.msg_iovlen = index;
-      total_send_len =
-        sizeof(send_msg_header) + msg->name.size() + send_to.size() + send_from.size() + msg->body.size();
-      send_message = msg;
-
-      // update metrics
-      send_metrics->UpdateMax(msg->body.size());
-      send_metrics->last_send_msg_name = msg->name;
-
-      return;
-    } else {
-      if (advertise_addr_.empty()) {
-        size_t index = advertiseUrl.find(URL_PROTOCOL_IP_SEPARATOR);
-        if (index == std::string::npos) {
-          advertise_addr_ = advertiseUrl;
-        } else {
-          advertise_addr_ = advertiseUrl.substr(index + sizeof(URL_PROTOCOL_IP_SEPARATOR) - 1);
-        }
+void Connection::FillSendMessages(const std::string &advertiseUrl, bool isHttpKmsg) {
+  send_kernel_msg.msg_iov = send_io_vec;
+  send_kernel_msg.msg_iovlen = 0;
+  total_send_len = 0;
+  send_batch_sent_len = 0;
+  while (!send_message_queue.empty() && send_messages.size() < SEND_BATCH_MAX_MSG_NUM &&
+         total_send_len < SEND_BATCH_MAX_LEN) {
+    MessageBase *msg = send_message_queue.front();
+    send_message_queue.pop();
+    FillSendMessage(msg, advertiseUrl, isHttpKmsg);
+  }
+  send_zerocopy = total_send_len >= ZEROCOPY_MIN_LEN && EnableZeroCopy();
+}
+
+void Connection::FillSendMessage(MessageBase *msg, const std::string &advertiseUrl, bool isHttpKmsg) {
+  if (msg->type != MessageBase::Type::KMSG) {
+    MS_LOG(WARNING) << "Drop the message of type " << static_cast<int>(msg->type) << ", name: " << msg->name;
+    delete msg;
+    return;
+  }
+  size_t index = send_kernel_msg.msg_iovlen;
+  SendingMessage &sending = *send_messages.emplace_back(std::make_unique<SendingMessage>());
+  sending.msg = msg;
+  if (!isHttpKmsg) {
+    sending.to = msg->to;
+    sending.from = msg->from.Name() + "@" + advertiseUrl;
+    size_t body_size = msg->body.size();
+
+    sending.header.name_len = htonl(static_cast<uint32_t>(msg->name.size()));
+    sending.header.to_len = htonl(static_cast<uint32_t>(sending.to.size()));
+    sending.header.from_len = htonl(static_cast<uint32_t>(sending.from.size()));
+    sending.header.body_len = htonl(static_cast<uint32_t>(body_size));
+
+    send_io_vec[index].iov_base = &sending.header;
+    send_io_vec[index].iov_len = sizeof(sending.header);
+    ++index;
+    send_io_vec[index].iov_base = const_cast<char *>(msg->name.data());
+    send_io_vec[index].iov_len = msg->name.size();
+    ++index;
+    send_io_vec[index].iov_base = const_cast<char *>(sending.to.data());
+    send_io_vec[index].iov_len = sending.to.size();
+    ++index;
+    send_io_vec[index].iov_base = const_cast<char *>(sending.from.data());
+    send_io_vec[index].iov_len = sending.from.size();
+    ++index;
+    send_io_vec[index].iov_base = const_cast<char *>(msg->body.data());
+    send_io_vec[index].iov_len = body_size;
+    ++index;
+    sending.len = sizeof(sending.header) + msg->name.size() + sending.to.size() + sending.from.size() + body_size;
+  } else {
+    if (advertise_addr_.empty()) {
+      size_t pos = advertiseUrl.find(URL_PROTOCOL_IP_SEPARATOR);
+      if (pos == std::string::npos) {
+        advertise_addr_ = advertiseUrl;
+      } else {
+        advertise_addr_ = advertiseUrl.substr(pos + sizeof(URL_PROTOCOL_IP_SEPARATOR) - 1);
       }
-      msg->body = GenerateHttpMessage(msg);
     }
+    msg->body = GenerateHttpMessage(msg);
 
     send_io_vec[index].iov_base = const_cast<char *>(msg->body.data());
     send_io_vec[index].iov_len = msg->body.size();
     ++index;
-    send_kernel_msg.msg_iov = send_io_vec;
-    send_kernel_msg.msg_iovlen = index;
-    total_send_len = msg->body.size();
-    send_message = msg;
+    sending.len = msg->body.size();
+  }
+  send_kernel_msg.msg_iovlen = index;
+  total_send_len += sending.len;
+
+  // update metrics
+  send_metrics->UpdateMax(msg->body.size());
+  send_metrics->last_send_msg_name = msg->name;
+}
+
+void Connection::ReleaseSentMessage(std::unique_ptr<SendingMessage> sending) {
+  if (send_zerocopy) {
+    // The message is done once the last zero copy call so far, which sent its end, is done.
+    zerocopy_messages.emplace_back(zerocopy_next_seq - 1, std::move(sending));
+  }
+  // Otherwise the kernel has copied it, it goes with sending.
+}
+
+void Connection::ReapZeroCopyCompletions() {
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+  if (!zerocopy_checked) {
+    return;
+  }
+  while (true) {
+    char control[128];
+    struct msghdr msg = {};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    // The error queue is never blocking, it fails with EAGAIN when empty.
+    if (recvmsg(socket_fd, &msg, MSG_ERRQUEUE) < 0) {
+      break;
+    }
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+        continue;
+      }
+      auto err = reinterpret_cast<struct sock_extended_err *>(CMSG_DATA(cmsg));
+      if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      // The kernel copied the data anyway (eg. through the loopback device), zero copy only costs here.
+      if (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+        zerocopy_enabled = false;
+      }
+      // The calls [ee_info, ee_data] are done, TCP completes them in order.
+      uint32_t done_seq = err->ee_data + 1;
+      if (static_cast<int32_t>(done_seq - zerocopy_done_seq) > 0) {
+        zerocopy_done_seq = done_seq;
+      }
+    }
+  }
+#endif
+  while (!zerocopy_messages.empty() &&
+         static_cast<int32_t>(zerocopy_messages.front().first - zerocopy_done_seq) < 0) {
+    zerocopy_messages.pop_front();
+  }
+}
+
+void Connection::ClearSendMessages() {
+  send_messages.clear();
+  // The kernel holds its own references to the pages still being sent, the buffers can go with the socket.
+  zerocopy_messages.clear();
+  total_send_len = 0;
+  send_batch_sent_len = 0;
+  send_kernel_msg.msg_iovlen = 0;
+  zerocopy_checked = false;
+  zerocopy_enabled = false;
+  send_zerocopy = false;
+  zerocopy_next_seq = 0;
+  zerocopy_done_seq = 0;
+}
 
-    // update metrics
-    send_metrics->UpdateMax(msg->body.size());
-    send_metrics->last_send_msg_name = msg->name;
+bool Connection::EnableZeroCopy() {
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+  if (!zerocopy_checked) {
+    zerocopy_checked = true;
+    int enable = 1;
+    zerocopy_enabled = setsockopt(socket_fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == 0;
   }
+  return zerocopy_enabled;
+#else
+  return false;
+#endif
 }
 
 void Connection::FillRecvMessage() {
@@ -485,6 +577,8 @@ bool Connection::ParseMessage() {
         total_recv_len -= retval;
         return false;
       }
+      recv_message->from = AID(recv_from);
+      recv_message->to = AID(recv_to);
       recv_state = State::kMsgHeader;
       break;
     default:
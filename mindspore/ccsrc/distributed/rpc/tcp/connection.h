@@ -17,9 +17,13 @@
 #ifndef MINDSPORE_CCSRC_DISTRIBUTED_RPC_TCP_CONNECTION_H_
 #define MINDSPORE_CCSRC_DISTRIBUTED_RPC_TCP_CONNECTION_H_
 
+#include <atomic>
+#include <deque>
 #include <queue>
+#include <memory>
 #include <string>
 #include <mutex>
+#include <utility>
 
 #include "actor/msg.h"
 #include "actor/iomgr.h"
@@ -51,6 +55,25 @@ struct MessageHeader {
   uint32_t body_len{0};
 };
 
+/*
+ * A message in the batch being sent through a connection, with the parts the connection fills for it. It owns the
+ * message. The iovecs of the batch point into it, so it stays at the same address until the kernel is done with them.
+ */
+struct SendingMessage {
+  SendingMessage() = default;
+  SendingMessage(const SendingMessage &) = delete;
+  SendingMessage &operator=(const SendingMessage &) = delete;
+  ~SendingMessage() { delete msg; }
+
+  MessageBase *msg{nullptr};
+  MessageHeader header;
+  std::string to;
+  std::string from;
+
+  // The number of bytes of the message on the wire.
+  uint32_t len{0};
+};
+
 /*
  * The SendMetrics is responsible for collecting metrics when sending data through a connection.
  */
@@ -121,8 +144,22 @@ struct Connection {
   int ReceiveMessage(IOMgr::MessageHandler msgHandler);
   void CheckMessageType();
 
-  // Fill the message to be sent based on the input message.
-  void FillSendMessage(MessageBase *msg, const std::string &advertiseUrl, bool isHttpKmsg, int index = 0);
+  // Gather the queued messages into the batch to be sent by one sendmsg call.
+  void FillSendMessages(const std::string &advertiseUrl, bool isHttpKmsg);
+
+  // Append the message to the batch to be sent. Its name and body are sent in place from the MessageBase, which is
+  // kept until the batch is sent. A body is still copied once by whoever builds it into MessageBase::body.
+  void FillSendMessage(MessageBase *msg, const std::string &advertiseUrl, bool isHttpKmsg);
+
+  // Release a message of the batch which has been sent. If it was sent with MSG_ZEROCOPY, it is kept with its header,
+  // to and from until a later event or send of the connection reads that the kernel is done with their pages.
+  void ReleaseSentMessage(std::unique_ptr<SendingMessage> sending);
+
+  // Read the completions of the MSG_ZEROCOPY sends from the error queue of the socket and release the messages done.
+  void ReapZeroCopyCompletions();
+
+  // Release the batch being sent and the messages waiting for zero copy completions, eg. when the socket is closed.
+  void ClearSendMessages();
 
   void FillRecvMessage();
 
@@ -159,7 +196,8 @@ struct Connection {
   // The state of this connection(eg. kInit/kConnecting/..)
   ConnectionState state{kInit};
 
-  // The threads for handling the receive and send requsets on this connection.
+  // The threads for handling the receive and send requsets on this connection. Both are the event loop owning the
+  // connection, the only thread which reads its socket and closes it.
   EventLoop *send_event_loop;
   EventLoop *recv_event_loop;
 
@@ -167,7 +205,7 @@ struct Connection {
   SendMetrics *send_metrics;
 
   // The message data waiting to be sent and receive through this connection..
-  MessageBase *send_message;
+  std::deque<std::unique_ptr<SendingMessage>> send_messages;
   MessageBase *recv_message;
 
   State recv_state;
@@ -177,13 +215,13 @@ struct Connection {
   uint32_t total_send_len;
   uint32_t recv_len;
 
-  std::string send_to;
-  std::string send_from;
+  // The number of bytes of the batch being sent not yet accounted to the messages sent.
+  uint32_t send_batch_sent_len{0};
+
   std::string recv_to;
   std::string recv_from;
 
   // Message header.
-  MessageHeader send_msg_header;
   MessageHeader recv_msg_header;
 
   // The message structure of kernel.
@@ -191,7 +229,19 @@ struct Connection {
   struct msghdr recv_kernel_msg;
 
   struct iovec recv_io_vec[RECV_MSG_IO_VEC_LEN];
-  struct iovec send_io_vec[SEND_MSG_IO_VEC_LEN];
+  struct iovec send_io_vec[SEND_BATCH_IO_VEC_LEN];
+
+  // Whether SO_ZEROCOPY has been tried on the socket and is usable, and whether the batch being sent uses it.
+  std::atomic<bool> zerocopy_checked{false};
+  bool zerocopy_enabled{false};
+  bool send_zerocopy{false};
+
+  // Each sendmsg call with MSG_ZEROCOPY takes the next number, the kernel reports the ranges of calls completed.
+  uint32_t zerocopy_next_seq{0};
+  uint32_t zerocopy_done_seq{0};
+
+  // The messages sent with MSG_ZEROCOPY, with the number of the last call that must complete before releasing them.
+  std::deque<std::pair<uint32_t, std::unique_ptr<SendingMessage>>> zerocopy_messages;
 
   ParseType recv_message_type{kUnknown};
 
@@ -209,8 +259,14 @@ struct Connection {
   // The error code when sending or receiving messages.
   int error_code;
 
+  // Guards the pool of connections and their lifetime.
   static std::mutex conn_mutex;
 
+  // Guards the messages, the socket writes and the metrics of the sends through this connection, so that the sends
+  // through different connections run in parallel. It is taken after conn_mutex. The event loop releasing the
+  // connection takes it too, to let a send under way in another event loop finish first.
+  std::mutex send_mutex;
+
  private:
   // Add handler for socket connect event.
   int AddConnnectEventHandler();
@@ -224,6 +280,9 @@ struct Connection {
   // Change the header body from network byte order to host byte order.
   void ReorderHeader(MessageHeader *header);
 
+  // Turn on SO_ZEROCOPY of the socket the first time, return whether it is usable.
+  bool EnableZeroCopy();
+
   std::string advertise_addr_;
 };
 }  // namespace rpc
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <sys/socket.h>
 #include <mutex>
 #include "distributed/rpc/tcp/connection_pool.h"
 
@@ -36,12 +37,23 @@ void ConnectionPool::CloseConnection(Connection *conn) {
   }
 
   if (!conn->destination.empty()) {
-    if (conn->is_remote) {
-      remote_conns_.erase(conn->destination);
-    } else {
-      local_conns_.erase(conn->destination);
+    // The connection may have been replaced by a new one to the same destination already.
+    auto &conns = conn->is_remote ? remote_conns_ : local_conns_;
+    auto iter = conns.find(conn->destination);
+    if (iter != conns.end() && iter->second == conn) {
+      (void)conns.erase(iter);
     }
   }
+
+  // A connection is only released in the event loop handling its socket, which may be busy with it right now. The other
+  // threads hang it up, the event loop then closes it like any connection closed by the peer.
+  if (conn->recv_event_loop != nullptr && !conn->recv_event_loop->IsInLoopThread()) {
+    MS_LOG(INFO) << "Hang up fd: " << conn->socket_fd << " for its event loop to close, to: " << conn->destination;
+    if (conn->socket_fd >= 0) {
+      (void)shutdown(conn->socket_fd, SHUT_RDWR);
+    }
+    return;
+  }
   conn->Close();
   delete conn;
   conn = nullptr;
@@ -89,9 +101,11 @@ Connection *ConnectionPool::FindConnection(const std::string &to, bool remoteLin
 
 void ConnectionPool::ResetAllConnMetrics() {
   for (const auto &iter : local_conns_) {
+    std::lock_guard<std::mutex> lock(iter.second->send_mutex);
     iter.second->send_metrics->Reset();
   }
   for (const auto &iter : remote_conns_) {
+    std::lock_guard<std::mutex> lock(iter.second->send_mutex);
     iter.second->send_metrics->Reset();
   }
 }
@@ -100,12 +114,14 @@ Connection *ConnectionPool::FindMaxConnection() {
   Connection *conn = nullptr;
   int count = 0;
   for (const auto &iter : local_conns_) {
+    std::lock_guard<std::mutex> lock(iter.second->send_mutex);
     if (iter.second->send_metrics->accum_msg_count > count) {
       count = iter.second->send_metrics->accum_msg_count;
       conn = iter.second;
     }
   }
   for (const auto &iter : remote_conns_) {
+    std::lock_guard<std::mutex> lock(iter.second->send_mutex);
     if (iter.second->send_metrics->accum_msg_count > count) {
       count = iter.second->send_metrics->accum_msg_count;
       conn = iter.second;
@@ -118,12 +134,14 @@ Connection *ConnectionPool::FindFastConnection() {
   Connection *conn = nullptr;
   int size = 0;
   for (const auto &iter : local_conns_) {
+    std::lock_guard<std::mutex> lock(iter.second->send_mutex);
     if (iter.second->send_metrics->max_msg_size > size) {
       size = iter.second->send_metrics->max_msg_size;
       conn = iter.second;
     }
   }
   for (const auto &iter : remote_conns_) {
+    std::lock_guard<std::mutex> lock(iter.second->send_mutex);
     if (iter.second->send_metrics->max_msg_size > size) {
       size = iter.second->send_metrics->max_msg_size;
       conn = iter.second;
@@ -30,6 +30,15 @@ using DeleteCallBack = void (*)(const std::string &from, const std::string &to);
 using ConnectionCallBack = void (*)(void *conn);
 
 constexpr int SEND_MSG_IO_VEC_LEN = 5;
+
+// The queued messages of a connection are gathered into one sendmsg call, up to SEND_BATCH_MAX_MSG_NUM messages and
+// until the batch reaches SEND_BATCH_MAX_LEN bytes.
+constexpr size_t SEND_BATCH_MAX_MSG_NUM = 64;
+constexpr size_t SEND_BATCH_MAX_LEN = 256 * 1024;
+constexpr int SEND_BATCH_IO_VEC_LEN = SEND_MSG_IO_VEC_LEN * SEND_BATCH_MAX_MSG_NUM;
+
+// A batch of at least this many bytes is sent with MSG_ZEROCOPY, below it pinning the pages costs more than the copy.
+constexpr size_t ZEROCOPY_MIN_LEN = 64 * 1024;
 constexpr int RECV_MSG_IO_VEC_LEN = 4;
 
 constexpr unsigned int BUSMAGIC_LEN = 4;
@@ -70,8 +79,18 @@ static const int SOCKET_KEEPCOUNT = 3;
 static const char RPC_MAGICID[] = "BUS0";
 static const char URL_PROTOCOL_IP_SEPARATOR[] = "://";
 static const char URL_IP_PORT_SEPARATOR[] = ":";
-static const char TCP_RECV_EVLOOP_THREADNAME[] = "RECV_EVENT_LOOP";
-static const char TCP_SEND_EVLOOP_THREADNAME[] = "SEND_EVENT_LOOP";
+// The event loop threads are named with this prefix and their index.
+static const char TCP_EVLOOP_THREADNAME[] = "RPC_EVLOOP_";
+
+// TCPComm runs one event loop per EVLOOP_CPU_NUM_PER_LOOP cpus, at least EVLOOP_MIN_NUM and at most
+// EVLOOP_DEFAULT_MAX_NUM of them. LITERPC_EVENT_LOOP_NUM sets the number instead, up to EVLOOP_MAX_NUM.
+constexpr size_t EVLOOP_CPU_NUM_PER_LOOP = 8;
+constexpr size_t EVLOOP_MIN_NUM = 2;
+constexpr size_t EVLOOP_DEFAULT_MAX_NUM = 8;
+constexpr size_t EVLOOP_MAX_NUM = 64;
+
+// The capacity of the lock free task queue of an event loop, the tasks beyond it wait in a locked queue.
+constexpr int32_t EVLOOP_TASK_QUEUE_SIZE = 4096;
 
 constexpr int RPC_ERROR = -1;
 constexpr int RPC_OK = 0;
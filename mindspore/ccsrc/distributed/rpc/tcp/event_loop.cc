@@ -23,6 +23,7 @@
 #include <sys/socket.h>
 #include <securec.h>
 #include <unistd.h>
+#include <algorithm>
 #include <utility>
 #include <atomic>
 #include <string>
@@ -66,6 +67,7 @@ int EventLoopRun(EventLoop *evloop, int timeout) {
     } else if (nevent > 0) {
       /* save the epoll modify in "stop" while dispatching handlers */
       evloop->HandleEvent(events, nevent);
+      (void)evloop->handled_events_.fetch_add(static_cast<uint64_t>(nevent), std::memory_order_relaxed);
     } else {
       MS_LOG(ERROR) << "Failed to call epoll_wait, epoll_fd_: " << evloop->epoll_fd_ << ", ret: 0,errno: " << errno;
       evloop->is_stop_ = true;
@@ -99,22 +101,65 @@ void QueueReadyCallback(int fd, uint32_t events, void *arg) {
   }
   uint64_t count;
   if (read(evloop->task_queue_event_fd_, &count, sizeof(count)) == sizeof(count)) {
-    // take out functions from the queue
-    std::queue<std::function<void()>> q;
-
-    evloop->task_queue_mutex_.lock();
-    evloop->task_queue_.swap(q);
-    evloop->task_queue_mutex_.unlock();
+    // The tasks added from now on notify the loop again, run the ones added so far.
+    (void)evloop->task_queue_notified_.exchange(false);
+    evloop->RunTasks(static_cast<size_t>(evloop->task_num_.load()));
+  }
+}
 
-    // invoke functions in the queue
-    while (!q.empty()) {
-      q.front()();
-      q.pop();
+void EventLoop::RunTasks(size_t max_num) {
+  constexpr size_t kTaskBatchSize = 64;
+  std::function<void()> *tasks[kTaskBatchSize];
+  size_t run_num = 0;
+  while (run_num < max_num) {
+    size_t num = task_queue_.DequeueBatch(tasks, std::min(kTaskBatchSize, max_num - run_num));
+    if (num == 0) {
+      if (overflow_task_num_.load() == 0) {
+        break;
+      }
+      // The tasks of task_queue_ were added before these ones, or by other threads.
+      std::queue<std::function<void()> *> overflow_tasks;
+      task_queue_mutex_.lock();
+      overflow_task_queue_.swap(overflow_tasks);
+      overflow_task_num_ = 0;
+      task_queue_mutex_.unlock();
+      while (!overflow_tasks.empty()) {
+        auto task = overflow_tasks.front();
+        overflow_tasks.pop();
+        (void)task_num_.fetch_sub(1);
+        (*task)();
+        delete task;
+        ++run_num;
+      }
+      continue;
     }
+    for (size_t i = 0; i < num; ++i) {
+      (void)task_num_.fetch_sub(1);
+      (*tasks[i])();
+      delete tasks[i];
+    }
+    run_num += num;
+  }
+  (void)handled_tasks_.fetch_add(run_num, std::memory_order_relaxed);
+}
+
+void EventLoop::ClearTasks() {
+  std::function<void()> *task = nullptr;
+  while ((task = task_queue_.Dequeue()) != nullptr) {
+    delete task;
+  }
+  std::lock_guard<std::mutex> lock(task_queue_mutex_);
+  while (!overflow_task_queue_.empty()) {
+    delete overflow_task_queue_.front();
+    overflow_task_queue_.pop();
   }
+  overflow_task_num_ = 0;
+  task_num_ = 0;
 }
 
 void EventLoop::ReleaseResource() {
+  ClearTasks();
+  task_queue_notified_ = false;
   if (task_queue_event_fd_ != -1) {
     close(task_queue_event_fd_);
     task_queue_event_fd_ = -1;
@@ -126,15 +171,20 @@ void EventLoop::ReleaseResource() {
 }
 
 int EventLoop::AddTask(std::function<void()> &&task) {
-  // put func to the queue
-  task_queue_mutex_.lock();
-  task_queue_.emplace(std::move(task));
+  auto new_task = new (std::nothrow) std::function<void()>(std::move(task));
+  RPC_OOM_EXIT(new_task);
 
   // return the queque size to send's caller.
-  int result = task_queue_.size();
-  task_queue_mutex_.unlock();
+  int result = task_num_.fetch_add(1) + 1;
 
-  if (result == 1) {
+  // Once a task overflows, the later tasks queue after it to keep their order.
+  if (overflow_task_num_.load() > 0 || !task_queue_.Enqueue(new_task)) {
+    std::lock_guard<std::mutex> lock(task_queue_mutex_);
+    overflow_task_queue_.push(new_task);
+    ++overflow_task_num_;
+  }
+
+  if (!task_queue_notified_.exchange(true)) {
     // wakeup event loop
     uint64_t one = 1;
     if (write(task_queue_event_fd_, &one, sizeof(one)) != sizeof(one)) {
@@ -144,6 +194,18 @@ int EventLoop::AddTask(std::function<void()> &&task) {
   return result;
 }
 
+bool EventLoop::IsInLoopThread() const { return loop_thread_ != 0 && pthread_equal(loop_thread_, pthread_self()); }
+
+EventLoopMetrics EventLoop::GetMetrics() const {
+  EventLoopMetrics metrics;
+  metrics.handled_events = handled_events_.load(std::memory_order_relaxed);
+  metrics.handled_tasks = handled_tasks_.load(std::memory_order_relaxed);
+  metrics.queued_tasks = static_cast<uint64_t>(std::max(task_num_.load(std::memory_order_relaxed), 0));
+  metrics.recv_bytes = recv_bytes_.load(std::memory_order_relaxed);
+  metrics.send_bytes = send_bytes_.load(std::memory_order_relaxed);
+  return metrics;
+}
+
 bool EventLoop::Initialize(const std::string &threadName) {
   int retval = InitResource();
   if (retval != RPC_OK) {
@@ -226,6 +288,10 @@ Event *EventLoop::FindEvent(int fd) {
 int EventLoop::InitResource() {
   int retval = 0;
   is_stop_ = false;
+  if (task_queue_.Capacity() == 0) {
+    MS_LOG(ERROR) << "Failed to allocate the task queue.";
+    return RPC_ERROR;
+  }
   epoll_fd_ = epoll_create(EPOLL_SIZE);
   if (epoll_fd_ == -1) {
     MS_LOG(ERROR) << "Failed to call epoll_create, errno:" << errno;
@@ -335,7 +401,10 @@ int EventLoop::UpdateEpollEvent(int fd, uint32_t events) {
   Event *tev = nullptr;
   int ret;
 
+  // The sends to a connection may come from another event loop.
+  event_lock_.lock();
   tev = FindEvent(fd);
+  event_lock_.unlock();
   if (tev == nullptr) {
     MS_LOG(ERROR) << "Failed to call event lookup, fd:" << fd << ",events:" << events_;
     return RPC_ERROR;
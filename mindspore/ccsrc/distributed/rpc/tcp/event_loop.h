@@ -21,6 +21,7 @@
 #include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <semaphore.h>
+#include <atomic>
 #include <functional>
 #include <list>
 #include <mutex>
@@ -28,6 +29,9 @@
 #include <map>
 #include <string>
 
+#include "thread/hqueue.h"
+#include "distributed/rpc/tcp/constants.h"
+
 namespace mindspore {
 namespace distributed {
 namespace rpc {
@@ -52,13 +56,26 @@ typedef struct Event {
   EventHandler handler;
 } Event;
 
+/*
+ * The counters of an event loop. The bytes are those received and sent through the connections handled by the loop.
+ */
+struct EventLoopMetrics {
+  uint64_t handled_events{0};
+  uint64_t handled_tasks{0};
+  uint64_t queued_tasks{0};
+  uint64_t recv_bytes{0};
+  uint64_t send_bytes{0};
+};
+
 /*
  * The class EventLoop monitors a certain file descriptor created by eventfd function call,
  * and triggers tasks when any event occurred on the file descriptor.
  */
 class EventLoop {
  public:
-  EventLoop() : epoll_fd_(-1), is_stop_(false), loop_thread_(0), task_queue_event_fd_(-1) {}
+  EventLoop() : epoll_fd_(-1), is_stop_(false), loop_thread_(0), task_queue_event_fd_(-1) {
+    (void)task_queue_.Init(EVLOOP_TASK_QUEUE_SIZE);
+  }
   EventLoop(const EventLoop &) = delete;
   EventLoop &operator=(const EventLoop &) = delete;
   ~EventLoop();
@@ -67,9 +84,19 @@ class EventLoop {
   void Finalize();
 
   // Add task (eg. send message, reconnect etc.) to task queue of the event loop by user.
-  // These tasks are executed asynchronously.
+  // These tasks are executed asynchronously, in the order of adding for the tasks added by the same thread.
+  // This is lock free unless the loop falls behind by more than EVLOOP_TASK_QUEUE_SIZE tasks.
   int AddTask(std::function<void()> &&task);
 
+  // Whether the caller runs in the thread of this event loop.
+  bool IsInLoopThread() const;
+
+  // Account the bytes received and sent through the connections handled by this event loop.
+  void AddRecvBytes(uint64_t bytes) { (void)recv_bytes_.fetch_add(bytes, std::memory_order_relaxed); }
+  void AddSendBytes(uint64_t bytes) { (void)send_bytes_.fetch_add(bytes, std::memory_order_relaxed); }
+
+  EventLoopMetrics GetMetrics() const;
+
   // Set event handler for events(read/write/..) occurred on the socket fd.
   int SetEventHandler(int sock_fd, uint32_t events, EventHandler handler, void *data);
 
@@ -86,6 +113,11 @@ class EventLoop {
   // Release the resources of epoll and tasks.
   void ReleaseResource();
 
+  // Run at most max_num queued tasks, the tasks added meanwhile wake the loop up again.
+  void RunTasks(size_t max_num);
+  // Release the tasks never run.
+  void ClearTasks();
+
   // Stop the event loop.
   void Stop();
 
@@ -106,7 +138,6 @@ class EventLoop {
   bool is_stop_;
 
   sem_t sem_id_;
-  std::mutex task_queue_mutex_;
 
   // The loop thread.
   pthread_t loop_thread_;
@@ -116,7 +147,25 @@ class EventLoop {
 
   // Queue tasks like send message, reconnect, collect metrics, etc.
   // This tasks will be triggered by task_queue_event_fd_.
-  std::queue<std::function<void()>> task_queue_;
+  HQueue<std::function<void()>> task_queue_;
+
+  // The tasks which don't fit in task_queue_, the later tasks follow them here until the loop takes them.
+  std::mutex task_queue_mutex_;
+  std::queue<std::function<void()> *> overflow_task_queue_;
+  std::atomic<size_t> overflow_task_num_{0};
+
+  // The number of the tasks added and not run yet.
+  std::atomic<int> task_num_{0};
+
+  // Whether task_queue_event_fd_ has been written since the loop took the tasks last time, so that only the first
+  // task added since then pays for the system call.
+  std::atomic<bool> task_queue_notified_{false};
+
+  // Metrics.
+  std::atomic<uint64_t> handled_events_{0};
+  std::atomic<uint64_t> handled_tasks_{0};
+  std::atomic<uint64_t> recv_bytes_{0};
+  std::atomic<uint64_t> send_bytes_{0};
 
   // Events on the socket.
   std::mutex event_lock_;
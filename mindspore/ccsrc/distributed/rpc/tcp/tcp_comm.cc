@@ -16,7 +16,9 @@
 
 #include "distributed/rpc/tcp/tcp_comm.h"
 
+#include <algorithm>
 #include <mutex>
+#include <thread>
 #include <utility>
 #include <memory>
 
@@ -31,10 +33,25 @@ namespace distributed {
 namespace rpc {
 bool TCPComm::is_http_msg_ = false;
 std::vector<char> TCPComm::advertise_url_;
-uint64_t TCPComm::output_buf_size_ = 0;
+std::atomic<uint64_t> TCPComm::output_buf_size_{0};
 
 IOMgr::MessageHandler TCPComm::message_handler_;
 
+namespace {
+size_t GetEventLoopNum() {
+  char *loop_num_env = getenv("LITERPC_EVENT_LOOP_NUM");
+  if (loop_num_env != nullptr) {
+    int loop_num = atoi(loop_num_env);
+    if (loop_num > 0) {
+      return std::min(static_cast<size_t>(loop_num), EVLOOP_MAX_NUM);
+    }
+    MS_LOG(WARNING) << "Invalid LITERPC_EVENT_LOOP_NUM: " << loop_num_env;
+  }
+  size_t cpu_num = std::thread::hardware_concurrency();
+  return std::min(std::max(cpu_num / EVLOOP_CPU_NUM_PER_LOOP, EVLOOP_MIN_NUM), EVLOOP_DEFAULT_MAX_NUM);
+}
+}  // namespace
+
 int DoConnect(const std::string &to, Connection *conn, ConnectionCallBack event_callback,
               ConnectionCallBack write_callback, ConnectionCallBack read_callback) {
   SocketAddress addr;
@@ -100,7 +117,7 @@ void OnAccept(int server, uint32_t events, void *arg) {
     return;
   }
   TCPComm *tcpmgr = reinterpret_cast<TCPComm *>(arg);
-  if (tcpmgr->recv_event_loop_ == nullptr) {
+  if (tcpmgr->event_loops_.empty()) {
     MS_LOG(ERROR) << "EventLoop is null, server fd: " << server << ", events: " << events;
     return;
   }
@@ -137,8 +154,8 @@ void OnAccept(int server, uint32_t events, void *arg) {
   conn->peer = SocketOperation::GetPeer(acceptFd);
 
   conn->is_remote = true;
-  conn->recv_event_loop = tcpmgr->recv_event_loop_;
-  conn->send_event_loop = tcpmgr->send_event_loop_;
+  conn->recv_event_loop = tcpmgr->GetEventLoop(acceptFd);
+  conn->send_event_loop = conn->recv_event_loop;
 
   conn->event_callback = TCPComm::EventCallBack;
   conn->write_callback = TCPComm::WriteCallBack;
@@ -157,33 +174,47 @@ void OnAccept(int server, uint32_t events, void *arg) {
 }
 
 void DoSend(Connection *conn) {
+  if (!conn->zerocopy_messages.empty()) {
+    conn->ReapZeroCopyCompletions();
+  }
   while (!conn->send_message_queue.empty() || conn->total_send_len != 0) {
     if (conn->total_send_len == 0) {
-      conn->FillSendMessage(conn->send_message_queue.front(), TCPComm::advertise_url_.data(), TCPComm::IsHttpMsg());
-      conn->send_message_queue.pop();
+      conn->FillSendMessages(TCPComm::advertise_url_.data(), TCPComm::IsHttpMsg());
+      if (conn->total_send_len == 0) {
+        continue;
+      }
     }
 
+    uint32_t unsentLen = conn->total_send_len;
     int sendLen = conn->socket_operation->SendMessage(conn, &conn->send_kernel_msg, &conn->total_send_len);
-    if (sendLen > 0) {
-      if (conn->total_send_len == 0) {
-        // update metrics
-        conn->send_metrics->UpdateError(false);
-
-        TCPComm::output_buf_size_ -= conn->send_message->body.size();
-        conn->output_buffer_size -= conn->send_message->body.size();
-        delete conn->send_message;
-        conn->send_message = nullptr;
-      }
-    } else if (sendLen == 0) {
-      // EAGAIN
-      (void)conn->recv_event_loop->UpdateEpollEvent(conn->socket_fd, EPOLLOUT | EPOLLIN | EPOLLHUP | EPOLLERR);
-      break;
-    } else {
+    if (sendLen < 0) {
       // update metrics
       conn->send_metrics->UpdateError(true, conn->error_code);
       conn->state = ConnectionState::kDisconnecting;
       break;
     }
+
+    // Release the messages of the batch sent completely.
+    conn->recv_event_loop->AddSendBytes(unsentLen - conn->total_send_len);
+    conn->send_batch_sent_len += unsentLen - conn->total_send_len;
+    while (!conn->send_messages.empty() && conn->send_messages.front()->len <= conn->send_batch_sent_len) {
+      std::unique_ptr<SendingMessage> sending = std::move(conn->send_messages.front());
+      conn->send_messages.pop_front();
+      conn->send_batch_sent_len -= sending->len;
+
+      // update metrics
+      conn->send_metrics->UpdateError(false);
+
+      TCPComm::output_buf_size_ -= sending->msg->body.size();
+      conn->output_buffer_size -= sending->msg->body.size();
+      conn->ReleaseSentMessage(std::move(sending));
+    }
+
+    if (sendLen == 0) {
+      // EAGAIN
+      (void)conn->recv_event_loop->UpdateEpollEvent(conn->socket_fd, EPOLLOUT | EPOLLIN | EPOLLHUP | EPOLLERR);
+      break;
+    }
   }
 }
 
@@ -214,36 +245,25 @@ bool TCPComm::Initialize() {
     MS_LOG(ERROR) << "Failed to create connection pool.";
     return false;
   }
-  recv_event_loop_ = new (std::nothrow) EventLoop();
-  if (recv_event_loop_ == nullptr) {
-    MS_LOG(ERROR) << "Failed to create recv evLoop.";
-    return false;
-  }
-
-  bool ok = recv_event_loop_->Initialize(TCP_RECV_EVLOOP_THREADNAME);
-  if (!ok) {
-    MS_LOG(ERROR) << "Failed to init recv evLoop";
-    delete recv_event_loop_;
-    recv_event_loop_ = nullptr;
-    return false;
-  }
-
-  send_event_loop_ = new (std::nothrow) EventLoop();
-  if (send_event_loop_ == nullptr) {
-    MS_LOG(ERROR) << "Failed to create send evLoop.";
-    delete recv_event_loop_;
-    recv_event_loop_ = nullptr;
-    return false;
-  }
-  ok = send_event_loop_->Initialize(TCP_SEND_EVLOOP_THREADNAME);
-  if (!ok) {
-    MS_LOG(ERROR) << "Failed to init send evLoop";
-    delete recv_event_loop_;
-    recv_event_loop_ = nullptr;
-    delete send_event_loop_;
-    send_event_loop_ = nullptr;
-    return false;
+  size_t loop_num = GetEventLoopNum();
+  for (size_t i = 0; i < loop_num; ++i) {
+    EventLoop *event_loop = new (std::nothrow) EventLoop();
+    if (event_loop == nullptr) {
+      MS_LOG(ERROR) << "Failed to create evLoop " << i;
+      Finalize();
+      return false;
+    }
+    if (!event_loop->Initialize(TCP_EVLOOP_THREADNAME + std::to_string(i))) {
+      MS_LOG(ERROR) << "Failed to init evLoop " << i;
+      delete event_loop;
+      Finalize();
+      return false;
+    }
+    event_loops_.push_back(event_loop);
   }
+  last_loop_metrics_.assign(loop_num, EventLoopMetrics());
+  last_collect_time_ = std::chrono::steady_clock::now();
+  MS_LOG(INFO) << "Started " << loop_num << " event loops.";
 
   if (g_httpKmsgEnable < 0) {
     char *httpKmsgEnv = getenv("LITERPC_HTTPKMSG_ENABLED");
@@ -291,10 +311,12 @@ bool TCPComm::StartServerSocket(const std::string &url, const std::string &aAdve
     advertise_url_.resize(tmp_url.size());
     advertise_url_.assign(tmp_url.begin(), tmp_url.end());
   }
+  // The advertise url is used as a C string.
+  advertise_url_.push_back('\0');
 
-  // Register read event callback for server socket
-  int retval = recv_event_loop_->SetEventHandler(server_fd_, EPOLLIN | EPOLLHUP | EPOLLERR, OnAccept,
-                                                 reinterpret_cast<void *>(this));
+  // Register read event callback for server socket, the connections accepted are handed over to their event loops.
+  int retval = event_loops_[0]->SetEventHandler(server_fd_, EPOLLIN | EPOLLHUP | EPOLLERR, OnAccept,
+                                                reinterpret_cast<void *>(this));
   if (retval != RPC_OK) {
     MS_LOG(ERROR) << "Failed to add server event, url: " << url.c_str()
                   << ", advertise_url_: " << advertise_url_.data();
@@ -322,23 +344,23 @@ void TCPComm::EventCallBack(void *context) {
   Connection *conn = reinterpret_cast<Connection *>(context);
 
   if (conn->state == ConnectionState::kConnected) {
-    Connection::conn_mutex.lock();
+    std::lock_guard<std::mutex> send_lock(conn->send_mutex);
     DoSend(conn);
-    Connection::conn_mutex.unlock();
   } else if (conn->state == ConnectionState::kDisconnecting) {
-    Connection::conn_mutex.lock();
-    output_buf_size_ -= conn->output_buffer_size;
+    std::lock_guard<std::mutex> lock(Connection::conn_mutex);
+    {
+      std::lock_guard<std::mutex> send_lock(conn->send_mutex);
+      output_buf_size_ -= conn->output_buffer_size;
+    }
     ConnectionPool::GetConnectionPool()->CloseConnection(conn);
-    Connection::conn_mutex.unlock();
   }
 }
 
 void TCPComm::WriteCallBack(void *context) {
   Connection *conn = reinterpret_cast<Connection *>(context);
   if (conn->state == ConnectionState::kConnected) {
-    Connection::conn_mutex.lock();
+    std::lock_guard<std::mutex> send_lock(conn->send_mutex);
     DoSend(conn);
-    Connection::conn_mutex.unlock();
   }
 }
 
@@ -408,7 +430,7 @@ int TCPComm::Connect(Connection *conn, const struct sockaddr *sa, socklen_t saLe
 }
 
 void TCPComm::Send(MessageBase *msg, const TCPComm *tcpmgr, bool remoteLink, bool isExactNotRemote) {
-  std::lock_guard<std::mutex> lock(Connection::conn_mutex);
+  std::unique_lock<std::mutex> lock(Connection::conn_mutex);
   Connection *conn = ConnectionPool::GetConnectionPool()->FindConnection(msg->to.Url(), remoteLink, isExactNotRemote);
 
   // Create a new connection if the connection to target of the message does not existed.
@@ -428,8 +450,8 @@ void TCPComm::Send(MessageBase *msg, const TCPComm *tcpmgr, bool remoteLink, boo
     }
     conn->source = advertise_url_.data();
     conn->destination = msg->to.Url();
-    conn->recv_event_loop = tcpmgr->recv_event_loop_;
-    conn->send_event_loop = tcpmgr->send_event_loop_;
+    conn->recv_event_loop = tcpmgr->GetEventLoop(conn->destination);
+    conn->send_event_loop = conn->recv_event_loop;
     conn->InitSocketOperation();
 
     int ret = DoConnect(msg->to.Url(), conn, TCPComm::EventCallBack, TCPComm::WriteCallBack, TCPComm::ReadCallBack);
@@ -454,12 +476,11 @@ void TCPComm::Send(MessageBase *msg, const TCPComm *tcpmgr, bool remoteLink, boo
     }
   }
 
-  // Prepare the message.
-  if (conn->total_send_len == 0) {
-    conn->FillSendMessage(msg, advertise_url_.data(), is_http_msg_);
-  } else {
-    conn->send_message_queue.emplace(msg);
-  }
+  // Queue the message, the queued messages are sent in batches. Only the sends through this connection wait for each
+  // other from here.
+  std::lock_guard<std::mutex> send_lock(conn->send_mutex);
+  lock.unlock();
+  conn->send_message_queue.emplace(msg);
 
   // Send the message.
   if (conn->state == ConnectionState::kConnected) {
@@ -467,14 +488,10 @@ void TCPComm::Send(MessageBase *msg, const TCPComm *tcpmgr, bool remoteLink, boo
   }
 }
 
-void TCPComm::SendByRecvLoop(MessageBase *msg, const TCPComm *tcpmgr, bool remoteLink, bool isExactNotRemote) {
-  recv_event_loop_->AddTask(
-    [msg, tcpmgr, remoteLink, isExactNotRemote] { TCPComm::Send(msg, tcpmgr, remoteLink, isExactNotRemote); });
-}
-
 int TCPComm::Send(MessageBase *msg, bool remoteLink, bool isExactNotRemote) {
-  return send_event_loop_->AddTask([msg, this, remoteLink, isExactNotRemote] {
-    std::lock_guard<std::mutex> lock(Connection::conn_mutex);
+  // Run in the event loop of the destination, which makes the connections to it.
+  return GetEventLoop(msg->to.Url())->AddTask([msg, this, remoteLink, isExactNotRemote] {
+    std::unique_lock<std::mutex> lock(Connection::conn_mutex);
     // Search connection by the target address
     bool exactNotRemote = is_http_msg_ || isExactNotRemote;
     Connection *conn = ConnectionPool::GetConnectionPool()->FindConnection(msg->to.Url(), remoteLink, exactNotRemote);
@@ -488,11 +505,17 @@ int TCPComm::Send(MessageBase *msg, bool remoteLink, bool isExactNotRemote) {
 
         return;
       }
-      this->SendByRecvLoop(msg, this, remoteLink, exactNotRemote);
+      lock.unlock();
+      TCPComm::Send(msg, this, remoteLink, exactNotRemote);
       return;
     }
 
-    if (conn->state != kConnected && conn->send_message_queue.size() >= SENDMSG_QUEUELEN) {
+    bool queue_full = false;
+    if (conn->state != kConnected) {
+      std::lock_guard<std::mutex> send_lock(conn->send_mutex);
+      queue_full = conn->send_message_queue.size() >= SENDMSG_QUEUELEN;
+    }
+    if (queue_full) {
       MS_LOG(WARNING) << "The name of dropped message is: " << msg->name.c_str() << ", fd: " << conn->socket_fd
                       << ", to: " << conn->destination.c_str() << ", remote: " << conn->is_remote;
       auto *ptr = msg;
@@ -503,7 +526,8 @@ int TCPComm::Send(MessageBase *msg, bool remoteLink, bool isExactNotRemote) {
     }
 
     if (conn->state == ConnectionState::kClose || conn->state == ConnectionState::kDisconnecting) {
-      this->SendByRecvLoop(msg, this, remoteLink, exactNotRemote);
+      lock.unlock();
+      TCPComm::Send(msg, this, remoteLink, exactNotRemote);
       return;
     }
 
@@ -514,12 +538,12 @@ int TCPComm::Send(MessageBase *msg, bool remoteLink, bool isExactNotRemote) {
       }
     }
 
+    // A connection isn't released while its send_mutex is held, so conn_mutex is let go before sending: the event loops
+    // only wait for each other to send through the same connection.
+    std::lock_guard<std::mutex> send_lock(conn->send_mutex);
+    lock.unlock();
     output_buf_size_ += msg->body.size();
-    if (conn->total_send_len == 0) {
-      conn->FillSendMessage(msg, advertise_url_.data(), is_http_msg_);
-    } else {
-      conn->send_message_queue.emplace(msg);
-    }
+    conn->send_message_queue.emplace(msg);
 
     if (conn->state == ConnectionState::kConnected) {
       DoSend(conn);
@@ -528,7 +552,7 @@ int TCPComm::Send(MessageBase *msg, bool remoteLink, bool isExactNotRemote) {
 }
 
 void TCPComm::CollectMetrics() {
-  send_event_loop_->AddTask([this] {
+  event_loops_[0]->AddTask([this] {
     Connection::conn_mutex.lock();
     Connection *maxConn = ConnectionPool::GetConnectionPool()->FindMaxConnection();
     Connection *fastConn = ConnectionPool::GetConnectionPool()->FindFastConnection();
@@ -538,6 +562,7 @@ void TCPComm::CollectMetrics() {
       StringTypeMetrics stringMetrics;
 
       if (maxConn != nullptr) {
+        std::lock_guard<std::mutex> send_lock(maxConn->send_mutex);
         intMetrics.push(maxConn->socket_fd);
         intMetrics.push(maxConn->error_code);
         intMetrics.push(maxConn->send_metrics->accum_msg_count);
@@ -547,6 +572,7 @@ void TCPComm::CollectMetrics() {
         stringMetrics.push(maxConn->send_metrics->last_fail_msg_name);
       }
       if (fastConn != nullptr && fastConn->IsSame(maxConn)) {
+        std::lock_guard<std::mutex> send_lock(fastConn->send_mutex);
         intMetrics.push(fastConn->socket_fd);
         intMetrics.push(fastConn->error_code);
         intMetrics.push(fastConn->send_metrics->accum_msg_count);
@@ -559,15 +585,46 @@ void TCPComm::CollectMetrics() {
 
     ConnectionPool::GetConnectionPool()->ResetAllConnMetrics();
     Connection::conn_mutex.unlock();
+
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - last_collect_time_).count();
+    if (seconds <= 0) {
+      return;
+    }
+    for (size_t i = 0; i < event_loops_.size(); ++i) {
+      EventLoopMetrics metrics = event_loops_[i]->GetMetrics();
+      EventLoopMetrics &last = last_loop_metrics_[i];
+      MS_LOG(INFO) << "Event loop " << i << ", events/s: " << (metrics.handled_events - last.handled_events) / seconds
+                   << ", tasks/s: " << (metrics.handled_tasks - last.handled_tasks) / seconds
+                   << ", queued tasks: " << metrics.queued_tasks
+                   << ", recv bytes/s: " << (metrics.recv_bytes - last.recv_bytes) / seconds
+                   << ", send bytes/s: " << (metrics.send_bytes - last.send_bytes) / seconds;
+      last = metrics;
+    }
+    last_collect_time_ = now;
   });
 }
 
+std::vector<EventLoopMetrics> TCPComm::GetEventLoopMetrics() const {
+  std::vector<EventLoopMetrics> metrics;
+  for (auto event_loop : event_loops_) {
+    metrics.push_back(event_loop->GetMetrics());
+  }
+  return metrics;
+}
+
+EventLoop *TCPComm::GetEventLoop(const std::string &url) const {
+  return event_loops_[std::hash<std::string>()(url) % event_loops_.size()];
+}
+
+EventLoop *TCPComm::GetEventLoop(int fd) const { return event_loops_[static_cast<size_t>(fd) % event_loops_.size()]; }
+
 int TCPComm::Send(std::unique_ptr<MessageBase> &&msg, bool remoteLink, bool isExactNotRemote) {
   return Send(msg.release(), remoteLink, isExactNotRemote);
 }
 
 void TCPComm::Link(const AID &source, const AID &destination) {
-  recv_event_loop_->AddTask([source, destination, this] {
+  GetEventLoop(destination.Url())->AddTask([source, destination, this] {
     std::string to = destination.Url();
     std::lock_guard<std::mutex> lock(Connection::conn_mutex);
 
@@ -587,8 +644,8 @@ void TCPComm::Link(const AID &source, const AID &destination) {
       conn->source = advertise_url_.data();
       conn->destination = to;
 
-      conn->recv_event_loop = this->recv_event_loop_;
-      conn->send_event_loop = this->send_event_loop_;
+      conn->recv_event_loop = GetEventLoop(to);
+      conn->send_event_loop = conn->recv_event_loop;
       conn->InitSocketOperation();
 
       int ret = DoConnect(to, conn, TCPComm::EventCallBack, TCPComm::WriteCallBack, TCPComm::ReadCallBack);
@@ -612,7 +669,7 @@ void TCPComm::Link(const AID &source, const AID &destination) {
 }
 
 void TCPComm::UnLink(const AID &destination) {
-  recv_event_loop_->AddTask([destination] {
+  GetEventLoop(destination.Url())->AddTask([destination] {
     std::string to = destination.Url();
     std::lock_guard<std::mutex> lock(Connection::conn_mutex);
     if (is_http_msg_) {
@@ -647,6 +704,8 @@ void TCPComm::DoReConnectConn(Connection *conn, std::string to, const AID &sourc
                << ", destination: " << std::string(destination).c_str() << ", remote: " << conn->is_remote
                << ", state: " << conn->state;
 
+  // Another event loop may be sending through the old socket.
+  std::lock_guard<std::mutex> send_lock(conn->send_mutex);
   *oldFd = conn->socket_fd;
 
   conn->recv_event_loop->DeleteEpollEvent(conn->socket_fd);
@@ -658,11 +717,7 @@ void TCPComm::DoReConnectConn(Connection *conn, std::string to, const AID &sourc
   conn->total_recv_len = 0;
   conn->recv_message_type = kUnknown;
   conn->state = kInit;
-  if (conn->total_send_len != 0 && conn->send_message != nullptr) {
-    delete conn->send_message;
-  }
-  conn->send_message = nullptr;
-  conn->total_send_len = 0;
+  conn->ClearSendMessages();
 
   if (conn->total_recv_len != 0 && conn->recv_message != nullptr) {
     delete conn->recv_message;
@@ -681,77 +736,76 @@ Connection *TCPComm::CreateDefaultConn(std::string to) {
   }
   conn->source = advertise_url_.data();
   conn->destination = to;
-  conn->recv_event_loop = this->recv_event_loop_;
-  conn->send_event_loop = this->send_event_loop_;
+  conn->recv_event_loop = GetEventLoop(to);
+  conn->send_event_loop = conn->recv_event_loop;
   conn->InitSocketOperation();
   return conn;
 }
 
 void TCPComm::Reconnect(const AID &source, const AID &destination) {
-  send_event_loop_->AddTask([source, destination, this] {
-    std::string to = destination.Url();
-    std::lock_guard<std::mutex> lock(Connection::conn_mutex);
-    Connection *conn = ConnectionPool::GetConnectionPool()->FindConnection(to, false, is_http_msg_);
+  EventLoop *loop = GetEventLoop(destination.Url());
+  loop->AddTask([source, destination, loop, this] { DoReconnect(source, destination, loop); });
+}
+
+void TCPComm::DoReconnect(const AID &source, const AID &destination, EventLoop *loop) {
+  std::string to = destination.Url();
+  int oldFd = -1;
+  std::lock_guard<std::mutex> lock(Connection::conn_mutex);
+  Connection *conn = ConnectionPool::GetConnectionPool()->FindConnection(to, false, is_http_msg_);
+  // The socket of a connection is only reset in the event loop owning it, which is another one for the connections
+  // accepted. Stop sending through the connection until then.
+  EventLoop *owner = (conn != nullptr) ? conn->recv_event_loop : GetEventLoop(to);
+  if (owner != loop) {
     if (conn != nullptr) {
       conn->state = ConnectionState::kClose;
     }
-
-    recv_event_loop_->AddTask([source, destination, this] {
-      std::string to = destination.Url();
-      int oldFd = -1;
-      std::lock_guard<std::mutex> lock(Connection::conn_mutex);
-      Connection *conn = ConnectionPool::GetConnectionPool()->FindConnection(to, false, is_http_msg_);
-      if (conn != nullptr) {
-        // connection already exist
-        DoReConnectConn(conn, to, source, destination, &oldFd);
-      } else {
-        // create default connection
-        conn = CreateDefaultConn(to);
-        if (conn == nullptr) {
-          return;
-        }
-      }
-      int ret = DoConnect(to, conn, TCPComm::EventCallBack, TCPComm::WriteCallBack, TCPComm::ReadCallBack);
-      if (ret < 0) {
-        if (conn->socket_operation != nullptr) {
-          delete conn->socket_operation;
-          conn->socket_operation = nullptr;
-        }
-        if (oldFd != -1) {
-          conn->socket_fd = oldFd;
-        }
-        MS_LOG(ERROR) << "Failed to connect and reconnect fail source: " << std::string(source).c_str()
-                      << ", destination: " << std::string(destination).c_str();
-        ConnectionPool::GetConnectionPool()->CloseConnection(conn);
-        return;
-      }
-      if (oldFd != -1) {
-        if (!ConnectionPool::GetConnectionPool()->ReverseConnInfo(oldFd, conn->socket_fd)) {
-          MS_LOG(ERROR) << "Failed to swap socket for " << oldFd << " and " << conn->socket_fd;
-        }
-      } else {
-        ConnectionPool::GetConnectionPool()->AddConnection(conn);
-      }
-      ConnectionPool::GetConnectionPool()->AddConnInfo(conn->socket_fd, source, destination, SendExitMsg);
-      MS_LOG(INFO) << "Reconnect fd: " << conn->socket_fd << ", source: " << std::string(source).c_str()
-                   << ", destination: " << std::string(destination).c_str();
-    });
-  });
+    owner->AddTask([source, destination, owner, this] { DoReconnect(source, destination, owner); });
+    return;
+  }
+  if (conn != nullptr) {
+    // connection already exist
+    DoReConnectConn(conn, to, source, destination, &oldFd);
+  } else {
+    // create default connection
+    conn = CreateDefaultConn(to);
+    if (conn == nullptr) {
+      return;
+    }
+  }
+  int ret = DoConnect(to, conn, TCPComm::EventCallBack, TCPComm::WriteCallBack, TCPComm::ReadCallBack);
+  if (ret < 0) {
+    if (conn->socket_operation != nullptr) {
+      delete conn->socket_operation;
+      conn->socket_operation = nullptr;
+    }
+    if (oldFd != -1) {
+      conn->socket_fd = oldFd;
+    }
+    MS_LOG(ERROR) << "Failed to connect and reconnect fail source: " << std::string(source).c_str()
+                  << ", destination: " << std::string(destination).c_str();
+    ConnectionPool::GetConnectionPool()->CloseConnection(conn);
+    return;
+  }
+  if (oldFd != -1) {
+    if (!ConnectionPool::GetConnectionPool()->ReverseConnInfo(oldFd, conn->socket_fd)) {
+      MS_LOG(ERROR) << "Failed to swap socket for " << oldFd << " and " << conn->socket_fd;
+    }
+  } else {
+    ConnectionPool::GetConnectionPool()->AddConnection(conn);
+  }
+  ConnectionPool::GetConnectionPool()->AddConnInfo(conn->socket_fd, source, destination, SendExitMsg);
+  MS_LOG(INFO) << "Reconnect fd: " << conn->socket_fd << ", source: " << std::string(source).c_str()
+               << ", destination: " << std::string(destination).c_str();
 }
 
 void TCPComm::Finalize() {
-  if (send_event_loop_ != nullptr) {
-    MS_LOG(INFO) << "Delete send event loop";
-    send_event_loop_->Finalize();
-    delete send_event_loop_;
-    send_event_loop_ = nullptr;
-  }
-
-  if (recv_event_loop_ != nullptr) {
-    MS_LOG(INFO) << "Delete recv event loop";
-    recv_event_loop_->Finalize();
-    delete recv_event_loop_;
-    recv_event_loop_ = nullptr;
+  for (auto event_loop : event_loops_) {
+    event_loop->Finalize();
+    delete event_loop;
+  }
+  if (!event_loops_.empty()) {
+    MS_LOG(INFO) << "Delete " << event_loops_.size() << " event loops";
+    event_loops_.clear();
   }
 
   if (server_fd_ > 0) {
@@ -17,6 +17,8 @@
 #ifndef MINDSPORE_CCSRC_DISTRIBUTED_RPC_TCP_TCP_COMM_H_
 #define MINDSPORE_CCSRC_DISTRIBUTED_RPC_TCP_TCP_COMM_H_
 
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <memory>
 #include <vector>
@@ -31,7 +33,7 @@ namespace rpc {
 // Event handler for new connecting request arrived.
 void OnAccept(int server, uint32_t events, void *arg);
 
-// Send messages buffered in the connection.
+// Send messages buffered in the connection, with the send_mutex of the connection locked.
 void DoSend(Connection *conn);
 
 // Create a server socket and connect to it, this is a local connection..
@@ -44,12 +46,12 @@ void ConnectedEventHandler(int fd, uint32_t events, void *context);
 
 class TCPComm : public IOMgr {
  public:
-  TCPComm() : server_fd_(-1), recv_event_loop_(nullptr), send_event_loop_(nullptr) {}
+  TCPComm() : server_fd_(-1) {}
   TCPComm(const TCPComm &) = delete;
   TCPComm &operator=(const TCPComm &) = delete;
   ~TCPComm();
 
-  // Init the event loop for reading and writing.
+  // Init the event loops for reading and writing.
   bool Initialize() override;
 
   // Destroy all the resources.
@@ -69,16 +71,25 @@ class TCPComm : public IOMgr {
   uint64_t GetOutBufSize() override;
   void CollectMetrics() override;
 
+  // The counters of each event loop so far.
+  std::vector<EventLoopMetrics> GetEventLoopMetrics() const;
+
+  // The event loop owning the connections made to the url.
+  EventLoop *GetEventLoop(const std::string &url) const;
+
  private:
   // Build the connection.
   Connection *CreateDefaultConn(std::string to);
   void Reconnect(const AID &source, const AID &destination);
+  void DoReconnect(const AID &source, const AID &destination, EventLoop *loop);
   void DoReConnectConn(Connection *conn, std::string to, const AID &source, const AID &destination, int *oldFd);
 
+  // The event loop owning the connection accepted on the fd.
+  EventLoop *GetEventLoop(int fd) const;
+
   // Send a message.
   int Send(MessageBase *msg, bool remoteLink = false, bool isExactNotRemote = false);
   static void Send(MessageBase *msg, const TCPComm *tcpmgr, bool remoteLink, bool isExactNotRemote);
-  void SendByRecvLoop(MessageBase *msg, const TCPComm *tcpmgr, bool remoteLink, bool isExactNotRemote);
   static void SendExitMsg(const std::string &from, const std::string &to);
 
   // Called by ReadCallBack when new message arrived.
@@ -104,7 +115,7 @@ class TCPComm : public IOMgr {
   int server_fd_;
 
   // The message size waiting to be sent.
-  static uint64_t output_buf_size_;
+  static std::atomic<uint64_t> output_buf_size_;
 
   // User defined handler for Handling received messages.
   static MessageHandler message_handler_;
@@ -114,9 +125,14 @@ class TCPComm : public IOMgr {
 
   static bool is_http_msg_;
 
-  // All the connections share the same read and write event loop objects.
-  EventLoop *recv_event_loop_;
-  EventLoop *send_event_loop_;
+  // Each event loop owns a share of the connections: it handles their sockets and runs the tasks of their
+  // destinations, so that the messages to a destination are sent in order. The connections accepted are sharded by fd,
+  // the connections made by the hash of their destination, which is known before their socket.
+  std::vector<EventLoop *> event_loops_;
+
+  // The counters of the event loops at the last CollectMetrics, for the rates since then.
+  std::vector<EventLoopMetrics> last_loop_metrics_;
+  std::chrono::steady_clock::time_point last_collect_time_;
 
   friend void OnAccept(int server, uint32_t events, void *arg);
   friend void DoSend(Connection *conn);
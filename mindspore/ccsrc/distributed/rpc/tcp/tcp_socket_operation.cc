@@ -109,8 +109,22 @@ int TCPSocketOperation::SendMessage(Connection *connection, struct msghdr *sendM
   uint32_t unsendLen = *sendLen;
 
   while (*sendLen != 0) {
-    int retval = sendmsg(connection->socket_fd, sendMsg, MSG_NOSIGNAL);
+    int flags = MSG_NOSIGNAL;
+#ifdef MSG_ZEROCOPY
+    bool zerocopy = connection->send_zerocopy && connection->zerocopy_enabled;
+    if (zerocopy) {
+      flags |= MSG_ZEROCOPY;
+    }
+#endif
+    int retval = sendmsg(connection->socket_fd, sendMsg, flags);
     if (retval < 0) {
+#ifdef MSG_ZEROCOPY
+      // Out of the memory for pinning the pages, send the rest by copying.
+      if (zerocopy && errno == ENOBUFS) {
+        connection->zerocopy_enabled = false;
+        continue;
+      }
+#endif
       --eagainCount;
       if (errno != EAGAIN) {
         connection->error_code = errno;
@@ -121,6 +135,11 @@ int TCPSocketOperation::SendMessage(Connection *connection, struct msghdr *sendM
         break;
       }
     } else {
+#ifdef MSG_ZEROCOPY
+      if (zerocopy) {
+        ++connection->zerocopy_next_seq;
+      }
+#endif
       *sendLen -= retval;
 
       if (*sendLen == 0) {
@@ -15,10 +15,26 @@
  */
 
 #include "fl/server/collective_ops_impl.h"
+#include <algorithm>
 
 namespace mindspore {
 namespace fl {
 namespace server {
+uint64_t NodeCollectiveTransport::SendAsync(uint32_t rank_id, const void *data, size_t size) {
+  return node_->CollectiveSendAsync(node_role_, GlobalRank(rank_id), data, size);
+}
+
+bool NodeCollectiveTransport::WaitSend(uint64_t request_id) { return node_->Wait(request_id, kCollectiveCommTimeout); }
+
+bool NodeCollectiveTransport::ReceiveMessage(uint32_t rank_id, std::shared_ptr<std::vector<unsigned char>> *output) {
+  auto recv_req_id = node_->CollectiveReceiveAsync(node_role_, GlobalRank(rank_id), output);
+  if (!node_->CollectiveWait(recv_req_id, kCollectiveCommTimeout)) {
+    MS_LOG(ERROR) << "CollectiveWait " << recv_req_id << " failed.";
+    return false;
+  }
+  return true;
+}
+
 void CollectiveOpsImpl::Initialize(const std::shared_ptr<ps::core::ServerNode> &server_node) {
   MS_EXCEPTION_IF_NULL(server_node);
   server_node_ = server_node;
@@ -27,9 +43,23 @@ void CollectiveOpsImpl::Initialize(const std::shared_ptr<ps::core::ServerNode> &
   return;
 }
 
+bool CollectiveTransport::Receive(uint32_t rank_id, size_t size,
+                                  std::shared_ptr<std::vector<unsigned char>> *recv_str) {
+  if (!ReceiveMessage(rank_id, recv_str)) {
+    return false;
+  }
+  if (*recv_str == nullptr || (*recv_str)->size() != size) {
+    MS_LOG(ERROR) << "The data received from rank " << rank_id << " is of "
+                  << (*recv_str == nullptr ? 0 : (*recv_str)->size()) << " bytes, expected " << size << " bytes.";
+    return false;
+  }
+  return true;
+}
+
 template <typename T>
-bool CollectiveOpsImpl::RingAllReduce(const void *sendbuff, void *recvbuff, size_t count) {
-  MS_ERROR_IF_NULL_W_RET_VAL(server_node_, false);
+bool CollectiveOpsImpl::RingAllReduce(CollectiveTransport *transport, const void *sendbuff, void *recvbuff,
+                                      size_t count) {
+  MS_ERROR_IF_NULL_W_RET_VAL(transport, false);
   MS_ERROR_IF_NULL_W_RET_VAL(sendbuff, false);
   MS_ERROR_IF_NULL_W_RET_VAL(recvbuff, false);
 
@@ -41,7 +71,8 @@ bool CollectiveOpsImpl::RingAllReduce(const void *sendbuff, void *recvbuff, size
     return false;
   }
 
-  uint32_t rank_size = server_num_;
+  uint32_t rank_id = transport->rank_id();
+  uint32_t rank_size = transport->rank_size();
   size_t chunk_size = count / rank_size;
   size_t remainder_size = count % rank_size;
   std::vector<size_t> chunk_sizes(rank_size, chunk_size);
@@ -58,93 +89,207 @@ bool CollectiveOpsImpl::RingAllReduce(const void *sendbuff, void *recvbuff, size
   }
 
   T *output_buff = reinterpret_cast<T *>(recvbuff);
-  uint32_t send_to_rank = (rank_id_ + 1) % rank_size;
-  uint32_t recv_from_rank = (rank_id_ - 1 + rank_size) % rank_size;
-  MS_LOG(DEBUG) << "AllReduce count:" << count << ", rank_size:" << rank_size << ", rank_id_:" << rank_id_
+  uint32_t send_to_rank = (rank_id + 1) % rank_size;
+  uint32_t recv_from_rank = (rank_id - 1 + rank_size) % rank_size;
+  size_t piece_size = std::max<size_t>(kRingPipelinePieceBytes / sizeof(T), 1);
+  MS_LOG(DEBUG) << "AllReduce count:" << count << ", rank_size:" << rank_size << ", rank_id:" << rank_id
                 << ", chunk_size:" << chunk_size << ", remainder_size:" << remainder_size
-                << ", chunk_sizes:" << chunk_sizes << ", send_to_rank:" << send_to_rank
+                << ", chunk_sizes:" << chunk_sizes << ", piece_size:" << piece_size << ", send_to_rank:" << send_to_rank
                 << ", recv_from_rank:" << recv_from_rank;
 
-  // Ring ReduceScatter.
+  // The rank_size - 1 steps of Ring ReduceScatter are followed by the rank_size - 1 steps of Ring AllGather. Each step
+  // receives the chunk that the next step sends, so a piece is forwarded to the next rank as soon as it is reduced or
+  // copied, while the following pieces of the chunk are still in flight. The pieces of a chunk only depend on the
+  // chunk, the messages of every rank are received in the order they are sent.
+  size_t step_num = 2 * (rank_size - 1);
+  std::vector<uint64_t> send_req_ids;
+  auto send_piece = [&](const T *chunk, size_t chunk_count, size_t begin) {
+    size_t piece_count = std::min(piece_size, chunk_count - begin);
+    send_req_ids.push_back(transport->SendAsync(send_to_rank, chunk + begin, piece_count * sizeof(T)));
+  };
+  if (step_num > 0) {
+    T *send_chunk = output_buff + chunk_offset[rank_id];
+    for (size_t begin = 0; begin < chunk_sizes[rank_id]; begin += piece_size) {
+      send_piece(send_chunk, chunk_sizes[rank_id], begin);
+    }
+  }
   MS_LOG(DEBUG) << "Start Ring ReduceScatter.";
-  std::unique_ptr<T[]> tmp_recv_chunk = std::make_unique<T[]>(chunk_sizes[0]);
-  MS_EXCEPTION_IF_NULL(tmp_recv_chunk);
-  for (size_t i = 0; i < rank_size - 1; i++) {
-    // Step 1: Async send data to next rank.
-    size_t send_chunk_index = (rank_id_ - i + rank_size) % rank_size;
-    T *send_chunk = output_buff + chunk_offset[send_chunk_index];
-    auto send_req_id = server_node_->CollectiveSendAsync(ps::core::NodeRole::SERVER, send_to_rank, send_chunk,
-                                                         chunk_sizes[send_chunk_index] * sizeof(T));
-    // Step 2: Async receive data to next rank and wait until it's done.
-    size_t recv_chunk_index = (rank_id_ - i - 1 + rank_size) % rank_size;
+  for (size_t i = 0; i < step_num; i++) {
+    bool reduce = i < rank_size - 1;
+    if (i == rank_size - 1) {
+      MS_LOG(DEBUG) << "End Ring ReduceScatter. Start Ring AllGather.";
+    }
+    size_t recv_chunk_index = (rank_id + 2 * rank_size - i - 1) % rank_size;
     T *recv_chunk = output_buff + chunk_offset[recv_chunk_index];
-    MS_LOG(DEBUG) << "Ring ReduceScatter send_to_rank:" << send_to_rank << ", recv_from_rank:" << recv_from_rank
-                  << ", send count:" << chunk_sizes[send_chunk_index]
-                  << ", recv count:" << chunk_sizes[recv_chunk_index] << ", iteration:" << i;
+    size_t recv_count = chunk_sizes[recv_chunk_index];
+    MS_LOG(DEBUG) << "Ring AllReduce send_to_rank:" << send_to_rank << ", recv_from_rank:" << recv_from_rank
+                  << ", recv count:" << recv_count << ", iteration:" << i;
+    for (size_t begin = 0; begin < recv_count; begin += piece_size) {
+      size_t piece_count = std::min(piece_size, recv_count - begin);
+      std::shared_ptr<std::vector<unsigned char>> recv_str;
+      if (!transport->Receive(recv_from_rank, piece_count * sizeof(T), &recv_str)) {
+        return false;
+      }
+      if (reduce) {
+        ReduceSum(recv_chunk + begin, reinterpret_cast<const T *>(recv_str->data()), piece_count);
+      } else {
+        ret = memcpy_s(recv_chunk + begin, piece_count * sizeof(T), recv_str->data(), recv_str->size());
+        if (ret != 0) {
+          MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+          return false;
+        }
+      }
+      if (i + 1 < step_num) {
+        send_piece(recv_chunk, recv_count, begin);
+      }
+    }
+  }
+  for (auto send_req_id : send_req_ids) {
+    if (!transport->WaitSend(send_req_id)) {
+      MS_LOG(ERROR) << "CollectiveWait " << send_req_id << " failed.";
+      return false;
+    }
+  }
+  MS_LOG(DEBUG) << "End Ring AllGather.";
+  return true;
+}
 
-    std::shared_ptr<std::vector<unsigned char>> recv_str;
-    auto recv_req_id = server_node_->CollectiveReceiveAsync(ps::core::NodeRole::SERVER, recv_from_rank, &recv_str);
-    if (!server_node_->CollectiveWait(recv_req_id, kCollectiveCommTimeout)) {
-      MS_LOG(ERROR) << "CollectiveWait " << recv_req_id << " failed.";
+template <typename T>
+bool CollectiveOpsImpl::HalvingDoublingAllReduce(CollectiveTransport *transport, const void *sendbuff, void *recvbuff,
+                                                 size_t count) {
+  MS_ERROR_IF_NULL_W_RET_VAL(transport, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(sendbuff, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(recvbuff, false);
+  uint32_t rank_id = transport->rank_id();
+  uint32_t rank_size = transport->rank_size();
+  // The halving and doubling runs among the largest power of two ranks.
+  uint32_t pof2 = 1;
+  while (pof2 * 2 <= rank_size) {
+    pof2 *= 2;
+  }
+  if (count < pof2) {
+    return ReduceBroadcastAllReduce<T>(transport, sendbuff, recvbuff, count);
+  }
+  uint32_t rem = rank_size - pof2;
+  MS_LOG(DEBUG) << "Halving Doubling AllReduce rank_size:" << rank_size << ", rank_id:" << rank_id
+                << ", count:" << count << ", pof2:" << pof2;
+
+  size_t data_size = count * sizeof(T);
+  int ret = memcpy_s(recvbuff, data_size, sendbuff, data_size);
+  if (ret != 0) {
+    MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+    return false;
+  }
+  T *output_buff = reinterpret_cast<T *>(recvbuff);
+  std::shared_ptr<std::vector<unsigned char>> recv_str;
+
+  // The first 2 * rem ranks are folded in pairs: the even rank gives its data to the odd one and waits for the result.
+  bool folded = rank_id < 2 * rem && rank_id % 2 == 0;
+  if (folded) {
+    auto send_req_id = transport->SendAsync(rank_id + 1, output_buff, data_size);
+    if (!transport->WaitSend(send_req_id)) {
+      MS_LOG(ERROR) << "CollectiveWait " << send_req_id << " failed.";
       return false;
     }
-    ret = memcpy_s(tmp_recv_chunk.get(), chunk_sizes[recv_chunk_index] * sizeof(T), recv_str->data(), recv_str->size());
+    if (!transport->Receive(rank_id + 1, data_size, &recv_str)) {
+      return false;
+    }
+    ret = memcpy_s(output_buff, data_size, recv_str->data(), recv_str->size());
     if (ret != 0) {
       MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
       return false;
     }
-    // Step 3: Reduce the data so we can overlap the time cost of send.
-    for (size_t j = 0; j < chunk_sizes[recv_chunk_index]; j++) {
-      recv_chunk[j] += tmp_recv_chunk[j];
+    return true;
+  }
+  if (rank_id < 2 * rem) {
+    if (!transport->Receive(rank_id - 1, data_size, &recv_str)) {
+      return false;
+    }
+    ReduceSum(output_buff, reinterpret_cast<const T *>(recv_str->data()), count);
+  }
+  uint32_t new_rank = rank_id < 2 * rem ? rank_id / 2 : rank_id - rem;
+  auto global_rank = [rem](uint32_t rank) { return rank < rem ? rank * 2 + 1 : rank + rem; };
+
+  // Exchange [send_begin, send_end) with the partner and receive [recv_begin, recv_end) in place, reduced or copied.
+  auto exchange = [&](uint32_t partner, size_t send_begin, size_t send_end, size_t recv_begin, size_t recv_end,
+                      bool reduce) {
+    auto send_req_id = transport->SendAsync(partner, output_buff + send_begin, (send_end - send_begin) * sizeof(T));
+    std::shared_ptr<std::vector<unsigned char>> piece;
+    size_t recv_count = recv_end - recv_begin;
+    if (!transport->Receive(partner, recv_count * sizeof(T), &piece)) {
+      return false;
+    }
+    if (reduce) {
+      ReduceSum(output_buff + recv_begin, reinterpret_cast<const T *>(piece->data()), recv_count);
+    } else if (memcpy_s(output_buff + recv_begin, recv_count * sizeof(T), piece->data(), piece->size()) != 0) {
+      MS_LOG(ERROR) << "memcpy_s error.";
+      return false;
     }
-    // Step 4: Wait until send is done.
-    if (!server_node_->Wait(send_req_id, kCollectiveCommTimeout)) {
+    if (!transport->WaitSend(send_req_id)) {
       MS_LOG(ERROR) << "CollectiveWait " << send_req_id << " failed.";
       return false;
     }
-  }
-  MS_LOG(DEBUG) << "End Ring ReduceScatter.";
-
-  // Ring AllGather.
-  MS_LOG(DEBUG) << "Start Ring AllGather.";
-  for (size_t i = 0; i < rank_size - 1; i++) {
-    size_t send_chunk_index = (rank_id_ - i + 1 + rank_size) % rank_size;
-    T *send_chunk = output_buff + chunk_offset[send_chunk_index];
-    auto send_req_id = server_node_->CollectiveSendAsync(ps::core::NodeRole::SERVER, send_to_rank, send_chunk,
-                                                         chunk_sizes[send_chunk_index] * sizeof(T));
-    size_t recv_chunk_index = (rank_id_ - i + rank_size) % rank_size;
-    T *recv_chunk = output_buff + chunk_offset[recv_chunk_index];
-    MS_LOG(DEBUG) << "Ring AllGather send_to_rank:" << send_to_rank << ", recv_from_rank:" << recv_from_rank
-                  << ", send count:" << chunk_sizes[send_chunk_index]
-                  << ", recv count:" << chunk_sizes[recv_chunk_index] << ", iteration:" << i;
-
-    std::shared_ptr<std::vector<unsigned char>> recv_str;
-    auto recv_req_id = server_node_->CollectiveReceiveAsync(ps::core::NodeRole::SERVER, recv_from_rank, &recv_str);
-    if (!server_node_->CollectiveWait(recv_req_id, kCollectiveCommTimeout)) {
-      MS_LOG(ERROR) << "CollectiveWait " << recv_req_id << " failed.";
+    return true;
+  };
+
+  // Recursive halving ReduceScatter: each step sends the half of the range that the partner keeps and reduces the
+  // other half, until each rank holds the sum of 1/pof2 of the data.
+  MS_LOG(DEBUG) << "Start Recursive Halving ReduceScatter.";
+  std::vector<std::pair<size_t, size_t>> ranges;
+  size_t begin = 0;
+  size_t end = count;
+  for (uint32_t mask = pof2 / 2; mask > 0; mask /= 2) {
+    size_t mid = begin + (end - begin) / 2;
+    bool lower = (new_rank & mask) == 0;
+    size_t keep_begin = lower ? begin : mid;
+    size_t keep_end = lower ? mid : end;
+    bool success = lower ? exchange(global_rank(new_rank ^ mask), mid, end, begin, mid, true)
+                         : exchange(global_rank(new_rank ^ mask), begin, mid, mid, end, true);
+    if (!success) {
       return false;
     }
-    ret = memcpy_s(recv_chunk, chunk_sizes[recv_chunk_index] * sizeof(T), recv_str->data(), recv_str->size());
-    if (ret != 0) {
-      MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+    ranges.emplace_back(begin, end);
+    begin = keep_begin;
+    end = keep_end;
+  }
+  MS_LOG(DEBUG) << "End Recursive Halving ReduceScatter.";
+
+  // Recursive doubling AllGather: the steps are undone in the reverse order, each one doubles the range of the sum.
+  MS_LOG(DEBUG) << "Start Recursive Doubling AllGather.";
+  for (uint32_t mask = 1; mask < pof2; mask *= 2) {
+    auto [parent_begin, parent_end] = ranges.back();
+    ranges.pop_back();
+    bool lower = begin == parent_begin;
+    bool success = lower ? exchange(global_rank(new_rank ^ mask), begin, end, end, parent_end, false)
+                         : exchange(global_rank(new_rank ^ mask), begin, end, parent_begin, begin, false);
+    if (!success) {
       return false;
     }
-    if (!server_node_->Wait(send_req_id, kCollectiveCommTimeout)) {
+    begin = parent_begin;
+    end = parent_end;
+  }
+  MS_LOG(DEBUG) << "End Recursive Doubling AllGather.";
+
+  // Give the result back to the folded rank.
+  if (rank_id < 2 * rem) {
+    auto send_req_id = transport->SendAsync(rank_id - 1, output_buff, data_size);
+    if (!transport->WaitSend(send_req_id)) {
       MS_LOG(ERROR) << "CollectiveWait " << send_req_id << " failed.";
       return false;
     }
   }
-  MS_LOG(DEBUG) << "End Ring AllGather.";
   return true;
 }
 
 template <typename T>
-bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const void *sendbuff, void *recvbuff, size_t count) {
-  MS_ERROR_IF_NULL_W_RET_VAL(server_node_, false);
+bool CollectiveOpsImpl::ReduceBroadcastAllReduce(CollectiveTransport *transport, const void *sendbuff, void *recvbuff,
+                                                 size_t count) {
+  MS_ERROR_IF_NULL_W_RET_VAL(transport, false);
   MS_ERROR_IF_NULL_W_RET_VAL(recvbuff, false);
   MS_ERROR_IF_NULL_W_RET_VAL(sendbuff, false);
-  uint32_t rank_size = server_num_;
-  MS_LOG(DEBUG) << "Reduce Broadcast AllReduce rank_size:" << rank_size << ", rank_id_:" << rank_id_
+  uint32_t rank_id = transport->rank_id();
+  uint32_t rank_size = transport->rank_size();
+  MS_LOG(DEBUG) << "Reduce Broadcast AllReduce rank_size:" << rank_size << ", rank_id:" << rank_id
                 << ", count:" << count;
 
   size_t src_size = count * sizeof(T);
@@ -157,15 +302,13 @@ bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const void *sendbuff, void *rec
   T *output_buff = reinterpret_cast<T *>(recvbuff);
   // Reduce data to rank 0 process.
   MS_LOG(DEBUG) << "Start Reduce to rank 0 process.";
-  if (rank_id_ == 0) {
+  if (rank_id == 0) {
     std::unique_ptr<T[]> tmp_recv_buff = std::make_unique<T[]>(count);
     MS_EXCEPTION_IF_NULL(tmp_recv_buff);
     for (uint32_t i = 1; i < rank_size; i++) {
       std::shared_ptr<std::vector<unsigned char>> recv_str;
       MS_LOG(DEBUG) << "Reduce rank 0 receive from rank " << i;
-      auto recv_req_id1 = server_node_->CollectiveReceiveAsync(ps::core::NodeRole::SERVER, i, &recv_str);
-      if (!server_node_->CollectiveWait(recv_req_id1, kCollectiveCommTimeout)) {
-        MS_LOG(ERROR) << "CollectiveWait " << recv_req_id1 << " failed.";
+      if (!transport->Receive(i, count * sizeof(T), &recv_str)) {
         return false;
       }
       ret = memcpy_s(tmp_recv_buff.get(), count * sizeof(T), recv_str->data(), recv_str->size());
@@ -179,8 +322,8 @@ bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const void *sendbuff, void *rec
     }
   } else {
     MS_LOG(DEBUG) << "Reduce send data to rank 0 process.";
-    auto send_req_id1 = server_node_->CollectiveSendAsync(ps::core::NodeRole::SERVER, 0, sendbuff, count * sizeof(T));
-    if (!server_node_->Wait(send_req_id1, kCollectiveCommTimeout)) {
+    auto send_req_id1 = transport->SendAsync(0, sendbuff, count * sizeof(T));
+    if (!transport->WaitSend(send_req_id1)) {
       MS_LOG(ERROR) << "CollectiveWait " << send_req_id1 << " failed.";
       return false;
     }
@@ -189,12 +332,11 @@ bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const void *sendbuff, void *rec
 
   // Broadcast data to not 0 rank process.
   MS_LOG(DEBUG) << "Start broadcast from rank 0 to other processes.";
-  if (rank_id_ == 0) {
+  if (rank_id == 0) {
     for (uint32_t i = 1; i < rank_size; i++) {
       MS_LOG(DEBUG) << "Broadcast data to process " << i;
-      auto send_req_id2 =
-        server_node_->CollectiveSendAsync(ps::core::NodeRole::SERVER, i, output_buff, count * sizeof(T));
-      if (!server_node_->Wait(send_req_id2, kCollectiveCommTimeout)) {
+      auto send_req_id2 = transport->SendAsync(i, output_buff, count * sizeof(T));
+      if (!transport->WaitSend(send_req_id2)) {
         MS_LOG(ERROR) << "CollectiveWait " << send_req_id2 << " failed.";
         return false;
       }
@@ -202,9 +344,7 @@ bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const void *sendbuff, void *rec
   } else {
     MS_LOG(DEBUG) << "Broadcast receive from rank 0.";
     std::shared_ptr<std::vector<unsigned char>> recv_str;
-    auto recv_req_id2 = server_node_->CollectiveReceiveAsync(ps::core::NodeRole::SERVER, 0, &recv_str);
-    if (!server_node_->CollectiveWait(recv_req_id2, kCollectiveCommTimeout)) {
-      MS_LOG(ERROR) << "CollectiveWait " << recv_req_id2 << " failed.";
+    if (!transport->Receive(0, count * sizeof(T), &recv_str)) {
       return false;
     }
     ret = memcpy_s(output_buff, count * sizeof(T), recv_str->data(), recv_str->size());
@@ -331,6 +471,7 @@ template <typename T>
 bool CollectiveOpsImpl::AllReduce(const void *sendbuff, void *recvbuff, size_t count) {
   // The collective communication API does not support calling Send and Recv concurrently with multiple threads;
   std::unique_lock<std::mutex> lock(mtx_);
+  MS_ERROR_IF_NULL_W_RET_VAL(server_node_, false);
   MS_ERROR_IF_NULL_W_RET_VAL(recvbuff, false);
   MS_ERROR_IF_NULL_W_RET_VAL(sendbuff, false);
 
@@ -344,11 +485,20 @@ bool CollectiveOpsImpl::AllReduce(const void *sendbuff, void *recvbuff, size_t c
     return true;
   }
 
-  if (count >= rank_size) {
-    return RingAllReduce<T>(sendbuff, recvbuff, count);
-  } else {
-    return ReduceBroadcastAllReduce<T>(sendbuff, recvbuff, count);
+  NodeCollectiveTransport transport(server_node_, ps::core::NodeRole::SERVER, rank_id_, rank_size);
+  return AllReduce<T>(&transport, sendbuff, recvbuff, count);
+}
+
+template <typename T>
+bool CollectiveOpsImpl::AllReduce(CollectiveTransport *transport, const void *sendbuff, void *recvbuff, size_t count) {
+  MS_ERROR_IF_NULL_W_RET_VAL(transport, false);
+  if (count < transport->rank_size()) {
+    return ReduceBroadcastAllReduce<T>(transport, sendbuff, recvbuff, count);
+  }
+  if (count * sizeof(T) < kHalvingDoublingMaxBytes) {
+    return HalvingDoublingAllReduce<T>(transport, sendbuff, recvbuff, count);
   }
+  return RingAllReduce<T>(transport, sendbuff, recvbuff, count);
 }
 
 template <typename T>
@@ -412,6 +562,38 @@ bool CollectiveOpsImpl::Broadcast(const void *sendbuff, void *const recvbuff, si
   return Broadcast<T>(sendbuff, recvbuff, count, root, group_info);
 }
 
+template <typename T>
+bool CollectiveOpsImpl::AllReduce(const void *sendbuff, void *recvbuff, size_t count,
+                                  const std::shared_ptr<ps::core::AbstractNode> &node,
+                                  const CommunicationGroupInfo &group_info) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  MS_ERROR_IF_NULL_W_RET_VAL(node, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(recvbuff, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(sendbuff, false);
+
+  // Initialize collective communication parameters.
+  node_ = node;
+  node_role_ = node_->role();
+  rank_id_ = node_->rank_id();
+  rank_size_ = group_info.size;
+  if (rank_size_ == 0) {
+    MS_LOG(ERROR) << "Rank size should not be 0.";
+    return false;
+  }
+  if (rank_size_ == 1) {
+    MS_LOG(DEBUG) << "Rank size is 1. Do nothing.";
+    return sendbuff == recvbuff || memcpy_s(recvbuff, count * sizeof(T), sendbuff, count * sizeof(T)) == 0;
+  }
+
+  if (group_info.group_ranks.size() != rank_size_ || group_info.global_to_group_ranks.count(rank_id_) == 0) {
+    MS_LOG(ERROR) << "The rank " << rank_id_ << " is not in the group of " << rank_size_ << " ranks.";
+    return false;
+  }
+  NodeCollectiveTransport transport(node_, node_role_, group_info.global_to_group_ranks.at(rank_id_), rank_size_,
+                                    group_info.group_ranks);
+  return AllReduce<T>(&transport, sendbuff, recvbuff, count);
+}
+
 bool CollectiveOpsImpl::ReInitForScaling() {
   // If CollectiveOpsImpl is not initialized yet but the scaling event is triggered, do not throw exception.
   if (server_node_ == nullptr) {
@@ -426,17 +608,56 @@ bool CollectiveOpsImpl::ReInitForScaling() {
   return true;
 }
 
-template bool CollectiveOpsImpl::RingAllReduce<float>(const void *sendbuff, void *recvbuff, size_t count);
-template bool CollectiveOpsImpl::RingAllReduce<size_t>(const void *sendbuff, void *recvbuff, size_t count);
-template bool CollectiveOpsImpl::RingAllReduce<int>(const void *sendbuff, void *recvbuff, size_t count);
-
-template bool CollectiveOpsImpl::ReduceBroadcastAllReduce<float>(const void *sendbuff, void *recvbuff, size_t count);
-template bool CollectiveOpsImpl::ReduceBroadcastAllReduce<size_t>(const void *sendbuff, void *recvbuff, size_t count);
-template bool CollectiveOpsImpl::ReduceBroadcastAllReduce<int>(const void *sendbuff, void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::RingAllReduce<float>(CollectiveTransport *transport, const void *sendbuff,
+                                                      void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::RingAllReduce<size_t>(CollectiveTransport *transport, const void *sendbuff,
+                                                       void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::RingAllReduce<int>(CollectiveTransport *transport, const void *sendbuff,
+                                                    void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::RingAllReduce<float16>(CollectiveTransport *transport, const void *sendbuff,
+                                                        void *recvbuff, size_t count);
+
+template bool CollectiveOpsImpl::HalvingDoublingAllReduce<float>(CollectiveTransport *transport, const void *sendbuff,
+                                                                 void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::HalvingDoublingAllReduce<size_t>(CollectiveTransport *transport, const void *sendbuff,
+                                                                  void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::HalvingDoublingAllReduce<int>(CollectiveTransport *transport, const void *sendbuff,
+                                                               void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::HalvingDoublingAllReduce<float16>(CollectiveTransport *transport,
+                                                                   const void *sendbuff, void *recvbuff, size_t count);
+
+template bool CollectiveOpsImpl::ReduceBroadcastAllReduce<float>(CollectiveTransport *transport, const void *sendbuff,
+                                                                 void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::ReduceBroadcastAllReduce<size_t>(CollectiveTransport *transport, const void *sendbuff,
+                                                                  void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::ReduceBroadcastAllReduce<int>(CollectiveTransport *transport, const void *sendbuff,
+                                                               void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::ReduceBroadcastAllReduce<float16>(CollectiveTransport *transport,
+                                                                   const void *sendbuff, void *recvbuff, size_t count);
 
 template bool CollectiveOpsImpl::AllReduce<float>(const void *sendbuff, void *recvbuff, size_t count);
 template bool CollectiveOpsImpl::AllReduce<size_t>(const void *sendbuff, void *recvbuff, size_t count);
 template bool CollectiveOpsImpl::AllReduce<int>(const void *sendbuff, void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::AllReduce<float16>(const void *sendbuff, void *recvbuff, size_t count);
+
+template bool CollectiveOpsImpl::AllReduce<float>(CollectiveTransport *transport, const void *sendbuff, void *recvbuff,
+                                                  size_t count);
+template bool CollectiveOpsImpl::AllReduce<size_t>(CollectiveTransport *transport, const void *sendbuff,
+                                                   void *recvbuff, size_t count);
+template bool CollectiveOpsImpl::AllReduce<int>(CollectiveTransport *transport, const void *sendbuff, void *recvbuff,
+                                                size_t count);
+template bool CollectiveOpsImpl::AllReduce<float16>(CollectiveTransport *transport, const void *sendbuff,
+                                                    void *recvbuff, size_t count);
+
+template bool CollectiveOpsImpl::AllReduce<float>(const void *sendbuff, void *recvbuff, size_t count,
+                                                  const std::shared_ptr<ps::core::AbstractNode> &node,
+                                                  const CommunicationGroupInfo &group_info);
+template bool CollectiveOpsImpl::AllReduce<int>(const void *sendbuff, void *recvbuff, size_t count,
+                                                const std::shared_ptr<ps::core::AbstractNode> &node,
+                                                const CommunicationGroupInfo &group_info);
+template bool CollectiveOpsImpl::AllReduce<float16>(const void *sendbuff, void *recvbuff, size_t count,
+                                                    const std::shared_ptr<ps::core::AbstractNode> &node,
+                                                    const CommunicationGroupInfo &group_info);
 
 template bool CollectiveOpsImpl::AllGather<float>(const void *sendbuff, void *recvbuff, size_t send_count,
                                                   const std::shared_ptr<ps::core::AbstractNode> &node);
@@ -22,10 +22,13 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <type_traits>
 #include "proto/ps.pb.h"
 #include "ps/ps_context.h"
 #include "ps/core/server_node.h"
 #include "fl/server/common.h"
+#include "base/float16.h"
+#include "backend/kernel_compiler/cpu/nnacl/fp32/add_fp32.h"
 
 namespace mindspore {
 namespace fl {
@@ -33,6 +36,26 @@ namespace server {
 // The timeout for server collective communication in case of network jitter.
 constexpr uint32_t kCollectiveCommTimeout = 30;
 
+// The ring AllReduce sends every chunk in pieces of this size, so that the reduce of a piece overlaps the transfer of
+// the next ones.
+constexpr size_t kRingPipelinePieceBytes = 1 << 20;
+
+// The messages smaller than this are AllReduced with recursive halving and doubling, which takes 2*log(n) steps
+// instead of the 2*(n-1) steps of the ring.
+constexpr size_t kHalvingDoublingMaxBytes = 256 * 1024;
+
+// Add src into dst, the floats with the SIMD add of nnacl.
+template <typename T>
+void ReduceSum(T *dst, const T *src, size_t count) {
+  if constexpr (std::is_same<T, float>::value) {
+    (void)ElementAdd(dst, src, dst, SizeToInt(count));
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      dst[i] += src[i];
+    }
+  }
+}
+
 // The collective communication groups which are composed of multiple processes. Refer to MPI_Group.
 struct CommunicationGroupInfo {
   // This group's rank size.
@@ -49,9 +72,55 @@ struct CommunicationGroupInfo {
   std::map<uint32_t, uint32_t> group_to_global_ranks;
 };
 
+// The point to point communication under the AllReduce algorithms. The ranks are numbered from 0 to rank_size - 1
+// within the ranks that run the algorithm.
+class CollectiveTransport {
+ public:
+  CollectiveTransport(uint32_t rank_id, uint32_t rank_size) : rank_id_(rank_id), rank_size_(rank_size) {}
+  virtual ~CollectiveTransport() = default;
+
+  uint32_t rank_id() const { return rank_id_; }
+  uint32_t rank_size() const { return rank_size_; }
+
+  // Send the data to the rank. The data must be kept until WaitSend of the returned request id returns.
+  virtual uint64_t SendAsync(uint32_t rank_id, const void *data, size_t size) = 0;
+  virtual bool WaitSend(uint64_t request_id) = 0;
+
+  // Receive the next message from the rank. The messages from a rank are received in the order they are sent.
+  virtual bool ReceiveMessage(uint32_t rank_id, std::shared_ptr<std::vector<unsigned char>> *output) = 0;
+
+  // Receive the next message from the rank, which must be of size bytes.
+  bool Receive(uint32_t rank_id, size_t size, std::shared_ptr<std::vector<unsigned char>> *output);
+
+ private:
+  uint32_t rank_id_;
+  uint32_t rank_size_;
+};
+
+// The transport over the collective messages of the node. Rank i of the transport is the node of rank global_ranks[i]
+// in the cluster, or of rank i if global_ranks is empty.
+class NodeCollectiveTransport : public CollectiveTransport {
+ public:
+  NodeCollectiveTransport(const std::shared_ptr<ps::core::AbstractNode> &node, ps::core::NodeRole node_role,
+                          uint32_t rank_id, uint32_t rank_size, const std::vector<uint32_t> &global_ranks = {})
+      : CollectiveTransport(rank_id, rank_size), node_(node), node_role_(node_role), global_ranks_(global_ranks) {}
+  ~NodeCollectiveTransport() override = default;
+
+  uint64_t SendAsync(uint32_t rank_id, const void *data, size_t size) override;
+  bool WaitSend(uint64_t request_id) override;
+  bool ReceiveMessage(uint32_t rank_id, std::shared_ptr<std::vector<unsigned char>> *output) override;
+
+ private:
+  uint32_t GlobalRank(uint32_t rank_id) const { return global_ranks_.empty() ? rank_id : global_ranks_[rank_id]; }
+
+  std::shared_ptr<ps::core::AbstractNode> node_;
+  ps::core::NodeRole node_role_;
+  std::vector<uint32_t> global_ranks_;
+};
+
 // CollectiveOpsImpl is the collective communication API of the server.
-// For now, it implements two AllReduce algorithms: RingAllReduce and BroadcastAllReduce. Elastic AllReduce is also
-// supported for the elastic scaling feature of the server.
+// For now, it implements three AllReduce algorithms: RingAllReduce, HalvingDoublingAllReduce and BroadcastAllReduce,
+// chosen by the message size. Elastic AllReduce is also supported for the elastic scaling feature of the server.
 class CollectiveOpsImpl {
  public:
   static CollectiveOpsImpl &GetInstance() {
@@ -64,6 +133,11 @@ class CollectiveOpsImpl {
   template <typename T>
   bool AllReduce(const void *sendbuff, void *recvbuff, size_t count);
 
+  // Collective sum within the specified group, with the algorithm chosen by the message size among the group ranks.
+  template <typename T>
+  bool AllReduce(const void *sendbuff, void *recvbuff, size_t count,
+                 const std::shared_ptr<ps::core::AbstractNode> &node, const CommunicationGroupInfo &group_info);
+
   template <typename T>
   bool AllGather(const void *sendbuff, void *recvbuff, size_t send_count,
                  const std::shared_ptr<ps::core::AbstractNode> &node);
@@ -77,6 +151,28 @@ class CollectiveOpsImpl {
   // Reinitialize the ring for collective communication after scaling operations are done.
   bool ReInitForScaling();
 
+  // The collectives which run over a NodeCollectiveTransport of their own hold this lock too, so that their messages
+  // are not interleaved with those of the operations of CollectiveOpsImpl.
+  std::mutex &mutex() { return mtx_; }
+
+  // AllReduce among the ranks of the transport, with the algorithm chosen by the message size.
+  template <typename T>
+  static bool AllReduce(CollectiveTransport *transport, const void *sendbuff, void *recvbuff, size_t count);
+
+  // Implementation of RingAllReduce.
+  template <typename T>
+  static bool RingAllReduce(CollectiveTransport *transport, const void *sendbuff, void *recvbuff, size_t count);
+
+  // Implementation of recursive halving ReduceScatter and recursive doubling AllGather, for small messages.
+  template <typename T>
+  static bool HalvingDoublingAllReduce(CollectiveTransport *transport, const void *sendbuff, void *recvbuff,
+                                       size_t count);
+
+  // Implementation of BroadcastAllReduce.
+  template <typename T>
+  static bool ReduceBroadcastAllReduce(CollectiveTransport *transport, const void *sendbuff, void *recvbuff,
+                                       size_t count);
+
  private:
   CollectiveOpsImpl()
       : server_node_(nullptr),
@@ -89,14 +185,6 @@ class CollectiveOpsImpl {
   CollectiveOpsImpl(const CollectiveOpsImpl &) = delete;
   CollectiveOpsImpl &operator=(const CollectiveOpsImpl &) = delete;
 
-  // Implementation of RingAllReduce.
-  template <typename T>
-  bool RingAllReduce(const void *sendbuff, void *recvbuff, size_t count);
-
-  // Implementation of BroadcastAllReduce.
-  template <typename T>
-  bool ReduceBroadcastAllReduce(const void *sendbuff, void *recvbuff, size_t count);
-
   // Implementation of RingAllGather.
   template <typename T>
   bool RingAllGather(const void *sendbuff, void *recvbuff, size_t send_count);
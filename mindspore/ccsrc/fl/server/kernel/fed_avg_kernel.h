@@ -29,6 +29,7 @@
 #include "fl/server/local_meta_store.h"
 #include "fl/server/kernel/aggregation_kernel.h"
 #include "fl/server/kernel/aggregation_kernel_factory.h"
+#include "fl/server/kernel/sharded_accumulator.h"
 
 namespace mindspore {
 namespace fl {
@@ -65,6 +66,7 @@ class FedAvgKernel : public AggregationKernel {
     size_t weight_size =
       std::accumulate(weight_shape.begin(), weight_shape.end(), sizeof(T), std::multiplies<size_t>());
     size_t new_weight_size = weight_size;
+    accumulator_.Init(weight_size / sizeof(T));
 
     input_size_list_.push_back(weight_size);
     input_size_list_.push_back(sizeof(size_t));
@@ -123,30 +125,37 @@ class FedAvgKernel : public AggregationKernel {
       MS_ERROR_IF_NULL_W_RET_VAL(inputs[i]->addr, false);
     }
 
-    std::unique_lock<std::mutex> lock(weight_mutex_);
+    if (inputs[0]->size != accumulator_.count() * sizeof(T) || inputs[2]->size != inputs[0]->size) {
+      MS_LOG(ERROR) << "The weight size " << inputs[0]->size << " and new weight size " << inputs[2]->size << " of "
+                    << name_ << " should both be " << accumulator_.count() * sizeof(T);
+      return false;
+    }
+
     // The weight and new_weight values should be multiplied by clients already, so we don't need to do multiplication
     // again.
     T *weight_addr = reinterpret_cast<T *>(inputs[0]->addr);
     S *data_size_addr = reinterpret_cast<S *>(inputs[1]->addr);
     T *new_weight_addr = reinterpret_cast<T *>(inputs[2]->addr);
     S *new_data_size_addr = reinterpret_cast<S *>(inputs[3]->addr);
-    if (accum_count_ == 0) {
-      ClearWeightAndDataSize();
-    }
-
-    MS_LOG(INFO) << "Iteration: " << LocalMetaStore::GetInstance().curr_iter_num() << " launching FedAvgKernel for "
-                 << name_ << " new data size is " << new_data_size_addr[0] << ", current total data size is "
-                 << data_size_addr[0];
-    for (size_t i = 0; i < inputs[2]->size / sizeof(T); i++) {
-      weight_addr[i] += new_weight_addr[i];
+    size_t accum_count = 0;
+    {
+      std::unique_lock<std::mutex> lock(weight_mutex_);
+      if (accum_count_ == 0) {
+        ClearWeightAndDataSize();
+      }
+      MS_LOG(INFO) << "Iteration: " << LocalMetaStore::GetInstance().curr_iter_num() << " launching FedAvgKernel for "
+                   << name_ << " new data size is " << new_data_size_addr[0] << ", current total data size is "
+                   << data_size_addr[0];
+      data_size_addr[0] += new_data_size_addr[0];
+      // Counted before the weight is added, so that a concurrent launch doesn't clear the weight again.
+      accum_count = ++accum_count_;
+      participated_ = true;
     }
-    data_size_addr[0] += new_data_size_addr[0];
-    lock.unlock();
+    // The weight is added shard by shard, at the same time as the weights of the other clients.
+    accumulator_.Add(weight_addr, new_weight_addr);
 
-    accum_count_++;
-    participated_ = true;
     return DistributedCountService::GetInstance().Count(
-      name_, std::to_string(DistributedCountService::GetInstance().local_rank()) + "_" + std::to_string(accum_count_));
+      name_, std::to_string(DistributedCountService::GetInstance().local_rank()) + "_" + std::to_string(accum_count));
   }
 
   void Reset() override {
@@ -224,8 +233,10 @@ class FedAvgKernel : public AggregationKernel {
   // Whether the kernel's Launch method is called.
   bool participated_;
 
-  // The kernel could be called concurrently so we need lock to ensure threadsafe.
+  // The kernel could be called concurrently. The lock guards the data size and the clearing of the weight, the
+  // accumulator locks the shards of the weight.
   std::mutex weight_mutex_;
+  ShardedAccumulator<T> accumulator_;
 };
 }  // namespace kernel
 }  // namespace server
@@ -0,0 +1,99 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_FL_SERVER_KERNEL_SHARDED_ACCUMULATOR_H_
+#define MINDSPORE_CCSRC_FL_SERVER_KERNEL_SHARDED_ACCUMULATOR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include "backend/kernel_compiler/cpu/nnacl/fp32/add_fp32.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace kernel {
+// The number of elements of a shard, small enough for the clients to spread over the shards of a large weight and
+// large enough for the vectorized add to outweigh the locking.
+constexpr size_t kAccumulateShardSize = 16384;
+
+// Accumulates the weights uploaded by the clients into a weight split into fixed-size shards, each with its own lock,
+// so that the clients of a round add into different parts of the weight at the same time instead of queuing for the
+// whole of it. Each add starts from a different shard and skips the shards held by others on its first pass. The float
+// shards are added with the SIMD kernel of nnacl.
+template <typename T>
+class ShardedAccumulator {
+ public:
+  ShardedAccumulator() = default;
+  ~ShardedAccumulator() = default;
+  ShardedAccumulator(const ShardedAccumulator &) = delete;
+  ShardedAccumulator &operator=(const ShardedAccumulator &) = delete;
+
+  // Split a weight of count elements into shards.
+  void Init(size_t count) {
+    count_ = count;
+    num_shards_ = std::max<size_t>((count + kAccumulateShardSize - 1) / kAccumulateShardSize, 1);
+    shard_mutexes_ = std::make_unique<std::mutex[]>(num_shards_);
+  }
+
+  // Add src into dst, both of the count elements given to Init. Thread safe with the other adds.
+  void Add(T *dst, const T *src) {
+    std::vector<size_t> busy_shards;
+    size_t start = next_start_.fetch_add(1, std::memory_order_relaxed) % num_shards_;
+    for (size_t i = 0; i < num_shards_; ++i) {
+      size_t shard = (start + i) % num_shards_;
+      std::unique_lock<std::mutex> lock(shard_mutexes_[shard], std::try_to_lock);
+      if (!lock.owns_lock()) {
+        busy_shards.push_back(shard);
+        continue;
+      }
+      AddShard(dst, src, shard);
+    }
+    for (size_t shard : busy_shards) {
+      std::lock_guard<std::mutex> lock(shard_mutexes_[shard]);
+      AddShard(dst, src, shard);
+    }
+  }
+
+  size_t count() const { return count_; }
+  size_t num_shards() const { return num_shards_; }
+
+ private:
+  void AddShard(T *dst, const T *src, size_t shard) const {
+    size_t begin = shard * kAccumulateShardSize;
+    size_t end = std::min(begin + kAccumulateShardSize, count_);
+    if constexpr (std::is_same<T, float>::value) {
+      (void)ElementAdd(dst + begin, src + begin, dst + begin, static_cast<int>(end - begin));
+    } else {
+      for (size_t i = begin; i < end; ++i) {
+        dst[i] += src[i];
+      }
+    }
+  }
+
+  size_t count_{0};
+  size_t num_shards_{1};
+  std::unique_ptr<std::mutex[]> shard_mutexes_{std::make_unique<std::mutex[]>(1)};
+  std::atomic<size_t> next_start_{0};
+};
+}  // namespace kernel
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_FL_SERVER_KERNEL_SHARDED_ACCUMULATOR_H_
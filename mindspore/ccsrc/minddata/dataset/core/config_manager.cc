@@ -36,6 +36,7 @@ ConfigManager::ConfigManager()
     : num_parallel_workers_(kCfgParallelWorkers),
       worker_connector_size_(kCfgWorkerConnectorSize),
       op_connector_size_(kCfgOpConnectorSize),
+      op_connector_max_bytes_(kCfgOpConnectorMaxBytes),
       sending_batches_(kCfgSendingBatch),
       rank_id_(kCfgDefaultRankId),
       seed_(kCfgDefaultSeed),
@@ -78,7 +79,8 @@ void ConfigManager::Print(std::ostream &out) const {
   out << "\nClient config settings :"
       << "\nParallelOp workers           : " << num_parallel_workers_
       << "\nParallelOp worker connector size    : " << worker_connector_size_
-      << "\nSize of each Connector : " << op_connector_size_ << std::endl;
+      << "\nSize of each Connector : " << op_connector_size_
+      << "\nMax bytes of each Connector : " << op_connector_max_bytes_ << std::endl;
 }
 
 // Private helper function that takes a nlohmann json format and populates the settings
@@ -86,6 +88,7 @@ Status ConfigManager::FromJson(const nlohmann::json &j) {
   RETURN_IF_NOT_OK(set_num_parallel_workers(j.value("numParallelWorkers", num_parallel_workers_)));
   set_worker_connector_size(j.value("workerConnectorSize", worker_connector_size_));
   set_op_connector_size(j.value("opConnectorSize", op_connector_size_));
+  set_op_connector_max_bytes(j.value("opConnectorMaxBytes", op_connector_max_bytes_));
   set_seed(j.value("seed", seed_));
   set_monitor_sampling_interval(j.value("monitorSamplingInterval", monitor_sampling_interval_));
   set_cache_host(j.value("cacheHost", cache_host_));
@@ -138,6 +141,11 @@ void ConfigManager::set_worker_connector_size(int32_t connector_size) { worker_c
 // Setter function
 void ConfigManager::set_op_connector_size(int32_t connector_size) { op_connector_size_ = connector_size; }
 
+// Setter function
+void ConfigManager::set_op_connector_max_bytes(int64_t max_bytes) {
+  op_connector_max_bytes_ = max_bytes > 0 ? max_bytes : 0;
+}
+
 void ConfigManager::set_sending_batches(int64_t sending_batches) { sending_batches_ = sending_batches; }
 
 uint32_t ConfigManager::seed() const { return seed_; }
@@ -82,6 +82,10 @@ class ConfigManager {
   // @return The queue size of the operator's output connector
   int32_t op_connector_size() const { return op_connector_size_; }
 
+  // getter function
+  // @return The max bytes of the rows held by each queue of a connector, 0 means no limit
+  int64_t op_connector_max_bytes() const { return op_connector_max_bytes_; }
+
   // getter function
   // @return The sending batches that will send to device
   int64_t sending_batches() const { return sending_batches_; }
@@ -125,6 +129,10 @@ class ConfigManager {
   // @param connector_size - The setting to apply to the config
   void set_op_connector_size(int32_t connector_size);
 
+  // setter function
+  // @param max_bytes - The max bytes of the rows held by each queue of a connector, 0 means no limit
+  void set_op_connector_max_bytes(int64_t max_bytes);
+
   // setter function
   // @param sending_batches - The setting to apply to the config
   void set_sending_batches(int64_t sending_batches);
@@ -250,6 +258,7 @@ class ConfigManager {
   int32_t num_parallel_workers_;
   int32_t worker_connector_size_;
   int32_t op_connector_size_;
+  int64_t op_connector_max_bytes_;
   int64_t sending_batches_;
   // This rank_id is for numa and device_queue, one process work with only one rank_id,
   // for standalone scenario, this rank_id may come from env 'CUDA_VISIBLE_DEVICES',
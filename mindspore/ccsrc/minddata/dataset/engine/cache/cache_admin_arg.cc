@@ -41,6 +41,7 @@ CacheAdminArgHandler::CacheAdminArgHandler()
       shm_mem_sz_(kDefaultSharedMemorySize),
       log_level_(kDefaultLogLevel),
       memory_cap_ratio_(kDefaultMemoryCapRatio),
+      compressed_ratio_(kDefaultCompressedRatio),
       hostname_(kCfgDefaultCacheHost),
       port_(kCfgDefaultCachePort),
       spill_dir_("") {
@@ -88,6 +89,8 @@ CacheAdminArgHandler::CacheAdminArgHandler()
   arg_map_["--loglevel"] = ArgValue::kArgLogLevel;
   arg_map_["-r"] = ArgValue::kArgMemoryCapRatio;
   arg_map_["--memory_cap_ratio"] = ArgValue::kArgMemoryCapRatio;
+  arg_map_["-c"] = ArgValue::kArgCompressedRatio;
+  arg_map_["--compressed_ratio"] = ArgValue::kArgCompressedRatio;
   arg_map_["--list_sessions"] = ArgValue::kArgListSessions;
   arg_map_["--server_info"] = ArgValue::kArgServerInfo;
   // Initialize argument tracker with false values
@@ -334,6 +337,10 @@ Status CacheAdminArgHandler::ParseArgStream(std::stringstream *arg_stream) {
         RETURN_IF_NOT_OK(AssignArg(tok, &memory_cap_ratio_, arg_stream));
         break;
       }
+      case ArgValue::kArgCompressedRatio: {
+        RETURN_IF_NOT_OK(AssignArg(tok, &compressed_ratio_, arg_stream));
+        break;
+      }
       case ArgValue::kArgListSessions: {
         RETURN_IF_NOT_OK(AssignArg(tok, static_cast<std::string *>(nullptr), arg_stream, CommandId::kCmdListSessions));
         break;
@@ -388,6 +395,10 @@ Status CacheAdminArgHandler::Validate() {
     return Status(StatusCode::kMDSyntaxError, "Memory cap ratio should be positive and no greater than 1");
   }
 
+  if (compressed_ratio_ < 0 || compressed_ratio_ >= 1) {
+    return Status(StatusCode::kMDSyntaxError, "Compressed ratio should be non-negative and less than 1");
+  }
+
   if (port_ < kMinLegalPort || port_ > kMaxLegalPort) {
     return Status(StatusCode::kMDSyntaxError, "Port must be in range (1025..65535).");
   }
@@ -443,13 +454,15 @@ Status CacheAdminArgHandler::RunCommand() {
       if (!session_info.empty()) {
         std::cout << std::setw(12) << "Session" << std::setw(12) << "Cache Id" << std::setw(12) << "Mem cached"
                   << std::setw(12) << "Disk cached" << std::setw(16) << "Avg cache size" << std::setw(10) << "Numa hit"
-                  << std::endl;
+                  << std::setw(12) << "Compressed" << std::setw(10) << "Mem hit" << std::setw(12) << "Comp hit"
+                  << std::setw(10) << "Disk hit" << std::setw(10) << "Miss" << std::endl;
         for (auto curr_session : session_info) {
           std::string cache_id;
           std::string stat_mem_cached;
           std::string stat_disk_cached;
           std::string stat_avg_cached;
           std::string stat_numa_hit;
+          auto n_a = [](int64_t v) { return v == 0 ? std::string("n/a") : std::to_string(v); };
           uint32_t crc = (curr_session.connection_id & 0x00000000FFFFFFFF);
           cache_id = (curr_session.connection_id == 0) ? "n/a" : std::to_string(crc);
           stat_mem_cached =
@@ -463,7 +476,11 @@ Status CacheAdminArgHandler::RunCommand() {
 
           std::cout << std::setw(12) << curr_session.session_id << std::setw(12) << cache_id << std::setw(12)
                     << stat_mem_cached << std::setw(12) << stat_disk_cached << std::setw(16) << stat_avg_cached
-                    << std::setw(10) << stat_numa_hit << std::endl;
+                    << std::setw(10) << stat_numa_hit << std::setw(12) << n_a(curr_session.stats.num_compressed_cached)
+                    << std::setw(10) << n_a(curr_session.stats.num_mem_hit) << std::setw(12)
+                    << n_a(curr_session.stats.num_compressed_hit) << std::setw(10)
+                    << n_a(curr_session.stats.num_disk_hit) << std::setw(10) << n_a(curr_session.stats.num_miss)
+                    << std::endl;
         }
       } else {
         std::cout << "No active sessions." << std::endl;
@@ -641,8 +658,9 @@ Status CacheAdminArgHandler::StartServer() {
     std::string minloglevel_string = std::to_string(log_level_);
     std::string daemonize_string = "true";
     std::string memory_cap_ratio_string = std::to_string(memory_cap_ratio_);
+    std::string compressed_ratio_string = std::to_string(compressed_ratio_);
 
-    char *argv[9];
+    char *argv[10];
     argv[0] = cache_server_binary.data();
     argv[1] = spill_dir_.data();
     argv[2] = workers_string.data();
@@ -651,7 +669,8 @@ Status CacheAdminArgHandler::StartServer() {
     argv[5] = minloglevel_string.data();
     argv[6] = daemonize_string.data();
     argv[7] = memory_cap_ratio_string.data();
-    argv[8] = nullptr;
+    argv[8] = compressed_ratio_string.data();
+    argv[9] = nullptr;
 
     // Now exec the binary
     execv(cache_server_binary.data(), argv);
@@ -686,6 +705,8 @@ void CacheAdminArgHandler::Help() {
   //    Default is: kDefaultSharedMemorySizeInGB (Gb in unit)
   // [ [-r | --memory_cap_ratio] <float percent value>]
   //    Default is kMemoryCapRatio
+  // [ [-c | --compressed_ratio] <float percent value>]
+  //    Ratio of the cache memory set aside for the compressed rows. Default is kDefaultCompressedRatio (no compression)
 }
 }  // namespace dataset
 }  // namespace mindspore
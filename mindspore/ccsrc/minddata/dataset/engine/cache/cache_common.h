@@ -42,6 +42,8 @@ constexpr static int32_t kLocalByPassThreshold = 64 * 1024;
 constexpr static int32_t kDefaultSharedMemorySize = 4;
 /// \brief Memory Cap ratio used by the server
 constexpr static float kDefaultMemoryCapRatio = 0.8;
+/// \brief Ratio of the cache memory set aside for the compressed rows. 0 means no compression
+constexpr static float kDefaultCompressedRatio = 0.0;
 /// \brief Default log level of the server
 constexpr static int32_t kDefaultLogLevel = 1;
 /// \brief Set num workers to half of num_cpus as the default
@@ -0,0 +1,263 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "minddata/dataset/engine/cache/cache_compressed_tier.h"
+#include <string>
+#include <utility>
+#include "zlib.h"
+
+namespace mindspore {
+namespace dataset {
+namespace {
+// Decoded images are large and short lived in the cache, so trade the ratio for the speed.
+constexpr int kCompressLevel = Z_BEST_SPEED;
+
+// Deflate all the slices into one zlib stream. Return false if the output doesn't shrink.
+bool Compress(const std::vector<ReadableSlice> &buf, size_t sz, std::vector<uint8_t> *out) {
+  z_stream strm{};
+  if (deflateInit(&strm, kCompressLevel) != Z_OK) {
+    return false;
+  }
+  out->resize(deflateBound(&strm, sz));
+  strm.next_out = out->data();
+  strm.avail_out = static_cast<uInt>(out->size());
+  int ret = Z_OK;
+  for (size_t i = 0; i < buf.size() && ret == Z_OK; ++i) {
+    strm.next_in = const_cast<Bytef *>(static_cast<const Bytef *>(buf[i].GetPointer()));
+    strm.avail_in = static_cast<uInt>(buf[i].GetSize());
+    ret = deflate(&strm, i + 1 == buf.size() ? Z_FINISH : Z_NO_FLUSH);
+  }
+  size_t comp_sz = strm.total_out;
+  (void)deflateEnd(&strm);
+  if (ret != Z_STREAM_END || comp_sz >= sz) {
+    return false;
+  }
+  out->resize(comp_sz);
+  return true;
+}
+
+Status Decompress(const void *src, size_t comp_sz, size_t sz, void *dest) {
+  auto dest_len = static_cast<uLongf>(sz);
+  int ret = uncompress(static_cast<Bytef *>(dest), &dest_len, static_cast<const Bytef *>(src),
+                       static_cast<uLong>(comp_sz));
+  if (ret != Z_OK || dest_len != sz) {
+    RETURN_STATUS_UNEXPECTED("Failed to decompress the cached row, zlib error: " + std::to_string(ret));
+  }
+  return Status::OK();
+}
+}  // namespace
+
+CacheCompressedTier::CacheCompressedTier(std::shared_ptr<MemoryPool> mp, uint64_t mem_budget,
+                                         std::shared_ptr<StorageManager> sm)
+    : mp_(std::move(mp)),
+      mem_budget_(mem_budget),
+      sm_(std::move(sm)),
+      hand_(clock_.end()),
+      mem_usage_(0),
+      num_evicted_(0),
+      num_mem_hit_(0),
+      num_disk_hit_(0) {}
+
+CacheCompressedTier::~CacheCompressedTier() {
+  for (auto &it : entries_) {
+    if (it.second.ptr != nullptr) {
+      mp_->Deallocate(it.second.ptr);
+      it.second.ptr = nullptr;
+    }
+  }
+}
+
+Status CacheCompressedTier::PackRow(const std::vector<ReadableSlice> &buf, Entry *entry, std::vector<uint8_t> *comp) {
+  for (auto &v : buf) {
+    entry->sz += v.GetSize();
+  }
+  entry->compressed = Compress(buf, entry->sz, comp);
+  if (!entry->compressed) {
+    comp->resize(entry->sz);
+    WritableSlice dest(comp->data(), comp->size());
+    size_t pos = 0;
+    for (auto &v : buf) {
+      WritableSlice out(dest, pos);
+      RETURN_IF_NOT_OK(WritableSlice::Copy(&out, v));
+      pos += v.GetSize();
+    }
+  }
+  entry->comp_sz = comp->size();
+  // Write through to disk, so that evicting the row from memory later needs no disk write.
+  if (sm_ != nullptr) {
+    RETURN_IF_NOT_OK(sm_->Write(&entry->storage_key, {ReadableSlice(comp->data(), comp->size())}));
+    entry->on_disk = true;
+  }
+  return Status::OK();
+}
+
+Status CacheCompressedTier::Insert(key_type key, const std::vector<ReadableSlice> &buf) {
+  // The StorageManager can't take a row back, so a duplicate key is refused before anything is written.
+  {
+    std::unique_lock<std::mutex> lck(mux_);
+    if (entries_.find(key) != entries_.end() || !inserting_.insert(key).second) {
+      return Status(StatusCode::kMDDuplicateKey, __LINE__, __FILE__);
+    }
+  }
+  // Compress outside the lock, which is where most of the time goes.
+  Entry entry;
+  std::vector<uint8_t> comp;
+  Status rc = PackRow(buf, &entry, &comp);
+  std::unique_lock<std::mutex> lck(mux_);
+  (void)inserting_.erase(key);
+  RETURN_IF_NOT_OK(rc);
+  auto r = entries_.emplace(key, std::move(entry));
+  auto &new_entry = r.first->second;
+  if (MakeRoom(new_entry.comp_sz)) {
+    KeepInMemory(key, &new_entry, comp.data());
+  }
+  if (new_entry.ptr == nullptr && !new_entry.on_disk) {
+    (void)entries_.erase(r.first);
+    return Status(StatusCode::kMDOutOfMemory, __LINE__, __FILE__);
+  }
+  return Status::OK();
+}
+
+Status CacheCompressedTier::Read(key_type key, WritableSlice *dest, size_t *bytes_read) {
+  RETURN_UNEXPECTED_IF_NULL(dest);
+  std::unique_lock<std::mutex> lck(mux_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    RETURN_STATUS_UNEXPECTED("Key not found");
+  }
+  // The entry stays at the same address while other rows are inserted.
+  auto &entry = it->second;
+  CHECK_FAIL_RETURN_UNEXPECTED(dest->GetSize() >= entry.sz, "Destination is smaller than the cached row.");
+  if (bytes_read != nullptr) {
+    *bytes_read = entry.sz;
+  }
+  WritableSlice out(*dest, 0, entry.sz);
+  if (entry.ptr != nullptr) {
+    // Pin the row so that it is not evicted while we decompress it without the lock.
+    ++entry.pin;
+    entry.referenced = true;
+    lck.unlock();
+    Status rc = entry.compressed ? Decompress(entry.ptr, entry.comp_sz, entry.sz, out.GetMutablePointer())
+                                 : WritableSlice::Copy(&out, ReadableSlice(entry.ptr, entry.sz));
+    lck.lock();
+    --entry.pin;
+    ++num_mem_hit_;
+    return rc;
+  }
+  CHECK_FAIL_RETURN_UNEXPECTED(sm_ != nullptr && entry.on_disk, "The cached row is lost.");
+  // Copy what we need, the entry may be erased while we read from disk without the lock.
+  auto storage_key = entry.storage_key;
+  auto compressed = entry.compressed;
+  auto sz = entry.sz;
+  auto comp_sz = entry.comp_sz;
+  lck.unlock();
+  std::vector<uint8_t> comp(comp_sz);
+  WritableSlice comp_slice(comp.data(), comp.size());
+  size_t comp_read = 0;
+  RETURN_IF_NOT_OK(sm_->Read(storage_key, &comp_slice, &comp_read));
+  CHECK_FAIL_RETURN_UNEXPECTED(comp_read == comp.size(), "Unexpected length of the cached row read from disk.");
+  if (compressed) {
+    RETURN_IF_NOT_OK(Decompress(comp.data(), comp.size(), sz, out.GetMutablePointer()));
+  } else {
+    RETURN_IF_NOT_OK(WritableSlice::Copy(&out, ReadableSlice(comp.data(), comp.size())));
+  }
+  ++num_disk_hit_;
+  // Bring the row back to memory unless another reader has done it.
+  lck.lock();
+  it = entries_.find(key);
+  if (it != entries_.end() && it->second.ptr == nullptr && MakeRoom(it->second.comp_sz)) {
+    KeepInMemory(key, &it->second, comp.data());
+  }
+  return Status::OK();
+}
+
+bool CacheCompressedTier::MakeRoom(size_t sz) {
+  if (sz > mem_budget_) {
+    return false;
+  }
+  // Without a copy on disk, a row can't be evicted.
+  if (sm_ == nullptr) {
+    return mem_usage_ + sz <= mem_budget_;
+  }
+  // The hand passes a row at most twice, once to clear the reference bit and once to evict it.
+  size_t steps = 2 * clock_.size();
+  while (mem_usage_ + sz > mem_budget_ && steps > 0 && !clock_.empty()) {
+    --steps;
+    if (hand_ == clock_.end()) {
+      hand_ = clock_.begin();
+    }
+    auto &entry = entries_.at(*hand_);
+    if (entry.pin > 0 || entry.referenced) {
+      entry.referenced = false;
+      ++hand_;
+      continue;
+    }
+    mp_->Deallocate(entry.ptr);
+    entry.ptr = nullptr;
+    mem_usage_ -= entry.comp_sz;
+    ++num_evicted_;
+    hand_ = clock_.erase(hand_);
+  }
+  return mem_usage_ + sz <= mem_budget_;
+}
+
+void CacheCompressedTier::KeepInMemory(key_type key, Entry *entry, const void *comp_data) {
+  void *p = nullptr;
+  if (mp_->Allocate(entry->comp_sz, &p).IsError()) {
+    // The memory pool is used up before the budget, keep the row on disk only.
+    return;
+  }
+  WritableSlice dest(p, entry->comp_sz);
+  if (WritableSlice::Copy(&dest, ReadableSlice(comp_data, entry->comp_sz)).IsError()) {
+    mp_->Deallocate(p);
+    return;
+  }
+  entry->ptr = p;
+  mem_usage_ += entry->comp_sz;
+  // A new row is put right behind the hand, so that it is the last one to be checked.
+  entry->clock_it = clock_.insert(hand_, key);
+}
+
+void CacheCompressedTier::Erase(key_type key) {
+  std::unique_lock<std::mutex> lck(mux_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return;
+  }
+  auto &entry = it->second;
+  if (entry.ptr != nullptr) {
+    if (hand_ == entry.clock_it) {
+      hand_ = clock_.erase(entry.clock_it);
+    } else {
+      (void)clock_.erase(entry.clock_it);
+    }
+    mp_->Deallocate(entry.ptr);
+    mem_usage_ -= entry.comp_sz;
+  }
+  (void)entries_.erase(it);
+}
+
+CacheCompressedTier::TierStat CacheCompressedTier::GetStat() const {
+  std::unique_lock<std::mutex> lck(mux_);
+  TierStat st{};
+  st.num_mem_cached = static_cast<int64_t>(clock_.size());
+  st.num_disk_cached = static_cast<int64_t>(entries_.size() - clock_.size());
+  st.num_mem_hit = num_mem_hit_;
+  st.num_disk_hit = num_disk_hit_;
+  st.num_evicted = num_evicted_;
+  return st;
+}
+}  // namespace dataset
+}  // namespace mindspore
@@ -0,0 +1,126 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_COMPRESSED_TIER_H_
+#define MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_COMPRESSED_TIER_H_
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "minddata/dataset/engine/cache/storage_manager.h"
+#include "minddata/dataset/util/memory_pool.h"
+#include "minddata/dataset/util/slice.h"
+#include "minddata/dataset/util/status.h"
+
+namespace mindspore {
+namespace dataset {
+/// \brief The compressed tier of a CachePool. It takes the rows that no longer fit in the uncompressed memory of the
+/// CachePool. A row is compressed and kept in memory up to a budget of its own. If a spill directory is given, the
+/// compressed row is also written to disk, so that the rows not read recently can be evicted from memory by a CLOCK
+/// sweep without any disk write, and be brought back to memory when they are read again.
+class CacheCompressedTier {
+ public:
+  using key_type = int64_t;
+
+  /// \brief Statistics of the compressed tier
+  struct TierStat {
+    int64_t num_mem_cached;   // rows compressed in memory
+    int64_t num_disk_cached;  // rows evicted from memory and only found on disk
+    int64_t num_mem_hit;
+    int64_t num_disk_hit;
+    int64_t num_evicted;
+  };
+
+  /// \brief Constructor
+  /// \param mp Memory pool to allocate the compressed rows from
+  /// \param mem_budget The maximum bytes of compressed rows kept in memory
+  /// \param sm Optional storage to write the compressed rows to
+  CacheCompressedTier(std::shared_ptr<MemoryPool> mp, uint64_t mem_budget, std::shared_ptr<StorageManager> sm);
+
+  CacheCompressedTier(const CacheCompressedTier &) = delete;
+  CacheCompressedTier &operator=(const CacheCompressedTier &) = delete;
+  ~CacheCompressedTier();
+
+  /// \brief Compress a sequence of ReadableSlice objects and insert it into the tier.
+  /// \param[in] key User supplied key
+  /// \param[in] buf A sequence of ReadableSlice objects
+  /// \return Error code, kMDDuplicateKey if the key is already inserted, kMDOutOfMemory if there is neither memory
+  /// nor disk left for the row
+  Status Insert(key_type key, const std::vector<ReadableSlice> &buf);
+
+  /// \brief Restore a row, and bring it back to memory if it is only found on disk.
+  /// \param[in] key A previous key given to Insert
+  /// \param[out] dest The decompressed row will be copied to this destination
+  /// \param[out] bytes_read Optional. Number of bytes read.
+  /// \return Error code
+  Status Read(key_type key, WritableSlice *dest, size_t *bytes_read = nullptr);
+
+  /// \brief Remove a row, which is used to roll back an Insert.
+  /// \note The copy on disk is not removed.
+  /// \param[in] key A previous key given to Insert
+  void Erase(key_type key);
+
+  /// \brief Get statistics.
+  /// \return TierStat object
+  TierStat GetStat() const;
+
+  /// \brief Bytes of the compressed rows kept in memory.
+  uint64_t GetMemUsage() const { return mem_usage_; }
+
+ private:
+  struct Entry {
+    void *ptr = nullptr;     // nullptr if the row is evicted from memory
+    size_t sz = 0;           // size of the row
+    size_t comp_sz = 0;      // size of the row after compression
+    bool compressed = true;  // false if the row doesn't shrink and is kept as it is
+    bool on_disk = false;
+    StorageManager::key_type storage_key = 0;
+    int32_t pin = 0;          // number of readers which are decompressing from ptr
+    bool referenced = false;  // read since the last time the CLOCK hand passes
+    std::list<key_type>::iterator clock_it;
+  };
+
+  /// \brief Compress a row, and write it through to disk if there is a StorageManager.
+  Status PackRow(const std::vector<ReadableSlice> &buf, Entry *entry, std::vector<uint8_t> *comp);
+
+  /// \brief Evict the rows from memory until there is room for sz more bytes. The mutex must be held.
+  /// \return True if there is enough room
+  bool MakeRoom(size_t sz);
+
+  /// \brief Copy the compressed row into the memory budget and put it on the clock. The mutex must be held.
+  void KeepInMemory(key_type key, Entry *entry, const void *comp_data);
+
+  std::shared_ptr<MemoryPool> mp_;
+  const uint64_t mem_budget_;
+  std::shared_ptr<StorageManager> sm_;
+  mutable std::mutex mux_;
+  std::unordered_map<key_type, Entry> entries_;
+  // Keys being compressed and written to disk by Insert, claimed before anything is written
+  std::unordered_set<key_type> inserting_;
+  // Keys of the rows in memory, the CLOCK hand sweeps it round for the row to evict
+  std::list<key_type> clock_;
+  std::list<key_type>::iterator hand_;
+  std::atomic<uint64_t> mem_usage_;
+  int64_t num_evicted_;
+  std::atomic<int64_t> num_mem_hit_;
+  std::atomic<int64_t> num_disk_hit_;
+};
+}  // namespace dataset
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_CACHE_COMPRESSED_TIER_H_
@@ -22,7 +22,16 @@
 namespace mindspore {
 namespace dataset {
 CachePool::CachePool(std::shared_ptr<NumaMemoryPool> mp, const std::string &root)
-    : mp_(std::move(mp)), root_(root), subfolder_(Services::GetUniqueID()), sm_(nullptr), tree_(nullptr) {
+    : mp_(std::move(mp)),
+      root_(root),
+      subfolder_(Services::GetUniqueID()),
+      sm_(nullptr),
+      ct_(nullptr),
+      tree_(nullptr),
+      compressed_mem_budget_(0),
+      num_mem_hit_(0),
+      num_disk_hit_(0),
+      num_miss_(0) {
   // Initialize soft memory cap to the current available memory on the machine.
   soft_mem_limit_ = CacheServerHW::GetAvailableMemory();
   temp_mem_usage_ = 0;
@@ -40,6 +49,13 @@ Status CachePool::DoServiceStart() {
     RETURN_IF_NOT_OK(sm_->ServiceStart());
     MS_LOG(INFO) << "CachePool will use disk folder: " << spill.ToString();
   }
+  // Set aside part of the memory the cache can use for the compressed rows.
+  float compressed_ratio = CacheServer::GetInstance().GetCompressedRatio();
+  if (compressed_ratio > 0 && soft_mem_limit_ > min_avail_mem_) {
+    compressed_mem_budget_ = static_cast<uint64_t>((soft_mem_limit_ - min_avail_mem_) * compressed_ratio);
+    ct_ = std::make_shared<CacheCompressedTier>(mp_, compressed_mem_budget_, sm_);
+    MS_LOG(INFO) << "CachePool sets aside " << compressed_mem_budget_ << " bytes for the compressed rows.";
+  }
   return Status::OK();
 }
 
@@ -52,6 +68,7 @@ Status CachePool::DoServiceStop() {
       rc2 = rc;
     }
   }
+  ct_.reset();
   sm_.reset();
 
   // We used to free the memory allocated from each DataLocator but
@@ -90,8 +107,13 @@ Status CachePool::Insert(CachePool::key_type key, const std::vector<ReadableSlic
   bl.sz = sz;
   // If required memory size exceeds the available size, it gives OOM status. To avoid cache server process got killed
   // or crashing the machine, set lower bound memory, which means stopping cache once the rest available memory is less
-  // than the lower bound. (The default is 20% of physical RAM)
-  if (soft_mem_limit_ - temp_mem_usage_ - static_cast<uint64_t>(sz) < min_avail_mem_) {
+  // than the lower bound. (The default is 20% of physical RAM) The part of the compressed tier budget not used yet is
+  // also kept away from the uncompressed buffer.
+  uint64_t reserved_mem = min_avail_mem_;
+  if (ct_ != nullptr) {
+    reserved_mem += compressed_mem_budget_ - std::min<uint64_t>(ct_->GetMemUsage(), compressed_mem_budget_);
+  }
+  if (soft_mem_limit_ - temp_mem_usage_ - static_cast<uint64_t>(sz) < reserved_mem) {
     MS_LOG(WARNING) << "Memory usage will exceed the upper bound limit of: " << min_avail_mem_
                     << ". The cache server will not cache any more data.";
     rc = Status(StatusCode::kMDOutOfMemory, __LINE__, __FILE__);
@@ -130,8 +152,11 @@ Status CachePool::Insert(CachePool::key_type key, const std::vector<ReadableSlic
       return rc;
     }
   } else if (rc == StatusCode::kMDOutOfMemory) {
-    // If no memory, write to disk.
-    if (sm_ != nullptr) {
+    // If no memory, compress it, or write to disk.
+    if (ct_ != nullptr) {
+      RETURN_IF_NOT_OK(ct_->Insert(key, buf));
+      bl.compressed = true;
+    } else if (sm_ != nullptr) {
       MS_LOG(DEBUG) << "Spill to disk directly ... " << bl.sz << " bytes.";
       RETURN_IF_NOT_OK(sm_->Write(&bl.storage_key, buf));
     } else {
@@ -154,6 +179,9 @@ Status CachePool::Insert(CachePool::key_type key, const std::vector<ReadableSlic
     bl.ptr = nullptr;
     return rc;
   }
+  if (rc.IsError() && bl.compressed) {
+    ct_->Erase(key);
+  }
   return rc;
 }
 
@@ -165,7 +193,12 @@ Status CachePool::Read(CachePool::key_type key, WritableSlice *dest, size_t *byt
     if (it->ptr != nullptr) {
       ReadableSlice src(it->ptr, it->sz);
       RETURN_IF_NOT_OK(WritableSlice::Copy(dest, src));
+    } else if (it->compressed) {
+      size_t expectedLength = 0;
+      RETURN_IF_NOT_OK(ct_->Read(key, dest, &expectedLength));
+      CHECK_FAIL_RETURN_UNEXPECTED(expectedLength == it->sz, "Length mismatch of the compressed row.");
     } else if (sm_ != nullptr) {
+      ++num_disk_hit_;
       size_t expectedLength = 0;
       RETURN_IF_NOT_OK(sm_->Read(it->storage_key, dest, &expectedLength));
       if (expectedLength != it->sz) {
@@ -192,15 +225,17 @@ CachePool::CacheStat CachePool::GetStat(bool GetMissingKeys) const {
   tree_->LockShared();  // Prevent any node split while we search.
   CacheStat cs{-1, -1, 0, 0, 0, 0};
   int64_t total_sz = 0;
+  int64_t num_rows = 0;
   if (tree_->begin() != tree_->end()) {
     cs.min_key = tree_->begin().key();
     cs.max_key = cs.min_key;  // will adjust later.
     for (auto it = tree_->begin(); it != tree_->end(); ++it) {
       it.LockShared();
       total_sz += it.value().sz;
+      ++num_rows;
       if (it.value().ptr != nullptr) {
         ++cs.num_mem_cached;
-      } else {
+      } else if (!it.value().compressed) {
         ++cs.num_disk_cached;
       }
       if (it.value().node_hit) {
@@ -218,12 +253,23 @@ CachePool::CacheStat CachePool::GetStat(bool GetMissingKeys) const {
   }
   if (total_sz > 0) {
     // integer arithmetic. NO need to cast to float or double.
-    cs.average_cache_sz = total_sz / (cs.num_disk_cached + cs.num_mem_cached);
+    cs.average_cache_sz = total_sz / num_rows;
     if (cs.average_cache_sz == 0) {
       cs.average_cache_sz = 1;
     }
   }
   tree_->Unlock();
+  cs.num_mem_hit = num_mem_hit_;
+  cs.num_disk_hit = num_disk_hit_;
+  cs.num_miss = num_miss_;
+  if (ct_ != nullptr) {
+    auto ts = ct_->GetStat();
+    cs.num_compressed_cached = ts.num_mem_cached;
+    cs.num_disk_cached += ts.num_disk_cached;
+    cs.num_compressed_hit = ts.num_mem_hit;
+    cs.num_disk_hit += ts.num_disk_hit;
+    cs.num_evicted = ts.num_evicted;
+  }
   return cs;
 }
 
@@ -233,6 +279,10 @@ Status CachePool::GetDataLocator(key_type key, const std::shared_ptr<flatbuffers
   auto r = tree_->Search(key);
   if (r.second) {
     auto &it = r.first;
+    // A row not in the uncompressed memory is counted when it is read.
+    if (it->ptr != nullptr) {
+      ++num_mem_hit_;
+    }
     DataLocatorMsgBuilder bld(*fbb);
     bld.add_key(key);
     bld.add_size(it->sz);
@@ -242,6 +292,7 @@ Status CachePool::GetDataLocator(key_type key, const std::shared_ptr<flatbuffers
     *out = offset;
   } else {
     // Key not in the cache.
+    ++num_miss_;
     auto offset = CreateDataLocatorMsg(*fbb, key, 0, 0, 0);
     *out = offset;
   }
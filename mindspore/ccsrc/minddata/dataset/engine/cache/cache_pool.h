@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 #include "minddata/dataset/engine/cache/cache_common.h"
+#include "minddata/dataset/engine/cache/cache_compressed_tier.h"
 #include "minddata/dataset/engine/cache/cache_numa.h"
 #include "minddata/dataset/engine/cache/storage_manager.h"
 #include "minddata/dataset/util/allocator.h"
@@ -35,6 +36,8 @@ namespace dataset {
 /// \brief A CachePool provides service for backup/restore a buffer. A buffer can be represented in a form of vector of
 /// ReadableSlice where all memory blocks will be copied to one contiguous block which can be in memory or spilled to
 /// disk (if a disk directory is provided). User must provide a key to insert the buffer.
+/// If a compressed ratio is set for the server, that ratio of the memory is set aside for a CacheCompressedTier which
+/// takes the buffers after the uncompressed memory is full, before they are spilled to disk.
 /// \see ReadableSlice
 class CachePool : public Service {
  public:
@@ -48,7 +51,7 @@ class CachePool : public Service {
   // An internal class to locate the whereabouts of a backed up buffer which can be either in
   class DataLocator {
    public:
-    DataLocator() : ptr(nullptr), sz(0), node_id(0), node_hit(false), storage_key(0) {}
+    DataLocator() : ptr(nullptr), sz(0), node_id(0), node_hit(false), storage_key(0), compressed(false) {}
     ~DataLocator() = default;
     DataLocator(const DataLocator &other) = default;
     DataLocator &operator=(const DataLocator &other) = default;
@@ -58,9 +61,11 @@ class CachePool : public Service {
       node_id = other.node_id;
       node_hit = other.node_hit;
       storage_key = other.storage_key;
+      compressed = other.compressed;
       other.ptr = nullptr;
       other.sz = 0;
       other.storage_key = 0;
+      other.compressed = false;
     }
     DataLocator &operator=(DataLocator &&other) noexcept {
       if (&other != this) {
@@ -69,9 +74,11 @@ class CachePool : public Service {
         node_id = other.node_id;
         node_hit = other.node_hit;
         storage_key = other.storage_key;
+        compressed = other.compressed;
         other.ptr = nullptr;
         other.sz = 0;
         other.storage_key = 0;
+        other.compressed = false;
       }
       return *this;
     }
@@ -80,6 +87,7 @@ class CachePool : public Service {
     numa_id_t node_id;  // where the numa node the memory is allocated to
     bool node_hit;      // we can allocate to the preferred node
     StorageManager::key_type storage_key;
+    bool compressed;  // the buffer is kept by the compressed tier
   };
 
   using data_index = BPlusTree<int64_t, DataLocator>;
@@ -95,6 +103,12 @@ class CachePool : public Service {
     int64_t num_disk_cached;
     int64_t average_cache_sz;
     int64_t num_numa_hit;
+    int64_t num_compressed_cached;
+    int64_t num_mem_hit;
+    int64_t num_compressed_hit;
+    int64_t num_disk_hit;
+    int64_t num_miss;
+    int64_t num_evicted;
     std::vector<key_type> gap;
   };
 
@@ -148,11 +162,16 @@ class CachePool : public Service {
   Path root_;
   const std::string subfolder_;
   std::shared_ptr<StorageManager> sm_;
+  std::shared_ptr<CacheCompressedTier> ct_;
   std::shared_ptr<data_index> tree_;
   std::atomic<uint64_t> soft_mem_limit_;  // the available memory in the machine
   std::atomic<uint64_t> temp_mem_usage_;  // temporary count on the amount of memory usage by cache every 100Mb (because
                                           // we will adjust soft_mem_limit_ every 100Mb based on this parameter)
   uint64_t min_avail_mem_;                // lower bound of the available memory
+  uint64_t compressed_mem_budget_;        // memory set aside for the compressed tier
+  mutable std::atomic<int64_t> num_mem_hit_;
+  mutable std::atomic<int64_t> num_disk_hit_;
+  mutable std::atomic<int64_t> num_miss_;
   const int kMemoryCapAdjustInterval = 104857600;
 };
 }  // namespace dataset
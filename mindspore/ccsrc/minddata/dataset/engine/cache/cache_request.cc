@@ -303,6 +303,12 @@ Status GetStatRequest::PostReply() {
   stat_.max_row_id = msg->max_row_id();
   stat_.min_row_id = msg->min_row_id();
   stat_.cache_service_state = msg->state();
+  stat_.num_compressed_cached = msg->num_compressed_cached();
+  stat_.num_mem_hit = msg->num_mem_hit();
+  stat_.num_compressed_hit = msg->num_compressed_hit();
+  stat_.num_disk_hit = msg->num_disk_hit();
+  stat_.num_miss = msg->num_miss();
+  stat_.num_evicted = msg->num_evicted();
   return Status::OK();
 }
 
@@ -331,6 +337,12 @@ Status ListSessionsRequest::PostReply() {
     stats.min_row_id = current_session_info->stats()->min_row_id();
     stats.max_row_id = current_session_info->stats()->max_row_id();
     stats.cache_service_state = current_session_info->stats()->state();
+    stats.num_compressed_cached = current_session_info->stats()->num_compressed_cached();
+    stats.num_mem_hit = current_session_info->stats()->num_mem_hit();
+    stats.num_compressed_hit = current_session_info->stats()->num_compressed_hit();
+    stats.num_disk_hit = current_session_info->stats()->num_disk_hit();
+    stats.num_miss = current_session_info->stats()->num_miss();
+    stats.num_evicted = current_session_info->stats()->num_evicted();
     current_info.stats = stats;  // fixed length struct.  = operator is safe
     session_info_list_.push_back(current_info);
   }
@@ -578,6 +578,12 @@ Status CacheServer::GetStat(CacheRequest *rq, CacheReply *reply) {
     bld.add_max_row_id(svc_stat.stat_.max_key);
     bld.add_min_row_id(svc_stat.stat_.min_key);
     bld.add_state(svc_stat.state_);
+    bld.add_num_compressed_cached(svc_stat.stat_.num_compressed_cached);
+    bld.add_num_mem_hit(svc_stat.stat_.num_mem_hit);
+    bld.add_num_compressed_hit(svc_stat.stat_.num_compressed_hit);
+    bld.add_num_disk_hit(svc_stat.stat_.num_disk_hit);
+    bld.add_num_miss(svc_stat.stat_.num_miss);
+    bld.add_num_evicted(svc_stat.stat_.num_evicted);
     auto offset = bld.Finish();
     fbb.Finish(offset);
     reply->set_result(fbb.GetBufferPointer(), fbb.GetSize());
@@ -711,7 +717,10 @@ Status CacheServer::ListSessions(CacheReply *reply) {
         RETURN_IF_NOT_OK(cs->GetStat(&svc_stat));
         auto current_stats = CreateServiceStatMsg(fbb, svc_stat.stat_.num_mem_cached, svc_stat.stat_.num_disk_cached,
                                                   svc_stat.stat_.average_cache_sz, svc_stat.stat_.num_numa_hit,
-                                                  svc_stat.stat_.min_key, svc_stat.stat_.max_key, svc_stat.state_);
+                                                  svc_stat.stat_.min_key, svc_stat.stat_.max_key, svc_stat.state_,
+                                                  svc_stat.stat_.num_compressed_cached, svc_stat.stat_.num_mem_hit,
+                                                  svc_stat.stat_.num_compressed_hit, svc_stat.stat_.num_disk_hit,
+                                                  svc_stat.stat_.num_miss, svc_stat.stat_.num_evicted);
         auto current_session_info = CreateListSessionMsg(fbb, current_session_id, current_conn_id, current_stats);
         session_msgs_vector.push_back(current_session_info);
       }
@@ -993,8 +1002,8 @@ session_id_type CacheServer::GetSessionID(connection_id_type connection_id) cons
 }
 
 CacheServer::CacheServer(const std::string &spill_path, int32_t num_workers, int32_t port,
-                         int32_t shared_meory_sz_in_gb, float memory_cap_ratio, int8_t log_level,
-                         std::shared_ptr<CacheServerHW> hw_info)
+                         int32_t shared_meory_sz_in_gb, float memory_cap_ratio, float compressed_ratio,
+                         int8_t log_level, std::shared_ptr<CacheServerHW> hw_info)
     : top_(spill_path),
       num_workers_(num_workers),
       num_grpc_workers_(num_workers_),
@@ -1002,6 +1011,7 @@ CacheServer::CacheServer(const std::string &spill_path, int32_t num_workers, int
       shared_memory_sz_in_gb_(shared_meory_sz_in_gb),
       global_shutdown_(false),
       memory_cap_ratio_(memory_cap_ratio),
+      compressed_ratio_(compressed_ratio),
       numa_affinity_(true),
       log_level_(log_level),
       hw_info_(std::move(hw_info)) {
@@ -1279,6 +1289,9 @@ Status CacheServer::Builder::SanityCheck() {
   if (memory_cap_ratio_ <= 0 || memory_cap_ratio_ > 1) {
     RETURN_STATUS_UNEXPECTED("Memory cap ratio should be positive and no greater than 1");
   }
+  if (compressed_ratio_ < 0 || compressed_ratio_ >= 1) {
+    RETURN_STATUS_UNEXPECTED("Compressed ratio should be non-negative and less than 1");
+  }
 
   // Check if the shared memory.
   RETURN_IF_NOT_OK(IpcResourceCleanup());
@@ -1305,6 +1318,7 @@ CacheServer::Builder::Builder()
       port_(kCfgDefaultCachePort),
       shared_memory_sz_in_gb_(kDefaultSharedMemorySize),
       memory_cap_ratio_(kDefaultMemoryCapRatio),
+      compressed_ratio_(kDefaultCompressedRatio),
       log_level_(kDefaultLogLevel) {
   if (num_workers_ == 0) {
     num_workers_ = 1;
@@ -71,7 +71,8 @@ class Connector {
   // @param n_producers The number of threads producing data into this DbConnector.
   // @param n_consumers The number of thread consuming data from this DbConnector.
   // @param queue_capacity The number of element for each queue.
-  Connector(int32_t n_producers, int32_t n_consumers, int32_t queue_capacity)
+  // @param queue_max_bytes The number of bytes of the elements each queue can hold, 0 means no limit.
+  Connector(int32_t n_producers, int32_t n_consumers, int32_t queue_capacity, int64_t queue_max_bytes = 0)
       : num_producers_(n_producers), num_consumers_(n_consumers) {
     MS_LOG(DEBUG) << "A connector is created with " << n_producers << " producers and " << n_consumers << " consumers.";
     my_name_ = Services::GetUniqueID();
@@ -84,7 +85,7 @@ class Connector {
 
     // Initialize the queues_ to have num_producers_ number of queues.
     // Each queue is a blocking queue and has the same queue_capacity.
-    queues_.Init(num_producers_, queue_capacity);
+    queues_.Init(num_producers_, queue_capacity, queue_max_bytes);
   }
 
   // Destructor of Connector
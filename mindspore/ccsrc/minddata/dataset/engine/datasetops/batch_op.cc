@@ -15,6 +15,7 @@
  */
 #include "minddata/dataset/engine/datasetops/batch_op.h"
 
+#include <future>
 #include <utility>
 
 #include "utils/ms_utils.h"
@@ -27,6 +28,59 @@
 
 namespace mindspore {
 namespace dataset {
+namespace {
+// A batch with fewer bytes than this is not worth collating a column per thread
+constexpr int64_t kParallelBatchBytes = 4 * 1024 * 1024;
+// Free batch buffers kept for the next batches of the same shape
+constexpr uint64_t kBatchPoolCachedBytes = 128 * 1024 * 1024;
+
+// Copy a numeric tensor into its slot of a batch buffer laid out as item_shape, cutting off the part of each dimension
+// beyond item_shape. The rest of the slot is left as it is, filled with the pad value beforehand.
+Status CopyPadded(const std::shared_ptr<Tensor> &src, const TensorShape &item_shape, uchar *dst, dsize_t dst_size) {
+  CHECK_FAIL_RETURN_UNEXPECTED(
+    src->Rank() == item_shape.Rank(),
+    "Invalid data, data to be padded together need to have the same rank, got shape 1: " +
+      std::to_string(src->Rank()) + ", shape 2: " + std::to_string(item_shape.Rank()));
+  size_t type_size = src->type().SizeInBytes();
+  if (src->Rank() == 0) {
+    CHECK_FAIL_RETURN_UNEXPECTED(memcpy_s(dst, dst_size, src->GetBuffer(), type_size) == 0, "memcpy error");
+    return Status::OK();
+  }
+  size_t rank = src->Rank();
+  std::vector<dsize_t> copy_shape(rank);
+  for (size_t dim = 0; dim < rank; dim++) {
+    copy_shape[dim] = std::min(src->shape()[dim], item_shape[dim]);
+    if (copy_shape[dim] == 0) {
+      return Status::OK();
+    }
+  }
+  std::vector<dsize_t> src_strides = src->shape().Strides();
+  std::vector<dsize_t> dst_strides = item_shape.Strides();
+  size_t len = copy_shape[rank - 1] * type_size;
+  // walk the indices of all the dimensions but the last, and copy the last dimension at each of them
+  std::vector<dsize_t> ind(rank, 0);
+  while (true) {
+    dsize_t src_off = 0, dst_off = 0;
+    for (size_t dim = 0; dim + 1 < rank; dim++) {
+      src_off += ind[dim] * src_strides[dim];
+      dst_off += ind[dim] * dst_strides[dim];
+    }
+    dsize_t dst_pos = dst_off * static_cast<dsize_t>(type_size);
+    CHECK_FAIL_RETURN_UNEXPECTED(
+      memcpy_s(dst + dst_pos, dst_size - dst_pos, src->GetBuffer() + src_off * type_size, len) == 0, "memcpy error");
+    size_t dim = rank - 1;
+    while (dim > 0 && ++ind[dim - 1] == copy_shape[dim - 1]) {
+      ind[dim - 1] = 0;
+      dim--;
+    }
+    if (dim == 0) {
+      break;
+    }
+  }
+  return Status::OK();
+}
+}  // namespace
+
 BatchOp::Builder::Builder(int32_t batch_size) : builder_drop_(false), builder_pad_(false), builder_pad_map_({}) {
   builder_batch_size_ = batch_size;
   std::shared_ptr<ConfigManager> cfg = GlobalContext::config_manager();
@@ -67,7 +121,8 @@ BatchOp::BatchOp(int32_t batch_size, bool drop, bool pad, int32_t op_queue_size,
       in_col_names_(cols_to_map),
       pad_info_(pad_map),
       batch_num_(0),
-      batch_cnt_(0) {
+      batch_cnt_(0),
+      batch_pool_(std::make_shared<RecyclingPool>(kBatchPoolCachedBytes)) {
   // Adjust connector queue size.  After batch each row is batch_size times larger
   worker_connector_size_ = std::max(1, worker_connector_size_ / start_batch_size_);
   if (num_workers == 1) {
@@ -164,63 +219,165 @@ void BatchOp::Print(std::ostream &out, bool show_all) const {
 }
 
 Status BatchOp::BatchRows(const std::unique_ptr<TensorQTable> *src, TensorRow *dest, dsize_t batch_size) {
+  return BatchRows(src, dest, batch_size, {}, {}, nullptr);
+}
+
+Status BatchOp::BatchRows(const std::unique_ptr<TensorQTable> *src, TensorRow *dest, dsize_t batch_size,
+                          const std::vector<std::vector<dsize_t>> &pad_shapes,
+                          const std::vector<std::shared_ptr<Tensor>> &pad_vals,
+                          const std::shared_ptr<MemoryPool> &pool) {
   RETURN_UNEXPECTED_IF_NULL(src);
   RETURN_UNEXPECTED_IF_NULL(dest);
   if ((*src)->size() != batch_size) {
     RETURN_STATUS_UNEXPECTED("[Internal ERROR] Source table size does not match the batch_size.");
   }
 
+  auto num_columns = (*src)->front().size();
+  CHECK_FAIL_RETURN_UNEXPECTED(pad_shapes.empty() || pad_shapes.size() == num_columns,
+                               "[Internal ERROR] Number of pad shapes does not match the number of columns.");
+  CHECK_FAIL_RETURN_UNEXPECTED(pad_vals.empty() || pad_vals.size() == num_columns,
+                               "[Internal ERROR] Number of pad values does not match the number of columns.");
+  const std::vector<dsize_t> no_pad;
+  auto pad_shape = [&pad_shapes, &no_pad](size_t i) -> const std::vector<dsize_t> & {
+    return pad_shapes.empty() ? no_pad : pad_shapes[i];
+  };
+  auto pad_val = [&pad_vals](size_t i) { return pad_vals.empty() ? nullptr : pad_vals[i]; };
+
   if (batch_size == 1) {
     *dest = std::move((*src)->front());
     (*src)->pop_front();
 
-    for (const auto &tensor : (*dest)) {
-      RETURN_IF_NOT_OK(tensor->ExpandDim(0));
+    for (size_t i = 0; i < dest->size(); i++) {
+      if (!pad_shape(i).empty()) {
+        std::shared_ptr<Tensor> pad_tensor;
+        RETURN_IF_NOT_OK(PadEnd((*dest)[i], &pad_tensor, pad_shape(i), pad_val(i)));
+        (*dest)[i] = pad_tensor;
+      }
+      RETURN_IF_NOT_OK((*dest)[i]->ExpandDim(0));
     }
     return Status::OK();
   }
 
-  auto num_columns = (*src)->front().size();
-  for (size_t i = 0; i < num_columns; i++) {
-    std::shared_ptr<Tensor> first_tensor = (*src)->at(0).at(i);  // first row, column i
-    TensorShape first_shape = first_tensor->shape();
-    DataType first_type = first_tensor->type();
-    TensorShape new_shape = first_shape.PrependDim(static_cast<int64_t>(batch_size));
-
-    std::shared_ptr<Tensor> new_tensor;
-    if (first_type.IsNumeric()) {  // numeric tensor
-      RETURN_IF_NOT_OK(Tensor::CreateEmpty(new_shape, first_type, &new_tensor));
-      dsize_t j = 0;
-      for (auto row : **src) {
-        std::shared_ptr<Tensor> old_tensor = row.at(i);  // row j, column i
-        if (old_tensor->shape() == first_shape) {        // check the newly popped rows have the same dim as the first
-          if (new_shape.NumOfElements() != 0) {
-            RETURN_IF_NOT_OK(new_tensor->InsertTensor({j++}, old_tensor));
-          }
-          // Don't do anything if the tensor has no data
-        } else {
-          std::stringstream shape1, shape2;
-          first_shape.Print(shape1);
-          old_tensor->shape().Print(shape2);
-          RETURN_STATUS_UNEXPECTED(
-            "Inconsistent batch shapes, batch operation expect same shape for each data row, "
-            "but got inconsistent shape in column " +
-            std::to_string(i) + ", expected shape for this column is:" + shape1.str() + ", got shape:" + shape2.str());
-        }
+  std::vector<std::shared_ptr<Tensor>> columns(num_columns);
+  auto batch_column = [&](size_t i) {
+    return BatchColumn(src, i, batch_size, pad_shape(i), pad_val(i), pool, &columns[i]);
+  };
+  int64_t batch_bytes = 0;
+  for (const auto &tensor : (*src)->front()) {
+    if (tensor->type().IsNumeric()) {
+      batch_bytes += tensor->SizeInBytes() * batch_size;
+    }
+  }
+  if (num_columns > 1 && batch_bytes >= kParallelBatchBytes) {
+    // the columns are independent, collate each of them in a thread of its own
+    std::vector<std::future<Status>> futures;
+    for (size_t i = 1; i < num_columns; i++) {
+      futures.emplace_back(std::async(std::launch::async, batch_column, i));
+    }
+    Status rc = batch_column(0);
+    for (auto &f : futures) {
+      Status col_rc = f.get();
+      if (rc.IsOk()) {
+        rc = col_rc;
       }
-    } else {  // handle string column differently
-      std::vector<std::string> strings;
-      for (dsize_t j = 0; j < batch_size; j++) {
-        std::shared_ptr<Tensor> old_tensor = (*src)->at(j).at(i);
-        for (auto itr = old_tensor->begin<std::string_view>(); itr != old_tensor->end<std::string_view>(); ++itr) {
-          strings.emplace_back(*itr);
-        }
+    }
+    RETURN_IF_NOT_OK(rc);
+  } else {
+    for (size_t i = 0; i < num_columns; i++) {
+      RETURN_IF_NOT_OK(batch_column(i));
+    }
+  }
+  for (auto &column : columns) {
+    dest->emplace_back(std::move(column));
+  }
+  return Status::OK();
+}
+
+Status BatchOp::BatchColumn(const std::unique_ptr<TensorQTable> *src, size_t col, dsize_t batch_size,
+                            const std::vector<dsize_t> &pad_shape, const std::shared_ptr<Tensor> &pad_val,
+                            const std::shared_ptr<MemoryPool> &pool, std::shared_ptr<Tensor> *out) {
+  std::shared_ptr<Tensor> first_tensor = (*src)->at(0).at(col);  // first row, column i
+  TensorShape first_shape = first_tensor->shape();
+  DataType first_type = first_tensor->type();
+  bool pad = !pad_shape.empty();
+  TensorShape item_shape = pad ? TensorShape(pad_shape) : first_shape;
+  TensorShape new_shape = item_shape.PrependDim(static_cast<int64_t>(batch_size));
+
+  if (!first_type.IsNumeric()) {  // handle string column differently
+    std::vector<std::string> strings;
+    for (dsize_t j = 0; j < batch_size; j++) {
+      std::shared_ptr<Tensor> old_tensor = (*src)->at(j).at(col);
+      if (pad) {
+        std::shared_ptr<Tensor> pad_tensor;
+        RETURN_IF_NOT_OK(PadEnd(old_tensor, &pad_tensor, pad_shape, pad_val));
+        old_tensor = pad_tensor;
+      }
+      for (auto itr = old_tensor->begin<std::string_view>(); itr != old_tensor->end<std::string_view>(); ++itr) {
+        strings.emplace_back(*itr);
       }
-      RETURN_IF_NOT_OK(Tensor::CreateFromVector(strings, new_shape, &new_tensor));
     }
-    dest->emplace_back(new_tensor);
+    return Tensor::CreateFromVector(strings, new_shape, out);
+  }
+
+  // check the rows against the first one, and see if any of them is to be padded
+  bool need_fill = false;
+  for (const TensorRow &row : **src) {
+    const std::shared_ptr<Tensor> &old_tensor = row.at(col);  // row j, column i
+    CHECK_FAIL_RETURN_UNEXPECTED(old_tensor->type().SizeInBytes() == first_type.SizeInBytes(),
+                                 "Inconsistent batch types, batch operation expect same type for each data row, "
+                                 "but got inconsistent type in column " +
+                                   std::to_string(col) + ", expected type for this column is:" +
+                                   first_type.ToString() + ", got type:" + old_tensor->type().ToString());
+    if (pad) {
+      need_fill = need_fill || old_tensor->shape() != item_shape;
+    } else if (old_tensor->shape() != first_shape) {  // check the newly popped rows have the same dim as the first
+      std::stringstream shape1, shape2;
+      first_shape.Print(shape1);
+      old_tensor->shape().Print(shape2);
+      RETURN_STATUS_UNEXPECTED(
+        "Inconsistent batch shapes, batch operation expect same shape for each data row, "
+        "but got inconsistent shape in column " +
+        std::to_string(col) + ", expected shape for this column is:" + shape1.str() + ", got shape:" + shape2.str());
+    }
   }
 
+  if (pool != nullptr) {
+    RETURN_IF_NOT_OK(Tensor::CreateEmpty(new_shape, first_type, pool, out));
+  } else {
+    RETURN_IF_NOT_OK(Tensor::CreateEmpty(new_shape, first_type, out));
+  }
+  if (new_shape.NumOfElements() == 0) {
+    return Status::OK();  // Don't do anything if the tensor has no data
+  }
+  if (need_fill) {
+    float val = 0;
+    if (pad_val != nullptr) {
+      CHECK_FAIL_RETURN_UNEXPECTED(pad_val->type().IsNumeric(),
+                                   "PadEnd: pad_value and item of dataset are not of the same type, type of pad_value "
+                                   "is:" +
+                                     pad_val->type().ToString() + ", and type of dataset item is:" +
+                                     first_type.ToString() + ".");
+      std::shared_ptr<Tensor> float_pad_value;
+      RETURN_IF_NOT_OK(TypeCast(pad_val, &float_pad_value, DataType(DataType::DE_FLOAT32)));
+      RETURN_IF_NOT_OK(float_pad_value->GetItemAt<float>(&val, {}));
+    }
+    RETURN_IF_NOT_OK(FillPadValue(*out, val));
+  }
+
+  // copy each row straight into its slot of the batch, padding it on the way
+  dsize_t item_bytes = item_shape.NumOfElements() * first_type.SizeInBytes();
+  uchar *dst = nullptr;
+  TensorShape remaining = TensorShape::CreateUnknownRankShape();
+  RETURN_IF_NOT_OK((*out)->StartAddrOfIndex({0}, &dst, &remaining));
+  for (dsize_t j = 0; j < batch_size; j++) {
+    const std::shared_ptr<Tensor> &old_tensor = (*src)->at(j).at(col);
+    if (old_tensor->shape() == item_shape) {
+      CHECK_FAIL_RETURN_UNEXPECTED(
+        memcpy_s(dst + j * item_bytes, item_bytes, old_tensor->GetBuffer(), item_bytes) == 0, "memcpy error");
+    } else {
+      RETURN_IF_NOT_OK(CopyPadded(old_tensor, item_shape, dst + j * item_bytes, item_bytes));
+    }
+  }
   return Status::OK();
 }
 
@@ -252,10 +409,13 @@ Status BatchOp::MakeBatchedRow(std::pair<std::unique_ptr<TensorQTable>, CBatchIn
     RETURN_IF_NOT_OK(MapColumns(&table_pair));
   }  // pass it through pyfun
 #endif
+  std::vector<std::vector<dsize_t>> pad_shapes;
+  std::vector<std::shared_ptr<Tensor>> pad_vals;
   if (pad_) {
-    RETURN_IF_NOT_OK(PadColumns(&table_pair.first, pad_info_, column_name_id_map_));
-  }  // do padding if needed
-  RETURN_IF_NOT_OK(BatchRows(&table_pair.first, new_row, table_pair.first->size()));
+    RETURN_IF_NOT_OK(GetPadShapes(&table_pair.first, pad_info_, column_name_id_map_, &pad_shapes, &pad_vals));
+  }  // padding is done while batching if needed
+  RETURN_IF_NOT_OK(
+    BatchRows(&table_pair.first, new_row, table_pair.first->size(), pad_shapes, pad_vals, batch_pool_));
   return Status::OK();
 }
 
@@ -421,25 +581,50 @@ Status BatchOp::InvokeBatchMapFunc(TensorTable *input, TensorTable *output, CBat
 Status BatchOp::PadColumns(std::unique_ptr<TensorQTable> *table, const PadInfo &pad_info,
                            const std::unordered_map<std::string, int32_t> &column_name_id_map) {
   RETURN_UNEXPECTED_IF_NULL(table);  // placeholder for now, might need this in the future
+  std::vector<std::vector<dsize_t>> pad_shapes;
+  std::vector<std::shared_ptr<Tensor>> pad_vals;
+  RETURN_IF_NOT_OK(GetPadShapes(table, pad_info, column_name_id_map, &pad_shapes, &pad_vals));
+
+  // call pad on each tensor that needs to be padded
+  for (TensorRow &row : **table) {
+    for (size_t col_id = 0; col_id < pad_shapes.size(); col_id++) {
+      if (pad_shapes[col_id].empty()) {
+        continue;
+      }
+      std::shared_ptr<Tensor> pad_tensor;
+      RETURN_IF_NOT_OK(PadEnd(row[col_id], &pad_tensor, pad_shapes[col_id], pad_vals[col_id]));
+      row[col_id] = pad_tensor;
+    }
+  }
+  return Status::OK();
+}
+
+Status BatchOp::GetPadShapes(const std::unique_ptr<TensorQTable> *table, const PadInfo &pad_info,
+                             const std::unordered_map<std::string, int32_t> &column_name_id_map,
+                             std::vector<std::vector<dsize_t>> *pad_shapes,
+                             std::vector<std::shared_ptr<Tensor>> *pad_vals) {
+  RETURN_UNEXPECTED_IF_NULL(table);
+  RETURN_UNEXPECTED_IF_NULL(pad_shapes);
+  RETURN_UNEXPECTED_IF_NULL(pad_vals);
   CHECK_FAIL_RETURN_UNEXPECTED(
     (*table)->front().size() == column_name_id_map.size(),
     "Invalid parameter, size of column_name_id_map must be equal to num of data columns. map size: " +
       std::to_string(column_name_id_map.size()) + ", column nums: " + std::to_string((*table)->front().size()));
-  std::vector<std::shared_ptr<Tensor>> pad_vals(column_name_id_map.size(),
-                                                0);  // value to pad each column's tensor with, default 0
+  pad_vals->assign(column_name_id_map.size(), nullptr);  // value to pad each column's tensor with, default 0
   std::set<int32_t> pad_cols;
   // padded_shape provided by user, maximum shapes of current batch of tensors
-  std::vector<std::vector<dsize_t>> pad_shapes(column_name_id_map.size()), max_shapes(column_name_id_map.size());
-  RETURN_IF_NOT_OK(UnpackPadInfo(pad_info, column_name_id_map, &pad_cols, &pad_vals, &pad_shapes));
+  pad_shapes->assign(column_name_id_map.size(), {});
+  std::vector<std::vector<dsize_t>> max_shapes(column_name_id_map.size());
+  RETURN_IF_NOT_OK(UnpackPadInfo(pad_info, column_name_id_map, &pad_cols, pad_vals, pad_shapes));
 
   // init each shape in max_shape to {-1,-1...} init each unspecified shape in pad_shape to -1 as well
   for (size_t col_id : pad_cols) {
     max_shapes[col_id] = std::vector<dsize_t>((*table)->front()[col_id]->Rank(), -1);
-    if (pad_shapes[col_id].empty()) pad_shapes[col_id] = max_shapes[col_id];  // fill pad shape with -1
+    if ((*pad_shapes)[col_id].empty()) (*pad_shapes)[col_id] = max_shapes[col_id];  // fill pad shape with -1
     CHECK_FAIL_RETURN_UNEXPECTED(
-      pad_shapes[col_id].size() == max_shapes[col_id].size(),
+      (*pad_shapes)[col_id].size() == max_shapes[col_id].size(),
       "Invalid pad_info, rank of pad_shape must be equal to rank of specified column. pad_shapes rank:" +
-        std::to_string(pad_shapes[col_id].size()) + ", column rank: " + std::to_string(max_shapes[col_id].size()));
+        std::to_string((*pad_shapes)[col_id].size()) + ", column rank: " + std::to_string(max_shapes[col_id].size()));
   }
 
   // calculate maximum shape for each column that needs to be padded
@@ -457,17 +642,8 @@ Status BatchOp::PadColumns(std::unique_ptr<TensorQTable> *table, const PadInfo &
 
   // if user sets a dimension to -1 (None in python), use the max value for current dimension
   for (size_t col_id : pad_cols) {
-    for (size_t dim = 0; dim < pad_shapes[col_id].size(); dim++) {
-      if (pad_shapes[col_id][dim] < 0) pad_shapes[col_id][dim] = max_shapes[col_id][dim];
-    }
-  }
-
-  // call pad on each tensor that needs to be padded
-  for (TensorRow &row : **table) {
-    for (size_t col_id : pad_cols) {
-      std::shared_ptr<Tensor> pad_tensor;
-      RETURN_IF_NOT_OK(PadEnd(row[col_id], &pad_tensor, pad_shapes[col_id], pad_vals[col_id]));
-      row[col_id] = pad_tensor;
+    for (size_t dim = 0; dim < (*pad_shapes)[col_id].size(); dim++) {
+      if ((*pad_shapes)[col_id][dim] < 0) (*pad_shapes)[col_id][dim] = max_shapes[col_id][dim];
     }
   }
   return Status::OK();
@@ -606,9 +782,13 @@ Status BatchOp::GetNextRowPullMode(TensorRow *const row) {
     }
   }
   RETURN_UNEXPECTED_IF_NULL(table);
-  if (pad_) RETURN_IF_NOT_OK(PadColumns(&table, pad_info_, column_name_id_map_));  // do padding if needed
   if (!table->empty()) {
-    RETURN_IF_NOT_OK(BatchRows(&table, row, table->size()));
+    std::vector<std::vector<dsize_t>> pad_shapes;
+    std::vector<std::shared_ptr<Tensor>> pad_vals;
+    if (pad_) {
+      RETURN_IF_NOT_OK(GetPadShapes(&table, pad_info_, column_name_id_map_, &pad_shapes, &pad_vals));
+    }  // padding is done while batching if needed
+    RETURN_IF_NOT_OK(BatchRows(&table, row, table->size(), pad_shapes, pad_vals, batch_pool_));
     batch_cnt_++;
     batch_num_++;
   }
@@ -30,6 +30,7 @@
 #include "minddata/dataset/core/tensor.h"
 #include "minddata/dataset/engine/dataset_iterator.h"
 #include "minddata/dataset/engine/datasetops/parallel_op.h"
+#include "minddata/dataset/util/recycling_pool.h"
 #include "minddata/dataset/util/status.h"
 
 namespace mindspore {
@@ -200,6 +201,19 @@ class BatchOp : public ParallelOp<std::pair<std::unique_ptr<TensorQTable>, CBatc
   // @return Status The status code returned
   static Status BatchRows(const std::unique_ptr<TensorQTable> *src, TensorRow *dest, dsize_t batch_size);
 
+  // batch the rows in src table then put it to dest table, padding the tensors as they are copied into the batch.
+  // The columns of a big batch are collated in parallel.
+  // @param const std::unique_ptr<TensorQTable> *src - table that has the rows for batching
+  // @param TensorRow *dest - row to hold the batched tensors
+  // @param int32_t size - batch_size
+  // @param std::vector<std::vector<dsize_t>> &pad_shapes - shape to pad each column to, empty for no padding
+  // @param std::vector<std::shared_ptr<Tensor>> &pad_vals - value to pad each column with, nullptr for 0
+  // @param std::shared_ptr<MemoryPool> &pool - pool of the numeric batch tensors, nullptr for the global pool
+  // @return Status The status code returned
+  static Status BatchRows(const std::unique_ptr<TensorQTable> *src, TensorRow *dest, dsize_t batch_size,
+                          const std::vector<std::vector<dsize_t>> &pad_shapes,
+                          const std::vector<std::shared_ptr<Tensor>> &pad_vals, const std::shared_ptr<MemoryPool> &pool);
+
   // @param table
   // @param const PadInfo &pad_info pad info
   // @param const std::unordered_map<std::string, int32_t>& column_name_id_map - column names to index mapping
@@ -207,6 +221,18 @@ class BatchOp : public ParallelOp<std::pair<std::unique_ptr<TensorQTable>, CBatc
   static Status PadColumns(std::unique_ptr<TensorQTable> *table, const PadInfo &pad_info,
                            const std::unordered_map<std::string, int32_t> &column_name_id_map);
 
+  // get the shape each column of a batch is padded to, without padding the tensors
+  // @param const std::unique_ptr<TensorQTable> *table - table that has the rows for batching
+  // @param const PadInfo &pad_info pad info
+  // @param const std::unordered_map<std::string, int32_t>& column_name_id_map - column names to index mapping
+  // @param std::vector<std::vector<dsize_t>> *pad_shapes - shape to pad each column to, empty for no padding
+  // @param std::vector<std::shared_ptr<Tensor>> *pad_vals - value to pad each column with, nullptr for 0
+  // @return Status The status code returned
+  static Status GetPadShapes(const std::unique_ptr<TensorQTable> *table, const PadInfo &pad_info,
+                             const std::unordered_map<std::string, int32_t> &column_name_id_map,
+                             std::vector<std::vector<dsize_t>> *pad_shapes,
+                             std::vector<std::shared_ptr<Tensor>> *pad_vals);
+
   int64_t GetTreeBatchSize() override;
 
   bool IsPython() const override {
@@ -246,6 +272,19 @@ class BatchOp : public ParallelOp<std::pair<std::unique_ptr<TensorQTable>, CBatc
                               std::set<int32_t> *pad_cols, std::vector<std::shared_ptr<Tensor>> *pad_vals,
                               std::vector<std::vector<dsize_t>> *pad_shapes);
 
+  // batch one column of the rows in src table
+  // @param const std::unique_ptr<TensorQTable> *src - table that has the rows for batching
+  // @param size_t col - column to batch
+  // @param int32_t size - batch_size
+  // @param std::vector<dsize_t> &pad_shape - shape to pad the column to, empty for no padding
+  // @param std::shared_ptr<Tensor> &pad_val - value to pad the column with, nullptr for 0
+  // @param std::shared_ptr<MemoryPool> &pool - pool of the numeric batch tensor, nullptr for the global pool
+  // @param std::shared_ptr<Tensor> *out - batched tensor
+  // @return Status The status code returned
+  static Status BatchColumn(const std::unique_ptr<TensorQTable> *src, size_t col, dsize_t batch_size,
+                            const std::vector<dsize_t> &pad_shape, const std::shared_ptr<Tensor> &pad_val,
+                            const std::shared_ptr<MemoryPool> &pool, std::shared_ptr<Tensor> *out);
+
   // get the batch size for next batch
   // @return Status The status code returned
   Status GetBatchSize(int32_t *batch_size, CBatchInfo info);
@@ -280,6 +319,7 @@ class BatchOp : public ParallelOp<std::pair<std::unique_ptr<TensorQTable>, CBatc
   std::unordered_map<std::string, int32_t> child_map_;  // col_name_id_map of the child node
   int64_t batch_num_;
   int64_t batch_cnt_;
+  std::shared_ptr<RecyclingPool> batch_pool_;  // buffers of the numeric batch tensors, reused across batches
 #ifdef ENABLE_PYTHON
   py::function batch_size_func_;  // Function pointer of batch size function
   py::function batch_map_func_;   // Function pointer of per batch map function
@@ -153,11 +153,13 @@ Status BucketBatchByLengthOp::PadAndBatchBucket(int32_t bucket_index, int32_t ba
     }
   }
 
-  // PadColumns will change the data in bucket
-  RETURN_IF_NOT_OK(BatchOp::PadColumns(bucket, pad_info_copy, column_name_id_map_));
+  // the tensors in bucket are padded while they are copied into the batch
+  std::vector<std::vector<dsize_t>> pad_shapes;
+  std::vector<std::shared_ptr<Tensor>> pad_vals;
+  RETURN_IF_NOT_OK(BatchOp::GetPadShapes(bucket, pad_info_copy, column_name_id_map_, &pad_shapes, &pad_vals));
 
   TensorRow batched_bucket;
-  RETURN_IF_NOT_OK(BatchOp::BatchRows(bucket, &batched_bucket, batch_size));
+  RETURN_IF_NOT_OK(BatchOp::BatchRows(bucket, &batched_bucket, batch_size, pad_shapes, pad_vals, nullptr));
   (*bucket)->clear();
 
   RETURN_IF_NOT_OK(out_connector_->Add(std::move(batched_bucket)));
@@ -23,6 +23,8 @@
 #include <string>
 #include <algorithm>
 
+#include "minddata/dataset/core/config_manager.h"
+#include "minddata/dataset/core/global_context.h"
 #include "minddata/dataset/engine/datasetops/device_queue_op.h"
 #include "minddata/dataset/engine/datasetops/source/sampler/sampler.h"
 
@@ -217,7 +219,8 @@ std::vector<DatasetOp *> DatasetOp::parents() const { return parent_; }
 void DatasetOp::CreateConnector() {
   MS_LOG(DEBUG) << "Creating connector in tree operator: " << operator_id_ << ".";
   if (oc_queue_size_ > 0) {
-    out_connector_ = std::make_unique<OperatorConnector>(oc_queue_size_);
+    out_connector_ =
+      std::make_unique<OperatorConnector>(oc_queue_size_, GlobalContext::config_manager()->op_connector_max_bytes());
   } else {
     // Some op's may choose not to have an output connector
     MS_LOG(DEBUG) << "Bypassed connector creation for tree operator: " << operator_id_ << ".";
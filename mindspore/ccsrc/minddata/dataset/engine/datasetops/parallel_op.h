@@ -23,6 +23,8 @@
 #include <utility>
 #include <vector>
 #include "minddata/dataset/include/dataset/constants.h"
+#include "minddata/dataset/core/config_manager.h"
+#include "minddata/dataset/core/global_context.h"
 #include "minddata/dataset/engine/datasetops/dataset_op.h"
 #include "minddata/dataset/engine/execution_tree.h"
 #include "minddata/dataset/engine/datasetops/source/io_block.h"
@@ -91,8 +93,9 @@ class ParallelOp : public DatasetOp {
   /// \return Status The status code returned
   virtual Status RegisterAndLaunchThreads() {
     RETURN_UNEXPECTED_IF_NULL(tree_);
-    worker_in_queues_.Init(num_workers_, worker_connector_size_);
-    worker_out_queues_.Init(num_workers_, worker_connector_size_);
+    int64_t worker_connector_max_bytes = GlobalContext::config_manager()->op_connector_max_bytes();
+    worker_in_queues_.Init(num_workers_, worker_connector_size_, worker_connector_max_bytes);
+    worker_out_queues_.Init(num_workers_, worker_connector_size_, worker_connector_max_bytes);
 
     // Registers QueueList and individual Queues for interrupt services
     RETURN_IF_NOT_OK(worker_in_queues_.Register(tree_->AllTasks()));
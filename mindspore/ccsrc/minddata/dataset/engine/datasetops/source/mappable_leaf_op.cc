@@ -53,6 +53,7 @@ Status MappableLeafOp::operator()() {
         ep_step++;
         total_step++;
         RETURN_IF_NOT_OK(callback_manager_.StepBegin(CallbackParam(op_current_epochs_ + 1, ep_step, total_step)));
+        PrefetchTensorRow(*itr);
         RETURN_IF_NOT_OK(
           worker_in_queues_[NextWorkerID()]->Add(std::make_unique<IOBlock>(*itr, IOBlock::kDeIoBlockNone)));
       }
@@ -93,6 +93,11 @@ class MappableLeafOp : public ParallelOp<std::unique_ptr<IOBlock>, TensorRow>, p
   /// \return Status The status code returned
   virtual Status LoadTensorRow(row_id_type row_id, TensorRow *row) = 0;
 
+  /// Virtual function called by the master thread when the row at row_id is handed to a worker, a source op
+  /// that reads from files can start loading the row before the worker asks for it
+  /// \param row_id_type row_id - id of the tensor row
+  virtual void PrefetchTensorRow(row_id_type row_id) {}
+
   /// Reset function to be called after every epoch to reset the source op after
   /// \return Status The status code returned
   Status Reset() override;
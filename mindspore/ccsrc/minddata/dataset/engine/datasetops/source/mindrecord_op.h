@@ -130,6 +130,9 @@ class MindRecordOp : public MappableLeafOp {
   Status LoadTensorRow(row_id_type row_id, TensorRow *row) override {
     return Status(StatusCode::kMDSyntaxError, "[Internal ERROR] Cannot call this method.");
   }
+
+  void PrefetchTensorRow(row_id_type row_id) override { shard_reader_->PrefetchById(row_id); }
+
   // Private function for computing the assignment of the column name map.
   // @return - Status
   Status ComputeColMap() override;
@@ -16,7 +16,6 @@
 #include "minddata/dataset/engine/datasetops/source/tf_reader_op.h"
 
 #include <algorithm>
-#include <fstream>
 #include <future>
 #include <memory>
 #include <mutex>
@@ -28,6 +27,7 @@
 #include "minddata/dataset/core/global_context.h"
 #include "minddata/dataset/engine/data_schema.h"
 #include "minddata/dataset/engine/datasetops/source/io_block.h"
+#include "minddata/dataset/engine/datasetops/source/tf_record_reader.h"
 #include "minddata/dataset/engine/execution_tree.h"
 #include "minddata/dataset/engine/jagged_connector.h"
 #include "minddata/dataset/util/status.h"
@@ -48,27 +48,28 @@ bool TFReaderOp::ValidateFirstRowCrc(const std::string &filename) {
     return false;
   }
 
-  std::ifstream reader;
-  reader.open(realpath.value());
-  if (!reader) {
+  TFRecordReader reader;
+  if (reader.Open(realpath.value()).IsError()) {
     return false;
   }
-  int64_t file_len = reader.seekg(0, std::ios::end).tellg();
-  if (file_len > kTFRecordFileLimit) {
+  if (reader.FileSize() > kTFRecordFileLimit) {
     MS_LOG(WARNING) << "The file size of " << filename
                     << " is larger than 5G, there may be performance problems in "
                        "distributed scenarios, and it can be split into sub-files "
                        "smaller than 5G to get better performance.";
   }
-  (void)reader.seekg(0, std::ios::beg);
 
   // read data
   int64_t record_length = 0;
-  (void)reader.read(reinterpret_cast<char *>(&record_length), static_cast<std::streamsize>(sizeof(int64_t)));
+  if (reader.Read(reinterpret_cast<char *>(&record_length), static_cast<int64_t>(sizeof(int64_t))).IsError()) {
+    return false;
+  }
 
   // read crc from file
   uint32_t masked_crc = 0;
-  (void)reader.read(reinterpret_cast<char *>(&masked_crc), static_cast<std::streamsize>(sizeof(uint32_t)));
+  if (reader.Read(reinterpret_cast<char *>(&masked_crc), static_cast<int64_t>(sizeof(uint32_t))).IsError()) {
+    return false;
+  }
 
   // generate crc from data
   uint32_t generated_crc =
@@ -271,37 +272,38 @@ Status TFReaderOp::LoadFile(const std::string &filename, int64_t start_offset, i
     RETURN_STATUS_UNEXPECTED("Invalid file path, " + filename + " does not exist.");
   }
 
-  std::ifstream reader;
-  reader.open(realpath.value());
-  if (!reader) {
-    RETURN_STATUS_UNEXPECTED("Invalid file, " + filename + " open failed: permission denied!");
-  }
+  // the reader decompresses GZIP or ZLIB files on the fly and reads the next chunk ahead
+  TFRecordReader reader;
+  RETURN_IF_NOT_OK(reader.Open(realpath.value()));
 
   int64_t rows_read = 0;
   int64_t rows_total = 0;
 
-  while (reader.peek() != EOF) {
-    if (!load_jagged_connector_) {
+  while (true) {
+    bool eof = false;
+    RETURN_IF_NOT_OK(reader.Eof(&eof));
+    // the rows after end_offset belong to the other shards
+    if (eof || !load_jagged_connector_ || (start_offset != kInvalidOffset && rows_total >= end_offset)) {
       break;
     }
     RETURN_IF_INTERRUPTED();
 
     // read length
     int64_t record_length = 0;
-    (void)reader.read(reinterpret_cast<char *>(&record_length), static_cast<std::streamsize>(sizeof(int64_t)));
+    RETURN_IF_NOT_OK(reader.Read(reinterpret_cast<char *>(&record_length), static_cast<int64_t>(sizeof(int64_t))));
 
     // ignore crc header
-    (void)reader.ignore(static_cast<std::streamsize>(sizeof(int32_t)));
-
-    // read serialized Example
-    std::string serialized_example;
-    serialized_example.resize(record_length);
-    (void)reader.read(&serialized_example[0], static_cast<std::streamsize>(record_length));
+    RETURN_IF_NOT_OK(reader.Skip(static_cast<int64_t>(sizeof(int32_t))));
 
     int32_t num_columns = data_schema_->NumColumns();
     TensorRow newRow(num_columns, nullptr);
 
     if (start_offset == kInvalidOffset || (rows_total >= start_offset && rows_total < end_offset)) {
+      // read serialized Example
+      std::string serialized_example;
+      serialized_example.resize(record_length);
+      RETURN_IF_NOT_OK(reader.Read(&serialized_example[0], record_length));
+
       dataengine::Example tf_file;
       if (!tf_file.ParseFromString(serialized_example)) {
         std::string errMsg = "Failed to parse tfrecord file: " + filename + ", make sure protobuf version is suitable.";
@@ -314,10 +316,13 @@ Status TFReaderOp::LoadFile(const std::string &filename, int64_t start_offset, i
       RETURN_IF_NOT_OK(LoadExample(&tf_file, &newRow));
       rows_read++;
       RETURN_IF_NOT_OK(jagged_rows_connector_->Add(worker_id, std::move(newRow)));
+    } else {
+      // the rows of other shards are skipped without being copied
+      RETURN_IF_NOT_OK(reader.Skip(record_length));
     }
 
     // ignore crc footer
-    (void)reader.ignore(static_cast<std::streamsize>(sizeof(int32_t)));
+    RETURN_IF_NOT_OK(reader.Skip(static_cast<int64_t>(sizeof(int32_t))));
     rows_total++;
   }
 
@@ -559,20 +564,20 @@ Status TFReaderOp::CreateSchema(const std::string tf_file, std::vector<std::stri
     RETURN_STATUS_UNEXPECTED("Invalid file path, " + tf_file + " does not exist.");
   }
 
-  std::ifstream reader;
-  reader.open(realpath.value());
+  TFRecordReader reader;
+  RETURN_IF_NOT_OK(reader.Open(realpath.value()));
 
   // read length
   int64_t record_length = 0;
-  (void)reader.read(reinterpret_cast<char *>(&record_length), static_cast<std::streamsize>(sizeof(int64_t)));
+  RETURN_IF_NOT_OK(reader.Read(reinterpret_cast<char *>(&record_length), static_cast<int64_t>(sizeof(int64_t))));
 
   // ignore crc header
-  (void)reader.ignore(static_cast<std::streamsize>(sizeof(int32_t)));
+  RETURN_IF_NOT_OK(reader.Skip(static_cast<int64_t>(sizeof(int32_t))));
 
   // read serialized Example
   std::string serialized_example;
   serialized_example.resize(record_length);
-  (void)reader.read(&serialized_example[0], static_cast<std::streamsize>(record_length));
+  RETURN_IF_NOT_OK(reader.Read(&serialized_example[0], record_length));
 
   dataengine::Example example;
   if (!example.ParseFromString(serialized_example)) {
@@ -697,26 +702,30 @@ int64_t TFReaderOp::CountTotalRowsSectioned(const std::vector<std::string> &file
       continue;
     }
 
-    std::ifstream reader;
-    reader.open(realpath.value());
-    if (!reader) {
+    TFRecordReader reader;
+    if (reader.Open(realpath.value()).IsError()) {
       MS_LOG(DEBUG) << "TFReader operator failed to open file " << filenames[i] << ".";
+      continue;
     }
 
-    while (reader.peek() != EOF) {
-      // read length
+    while (true) {
+      bool eof = false;
       int64_t record_length = 0;
-      (void)reader.read(reinterpret_cast<char *>(&record_length), static_cast<std::streamsize>(sizeof(int64_t)));
-
-      // ignore crc header
-      (void)reader.ignore(static_cast<std::streamsize>(sizeof(int32_t)));
-
-      // ignore tf_file contents
-      (void)reader.ignore(static_cast<std::streamsize>(record_length));
-
-      // ignore crc footer
-      (void)reader.ignore(static_cast<std::streamsize>(sizeof(int32_t)));
-
+      // read length, ignore crc header, tf_file contents and crc footer
+      Status rc = reader.Eof(&eof);
+      if (rc.IsOk() && !eof) {
+        rc = reader.Read(reinterpret_cast<char *>(&record_length), static_cast<int64_t>(sizeof(int64_t)));
+      }
+      if (rc.IsOk() && !eof) {
+        rc = reader.Skip(static_cast<int64_t>(sizeof(int32_t)) + record_length + static_cast<int64_t>(sizeof(int32_t)));
+      }
+      if (rc.IsError()) {
+        MS_LOG(WARNING) << "TFReader operator failed to count the rows of file " << filenames[i] << ", " << rc;
+        break;
+      }
+      if (eof) {
+        break;
+      }
       rows_read++;
     }
   }
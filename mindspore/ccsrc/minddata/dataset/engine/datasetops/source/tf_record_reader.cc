@@ -0,0 +1,200 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "minddata/dataset/engine/datasetops/source/tf_record_reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils/system/crc32c.h"
+
+namespace mindspore {
+namespace dataset {
+namespace {
+// large enough that a worker reads the file with few syscalls, a reader holds up to three such buffers
+constexpr int64_t kTFRecordReadBufferSize = 2 * 1024 * 1024;
+constexpr uint8_t kGzipMagic0 = 0x1f;
+constexpr uint8_t kGzipMagic1 = 0x8b;
+constexpr uint8_t kZlibMethodMask = 0x0f;
+constexpr uint8_t kZlibMethodDeflate = 8;
+constexpr int kZlibHeaderCheckBase = 31;
+constexpr int kByteBits = 8;
+#ifdef ENABLE_ZLIB
+// adding 32 to the window bits makes zlib detect the GZIP or ZLIB header by itself
+constexpr int kZlibAutoDetectHeader = 32;
+#endif
+
+int64_t ReadChunk(std::ifstream *file, std::vector<char> *buf) {
+  (void)file->read(buf->data(), static_cast<std::streamsize>(buf->size()));
+  return static_cast<int64_t>(file->gcount());
+}
+}  // namespace
+
+TFRecordReader::~TFRecordReader() {
+  if (next_read_.valid()) {
+    next_read_.wait();
+  }
+#ifdef ENABLE_ZLIB
+  if (strm_inited_) {
+    (void)inflateEnd(&strm_);
+  }
+#endif
+}
+
+Status TFRecordReader::Open(const std::string &file_path) {
+  file_path_ = file_path;
+  file_.open(file_path, std::ios::in | std::ios::binary);
+  if (!file_.is_open()) {
+    RETURN_STATUS_UNEXPECTED("Invalid file, " + file_path + " open failed: permission denied!");
+  }
+  file_size_ = static_cast<int64_t>(file_.seekg(0, std::ios::end).tellg());
+  (void)file_.seekg(0, std::ios::beg);
+
+  // the first chunk is read without read ahead, since a reader may only need the first record
+  raw_buf_.resize(kTFRecordReadBufferSize);
+  FillRaw(false);
+  compressed_ = DetectCompression();
+  if (!compressed_) {
+    return Status::OK();
+  }
+#ifdef ENABLE_ZLIB
+  out_buf_.resize(kTFRecordReadBufferSize);
+  if (inflateInit2(&strm_, MAX_WBITS + kZlibAutoDetectHeader) != Z_OK) {
+    RETURN_STATUS_UNEXPECTED("Invalid file, failed to init the decompressor of " + file_path + ".");
+  }
+  strm_inited_ = true;
+  strm_.next_in = reinterpret_cast<Bytef *>(raw_buf_.data());
+  strm_.avail_in = static_cast<uInt>(raw_len_);
+  raw_pos_ = raw_len_;
+  return Status::OK();
+#else
+  RETURN_STATUS_UNEXPECTED("Invalid file, " + file_path +
+                           " is compressed by GZIP or ZLIB, which is not supported on this platform.");
+#endif
+}
+
+void TFRecordReader::FillRaw(bool read_ahead) {
+  raw_pos_ = 0;
+  raw_len_ = 0;
+  if (next_read_.valid()) {
+    raw_len_ = next_read_.get();
+    raw_buf_.swap(next_buf_);
+  } else if (!raw_eof_) {
+    raw_len_ = ReadChunk(&file_, &raw_buf_);
+  }
+  if (raw_len_ <= 0) {
+    raw_len_ = 0;
+    raw_eof_ = true;
+    return;
+  }
+  if (read_ahead && file_.good()) {
+    next_buf_.resize(kTFRecordReadBufferSize);
+    next_read_ = std::async(std::launch::async, [this]() { return ReadChunk(&file_, &next_buf_); });
+  }
+}
+
+bool TFRecordReader::DetectCompression() const {
+  if (raw_len_ < static_cast<int64_t>(sizeof(int64_t) + sizeof(uint32_t))) {
+    return false;
+  }
+  // an uncompressed file starts with the length of the first record followed by its masked crc
+  uint32_t masked_crc = 0;
+  (void)std::memcpy(&masked_crc, raw_buf_.data() + sizeof(int64_t), sizeof(uint32_t));
+  if (masked_crc == system::Crc32c::GetMaskCrc32cValue(raw_buf_.data(), sizeof(int64_t))) {
+    return false;
+  }
+  auto header = reinterpret_cast<const uint8_t *>(raw_buf_.data());
+  bool is_gzip = header[0] == kGzipMagic0 && header[1] == kGzipMagic1;
+  bool is_zlib = (header[0] & kZlibMethodMask) == kZlibMethodDeflate &&
+                 ((static_cast<int>(header[0]) << kByteBits) | header[1]) % kZlibHeaderCheckBase == 0;
+  return is_gzip || is_zlib;
+}
+
+Status TFRecordReader::Fill(bool *eof) {
+  RETURN_UNEXPECTED_IF_NULL(eof);
+  if (!compressed_) {
+    if (raw_pos_ >= raw_len_ && !raw_eof_) {
+      FillRaw(true);
+    }
+    *eof = raw_pos_ >= raw_len_;
+    return Status::OK();
+  }
+#ifdef ENABLE_ZLIB
+  while (out_pos_ >= out_len_) {
+    if (strm_.avail_in == 0 && !raw_eof_) {
+      FillRaw(true);
+      strm_.next_in = reinterpret_cast<Bytef *>(raw_buf_.data());
+      strm_.avail_in = static_cast<uInt>(raw_len_);
+      raw_pos_ = raw_len_;
+    }
+    if (strm_.avail_in == 0) {
+      CHECK_FAIL_RETURN_UNEXPECTED(strm_end_, "Invalid file, " + file_path_ + " is truncated, failed to decompress it.");
+      *eof = true;
+      return Status::OK();
+    }
+    if (strm_end_) {
+      // a GZIP file may hold several members one after another
+      CHECK_FAIL_RETURN_UNEXPECTED(inflateReset(&strm_) == Z_OK,
+                                   "Invalid file, failed to reset the decompressor of " + file_path_ + ".");
+      strm_end_ = false;
+    }
+    strm_.next_out = reinterpret_cast<Bytef *>(out_buf_.data());
+    strm_.avail_out = static_cast<uInt>(out_buf_.size());
+    int ret = inflate(&strm_, Z_NO_FLUSH);
+    if (ret == Z_STREAM_END) {
+      strm_end_ = true;
+    } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+      std::string msg = strm_.msg == nullptr ? std::to_string(ret) : strm_.msg;
+      RETURN_STATUS_UNEXPECTED("Invalid file, failed to decompress " + file_path_ + ", " + msg + ".");
+    }
+    out_pos_ = 0;
+    out_len_ = static_cast<int64_t>(out_buf_.size()) - strm_.avail_out;
+  }
+#endif
+  *eof = false;
+  return Status::OK();
+}
+
+Status TFRecordReader::Eof(bool *eof) { return Fill(eof); }
+
+Status TFRecordReader::Read(char *dst, int64_t len) {
+  while (len > 0) {
+    bool eof = false;
+    RETURN_IF_NOT_OK(Fill(&eof));
+    CHECK_FAIL_RETURN_UNEXPECTED(!eof, "Invalid file, " + file_path_ + " is truncated, the last record is incomplete.");
+    const char *src = raw_buf_.data() + raw_pos_;
+    int64_t *pos = &raw_pos_;
+    int64_t avail = raw_len_ - raw_pos_;
+#ifdef ENABLE_ZLIB
+    if (compressed_) {
+      src = out_buf_.data() + out_pos_;
+      pos = &out_pos_;
+      avail = out_len_ - out_pos_;
+    }
+#endif
+    int64_t n = std::min(avail, len);
+    if (dst != nullptr) {
+      (void)std::copy_n(src, n, dst);
+      dst += n;
+    }
+    *pos += n;
+    len -= n;
+  }
+  return Status::OK();
+}
+
+Status TFRecordReader::Skip(int64_t len) { return Read(nullptr, len); }
+}  // namespace dataset
+}  // namespace mindspore
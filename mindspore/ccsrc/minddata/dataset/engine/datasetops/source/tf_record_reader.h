@@ -0,0 +1,107 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_DATASETOPS_SOURCE_TF_RECORD_READER_H_
+#define MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_DATASETOPS_SOURCE_TF_RECORD_READER_H_
+
+#include <fstream>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "minddata/dataset/util/status.h"
+
+#ifdef ENABLE_ZLIB
+#include "zlib.h"
+#endif
+
+namespace mindspore {
+namespace dataset {
+/// \brief Reads the bytes of a TFRecord file through a large buffer. A file compressed by GZIP or ZLIB is detected
+///     from its first bytes and inflated while it is read, so the records of compressed and uncompressed files are
+///     read the same way. The next chunk of the file is read by another thread while the current one is consumed.
+class TFRecordReader {
+ public:
+  TFRecordReader() = default;
+
+  ~TFRecordReader();
+
+  /// \brief Open the file and detect its compression type.
+  /// \param[in] file_path The real path of the TFRecord file.
+  /// \return Status The status code returned.
+  Status Open(const std::string &file_path);
+
+  /// \brief Check whether all the bytes of the file are read.
+  /// \param[out] eof True if there is no more byte to read.
+  /// \return Status The status code returned.
+  Status Eof(bool *eof);
+
+  /// \brief Read exactly len bytes, fails if the file ends before.
+  /// \param[out] dst The buffer to read into, the bytes are skipped if it is nullptr.
+  /// \param[in] len The number of bytes to read.
+  /// \return Status The status code returned.
+  Status Read(char *dst, int64_t len);
+
+  /// \brief Skip exactly len bytes, fails if the file ends before.
+  /// \param[in] len The number of bytes to skip.
+  /// \return Status The status code returned.
+  Status Skip(int64_t len);
+
+  /// \brief The size of the file on disk.
+  int64_t FileSize() const { return file_size_; }
+
+  /// \brief Whether the file is compressed by GZIP or ZLIB.
+  bool IsCompressed() const { return compressed_; }
+
+ private:
+  /// \brief Make the bytes to read non empty, unless the file ends.
+  Status Fill(bool *eof);
+
+  /// \brief Replace the consumed raw bytes with the next chunk of the file.
+  /// \param[in] read_ahead Start reading the chunk after it in another thread.
+  void FillRaw(bool read_ahead);
+
+  /// \brief Whether the first bytes of the file are the header of a compressed stream.
+  bool DetectCompression() const;
+
+  std::string file_path_;
+  std::ifstream file_;
+  int64_t file_size_ = 0;
+  bool compressed_ = false;
+
+  // the chunk of the file being consumed
+  std::vector<char> raw_buf_;
+  int64_t raw_pos_ = 0;
+  int64_t raw_len_ = 0;
+  bool raw_eof_ = false;
+
+#ifdef ENABLE_ZLIB
+  // the bytes inflated from the raw chunk
+  std::vector<char> out_buf_;
+  int64_t out_pos_ = 0;
+  int64_t out_len_ = 0;
+  z_stream strm_{};
+  bool strm_inited_ = false;
+  bool strm_end_ = false;
+#endif
+
+  // the chunk read ahead by another thread, declared last so the read finishes before the buffers are freed
+  std::vector<char> next_buf_;
+  std::future<int64_t> next_read_;
+};
+}  // namespace dataset
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_DATASETOPS_SOURCE_TF_RECORD_READER_H_
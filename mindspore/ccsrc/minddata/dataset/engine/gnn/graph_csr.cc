@@ -0,0 +1,671 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "minddata/dataset/engine/gnn/graph_csr.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+#include "securec.h"
+
+namespace mindspore {
+namespace dataset {
+namespace gnn {
+namespace {
+constexpr char kCsrMagic[] = "MSGNNCSR";
+constexpr int64_t kCsrMagicLen = 8;
+constexpr int64_t kCsrVersion = 3;
+constexpr int64_t kCsrAlign = 8;
+
+// Writes the image of the store, every array starts at a multiple of kCsrAlign
+class ImageWriter {
+ public:
+  explicit ImageWriter(std::ofstream *out) : out_(out), pos_(0) {}
+
+  void PutInt(int64_t v) { PutArray(&v, 1); }
+
+  template <typename T>
+  void PutArray(const T *data, size_t n) {
+    if (n > 0) {
+      (void)out_->write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(n * sizeof(T)));
+      pos_ += n * sizeof(T);
+    }
+    static const char kPadding[kCsrAlign] = {0};
+    size_t pad = (kCsrAlign - pos_ % kCsrAlign) % kCsrAlign;
+    (void)out_->write(kPadding, static_cast<std::streamsize>(pad));
+    pos_ += pad;
+  }
+
+ private:
+  std::ofstream *out_;
+  size_t pos_;
+};
+
+// Build the alias table of one node over the weights of its neighbors (Vose's method). A node whose weights are all
+// zero is sampled uniformly, the same as std::discrete_distribution does.
+void BuildAliasTable(const WeightType *weights, int64_t n, float *prob, int32_t *alias, std::vector<double> *scaled,
+                     std::vector<int32_t> *small, std::vector<int32_t> *large) {
+  double sum = 0;
+  for (int64_t i = 0; i < n; ++i) {
+    sum += std::max<double>(weights[i], 0);
+  }
+  scaled->resize(n);
+  small->clear();
+  large->clear();
+  for (int64_t i = 0; i < n; ++i) {
+    (*scaled)[i] = sum > 0 ? std::max<double>(weights[i], 0) * n / sum : 1.0;
+    ((*scaled)[i] < 1.0 ? small : large)->push_back(static_cast<int32_t>(i));
+  }
+  while (!small->empty() && !large->empty()) {
+    int32_t s = small->back();
+    small->pop_back();
+    int32_t l = large->back();
+    large->pop_back();
+    prob[s] = static_cast<float>((*scaled)[s]);
+    alias[s] = l;
+    (*scaled)[l] += (*scaled)[s] - 1.0;
+    ((*scaled)[l] < 1.0 ? small : large)->push_back(l);
+  }
+  // What is left is 1 up to rounding errors
+  for (int32_t i : *small) {
+    prob[i] = 1.0;
+    alias[i] = i;
+  }
+  for (int32_t i : *large) {
+    prob[i] = 1.0;
+    alias[i] = i;
+  }
+}
+
+// Reads the image back, the arrays point into the image
+class ImageReader {
+ public:
+  ImageReader(const uint8_t *base, size_t size) : base_(base), size_(size), pos_(0) {}
+
+  Status GetInt(int64_t *v) {
+    const int64_t *p = nullptr;
+    RETURN_IF_NOT_OK(GetArray(1, &p));
+    *v = *p;
+    return Status::OK();
+  }
+
+  template <typename T>
+  Status GetArray(int64_t n, const T **out) {
+    CHECK_FAIL_RETURN_UNEXPECTED(n >= 0 && static_cast<size_t>(n) <= (size_ - pos_) / sizeof(T),
+                                 "Invalid graph store file, it is truncated.");
+    *out = reinterpret_cast<const T *>(base_ + pos_);
+    pos_ += n * sizeof(T);
+    pos_ += (kCsrAlign - pos_ % kCsrAlign) % kCsrAlign;
+    pos_ = std::min(pos_, size_);
+    return Status::OK();
+  }
+
+ private:
+  const uint8_t *base_;
+  size_t size_;
+  size_t pos_;
+};
+}  // namespace
+
+GraphCsr::~GraphCsr() { Unmap(); }
+
+Status GraphCsr::Build(const NodeMap &nodes, const std::vector<std::shared_ptr<Edge>> &edges) {
+  Unmap();
+  adjacency_.clear();
+  features_.clear();
+  source_.clear();
+  std::vector<NodeIdType> ids;
+  ids.reserve(nodes.size());
+  for (const auto &node : nodes) {
+    ids.push_back(node.first);
+  }
+  std::sort(ids.begin(), ids.end());
+  node_ids_.Assign(std::move(ids));
+  num_edges_ = static_cast<int64_t>(edges.size());
+  const size_t num_nodes = node_ids_.size();
+
+  // Count the neighbors of each node first, then fill in the neighbors in the load order of the edges.
+  std::vector<std::pair<int64_t, NodeType>> edge_src(edges.size());
+  std::unordered_map<NodeType, std::vector<int64_t>> offsets;
+  for (size_t i = 0; i < edges.size(); ++i) {
+    std::pair<std::shared_ptr<Node>, std::shared_ptr<Node>> p;
+    RETURN_IF_NOT_OK(edges[i]->GetNode(&p));
+    int64_t src = 0;
+    RETURN_IF_NOT_OK(GetNodeIndex(p.first->id(), &src));
+    NodeType neighbor_type = p.second->type();
+    auto &count = offsets[neighbor_type];
+    if (count.empty()) {
+      count.resize(num_nodes + 1, 0);
+    }
+    ++count[src + 1];
+    edge_src[i] = {src, neighbor_type};
+  }
+  std::unordered_map<NodeType, std::vector<int64_t>> next;
+  std::unordered_map<NodeType, std::vector<NodeIdType>> neighbors;
+  std::unordered_map<NodeType, std::vector<WeightType>> weights;
+  std::unordered_map<NodeType, std::vector<EdgeIdType>> edge_ids;
+  for (auto &itr : offsets) {
+    std::partial_sum(itr.second.begin(), itr.second.end(), itr.second.begin());
+    next[itr.first].assign(itr.second.begin(), itr.second.end() - 1);
+    neighbors[itr.first].resize(itr.second.back());
+    weights[itr.first].resize(itr.second.back());
+    edge_ids[itr.first].resize(itr.second.back());
+  }
+  for (size_t i = 0; i < edges.size(); ++i) {
+    std::pair<std::shared_ptr<Node>, std::shared_ptr<Node>> p;
+    RETURN_IF_NOT_OK(edges[i]->GetNode(&p));
+    NodeType neighbor_type = edge_src[i].second;
+    int64_t pos = next[neighbor_type][edge_src[i].first]++;
+    neighbors[neighbor_type][pos] = p.second->id();
+    weights[neighbor_type][pos] = edges[i]->weight();
+    edge_ids[neighbor_type][pos] = edges[i]->id();
+  }
+  std::vector<double> scaled;
+  std::vector<int32_t> small;
+  std::vector<int32_t> large;
+  for (auto &itr : offsets) {
+    const auto &offset = itr.second;
+    const auto &weight = weights[itr.first];
+    std::vector<float> alias_prob(weight.size());
+    std::vector<int32_t> alias_index(weight.size());
+    std::vector<NodeIdType> sorted_neighbors = neighbors[itr.first];
+    for (size_t i = 0; i < num_nodes; ++i) {
+      int64_t begin = offset[i];
+      int64_t end = offset[i + 1];
+      BuildAliasTable(weight.data() + begin, end - begin, alias_prob.data() + begin, alias_index.data() + begin,
+                      &scaled, &small, &large);
+      std::sort(sorted_neighbors.begin() + begin, sorted_neighbors.begin() + end);
+    }
+    auto &adj = adjacency_[itr.first];
+    adj.alias_prob.Assign(std::move(alias_prob));
+    adj.alias_index.Assign(std::move(alias_index));
+    adj.sorted_neighbors.Assign(std::move(sorted_neighbors));
+    adj.offsets.Assign(std::move(itr.second));
+    adj.neighbors.Assign(std::move(neighbors[itr.first]));
+    adj.weights.Assign(std::move(weights[itr.first]));
+    adj.edge_ids.Assign(std::move(edge_ids[itr.first]));
+  }
+  return Status::OK();
+}
+
+Status GraphCsr::BuildNodeFeature(FeatureType feature_type, const NodeMap &nodes, bool persistent, bool *built) {
+  RETURN_UNEXPECTED_IF_NULL(built);
+  *built = false;
+  const size_t num_nodes = node_ids_.size();
+  std::vector<std::shared_ptr<Tensor>> values(num_nodes);
+  std::shared_ptr<Tensor> first;
+  int32_t num_rows = 0;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    auto itr = nodes.find(node_ids_[i]);
+    CHECK_FAIL_RETURN_UNEXPECTED(itr != nodes.end(), "Invalid node id:" + std::to_string(node_ids_[i]));
+    std::shared_ptr<Feature> feature;
+    if (!itr->second->GetFeatures(feature_type, &feature).IsOk()) {
+      continue;
+    }
+    values[i] = feature->Value();
+    if (first == nullptr) {
+      first = values[i];
+      if (!first->type().IsNumeric()) {
+        return Status::OK();
+      }
+    } else if (values[i]->type() != first->type() || !(values[i]->shape() == first->shape())) {
+      // The nodes don't agree on the feature, keep it in the nodes.
+      return Status::OK();
+    }
+    ++num_rows;
+  }
+  if (first == nullptr) {
+    return Status::OK();
+  }
+
+  FeatureMatrix matrix;
+  matrix.type = first->type();
+  matrix.shape = first->shape().AsVector();
+  matrix.row_bytes = first->SizeInBytes();
+  matrix.persistent = persistent;
+  std::vector<int32_t> rows(num_nodes, -1);
+  std::vector<uint8_t> data(static_cast<size_t>(num_rows) * matrix.row_bytes);
+  int32_t row = 0;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (values[i] == nullptr) {
+      continue;
+    }
+    if (matrix.row_bytes > 0) {
+      CHECK_FAIL_RETURN_UNEXPECTED(memcpy_s(data.data() + row * matrix.row_bytes, matrix.row_bytes,
+                                            values[i]->GetBuffer(), matrix.row_bytes) == EOK,
+                                   "Failed to copy the feature of node " + std::to_string(node_ids_[i]));
+    }
+    rows[i] = row++;
+  }
+  matrix.rows.Assign(std::move(rows));
+  matrix.data.Assign(std::move(data));
+  features_[feature_type] = std::move(matrix);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (values[i] != nullptr) {
+      RETURN_IF_NOT_OK(nodes.at(node_ids_[i])->RemoveFeature(feature_type));
+    }
+  }
+  *built = true;
+  return Status::OK();
+}
+
+Status GraphCsr::Save(const std::string &path, const std::string &source) const {
+  // Write to a temporary file first, so that no reader maps a half written file.
+  std::string tmp_path = path + ".tmp";
+  std::ofstream out(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  CHECK_FAIL_RETURN_UNEXPECTED(out.is_open(), "Failed to open " + tmp_path + " to save the graph store.");
+  ImageWriter writer(&out);
+  writer.PutArray(kCsrMagic, kCsrMagicLen);
+  writer.PutInt(kCsrVersion);
+  writer.PutInt(static_cast<int64_t>(source.size()));
+  writer.PutArray(source.data(), source.size());
+  writer.PutInt(NumNodes());
+  writer.PutInt(num_edges_);
+  writer.PutArray(node_ids_.data(), node_ids_.size());
+  writer.PutInt(static_cast<int64_t>(adjacency_.size()));
+  for (const auto &itr : adjacency_) {
+    const auto &adj = itr.second;
+    writer.PutInt(itr.first);
+    writer.PutInt(static_cast<int64_t>(adj.neighbors.size()));
+    writer.PutArray(adj.offsets.data(), adj.offsets.size());
+    writer.PutArray(adj.neighbors.data(), adj.neighbors.size());
+    writer.PutArray(adj.weights.data(), adj.weights.size());
+    writer.PutArray(adj.edge_ids.data(), adj.edge_ids.size());
+    writer.PutArray(adj.alias_prob.data(), adj.alias_prob.size());
+    writer.PutArray(adj.alias_index.data(), adj.alias_index.size());
+    writer.PutArray(adj.sorted_neighbors.data(), adj.sorted_neighbors.size());
+  }
+  int64_t num_features = std::count_if(features_.begin(), features_.end(),
+                                       [](const auto &itr) { return itr.second.persistent; });
+  writer.PutInt(num_features);
+  for (const auto &itr : features_) {
+    const auto &matrix = itr.second;
+    if (!matrix.persistent) {
+      continue;
+    }
+    writer.PutInt(itr.first);
+    writer.PutInt(static_cast<int64_t>(matrix.type.value()));
+    writer.PutInt(static_cast<int64_t>(matrix.shape.size()));
+    writer.PutArray(matrix.shape.data(), matrix.shape.size());
+    writer.PutInt(matrix.row_bytes);
+    writer.PutInt(static_cast<int64_t>(matrix.data.size()));
+    writer.PutArray(matrix.rows.data(), matrix.rows.size());
+    writer.PutArray(matrix.data.data(), matrix.data.size());
+  }
+  out.close();
+  if (out.fail()) {
+    (void)std::remove(tmp_path.c_str());
+    RETURN_STATUS_UNEXPECTED("Failed to write the graph store to " + tmp_path);
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    (void)std::remove(tmp_path.c_str());
+    RETURN_STATUS_UNEXPECTED("Failed to rename " + tmp_path + " to " + path);
+  }
+  return Status::OK();
+}
+
+Status GraphCsr::Load(const std::string &path) {
+  Unmap();
+  const uint8_t *base = nullptr;
+  size_t size = 0;
+#if !defined(_WIN32) && !defined(_WIN64)
+  int fd = open(path.c_str(), O_RDONLY);
+  CHECK_FAIL_RETURN_UNEXPECTED(fd >= 0, "Failed to open the graph store " + path);
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    (void)close(fd);
+    RETURN_STATUS_UNEXPECTED("Invalid graph store file, " + path + " is empty.");
+  }
+  void *addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  (void)close(fd);
+  CHECK_FAIL_RETURN_UNEXPECTED(addr != MAP_FAILED, "Failed to map the graph store " + path);
+  mapped_addr_ = addr;
+  mapped_size_ = static_cast<size_t>(st.st_size);
+  base = static_cast<const uint8_t *>(addr);
+  size = mapped_size_;
+#else
+  std::ifstream in(path, std::ios::in | std::ios::binary);
+  CHECK_FAIL_RETURN_UNEXPECTED(in.is_open(), "Failed to open the graph store " + path);
+  file_buf_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  base = file_buf_.data();
+  size = file_buf_.size();
+#endif
+  Status rc = Parse(base, size);
+  if (rc.IsError()) {
+    Unmap();
+    return rc;
+  }
+  return Status::OK();
+}
+
+Status GraphCsr::Parse(const uint8_t *base, size_t size) {
+  adjacency_.clear();
+  features_.clear();
+  ImageReader reader(base, size);
+  const char *magic = nullptr;
+  RETURN_IF_NOT_OK(reader.GetArray(kCsrMagicLen, &magic));
+  CHECK_FAIL_RETURN_UNEXPECTED(std::memcmp(magic, kCsrMagic, kCsrMagicLen) == 0, "Invalid graph store file.");
+  int64_t version = 0;
+  RETURN_IF_NOT_OK(reader.GetInt(&version));
+  CHECK_FAIL_RETURN_UNEXPECTED(version == kCsrVersion,
+                               "Unsupported graph store version: " + std::to_string(version) + ".");
+  int64_t source_len = 0;
+  const char *source = nullptr;
+  RETURN_IF_NOT_OK(reader.GetInt(&source_len));
+  RETURN_IF_NOT_OK(reader.GetArray(source_len, &source));
+  source_.assign(source, source_len);
+  int64_t num_nodes = 0;
+  RETURN_IF_NOT_OK(reader.GetInt(&num_nodes));
+  RETURN_IF_NOT_OK(reader.GetInt(&num_edges_));
+  CHECK_FAIL_RETURN_UNEXPECTED(num_nodes >= 0 && num_nodes <= std::numeric_limits<int32_t>::max() && num_edges_ >= 0,
+                               "Invalid graph store file, bad number of nodes or edges.");
+  const NodeIdType *ids = nullptr;
+  RETURN_IF_NOT_OK(reader.GetArray(num_nodes, &ids));
+  // The node index is found by a binary search over the ids
+  for (int64_t n = 1; n < num_nodes; ++n) {
+    CHECK_FAIL_RETURN_UNEXPECTED(ids[n - 1] < ids[n], "Invalid graph store file, the node ids are not sorted.");
+  }
+  node_ids_.Map(ids, num_nodes);
+
+  int64_t num_types = 0;
+  RETURN_IF_NOT_OK(reader.GetInt(&num_types));
+  for (int64_t i = 0; i < num_types; ++i) {
+    int64_t type = 0;
+    int64_t num_neighbors = 0;
+    RETURN_IF_NOT_OK(reader.GetInt(&type));
+    RETURN_IF_NOT_OK(reader.GetInt(&num_neighbors));
+    const int64_t *offsets = nullptr;
+    const NodeIdType *neighbors = nullptr;
+    const WeightType *weights = nullptr;
+    const EdgeIdType *edge_ids = nullptr;
+    const float *alias_prob = nullptr;
+    const int32_t *alias_index = nullptr;
+    const NodeIdType *sorted_neighbors = nullptr;
+    RETURN_IF_NOT_OK(reader.GetArray(num_nodes + 1, &offsets));
+    RETURN_IF_NOT_OK(reader.GetArray(num_neighbors, &neighbors));
+    RETURN_IF_NOT_OK(reader.GetArray(num_neighbors, &weights));
+    RETURN_IF_NOT_OK(reader.GetArray(num_neighbors, &edge_ids));
+    RETURN_IF_NOT_OK(reader.GetArray(num_neighbors, &alias_prob));
+    RETURN_IF_NOT_OK(reader.GetArray(num_neighbors, &alias_index));
+    RETURN_IF_NOT_OK(reader.GetArray(num_neighbors, &sorted_neighbors));
+    // Check every index the queries follow, so that a corrupt file fails here instead of reading out of bounds later
+    CHECK_FAIL_RETURN_UNEXPECTED(offsets[0] == 0 && offsets[num_nodes] == num_neighbors,
+                                 "Invalid graph store file, bad offsets.");
+    for (int64_t n = 0; n < num_nodes; ++n) {
+      int64_t begin = offsets[n];
+      int64_t end = offsets[n + 1];
+      CHECK_FAIL_RETURN_UNEXPECTED(begin <= end && end <= num_neighbors, "Invalid graph store file, bad offsets.");
+      for (int64_t k = begin; k < end; ++k) {
+        CHECK_FAIL_RETURN_UNEXPECTED(alias_index[k] >= 0 && alias_index[k] < end - begin,
+                                     "Invalid graph store file, bad alias table.");
+        CHECK_FAIL_RETURN_UNEXPECTED(k == begin || sorted_neighbors[k - 1] <= sorted_neighbors[k],
+                                     "Invalid graph store file, the neighbors are not sorted.");
+      }
+    }
+    auto &adj = adjacency_[static_cast<NodeType>(type)];
+    adj.offsets.Map(offsets, num_nodes + 1);
+    adj.neighbors.Map(neighbors, num_neighbors);
+    adj.weights.Map(weights, num_neighbors);
+    adj.edge_ids.Map(edge_ids, num_neighbors);
+    adj.alias_prob.Map(alias_prob, num_neighbors);
+    adj.alias_index.Map(alias_index, num_neighbors);
+    adj.sorted_neighbors.Map(sorted_neighbors, num_neighbors);
+  }
+
+  int64_t num_features = 0;
+  RETURN_IF_NOT_OK(reader.GetInt(&num_features));
+  for (int64_t i = 0; i < num_features; ++i) {
+    int64_t type = 0;
+    int64_t data_type = 0;
+    int64_t rank = 0;
+    int64_t data_size = 0;
+    FeatureMatrix matrix;
+    RETURN_IF_NOT_OK(reader.GetInt(&type));
+    RETURN_IF_NOT_OK(reader.GetInt(&data_type));
+    CHECK_FAIL_RETURN_UNEXPECTED(data_type > DataType::DE_UNKNOWN && data_type < DataType::DE_STRING,
+                                 "Invalid graph store file, bad feature type.");
+    matrix.type = DataType(static_cast<DataType::Type>(data_type));
+    RETURN_IF_NOT_OK(reader.GetInt(&rank));
+    const int64_t *shape = nullptr;
+    RETURN_IF_NOT_OK(reader.GetArray(rank, &shape));
+    // The row size is computed from the shape, and every product is bounded by the file size to rule out overflow
+    int64_t row_bytes = matrix.type.SizeInBytes();
+    for (int64_t d = 0; d < rank; ++d) {
+      bool dim_ok = shape[d] >= 0 && (shape[d] == 0 || row_bytes <= static_cast<int64_t>(size) / shape[d]);
+      CHECK_FAIL_RETURN_UNEXPECTED(dim_ok, "Invalid graph store file, bad feature shape.");
+      row_bytes *= shape[d];
+    }
+    RETURN_IF_NOT_OK(reader.GetInt(&matrix.row_bytes));
+    CHECK_FAIL_RETURN_UNEXPECTED(matrix.row_bytes == row_bytes, "Invalid graph store file, bad feature row size.");
+    RETURN_IF_NOT_OK(reader.GetInt(&data_size));
+    const int32_t *rows = nullptr;
+    const uint8_t *data = nullptr;
+    RETURN_IF_NOT_OK(reader.GetArray(num_nodes, &rows));
+    RETURN_IF_NOT_OK(reader.GetArray(data_size, &data));
+    // The rows are given to the nodes that have the feature in turn, so they are below the number of such nodes
+    int64_t num_rows = std::count_if(rows, rows + num_nodes, [](int32_t r) { return r >= 0; });
+    for (int64_t n = 0; n < num_nodes; ++n) {
+      CHECK_FAIL_RETURN_UNEXPECTED(rows[n] >= -1 && rows[n] < num_rows, "Invalid graph store file, bad feature row.");
+    }
+    bool size_ok = row_bytes == 0 ? data_size == 0 : data_size % row_bytes == 0 && data_size / row_bytes == num_rows;
+    CHECK_FAIL_RETURN_UNEXPECTED(size_ok, "Invalid graph store file, bad feature size.");
+    matrix.shape.assign(shape, shape + rank);
+    matrix.rows.Map(rows, num_nodes);
+    matrix.data.Map(data, data_size);
+    features_[static_cast<FeatureType>(type)] = std::move(matrix);
+  }
+  return Status::OK();
+}
+
+void GraphCsr::Unmap() {
+#if !defined(_WIN32) && !defined(_WIN64)
+  if (mapped_addr_ != nullptr) {
+    (void)munmap(mapped_addr_, mapped_size_);
+  }
+#endif
+  mapped_addr_ = nullptr;
+  mapped_size_ = 0;
+  file_buf_.clear();
+  file_buf_.shrink_to_fit();
+}
+
+bool GraphCsr::Match(const NodeMap &nodes, int64_t num_edges, const std::string &source) const {
+  if (source_ != source || node_ids_.size() != nodes.size() || num_edges_ != num_edges) {
+    return false;
+  }
+  for (size_t i = 0; i < node_ids_.size(); ++i) {
+    if (nodes.find(node_ids_[i]) == nodes.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<FeatureType> GraphCsr::NodeFeatureTypes() const {
+  std::vector<FeatureType> types;
+  for (const auto &itr : features_) {
+    types.push_back(itr.first);
+  }
+  return types;
+}
+
+Status GraphCsr::GetNodeIndex(NodeIdType id, int64_t *index) const {
+  auto begin = node_ids_.data();
+  auto end = begin + node_ids_.size();
+  auto itr = std::lower_bound(begin, end, id);
+  if (itr == end || *itr != id) {
+    std::string err_msg = "Invalid node id:" + std::to_string(id);
+    RETURN_STATUS_UNEXPECTED(err_msg);
+  }
+  *index = itr - begin;
+  return Status::OK();
+}
+
+Status GraphCsr::GetAllNeighbors(NodeIdType id, NodeType neighbor_type, std::vector<NodeIdType> *out_neighbors,
+                                 bool exclude_itself) const {
+  RETURN_UNEXPECTED_IF_NULL(out_neighbors);
+  int64_t index = 0;
+  RETURN_IF_NOT_OK(GetNodeIndex(id, &index));
+  std::vector<NodeIdType> neighbors;
+  if (!exclude_itself) {
+    neighbors.emplace_back(id);
+  }
+  auto itr = adjacency_.find(neighbor_type);
+  if (itr != adjacency_.end()) {
+    const auto &adj = itr->second;
+    neighbors.insert(neighbors.end(), adj.neighbors.data() + adj.offsets[index],
+                     adj.neighbors.data() + adj.offsets[index + 1]);
+  } else {
+    MS_LOG(DEBUG) << "No neighbors. node_id:" << id << " neighbor_type:" << neighbor_type;
+  }
+  *out_neighbors = std::move(neighbors);
+  return Status::OK();
+}
+
+Status GraphCsr::GetSampledNeighbors(NodeIdType id, NodeType neighbor_type, int32_t samples_num,
+                                     SamplingStrategy strategy, std::mt19937 *rnd,
+                                     std::vector<NodeIdType> *out_neighbors) const {
+  RETURN_UNEXPECTED_IF_NULL(rnd);
+  RETURN_UNEXPECTED_IF_NULL(out_neighbors);
+  int64_t index = 0;
+  RETURN_IF_NOT_OK(GetNodeIndex(id, &index));
+  auto itr = adjacency_.find(neighbor_type);
+  int64_t begin = 0;
+  int64_t end = 0;
+  if (itr != adjacency_.end()) {
+    begin = itr->second.offsets[index];
+    end = itr->second.offsets[index + 1];
+  }
+  if (begin == end) {
+    MS_LOG(DEBUG) << "There are no neighbors. node_id:" << id << " neighbor_type:" << neighbor_type;
+    // If there are no neighbors, they are filled with kDefaultNodeId
+    out_neighbors->insert(out_neighbors->end(), samples_num, kDefaultNodeId);
+    return Status::OK();
+  }
+  const auto &adj = itr->second;
+  const NodeIdType *neighbors = adj.neighbors.data() + begin;
+  const int64_t degree = end - begin;
+  if (strategy == SamplingStrategy::kRandom) {
+    // Sample without replacement, and start over once all the neighbors are taken.
+    std::vector<int64_t> shuffled_id(degree);
+    std::iota(shuffled_id.begin(), shuffled_id.end(), 0);
+    int32_t remaining = samples_num;
+    while (remaining > 0) {
+      int64_t num = std::min<int64_t>(remaining, degree);
+      for (int64_t i = 0; i < num; ++i) {
+        std::uniform_int_distribution<int64_t> dist(i, degree - 1);
+        std::swap(shuffled_id[i], shuffled_id[dist(*rnd)]);
+        out_neighbors->emplace_back(neighbors[shuffled_id[i]]);
+      }
+      remaining -= static_cast<int32_t>(num);
+    }
+  } else if (strategy == SamplingStrategy::kEdgeWeight) {
+    // Draw a slot, then keep it or take its alias
+    std::uniform_int_distribution<int64_t> slot_dist(0, degree - 1);
+    std::uniform_real_distribution<float> coin(0.0, 1.0);
+    for (int32_t i = 0; i < samples_num; ++i) {
+      int64_t slot = slot_dist(*rnd);
+      if (coin(*rnd) >= adj.alias_prob[begin + slot]) {
+        slot = adj.alias_index[begin + slot];
+      }
+      out_neighbors->emplace_back(neighbors[slot]);
+    }
+  } else {
+    RETURN_STATUS_UNEXPECTED("Invalid strategy");
+  }
+  return Status::OK();
+}
+
+Status GraphCsr::GetNeighbors(NodeIdType id, NodeType neighbor_type, const NodeIdType **neighbors,
+                              int64_t *num) const {
+  RETURN_UNEXPECTED_IF_NULL(neighbors);
+  RETURN_UNEXPECTED_IF_NULL(num);
+  int64_t index = 0;
+  RETURN_IF_NOT_OK(GetNodeIndex(id, &index));
+  auto itr = adjacency_.find(neighbor_type);
+  if (itr == adjacency_.end()) {
+    *neighbors = nullptr;
+    *num = 0;
+    return Status::OK();
+  }
+  const auto &adj = itr->second;
+  *neighbors = adj.neighbors.data() + adj.offsets[index];
+  *num = adj.offsets[index + 1] - adj.offsets[index];
+  return Status::OK();
+}
+
+bool GraphCsr::HasNeighbor(NodeIdType id, NodeType neighbor_type, NodeIdType neighbor) const {
+  auto itr = adjacency_.find(neighbor_type);
+  if (itr == adjacency_.end()) {
+    return false;
+  }
+  auto begin = node_ids_.data();
+  auto end = begin + node_ids_.size();
+  auto node = std::lower_bound(begin, end, id);
+  if (node == end || *node != id) {
+    return false;
+  }
+  const auto &adj = itr->second;
+  int64_t index = node - begin;
+  return std::binary_search(adj.sorted_neighbors.data() + adj.offsets[index],
+                            adj.sorted_neighbors.data() + adj.offsets[index + 1], neighbor);
+}
+
+Status GraphCsr::GetEdgeByAdjNodeId(NodeIdType src, NodeIdType dst, EdgeIdType *out_edge_id) const {
+  RETURN_UNEXPECTED_IF_NULL(out_edge_id);
+  int64_t index = 0;
+  RETURN_IF_NOT_OK(GetNodeIndex(src, &index));
+  // A node id is unique among all the node types, so at most one type has it as a neighbor.
+  for (const auto &itr : adjacency_) {
+    const auto &adj = itr.second;
+    for (int64_t i = adj.offsets[index]; i < adj.offsets[index + 1]; ++i) {
+      if (adj.neighbors[i] == dst) {
+        *out_edge_id = adj.edge_ids[i];
+        return Status::OK();
+      }
+    }
+  }
+  *out_edge_id = -1;
+  MS_LOG(WARNING) << "Number " << dst << " node is not adjacent to number " << src << " node.";
+  return Status::OK();
+}
+
+bool GraphCsr::GetNodeFeature(FeatureType feature_type, int64_t index, const uchar **row, TensorShape *shape,
+                              DataType *type) const {
+  auto itr = features_.find(feature_type);
+  if (itr == features_.end()) {
+    return false;
+  }
+  const auto &matrix = itr->second;
+  int32_t r = matrix.rows[index];
+  *row = r < 0 ? nullptr : matrix.data.data() + static_cast<int64_t>(r) * matrix.row_bytes;
+  *shape = TensorShape(matrix.shape);
+  *type = matrix.type;
+  return true;
+}
+}  // namespace gnn
+}  // namespace dataset
+}  // namespace mindspore
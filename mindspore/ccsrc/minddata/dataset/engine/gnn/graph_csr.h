@@ -0,0 +1,226 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_GNN_GRAPH_CSR_H_
+#define MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_GNN_GRAPH_CSR_H_
+
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "minddata/dataset/core/tensor.h"
+#include "minddata/dataset/engine/gnn/edge.h"
+#include "minddata/dataset/engine/gnn/feature.h"
+#include "minddata/dataset/engine/gnn/node.h"
+#include "minddata/dataset/util/status.h"
+
+namespace mindspore {
+namespace dataset {
+namespace gnn {
+
+// A read only array which either owns its elements or points into a mapped file
+template <typename T>
+class CsrArray {
+ public:
+  CsrArray() = default;
+  CsrArray(const CsrArray &) = delete;
+  CsrArray &operator=(const CsrArray &) = delete;
+  CsrArray(CsrArray &&) = default;
+  CsrArray &operator=(CsrArray &&) = default;
+  ~CsrArray() = default;
+
+  void Assign(std::vector<T> &&v) {
+    owned_ = std::move(v);
+    data_ = owned_.data();
+    size_ = owned_.size();
+  }
+
+  void Map(const T *data, size_t size) {
+    owned_.clear();
+    data_ = data;
+    size_ = size;
+  }
+
+  const T *data() const { return data_; }
+  size_t size() const { return size_; }
+  const T &operator[](size_t i) const { return data_[i]; }
+
+ private:
+  std::vector<T> owned_;
+  const T *data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// Immutable graph topology and node features in compressed sparse row form.
+// Nodes are numbered by their position in the sorted node id array. The neighbors of each neighbor node type are kept
+// in three arrays (neighbor id, edge weight, edge id) indexed through an offset array, in the order the edges are
+// loaded. Each node also has an alias table over the weights of its neighbors, so that a weighted draw takes constant
+// time, and a sorted copy of its neighbors for the membership tests of the random walk. A node feature with the same
+// shape and type on all the nodes that have it is kept as one contiguous matrix with a row for each of these nodes.
+// The whole store can be saved to a file, and mapped from that file later instead of being built again. The file
+// records what the store is built from, and is only mapped for the same source.
+class GraphCsr {
+ public:
+  using NodeMap = std::unordered_map<NodeIdType, std::shared_ptr<Node>>;
+
+  GraphCsr() = default;
+
+  GraphCsr(const GraphCsr &) = delete;
+  GraphCsr &operator=(const GraphCsr &) = delete;
+
+  ~GraphCsr();
+
+  // Build the topology
+  // @param NodeMap &nodes - all the nodes of the graph
+  // @param std::vector<std::shared_ptr<Edge>> &edges - all the edges in load order, connected to the nodes
+  // @return Status The status code returned
+  Status Build(const NodeMap &nodes, const std::vector<std::shared_ptr<Edge>> &edges);
+
+  // Move a node feature into a contiguous matrix, if all the nodes that have it agree on its shape and type
+  // @param FeatureType feature_type - type of feature
+  // @param NodeMap &nodes - all the nodes of the graph, the feature is removed from them once it is in the matrix
+  // @param bool persistent - whether the matrix is saved with the store. The features in shared memory are the
+  //     (offset, size) pairs of this load, so they are built again after the store is mapped.
+  // @param bool *built - Returned whether the feature is moved
+  // @return Status The status code returned
+  Status BuildNodeFeature(FeatureType feature_type, const NodeMap &nodes, bool persistent, bool *built);
+
+  // Save the store to a file, the matrices that are not persistent are left out
+  // @param std::string &path - file to write
+  // @param std::string &source - what the store is built from, checked by Match once the file is mapped
+  // @return Status The status code returned
+  Status Save(const std::string &path, const std::string &source) const;
+
+  // Map a store saved by Save
+  // @param std::string &path - file to map
+  // @return Status The status code returned
+  Status Load(const std::string &path);
+
+  // Check that the store is built from the given graph
+  // @param NodeMap &nodes - all the nodes of the graph
+  // @param int64_t num_edges - number of edges of the graph
+  // @param std::string &source - what the graph is loaded from
+  // @return bool - true if the store has the same source, nodes and number of edges
+  bool Match(const NodeMap &nodes, int64_t num_edges, const std::string &source) const;
+
+  int64_t NumNodes() const { return static_cast<int64_t>(node_ids_.size()); }
+
+  int64_t NumEdges() const { return num_edges_; }
+
+  // Feature types kept as matrices
+  std::vector<FeatureType> NodeFeatureTypes() const;
+
+  // Find the row of a node
+  // @param NodeIdType id - node id
+  // @param int64_t *index - Returned row of the node
+  // @return Status The status code returned, error if the node doesn't exist
+  Status GetNodeIndex(NodeIdType id, int64_t *index) const;
+
+  // Get the all neighbors of a node, led by the node itself unless it is excluded
+  // @param NodeIdType id - node id
+  // @param NodeType neighbor_type - type of neighbor
+  // @param std::vector<NodeIdType> *out_neighbors - Returned neighbors id
+  // @param bool exclude_itself - whether the node itself is left out of the neighbors
+  // @return Status The status code returned
+  Status GetAllNeighbors(NodeIdType id, NodeType neighbor_type, std::vector<NodeIdType> *out_neighbors,
+                         bool exclude_itself = false) const;
+
+  // Get the sampled neighbors of a node, filled with kDefaultNodeId if it has no neighbor of the type
+  // @param NodeIdType id - node id
+  // @param NodeType neighbor_type - type of neighbor
+  // @param int32_t samples_num - Number of neighbors to be acquired
+  // @param SamplingStrategy strategy - Sampling strategy
+  // @param std::mt19937 *rnd - random generator
+  // @param std::vector<NodeIdType> *out_neighbors - Returned neighbors id, appended to
+  // @return Status The status code returned
+  Status GetSampledNeighbors(NodeIdType id, NodeType neighbor_type, int32_t samples_num, SamplingStrategy strategy,
+                             std::mt19937 *rnd, std::vector<NodeIdType> *out_neighbors) const;
+
+  // Get the neighbors of a node without copying them
+  // @param NodeIdType id - node id
+  // @param NodeType neighbor_type - type of neighbor
+  // @param const NodeIdType **neighbors - Returned neighbors id, valid as long as the store
+  // @param int64_t *num - Returned number of neighbors
+  // @return Status The status code returned
+  Status GetNeighbors(NodeIdType id, NodeType neighbor_type, const NodeIdType **neighbors, int64_t *num) const;
+
+  // Check whether a node is a neighbor of another one
+  // @param NodeIdType id - node id
+  // @param NodeType neighbor_type - type of neighbor
+  // @param NodeIdType neighbor - the node to look for among the neighbors
+  // @return bool - true if neighbor is a neighbor of the node
+  bool HasNeighbor(NodeIdType id, NodeType neighbor_type, NodeIdType neighbor) const;
+
+  // Get the edge from a node to its neighbor
+  // @param NodeIdType src - source node id
+  // @param NodeIdType dst - neighbor node id
+  // @param EdgeIdType *out_edge_id - Returned edge id, -1 if the nodes are not connected
+  // @return Status The status code returned
+  Status GetEdgeByAdjNodeId(NodeIdType src, NodeIdType dst, EdgeIdType *out_edge_id) const;
+
+  // Get the feature of a node kept as a matrix
+  // @param FeatureType feature_type - type of feature
+  // @param int64_t index - row of the node
+  // @param const uchar **row - Returned feature of the node, nullptr if the node doesn't have this feature
+  // @param TensorShape *shape - Returned shape of the feature
+  // @param DataType *type - Returned type of the feature
+  // @return bool - false if the feature is not kept as a matrix
+  bool GetNodeFeature(FeatureType feature_type, int64_t index, const uchar **row, TensorShape *shape,
+                      DataType *type) const;
+
+ private:
+  struct Adjacency {
+    CsrArray<int64_t> offsets;  // NumNodes() + 1 offsets into the arrays below
+    CsrArray<NodeIdType> neighbors;
+    CsrArray<WeightType> weights;
+    CsrArray<EdgeIdType> edge_ids;
+    // alias table of each node: slot i is kept with alias_prob[i], or else replaced by slot alias_index[i]
+    CsrArray<float> alias_prob;
+    CsrArray<int32_t> alias_index;
+    CsrArray<NodeIdType> sorted_neighbors;  // neighbors of each node in ascending order
+  };
+
+  struct FeatureMatrix {
+    DataType type;
+    std::vector<dsize_t> shape;
+    int64_t row_bytes = 0;
+    bool persistent = true;
+    CsrArray<int32_t> rows;  // row of each node in data, -1 if the node doesn't have the feature
+    CsrArray<uint8_t> data;  // rows of row_bytes
+  };
+
+  // Parse the store from a saved image
+  Status Parse(const uint8_t *base, size_t size);
+
+  void Unmap();
+
+  CsrArray<NodeIdType> node_ids_;  // sorted
+  int64_t num_edges_ = 0;
+  std::string source_;  // what the store is built from, only known for a mapped store
+  std::unordered_map<NodeType, Adjacency> adjacency_;
+  std::unordered_map<FeatureType, FeatureMatrix> features_;
+
+  // the mapped file, if the store is loaded
+  void *mapped_addr_ = nullptr;
+  size_t mapped_size_ = 0;
+  std::vector<uint8_t> file_buf_;
+};
+}  // namespace gnn
+}  // namespace dataset
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_GNN_GRAPH_CSR_H_
@@ -24,6 +24,7 @@
 #include "minddata/dataset/core/tensor_shape.h"
 #include "minddata/dataset/engine/gnn/graph_loader.h"
 #include "minddata/dataset/util/random.h"
+#include "minddata/dataset/util/task_manager.h"
 namespace mindspore {
 namespace dataset {
 namespace gnn {
@@ -143,11 +144,8 @@ Status GraphDataImpl::GetEdgesFromNodes(const std::vector<std::pair<NodeIdType,
   edge_list.reserve(node_list.size());
 
   for (const auto &node_id : node_list) {
-    std::shared_ptr<Node> src_node;
-    RETURN_IF_NOT_OK(GetNodeByNodeId(node_id.first, &src_node));
-
     EdgeIdType edge_id;
-    src_node->GetEdgeByAdjNodeId(node_id.second, &edge_id);
+    RETURN_IF_NOT_OK(graph_csr_.GetEdgeByAdjNodeId(node_id.first, node_id.second, &edge_id));
 
     std::vector<EdgeIdType> connection_edge = {edge_id};
     edge_list.emplace_back(std::move(connection_edge));
@@ -172,16 +170,14 @@ Status GraphDataImpl::GetAllNeighbors(const std::vector<NodeIdType> &node_list,
   // Collect information of adjacent table
   neighbors.resize(node_list.size());
   for (size_t i = 0; i < node_list.size(); ++i) {
-    std::shared_ptr<Node> node;
-    RETURN_IF_NOT_OK(GetNodeByNodeId(node_list[i], &node));
     if (format == OutputFormat::kNormal) {
-      RETURN_IF_NOT_OK(node->GetAllNeighbors(neighbor_type, &neighbors[i]));
+      RETURN_IF_NOT_OK(graph_csr_.GetAllNeighbors(node_list[i], neighbor_type, &neighbors[i]));
       max_neighbor_num = max_neighbor_num > neighbors[i].size() ? max_neighbor_num : neighbors[i].size();
     } else if (format == OutputFormat::kCoo) {
-      RETURN_IF_NOT_OK(node->GetAllNeighbors(neighbor_type, &neighbors[i], true));
+      RETURN_IF_NOT_OK(graph_csr_.GetAllNeighbors(node_list[i], neighbor_type, &neighbors[i], true));
       total_edge_num += neighbors[i].size();
     } else {
-      RETURN_IF_NOT_OK(node->GetAllNeighbors(neighbor_type, &neighbors[i], true));
+      RETURN_IF_NOT_OK(graph_csr_.GetAllNeighbors(node_list[i], neighbor_type, &neighbors[i], true));
       total_edge_num += neighbors[i].size();
       if (i < node_list.size() - 1) {
         offset_table[i + 1] = total_edge_num;
@@ -273,11 +269,8 @@ Status GraphDataImpl::GetSampledNeighbors(const std::vector<NodeIdType> &node_li
             neighbors.emplace_back(kDefaultNodeId);
           }
         } else {
-          std::shared_ptr<Node> node;
-          RETURN_IF_NOT_OK(GetNodeByNodeId(node_id, &node));
-          std::vector<NodeIdType> out;
-          RETURN_IF_NOT_OK(node->GetSampledNeighbors(neighbor_types[i], neighbor_nums[i], strategy, &out));
-          neighbors.insert(neighbors.end(), out.begin(), out.end());
+          RETURN_IF_NOT_OK(
+            graph_csr_.GetSampledNeighbors(node_id, neighbor_types[i], neighbor_nums[i], strategy, &rnd_, &neighbors));
         }
       }
       neighbors_vec[node_idx].insert(neighbors_vec[node_idx].end(), neighbors.begin(), neighbors.end());
@@ -326,15 +319,13 @@ Status GraphDataImpl::GetNegSampledNeighbors(const std::vector<NodeIdType> &node
   std::vector<std::vector<NodeIdType>> neg_neighbors_vec;
   neg_neighbors_vec.resize(node_list.size());
   for (size_t node_idx = 0; node_idx < node_list.size(); ++node_idx) {
-    std::shared_ptr<Node> node;
-    RETURN_IF_NOT_OK(GetNodeByNodeId(node_list[node_idx], &node));
     std::vector<NodeIdType> neighbors;
-    RETURN_IF_NOT_OK(node->GetAllNeighbors(neg_neighbor_type, &neighbors));
+    RETURN_IF_NOT_OK(graph_csr_.GetAllNeighbors(node_list[node_idx], neg_neighbor_type, &neighbors));
     std::unordered_set<NodeIdType> exclude_nodes;
     (void)std::transform(neighbors.begin(), neighbors.end(),
                          std::insert_iterator<std::unordered_set<NodeIdType>>(exclude_nodes, exclude_nodes.begin()),
                          [](const NodeIdType node) { return node; });
-    neg_neighbors_vec[node_idx].emplace_back(node->id());
+    neg_neighbors_vec[node_idx].emplace_back(node_list[node_idx]);
     if (all_nodes.size() > exclude_nodes.size()) {
       while (neg_neighbors_vec[node_idx].size() < samples_num + 1) {
         RETURN_IF_NOT_OK(NegativeSample(all_nodes, shuffled_id, &start_index, exclude_nodes, samples_num + 1,
@@ -345,7 +336,7 @@ Status GraphDataImpl::GetNegSampledNeighbors(const std::vector<NodeIdType> &node
         }
       }
     } else {
-      MS_LOG(DEBUG) << "There are no negative neighbors. node_id:" << node->id()
+      MS_LOG(DEBUG) << "There are no negative neighbors. node_id:" << node_list[node_idx]
                     << " neg_neighbor_type:" << neg_neighbor_type;
       // If there are no negative neighbors, they are filled with kDefaultNodeId
       for (int32_t i = 0; i < samples_num; ++i) {
@@ -366,7 +357,8 @@ Status GraphDataImpl::RandomWalk(const std::vector<NodeIdType> &node_list, const
                                  float step_home_param, float step_away_param, NodeIdType default_node,
                                  std::shared_ptr<Tensor> *out) {
   RETURN_UNEXPECTED_IF_NULL(out);
-  RETURN_IF_NOT_OK(random_walk_.Build(node_list, meta_path, step_home_param, step_away_param, default_node));
+  RETURN_IF_NOT_OK(
+    random_walk_.Build(node_list, meta_path, step_home_param, step_away_param, default_node, 1, num_workers_));
   std::vector<std::vector<NodeIdType>> walks;
   RETURN_IF_NOT_OK(random_walk_.SimulateWalk(&walks));
   RETURN_IF_NOT_OK(CreateTensorByVector<NodeIdType>({walks}, DataType(DataType::DE_INT32), out));
@@ -385,6 +377,24 @@ Status GraphDataImpl::GetNodeDefaultFeature(FeatureType feature_type, std::share
   return Status::OK();
 }
 
+Status GraphDataImpl::InsertFeatureRow(const uchar *row, const TensorShape &row_shape, const DataType &row_type,
+                                       dsize_t index, const std::shared_ptr<Tensor> &fea_tensor) {
+  uchar *dst = nullptr;
+  TensorShape remaining = TensorShape::CreateUnknownRankShape();
+  RETURN_IF_NOT_OK(fea_tensor->StartAddrOfIndex({index}, &dst, &remaining));
+  if (row_type == fea_tensor->type() && remaining == row_shape) {
+    dsize_t row_bytes = row_shape.NumOfElements() * row_type.SizeInBytes();
+    if (row_bytes > 0) {
+      CHECK_FAIL_RETURN_UNEXPECTED(memcpy_s(dst, row_bytes, row, row_bytes) == EOK, "Failed to copy the feature.");
+    }
+    return Status::OK();
+  }
+  std::shared_ptr<Tensor> tensor;
+  RETURN_IF_NOT_OK(Tensor::CreateFromMemory(row_shape, row_type, row, &tensor));
+  RETURN_IF_NOT_OK(fea_tensor->InsertTensor({index}, tensor));
+  return Status::OK();
+}
+
 Status GraphDataImpl::GetEdgeDefaultFeature(FeatureType feature_type, std::shared_ptr<Feature> *out_feature) {
   RETURN_UNEXPECTED_IF_NULL(out_feature);
   auto itr = default_edge_feature_map_.find(feature_type);
@@ -423,10 +433,25 @@ Status GraphDataImpl::GetNodeFeature(const std::shared_ptr<Tensor> &nodes,
       if (*node_itr == kDefaultNodeId) {
         feature = default_feature;
       } else {
-        std::shared_ptr<Node> node;
-
-        if (!GetNodeByNodeId(*node_itr, &node).IsOk() || !node->GetFeatures(f_type, &feature).IsOk()) {
+        int64_t node_index = 0;
+        const uchar *row = nullptr;
+        TensorShape row_shape = TensorShape::CreateUnknownRankShape();
+        DataType row_type;
+        if (!graph_csr_.GetNodeIndex(*node_itr, &node_index).IsOk()) {
           feature = default_feature;
+        } else if (graph_csr_.GetNodeFeature(f_type, node_index, &row, &row_shape, &row_type)) {
+          if (row != nullptr) {
+            // Copy the row of the feature matrix straight into the output
+            RETURN_IF_NOT_OK(InsertFeatureRow(row, row_shape, row_type, index, fea_tensor));
+            index++;
+            continue;
+          }
+          feature = default_feature;
+        } else {
+          std::shared_ptr<Node> node;
+          if (!GetNodeByNodeId(*node_itr, &node).IsOk() || !node->GetFeatures(f_type, &feature).IsOk()) {
+            feature = default_feature;
+          }
         }
       }
       RETURN_IF_NOT_OK(fea_tensor->InsertTensor({index}, feature->Value()));
@@ -463,6 +488,22 @@ Status GraphDataImpl::GetNodeFeatureSharedMemory(const std::shared_ptr<Tensor> &
       *out_fea_itr = -1;
       ++out_fea_itr;
     } else {
+      int64_t node_index = 0;
+      const uchar *row = nullptr;
+      TensorShape row_shape = TensorShape::CreateUnknownRankShape();
+      DataType row_type;
+      RETURN_IF_NOT_OK(graph_csr_.GetNodeIndex(*node_itr, &node_index));
+      if (graph_csr_.GetNodeFeature(type, node_index, &row, &row_shape, &row_type)) {
+        // The offset and size of the feature in shared memory
+        CHECK_FAIL_RETURN_UNEXPECTED(row_type == DataType(DataType::DE_INT64),
+                                     "Invalid feature type of shared memory:" + row_type.ToString());
+        const int64_t *value = reinterpret_cast<const int64_t *>(row);
+        *out_fea_itr = row == nullptr ? -1 : value[0];
+        ++out_fea_itr;
+        *out_fea_itr = row == nullptr ? -1 : value[1];
+        ++out_fea_itr;
+        continue;
+      }
       std::shared_ptr<Node> node;
       RETURN_IF_NOT_OK(GetNodeByNodeId(*node_itr, &node));
       std::shared_ptr<Feature> feature;
@@ -702,169 +743,114 @@ Status GraphDataImpl::RandomWalkBase::Build(const std::vector<NodeIdType> &node_
   return Status::OK();
 }
 
-Status GraphDataImpl::RandomWalkBase::Node2vecWalk(const NodeIdType &start_node, std::vector<NodeIdType> *walk_path) {
+Status GraphDataImpl::RandomWalkBase::Node2vecWalk(const NodeIdType &start_node, std::mt19937 *rnd,
+                                                   std::vector<NodeIdType> *walk_path) const {
   RETURN_UNEXPECTED_IF_NULL(walk_path);
   // Simulate a random walk starting from start node.
-  auto walk = std::vector<NodeIdType>(1, start_node);  // walk is an vector
-  // walk simulate
+  auto &walk = *walk_path;
+  walk.assign(1, start_node);
+  walk.reserve(meta_path_.size() + 1);
   while (walk.size() - 1 < meta_path_.size()) {
-    // current nodE
-    auto cur_node_id = walk.back();
-    std::shared_ptr<Node> cur_node;
-    RETURN_IF_NOT_OK(graph_->GetNodeByNodeId(cur_node_id, &cur_node));
-
-    // current neighbors
-    std::vector<NodeIdType> cur_neighbors;
-    RETURN_IF_NOT_OK(cur_node->GetAllNeighbors(meta_path_[walk.size() - 1], &cur_neighbors, true));
-    std::sort(cur_neighbors.begin(), cur_neighbors.end());
+    size_t step = walk.size() - 1;
+    NodeIdType cur_node_id = walk.back();
+    const NodeIdType *cur_neighbors = nullptr;
+    int64_t num_neighbors = 0;
+    RETURN_IF_NOT_OK(graph_->graph_csr_.GetNeighbors(cur_node_id, meta_path_[step], &cur_neighbors, &num_neighbors));
 
     // break if no neighbors
-    if (cur_neighbors.empty()) {
+    if (num_neighbors == 0) {
       break;
     }
 
     // walk by the fist node, then by the previous 2 nodes
-    std::shared_ptr<StochasticIndex> stochastic_index;
-    if (walk.size() == 1) {
-      RETURN_IF_NOT_OK(GetNodeProbability(cur_node_id, meta_path_[0], &stochastic_index));
+    NodeIdType next_node_id = kDefaultNodeId;
+    if (step == 0) {
+      std::uniform_int_distribution<int64_t> distribution(0, num_neighbors - 1);
+      next_node_id = cur_neighbors[distribution(*rnd)];
     } else {
-      NodeIdType prev_node_id = walk[walk.size() - 2];
-      RETURN_IF_NOT_OK(GetEdgeProbability(prev_node_id, cur_node_id, walk.size() - 2, &stochastic_index));
+      RETURN_IF_NOT_OK(
+        WalkToNextNode(walk[step - 1], meta_path_[step - 1], cur_neighbors, num_neighbors, rnd, &next_node_id));
     }
-    NodeIdType next_node_id = cur_neighbors[WalkToNextNode(*stochastic_index)];
     walk.push_back(next_node_id);
   }
 
   while (walk.size() - 1 < meta_path_.size()) {
     walk.push_back(default_node_);
   }
-
-  *walk_path = std::move(walk);
   return Status::OK();
 }
 
 Status GraphDataImpl::RandomWalkBase::SimulateWalk(std::vector<std::vector<NodeIdType>> *walks) {
   RETURN_UNEXPECTED_IF_NULL(walks);
-  for (int32_t i = 0; i < num_walks_; ++i) {
-    for (const auto &node : node_list_) {
-      std::vector<NodeIdType> walk;
-      RETURN_IF_NOT_OK(Node2vecWalk(node, &walk));
-      walks->push_back(walk);
+  const size_t num_nodes = node_list_.size();
+  const size_t total = num_nodes * num_walks_;
+  walks->resize(total);
+  // Each worker walks a contiguous range of the walks, with a random stream of its own seeded from the graph.
+  const uint32_t seed = graph_->rnd_();
+  auto walk_range = [this, walks, seed, num_nodes](size_t begin, size_t end, int32_t worker_id) -> Status {
+    std::seed_seq seq{seed, static_cast<uint32_t>(worker_id)};
+    std::mt19937 rnd(seq);
+    for (size_t i = begin; i < end; ++i) {
+      RETURN_IF_NOT_OK(Node2vecWalk(node_list_[i % num_nodes], &rnd, &(*walks)[i]));
     }
-  }
+    return Status::OK();
+  };
+  size_t num_tasks = std::min<size_t>(num_workers_, (total + kMinWalksPerWorker - 1) / kMinWalksPerWorker);
+  if (num_tasks <= 1) {
+    return walk_range(0, total, 0);
+  }
+  TaskGroup vg;
+  size_t chunk = (total + num_tasks - 1) / num_tasks;
+  for (size_t task_id = 0; task_id < num_tasks; ++task_id) {
+    size_t begin = task_id * chunk;
+    size_t end = std::min(total, begin + chunk);
+    RETURN_IF_NOT_OK(vg.CreateAsyncTask("RandomWalk", [walk_range, begin, end, task_id]() -> Status {
+      TaskManager::FindMe()->Post();
+      return walk_range(begin, end, static_cast<int32_t>(task_id));
+    }));
+  }
+  RETURN_IF_NOT_OK(vg.join_all(Task::WaitFlag::kBlocking));
+  RETURN_IF_NOT_OK(vg.GetTaskErrorIfAny());
   return Status::OK();
 }
 
-Status GraphDataImpl::RandomWalkBase::GetNodeProbability(const NodeIdType &node_id, const NodeType &node_type,
-                                                         std::shared_ptr<StochasticIndex> *node_probability) {
-  RETURN_UNEXPECTED_IF_NULL(node_probability);
-  // Generate alias nodes
-  std::shared_ptr<Node> node;
-  RETURN_IF_NOT_OK(graph_->GetNodeByNodeId(node_id, &node));
-  std::vector<NodeIdType> neighbors;
-  RETURN_IF_NOT_OK(node->GetAllNeighbors(node_type, &neighbors, true));
-  std::sort(neighbors.begin(), neighbors.end());
-  auto non_normalized_probability = std::vector<float>(neighbors.size(), 1.0);
-  *node_probability =
-    std::make_shared<StochasticIndex>(GenerateProbability(Normalize<float>(non_normalized_probability)));
-  return Status::OK();
-}
-
-Status GraphDataImpl::RandomWalkBase::GetEdgeProbability(const NodeIdType &src, const NodeIdType &dst,
-                                                         uint32_t meta_path_index,
-                                                         std::shared_ptr<StochasticIndex> *edge_probability) {
-  RETURN_UNEXPECTED_IF_NULL(edge_probability);
-  // Get the alias edge setup lists for a given edge.
-  std::shared_ptr<Node> src_node;
-  RETURN_IF_NOT_OK(graph_->GetNodeByNodeId(src, &src_node));
-  std::vector<NodeIdType> src_neighbors;
-  RETURN_IF_NOT_OK(src_node->GetAllNeighbors(meta_path_[meta_path_index], &src_neighbors, true));
-
-  std::shared_ptr<Node> dst_node;
-  RETURN_IF_NOT_OK(graph_->GetNodeByNodeId(dst, &dst_node));
-  std::vector<NodeIdType> dst_neighbors;
-  RETURN_IF_NOT_OK(dst_node->GetAllNeighbors(meta_path_[meta_path_index + 1], &dst_neighbors, true));
-
+Status GraphDataImpl::RandomWalkBase::WalkToNextNode(NodeIdType prev_node, NodeType prev_type,
+                                                     const NodeIdType *neighbors, int64_t num, std::mt19937 *rnd,
+                                                     NodeIdType *next_node) const {
   CHECK_FAIL_RETURN_UNEXPECTED(step_home_param_ != 0, "Invalid data, step home parameter can't be zero.");
   CHECK_FAIL_RETURN_UNEXPECTED(step_away_param_ != 0, "Invalid data, step away parameter can't be zero.");
-  std::sort(dst_neighbors.begin(), dst_neighbors.end());
-  std::vector<float> non_normalized_probability;
-  for (const auto &dst_nbr : dst_neighbors) {
-    if (dst_nbr == src) {
-      non_normalized_probability.push_back(1.0 / step_home_param_);  // replace 1.0 with G[dst][dst_nbr]['weight']
-      continue;
+  const GraphCsr &csr = graph_->graph_csr_;
+  const float home_weight = 1.0 / step_home_param_;
+  const float away_weight = 1.0 / step_away_param_;
+  // Go back to the previous node, stay close to it, or step far away
+  auto weight = [&](NodeIdType node) -> float {
+    if (node == prev_node) {
+      return home_weight;
     }
-    auto it = std::find(src_neighbors.begin(), src_neighbors.end(), dst_nbr);
-    if (it != src_neighbors.end()) {
-      // stay close, this node connect both src and dst
-      non_normalized_probability.push_back(1.0);  // replace 1.0 with G[dst][dst_nbr]['weight']
-    } else {
-      // step far away
-      non_normalized_probability.push_back(1.0 / step_away_param_);  // replace 1.0 with G[dst][dst_nbr]['weight']
+    return csr.HasNeighbor(prev_node, prev_type, node) ? 1.0 : away_weight;
+  };
+
+  // Draw a neighbor uniformly and accept it with a probability in proportion to its weight, so that there is no need
+  // to compute the weights of all the neighbors.
+  const float max_weight = std::max({home_weight, 1.0f, away_weight});
+  std::uniform_int_distribution<int64_t> slot_distribution(0, num - 1);
+  std::uniform_real_distribution<float> accept_distribution(0.0, max_weight);
+  for (int32_t i = 0; i < kMaxWalkRejections; ++i) {
+    NodeIdType node = neighbors[slot_distribution(*rnd)];
+    if (accept_distribution(*rnd) < weight(node)) {
+      *next_node = node;
+      return Status::OK();
     }
   }
 
-  *edge_probability =
-    std::make_shared<StochasticIndex>(GenerateProbability(Normalize<float>(non_normalized_probability)));
-  return Status::OK();
-}
-
-StochasticIndex GraphDataImpl::RandomWalkBase::GenerateProbability(const std::vector<float> &probability) {
-  uint32_t K = probability.size();
-  std::vector<int32_t> switch_to_large_index(K, 0);
-  std::vector<float> weight(K, .0);
-  std::vector<int32_t> smaller;
-  std::vector<int32_t> larger;
-  auto random_device = GetRandomDevice();
-  std::uniform_real_distribution<> distribution(-kGnnEpsilon, kGnnEpsilon);
-  float accumulate_threshold = 0.0;
-  for (uint32_t i = 0; i < K; i++) {
-    float threshold_one = distribution(random_device);
-    accumulate_threshold += threshold_one;
-    weight[i] = i < K - 1 ? probability[i] * K + threshold_one : probability[i] * K - accumulate_threshold;
-    weight[i] < 1.0 ? smaller.push_back(i) : larger.push_back(i);
-  }
-
-  while ((!smaller.empty()) && (!larger.empty())) {
-    uint32_t small = smaller.back();
-    smaller.pop_back();
-    uint32_t large = larger.back();
-    larger.pop_back();
-    switch_to_large_index[small] = large;
-    weight[large] = weight[large] + weight[small] - 1.0;
-    weight[large] < 1.0 ? smaller.push_back(large) : larger.push_back(large);
-  }
-  return StochasticIndex(switch_to_large_index, weight);
-}
-
-uint32_t GraphDataImpl::RandomWalkBase::WalkToNextNode(const StochasticIndex &stochastic_index) {
-  auto switch_to_large_index = stochastic_index.first;
-  auto weight = stochastic_index.second;
-  const uint32_t size_of_index = switch_to_large_index.size();
-
-  auto random_device = GetRandomDevice();
-  std::uniform_real_distribution<> distribution(0.0, 1.0);
-
-  // Generate random integer between [0, K)
-  uint32_t random_idx = std::floor(distribution(random_device) * size_of_index);
-
-  if (distribution(random_device) < weight[random_idx]) {
-    return random_idx;
+  // The weights are too far apart for rejection sampling, draw from all the neighbors instead
+  std::vector<float> weights(num);
+  for (int64_t i = 0; i < num; ++i) {
+    weights[i] = weight(neighbors[i]);
   }
-  return switch_to_large_index[random_idx];
-}
-
-template <typename T>
-std::vector<float> GraphDataImpl::RandomWalkBase::Normalize(const std::vector<T> &non_normalized_probability) {
-  float sum_probability =
-    1.0 * std::accumulate(non_normalized_probability.begin(), non_normalized_probability.end(), 0);
-  if (sum_probability < kGnnEpsilon) {
-    sum_probability = 1.0;
-  }
-  std::vector<float> normalized_probability;
-  std::transform(non_normalized_probability.begin(), non_normalized_probability.end(),
-                 std::back_inserter(normalized_probability), [&](T value) -> float { return value / sum_probability; });
-  return normalized_probability;
+  std::discrete_distribution<int64_t> distribution(weights.begin(), weights.end());
+  *next_node = neighbors[distribution(*rnd)];
+  return Status::OK();
 }
 }  // namespace gnn
 }  // namespace dataset
@@ -25,6 +25,7 @@
 #include <vector>
 #include <utility>
 
+#include "minddata/dataset/engine/gnn/graph_csr.h"
 #include "minddata/dataset/engine/gnn/graph_data.h"
 #if !defined(_WIN32) && !defined(_WIN64)
 #include "minddata/dataset/engine/gnn/graph_shared_memory.h"
@@ -37,7 +38,8 @@ namespace gnn {
 
 const float kGnnEpsilon = 0.0001;
 const uint32_t kMaxNumWalks = 80;
-using StochasticIndex = std::pair<std::vector<int32_t>, std::vector<float>>;
+const uint32_t kMinWalksPerWorker = 64;  // fewer walks are not worth a thread of their own
+const int32_t kMaxWalkRejections = 16;   // rejection sampling gives up after this many draws for a step
 
 class GraphDataImpl : public GraphData {
  public:
@@ -185,20 +187,18 @@ class GraphDataImpl : public GraphData {
     Status SimulateWalk(std::vector<std::vector<NodeIdType>> *walks);
 
    private:
-    Status Node2vecWalk(const NodeIdType &start_node, std::vector<NodeIdType> *walk_path);
-
-    Status GetNodeProbability(const NodeIdType &node_id, const NodeType &node_type,
-                              std::shared_ptr<StochasticIndex> *node_probability);
-
-    Status GetEdgeProbability(const NodeIdType &src, const NodeIdType &dst, uint32_t meta_path_index,
-                              std::shared_ptr<StochasticIndex> *edge_probability);
-
-    static StochasticIndex GenerateProbability(const std::vector<float> &probability);
-
-    static uint32_t WalkToNextNode(const StochasticIndex &stochastic_index);
-
-    template <typename T>
-    std::vector<float> Normalize(const std::vector<T> &non_normalized_probability);
+    Status Node2vecWalk(const NodeIdType &start_node, std::mt19937 *rnd, std::vector<NodeIdType> *walk_path) const;
+
+    // Draw the next node of a walk with the node2vec bias, by rejection sampling over the neighbors of current node
+    // @param NodeIdType prev_node - the node before current node
+    // @param NodeType prev_type - type of the neighbors of prev_node in the meta path
+    // @param const NodeIdType *neighbors - the neighbors of current node
+    // @param int64_t num - number of neighbors, greater than 0
+    // @param std::mt19937 *rnd - random generator of the worker
+    // @param NodeIdType *next_node - Returned next node
+    // @return Status The status code returned
+    Status WalkToNextNode(NodeIdType prev_node, NodeType prev_type, const NodeIdType *neighbors, int64_t num,
+                          std::mt19937 *rnd, NodeIdType *next_node) const;
 
     GraphDataImpl *graph_;
     std::vector<NodeIdType> node_list_;
@@ -237,6 +237,16 @@ class GraphDataImpl : public GraphData {
   // @return Status The status code returned
   Status GetNodeDefaultFeature(FeatureType feature_type, std::shared_ptr<Feature> *out_feature);
 
+  // Copy a row of a feature matrix into the output tensor
+  // @param uchar *row - the row of the feature matrix
+  // @param TensorShape &row_shape - shape of the feature
+  // @param DataType &row_type - type of the feature
+  // @param dsize_t index - index of the node in the output tensor
+  // @param std::shared_ptr<Tensor> &fea_tensor - the output tensor
+  // @return Status The status code returned
+  Status InsertFeatureRow(const uchar *row, const TensorShape &row_shape, const DataType &row_type, dsize_t index,
+                          const std::shared_ptr<Tensor> &fea_tensor);
+
   // Get the default feature of a edge
   // @param FeatureType feature_type -
   // @param std::shared_ptr<Feature> *out_feature - Returned feature
@@ -289,6 +299,9 @@ class GraphDataImpl : public GraphData {
 
   std::unordered_map<FeatureType, std::shared_ptr<Feature>> default_node_feature_map_;
   std::unordered_map<FeatureType, std::shared_ptr<Feature>> default_edge_feature_map_;
+
+  // Topology and node features for the queries, built by GraphLoader
+  GraphCsr graph_csr_;
 };
 }  // namespace gnn
 }  // namespace dataset
@@ -15,15 +15,20 @@
  */
 #include "minddata/dataset/engine/gnn/graph_loader.h"
 
+#include <sys/stat.h>
+
 #include <future>
+#include <set>
 #include <tuple>
 #include <utility>
 
 #include "minddata/dataset/engine/gnn/graph_data_impl.h"
 #include "minddata/dataset/engine/gnn/local_edge.h"
 #include "minddata/dataset/engine/gnn/local_node.h"
+#include "minddata/dataset/util/path.h"
 #include "minddata/dataset/util/task_manager.h"
 #include "minddata/mindrecord/include/shard_error.h"
+#include "utils/ms_utils.h"
 
 using ShardTuple = std::vector<std::tuple<std::vector<uint8_t>, mindspore::mindrecord::json>>;
 namespace mindspore {
@@ -32,6 +37,9 @@ namespace gnn {
 
 using mindrecord::MSRStatus;
 
+// File to map the graph store from, the graph store is saved to it if it doesn't exist
+constexpr char kGraphCsrFileEnv[] = "MS_GNN_CSR_FILE";
+
 GraphLoader::GraphLoader(GraphDataImpl *graph_impl, std::string mr_filepath, int32_t num_workers, bool server_mode)
     : graph_impl_(graph_impl),
       mr_path_(mr_filepath),
@@ -55,6 +63,7 @@ Status GraphLoader::GetNodesAndEdges() {
     }
   }
 
+  std::vector<std::shared_ptr<Edge>> edges;
   for (std::deque<std::shared_ptr<Edge>> &dq : e_deques_) {
     while (dq.empty() == false) {
       std::shared_ptr<Edge> edge_ptr = dq.front();
@@ -66,8 +75,7 @@ Status GraphLoader::GetNodesAndEdges() {
       CHECK_FAIL_RETURN_UNEXPECTED(dst_itr != n_id_map->end(), "invalid src_id:" + std::to_string(dst_itr->first));
 
       RETURN_IF_NOT_OK(edge_ptr->SetNode({src_itr->second, dst_itr->second}));
-      RETURN_IF_NOT_OK(src_itr->second->AddNeighbor(dst_itr->second, edge_ptr->weight()));
-      RETURN_IF_NOT_OK(src_itr->second->AddAdjacent(dst_itr->second, edge_ptr));
+      edges.push_back(edge_ptr);
 
       e_id_map->insert({edge_ptr->id(), edge_ptr});  // add edge to edge_id_map_
       graph_impl_->edge_type_map_[edge_ptr->type()].push_back(edge_ptr->id());
@@ -79,6 +87,73 @@ Status GraphLoader::GetNodesAndEdges() {
   for (auto &itr : graph_impl_->edge_type_map_) itr.second.shrink_to_fit();
 
   MergeFeatureMaps();
+  RETURN_IF_NOT_OK(BuildGraphCsr(edges));
+  return Status::OK();
+}
+
+Status GraphLoader::GetGraphSource(std::string *source) {
+  RETURN_UNEXPECTED_IF_NULL(source);
+  // The features in shared memory depend on the order the workers load the rows in, so they are never saved, the
+  // number of workers and the mode are still part of the source to keep the stores of each setting apart.
+  std::string result = "num_workers:" + std::to_string(num_workers_) +
+                       ",server_mode:" + std::to_string(static_cast<int>(graph_impl_->server_mode_));
+  for (const auto &file : shard_reader_->GetShardHeader()->GetShardAddresses()) {
+    struct stat file_stat;
+    CHECK_FAIL_RETURN_UNEXPECTED(stat(file.c_str(), &file_stat) == 0, "Failed to get the status of " + file);
+    result += ",file:" + file + ",size:" + std::to_string(file_stat.st_size) +
+              ",mtime:" + std::to_string(file_stat.st_mtime);
+  }
+  result += ",schema:" + graph_impl_->data_schema_.dump();
+  *source = std::move(result);
+  return Status::OK();
+}
+
+Status GraphLoader::BuildGraphCsr(const std::vector<std::shared_ptr<Edge>> &edges) {
+  GraphCsr *csr = &graph_impl_->graph_csr_;
+  const NodeIdMap &n_id_map = graph_impl_->node_id_map_;
+  std::string csr_file = common::GetEnv(kGraphCsrFileEnv);
+  std::string source;
+  if (!csr_file.empty()) {
+    RETURN_IF_NOT_OK(GetGraphSource(&source));
+  }
+  bool mapped = false;
+  if (!csr_file.empty() && Path(csr_file).Exists()) {
+    Status rc = csr->Load(csr_file);
+    if (rc.IsOk() && csr->Match(n_id_map, static_cast<int64_t>(edges.size()), source)) {
+      // The features in the mapped matrices are no longer needed by the nodes.
+      for (FeatureType feature_type : csr->NodeFeatureTypes()) {
+        for (auto &itr : n_id_map) {
+          RETURN_IF_NOT_OK(itr.second->RemoveFeature(feature_type));
+        }
+      }
+      MS_LOG(INFO) << "Graph store is mapped from " << csr_file;
+      mapped = true;
+    } else {
+      MS_LOG(WARNING) << "Graph store " << csr_file << " doesn't match the graph, it will be built again. "
+                      << rc.ToString();
+    }
+  }
+  if (!mapped) {
+    RETURN_IF_NOT_OK(csr->Build(n_id_map, edges));
+  }
+  // The (offset, size) pairs in shared memory only hold for this load, they are gathered every time and not saved.
+  const bool persistent = !graph_impl_->server_mode_;
+  if (!mapped || !persistent) {
+    std::set<FeatureType> feature_types;
+    for (auto &itr : graph_impl_->node_feature_map_) {
+      feature_types.insert(itr.second.begin(), itr.second.end());
+    }
+    for (FeatureType feature_type : feature_types) {
+      bool built = false;
+      RETURN_IF_NOT_OK(csr->BuildNodeFeature(feature_type, n_id_map, persistent, &built));
+    }
+  }
+  if (!csr_file.empty() && !mapped) {
+    Status rc = csr->Save(csr_file, source);
+    if (rc.IsError()) {
+      MS_LOG(WARNING) << "Failed to save the graph store to " << csr_file << ". " << rc.ToString();
+    }
+  }
   return Status::OK();
 }
 
@@ -98,6 +98,17 @@ class GraphLoader {
   // merge NodeFeatureMap and EdgeFeatureMap of each worker into 1
   void MergeFeatureMaps();
 
+  // Describe what the graph is loaded from: the number of workers, the mode, the size and modification time of each
+  // shard file and the schema. A saved graph store is only mapped for the same source.
+  // @param std::string *source - return value
+  // @return Status - the status code
+  Status GetGraphSource(std::string *source);
+
+  // Build the graph store of GraphDataImpl, or map it from the file given by MS_GNN_CSR_FILE
+  // @param std::vector<std::shared_ptr<Edge>> &edges - all the edges in load order, connected to the nodes
+  // @return Status - the status code
+  Status BuildGraphCsr(const std::vector<std::shared_ptr<Edge>> &edges);
+
   GraphDataImpl *graph_impl_;
   std::string mr_path_;
   const int32_t num_workers_;
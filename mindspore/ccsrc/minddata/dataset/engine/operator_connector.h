@@ -16,9 +16,12 @@
 #ifndef MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_OPERATOR_CONNECTOR_H_
 #define MINDSPORE_CCSRC_MINDDATA_DATASET_ENGINE_OPERATOR_CONNECTOR_H_
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 #include "minddata/dataset/core/tensor_row.h"
 #include "minddata/dataset/engine/connector.h"
 
@@ -31,18 +34,39 @@ class OperatorConnector : public Queue<TensorRow> {
  public:
   /// Constructor of OperatorConnector
   /// \param queue_capacity The number of element (TensorRows) for the queue.
-  explicit OperatorConnector(int32_t queue_capacity) : Queue<TensorRow>(queue_capacity) {
+  /// \param queue_max_bytes The number of bytes of the TensorRows the queue can hold, 0 means no limit.
+  explicit OperatorConnector(int32_t queue_capacity, int64_t queue_max_bytes = 0) : Queue<TensorRow>(queue_capacity) {
     my_name_ = Services::GetUniqueID();
     out_rows_count_ = 0;
+    local_rows_left_ = 0;
+    SetMaxBytes(queue_max_bytes);
   }
 
   /// Destructor of -OperatorConnector
   ~OperatorConnector() = default;
 
+  /// Pop the next row. The consumer takes up to kMaxPopBatch rows that are ready under one lock of the queue and
+  /// serves the following calls from them, so the producers are woken up once per batch. The connector holds at most
+  /// kMaxPopBatch rows beyond its capacity.
+  /// \param row The address of the popped row.
+  /// \return Status The status code returned
   Status PopFront(TensorRow *row) {
+    RETURN_UNEXPECTED_IF_NULL(row);
+    std::unique_lock<std::mutex> lock(local_mux_);
+    if (local_row_idx_ == local_rows_.size()) {
+      local_rows_.clear();
+      local_row_idx_ = 0;
+      RETURN_IF_NOT_OK(Queue::PopFrontBatch(&local_rows_, kMaxPopBatch));
+      local_rows_left_ = local_rows_.size();
+    }
+    *row = std::move(local_rows_[local_row_idx_++]);
+    local_rows_left_--;
     out_rows_count_++;
-    return Queue::PopFront(row);
+    return Status::OK();
   }
+
+  /// The number of rows in the connector, including the rows the consumer has taken but not returned yet.
+  size_t size() const { return Queue::size() + local_rows_left_; }
   Status SendEOE() noexcept {
     TensorRow eoe = TensorRow(TensorRow::kFlagEOE);
     return Add(std::move(eoe));
@@ -55,8 +79,15 @@ class OperatorConnector : public Queue<TensorRow> {
   auto out_rows_count() const { return out_rows_count_; }
 
  private:
+  static constexpr size_t kMaxPopBatch = 8;
+
   std::string my_name_;
   int64_t out_rows_count_;
+  // the rows taken from the queue by the last batch pop, guarded by local_mux_
+  std::mutex local_mux_;
+  std::vector<TensorRow> local_rows_;
+  size_t local_row_idx_ = 0;
+  std::atomic<size_t> local_rows_left_;
 };
 }  // namespace dataset
 }  // namespace mindspore
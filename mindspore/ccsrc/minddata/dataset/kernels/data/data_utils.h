@@ -90,6 +90,12 @@ Status PadEnd(const std::shared_ptr<Tensor> &src, std::shared_ptr<Tensor> *dst,
 Status PadEndNumeric(const std::shared_ptr<Tensor> &src, std::shared_ptr<Tensor> *dst,
                      const std::vector<dsize_t> &pad_shape, float pad_val);
 
+// Fill a numeric tensor with the value to pad with, casted to the type of the tensor.
+// @param std::shared_ptr<Tensor> tensor - tensor to fill
+// @param float pad_val - value to pad with
+// @return Status The status code returned
+Status FillPadValue(const std::shared_ptr<Tensor> &tensor, float pad_val);
+
 // recursive helper function for padding numric tensors. This function could be very expensive if called on a
 // multi-dimensional tensor it is only meant to be called by PadEndNumeric.
 // @tparam T - type of tensor and fill value
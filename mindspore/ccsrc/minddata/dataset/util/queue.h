@@ -34,6 +34,18 @@
 
 namespace mindspore {
 namespace dataset {
+// The number of bytes that an element of a Queue is charged against the byte capacity of the queue. Only the types
+// that report their size through SizeInBytes(), e.g. TensorRow, are charged, the others cost nothing.
+template <typename T, typename = void>
+struct QueueElementBytes {
+  static int64_t Get(const T &) { return 0; }
+};
+
+template <typename T>
+struct QueueElementBytes<T, std::void_t<decltype(std::declval<const T &>().SizeInBytes())>> {
+  static int64_t Get(const T &ele) { return static_cast<int64_t>(ele.SizeInBytes()); }
+};
+
 // A simple thread safe queue using a fixed size array
 template <typename T>
 class Queue {
@@ -45,7 +57,13 @@ class Queue {
   using const_reference = const T &;
 
   explicit Queue(int sz)
-      : sz_(sz), arr_(Services::GetAllocator<T>()), head_(0), tail_(0), my_name_(Services::GetUniqueID()) {
+      : sz_(sz),
+        arr_(Services::GetAllocator<T>()),
+        head_(0),
+        tail_(0),
+        max_bytes_(0),
+        bytes_(0),
+        my_name_(Services::GetUniqueID()) {
     Status rc = arr_.allocate(sz);
     if (rc.IsError()) {
       MS_LOG(ERROR) << "Fail to create a queue.";
@@ -66,18 +84,45 @@ class Queue {
 
   bool empty() const { return head_ == tail_; }
 
+  // The bytes held by the elements in the queue, only counted when a byte capacity is set.
+  int64_t bytes() const { return bytes_; }
+
+  int64_t max_bytes() const { return max_bytes_; }
+
   void Reset() {
     std::unique_lock<std::mutex> _lock(mux_);
     ResetQue();
     extra_arr_.clear();
+    bytes_ = 0;
+  }
+
+  // Set a capacity in bytes on top of the capacity in elements, 0 means no limit. A producer blocks while the queue
+  // holds max_bytes or more, but an empty queue always accepts one element, so an element larger than the limit
+  // still makes progress.
+  // @param max_bytes The byte capacity of the queue.
+  void SetMaxBytes(int64_t max_bytes) {
+    std::unique_lock<std::mutex> _lock(mux_);
+    max_bytes_ = max_bytes > 0 ? max_bytes : 0;
+    bytes_ = 0;
+    if (max_bytes_ > 0) {
+      for (auto i = head_; i < tail_; ++i) {
+        bytes_ += QueueElementBytes<T>::Get(*(arr_[i % sz_]));
+      }
+      for (auto &ele : extra_arr_) {
+        bytes_ += QueueElementBytes<T>::Get(ele);
+      }
+    }
+    _lock.unlock();
+    full_cv_.NotifyAll();
   }
 
   // Producer
   Status Add(const_reference ele) noexcept {
     std::unique_lock<std::mutex> _lock(mux_);
     // Block when full
-    Status rc = full_cv_.Wait(&_lock, [this]() -> bool { return (size() != capacity()); });
+    Status rc = full_cv_.Wait(&_lock, [this]() -> bool { return HasRoom(); });
     if (rc.IsOk()) {
+      ChargeBytes(ele);
       RETURN_IF_NOT_OK(AddWhileHoldingLock(ele));
       empty_cv_.NotifyAll();
       _lock.unlock();
@@ -90,8 +135,9 @@ class Queue {
   Status Add(T &&ele) noexcept {
     std::unique_lock<std::mutex> _lock(mux_);
     // Block when full
-    Status rc = full_cv_.Wait(&_lock, [this]() -> bool { return (size() != capacity()); });
+    Status rc = full_cv_.Wait(&_lock, [this]() -> bool { return HasRoom(); });
     if (rc.IsOk()) {
+      ChargeBytes(ele);
       RETURN_IF_NOT_OK(AddWhileHoldingLock(std::forward<T>(ele)));
       empty_cv_.NotifyAll();
       _lock.unlock();
@@ -105,10 +151,11 @@ class Queue {
   Status EmplaceBack(Ts &&... args) noexcept {
     std::unique_lock<std::mutex> _lock(mux_);
     // Block when full
-    Status rc = full_cv_.Wait(&_lock, [this]() -> bool { return (size() != capacity()); });
+    Status rc = full_cv_.Wait(&_lock, [this]() -> bool { return HasRoom(); });
     if (rc.IsOk()) {
       auto k = tail_++ % sz_;
       new (arr_[k]) T(std::forward<Ts>(args)...);
+      ChargeBytes(*(arr_[k]));
       empty_cv_.NotifyAll();
       _lock.unlock();
     } else {
@@ -124,6 +171,26 @@ class Queue {
     Status rc = empty_cv_.Wait(&_lock, [this]() -> bool { return !empty(); });
     if (rc.IsOk()) {
       RETURN_IF_NOT_OK(PopFrontWhileHoldingLock(p, true));
+      ReleaseBytes(*p);
+      full_cv_.NotifyAll();
+      _lock.unlock();
+    } else {
+      full_cv_.Interrupt();
+    }
+    return rc;
+  }
+
+  // Consumer, block until the queue is not empty, then pop up to max_num elements under one lock. The popped
+  // elements are appended to eles in order.
+  // @param eles The vector that receives the popped elements.
+  // @param max_num The max number of elements to pop.
+  Status PopFrontBatch(std::vector<T> *eles, size_t max_num) {
+    RETURN_UNEXPECTED_IF_NULL(eles);
+    std::unique_lock<std::mutex> _lock(mux_);
+    // Block when empty
+    Status rc = empty_cv_.Wait(&_lock, [this]() -> bool { return !empty(); });
+    if (rc.IsOk()) {
+      RETURN_IF_NOT_OK(PopFrontBatchWhileHoldingLock(eles, max_num));
       full_cv_.NotifyAll();
       _lock.unlock();
     } else {
@@ -191,11 +258,41 @@ class Queue {
                               // will pop when there is a space in queue (by PopFront or Resize)
   size_t head_;
   size_t tail_;
+  int64_t max_bytes_;  // the byte capacity set by SetMaxBytes, 0 means the queue is only bounded by sz_
+  int64_t bytes_;      // the bytes charged for the elements in arr_ and extra_arr_ when max_bytes_ is set
   std::string my_name_;
   std::mutex mux_;
   CondVar empty_cv_;
   CondVar full_cv_;
 
+  // Whether a producer can add an element, must be called when holding a lock
+  bool HasRoom() const { return size() < capacity() && (max_bytes_ == 0 || bytes_ < max_bytes_ || empty()); }
+
+  // Helper functions for the byte capacity, must be called when holding a lock
+  void ChargeBytes(const_reference ele) {
+    if (max_bytes_ > 0) {
+      bytes_ += QueueElementBytes<T>::Get(ele);
+    }
+  }
+
+  void ReleaseBytes(const_reference ele) {
+    if (max_bytes_ > 0) {
+      bytes_ -= QueueElementBytes<T>::Get(ele);
+      bytes_ = bytes_ > 0 ? bytes_ : 0;
+    }
+  }
+
+  // Helper function for PopFrontBatch, must be called when holding a lock
+  Status PopFrontBatchWhileHoldingLock(std::vector<T> *eles, size_t max_num) {
+    for (size_t i = 0; i < max_num && !empty(); ++i) {
+      T ele;
+      RETURN_IF_NOT_OK(PopFrontWhileHoldingLock(&ele, true));
+      ReleaseBytes(ele);
+      eles->push_back(std::move(ele));
+    }
+    return Status::OK();
+  }
+
   // Helper function for Add, must be called when holding a lock
   Status AddWhileHoldingLock(const_reference ele) {
     auto k = tail_++ % sz_;
@@ -241,10 +338,11 @@ class QueueList {
  public:
   QueueList() {}
 
-  void Init(int num_queues, int capacity) {
+  void Init(int num_queues, int capacity, int64_t max_bytes = 0) {
     queue_list_.reserve(num_queues);
     for (int i = 0; i < num_queues; i++) {
       queue_list_.emplace_back(std::make_unique<Queue<T>>(capacity));
+      queue_list_.back()->SetMaxBytes(max_bytes);
     }
   }
 
@@ -269,6 +367,7 @@ class QueueList {
 
   Status AddQueue(TaskGroup *vg) {
     queue_list_.emplace_back(std::make_unique<Queue<T>>(queue_list_[0]->capacity()));
+    queue_list_.back()->SetMaxBytes(queue_list_[0]->max_bytes());
     return queue_list_[queue_list_.size() - 1]->Register(vg);
   }
   Status RemoveLastQueue() {
@@ -0,0 +1,128 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "minddata/dataset/util/recycling_pool.h"
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include "./securec.h"
+
+namespace mindspore {
+namespace dataset {
+RecyclingPool::~RecyclingPool() {
+  // The blocks still given out are freed by their owners, which hold the pool until then.
+  for (auto &sz_blocks : free_) {
+    for (void *p : sz_blocks.second) {
+      free(p);
+    }
+  }
+}
+
+Status RecyclingPool::Allocate(size_t n, void **pp) {
+  RETURN_UNEXPECTED_IF_NULL(pp);
+  {
+    std::lock_guard<std::mutex> lck(mux_);
+    auto it = free_.find(n);
+    if (it != free_.end() && !it->second.empty()) {
+      *pp = it->second.back();
+      it->second.pop_back();
+      cached_bytes_ -= n;
+      block_size_[*pp] = n;
+      ++num_hit_;
+      return Status::OK();
+    }
+    ++num_miss_;
+  }
+  RETURN_IF_NOT_OK(DeMalloc(n, pp, false));
+  std::lock_guard<std::mutex> lck(mux_);
+  block_size_[*pp] = n;
+  return Status::OK();
+}
+
+void RecyclingPool::Deallocate(void *p) {
+  if (p == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lck(mux_);
+  auto it = block_size_.find(p);
+  if (it == block_size_.end()) {
+    free(p);
+    return;
+  }
+  size_t sz = it->second;
+  block_size_.erase(it);
+  if (cached_bytes_ + sz > max_cached_bytes_) {
+    ReleaseOthers(sz);
+  }
+  if (cached_bytes_ + sz > max_cached_bytes_) {
+    free(p);
+    return;
+  }
+  free_[sz].push_back(p);
+  cached_bytes_ += sz;
+}
+
+Status RecyclingPool::Reallocate(void **p, size_t old_sz, size_t new_sz) {
+  RETURN_UNEXPECTED_IF_NULL(p);
+  if (old_sz >= new_sz) {
+    // Do nothing if we shrink.
+    return Status::OK();
+  }
+  void *q = nullptr;
+  RETURN_IF_NOT_OK(Allocate(new_sz, &q));
+  if (*p != nullptr) {
+    errno_t err = memcpy_s(q, new_sz, *p, old_sz);
+    if (err) {
+      Deallocate(q);
+      RETURN_STATUS_UNEXPECTED(std::to_string(err));
+    }
+    Deallocate(*p);
+  }
+  *p = q;
+  return Status::OK();
+}
+
+uint64_t RecyclingPool::get_max_size() const { return std::numeric_limits<uint64_t>::max(); }
+
+int64_t RecyclingPool::NumHit() const {
+  std::lock_guard<std::mutex> lck(mux_);
+  return num_hit_;
+}
+
+int64_t RecyclingPool::NumMiss() const {
+  std::lock_guard<std::mutex> lck(mux_);
+  return num_miss_;
+}
+
+uint64_t RecyclingPool::CachedBytes() const {
+  std::lock_guard<std::mutex> lck(mux_);
+  return cached_bytes_;
+}
+
+void RecyclingPool::ReleaseOthers(size_t sz) {
+  for (auto it = free_.begin(); it != free_.end();) {
+    if (it->first == sz) {
+      ++it;
+      continue;
+    }
+    for (void *p : it->second) {
+      free(p);
+    }
+    cached_bytes_ -= it->first * it->second.size();
+    it = free_.erase(it);
+  }
+}
+}  // namespace dataset
+}  // namespace mindspore
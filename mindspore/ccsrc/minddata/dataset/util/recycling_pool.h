@@ -0,0 +1,73 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_MINDDATA_DATASET_UTIL_RECYCLING_POOL_H_
+#define MINDSPORE_CCSRC_MINDDATA_DATASET_UTIL_RECYCLING_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "minddata/dataset/util/memory_pool.h"
+
+namespace mindspore {
+namespace dataset {
+// A memory pool for blocks that are allocated again and again in a few sizes, like the buffers of the batches of
+// a pipeline whose shapes don't change. A freed block is kept, and given out again to the next allocation of exactly
+// the same size instead of going back to the system. Up to max_cached_bytes of free blocks are kept, and the blocks of
+// the other sizes are released first when a freed block doesn't fit, so that a change of shape doesn't pin the old
+// buffers. The pool is thread safe, a block may be freed by a thread other than the one that allocates it.
+class RecyclingPool : public MemoryPool {
+ public:
+  explicit RecyclingPool(uint64_t max_cached_bytes)
+      : max_cached_bytes_(max_cached_bytes), cached_bytes_(0), num_hit_(0), num_miss_(0) {}
+
+  ~RecyclingPool() override;
+
+  Status Allocate(size_t n, void **pp) override;
+
+  void Deallocate(void *p) override;
+
+  Status Reallocate(void **p, size_t old_sz, size_t new_sz) override;
+
+  uint64_t get_max_size() const override;
+
+  int PercentFree() const override { return 100; }
+
+  // Number of allocations served from the free blocks
+  int64_t NumHit() const;
+
+  // Number of allocations that go to the system
+  int64_t NumMiss() const;
+
+  // Bytes of the free blocks kept
+  uint64_t CachedBytes() const;
+
+ private:
+  // Release the free blocks of all the sizes other than sz. The mutex must be held.
+  void ReleaseOthers(size_t sz);
+
+  const uint64_t max_cached_bytes_;
+  mutable std::mutex mux_;
+  std::unordered_map<void *, size_t> block_size_;          // size of each block given out and not yet freed
+  std::unordered_map<size_t, std::vector<void *>> free_;  // free blocks of each size
+  uint64_t cached_bytes_;
+  int64_t num_hit_;
+  int64_t num_miss_;
+};
+}  // namespace dataset
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_MINDDATA_DATASET_UTIL_RECYCLING_POOL_H_
@@ -91,6 +91,7 @@ class ReadableSlice {
 class WritableSlice : public ReadableSlice {
  public:
   friend class StorageContainer;
+  friend class CacheCompressedTier;
   friend class CacheService;
   friend class CacheServer;
   /// \brief Default constructor
@@ -63,6 +63,7 @@ using ROW_GROUPS = std::pair<std::vector<std::vector<std::vector<uint64_t>>>, st
 using ROW_GROUP_BRIEF = std::tuple<std::string, int, uint64_t, std::vector<std::vector<uint64_t>>, std::vector<json>>;
 using TASK_CONTENT = std::pair<TaskType, std::vector<std::tuple<std::vector<uint8_t>, json>>>;
 const int kNumBatchInMap = 1000;  // iterator buffer size in row-reader mode
+const int kNumReadAheadTask = 32;  // tasks read ahead of the consumers when the shard files are mapped
 
 class API_PUBLIC ShardReader {
  public:
@@ -194,6 +195,11 @@ class API_PUBLIC ShardReader {
   /// \brief get the size of blob data
   Status GetTotalBlobSize(int64_t *total_blob_size);
 
+  /// \brief hint that the task will be consumed soon, so that the pages of its blob are read ahead. Only takes effect
+  /// when the shard files are mapped, see MS_MINDRECORD_READ_MODE
+  /// \param[in] task_id the id of the task
+  void PrefetchById(int64_t task_id);
+
   /// \brief extract uncompressed data based on column list
   Status UnCompressBlob(const std::vector<uint8_t> &raw_blob_data,
                         std::shared_ptr<std::vector<std::vector<uint8_t>>> *blob_data_ptr);
@@ -277,6 +283,12 @@ class API_PUBLIC ShardReader {
   /// \brief open multiple file handle
   void FileStreamsOperator();
 
+  /// \brief map a shard file into memory, shared by all the consumers
+  Status MapShardFile(const std::string &file_path, int shard_id);
+
+  /// \brief unmap all the mapped shard files
+  void UnmapShardFiles();
+
   /// \brief read one row by one task
   Status ConsumerOneTask(int64_t task_id, uint32_t consumer_id, std::shared_ptr<TASK_CONTENT> *task_content_pt);
 
@@ -307,6 +319,8 @@ class API_PUBLIC ShardReader {
   std::vector<string> file_paths_;                                               // file paths
   std::vector<std::shared_ptr<std::fstream>> file_streams_;                      // single-file handle list
   std::vector<std::vector<std::shared_ptr<std::fstream>>> file_streams_random_;  // multiple-file handle list
+  std::vector<uint8_t *> file_maps_;                                             // mapped shard files, if any
+  std::vector<uint64_t> file_map_sizes_;                                         // sizes of the mapped shard files
 
  private:
   int n_consumer_;                                         // number of workers (threads)
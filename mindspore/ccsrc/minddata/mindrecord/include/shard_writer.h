@@ -129,6 +129,12 @@ class __attribute__((visibility("default"))) ShardWriter {
   void FillArray(int start, int end, std::map<uint64_t, vector<json>> &raw_data,
                  std::vector<std::vector<uint8_t>> &bin_data);
 
+  /// \brief compress blob data in multiple thread run
+  void CompressBlobSlice(int start, int end, std::vector<std::vector<uint8_t>> &blob_data);
+
+  /// \brief compress blob data
+  Status CompressBlobData(std::vector<std::vector<uint8_t>> &blob_data);
+
   /// \brief serialized raw data
   Status SerializeRawData(std::map<uint64_t, std::vector<json>> &raw_data, std::vector<std::vector<uint8_t>> &bin_data,
                           uint32_t row_count);
@@ -16,6 +16,10 @@
 
 #include "minddata/mindrecord/include/shard_reader.h"
 
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
 #include <algorithm>
 #include <thread>
 
@@ -221,23 +225,39 @@ Status ShardReader::Open() {
 Status ShardReader::Open(int n_consumer) {
   file_streams_random_ =
     std::vector<std::vector<std::shared_ptr<std::fstream>>>(n_consumer, std::vector<std::shared_ptr<std::fstream>>());
-  for (const auto &file : file_paths_) {
-    for (int j = 0; j < n_consumer; ++j) {
-      std::optional<std::string> dir = "";
-      std::optional<std::string> local_file_name = "";
-      FileUtils::SplitDirAndFileName(file, &dir, &local_file_name);
-      if (!dir.has_value()) {
-        dir = ".";
-      }
+  file_maps_ = std::vector<uint8_t *>(file_paths_.size(), nullptr);
+  file_map_sizes_ = std::vector<uint64_t>(file_paths_.size(), 0);
+  // the mapped files are shared by all the consumers and read without a syscall per blob
+  bool use_mmap = common::GetEnv("MS_MINDRECORD_READ_MODE") == "mmap";
+  for (size_t shard_id = 0; shard_id < file_paths_.size(); ++shard_id) {
+    const auto &file = file_paths_[shard_id];
+    std::optional<std::string> dir = "";
+    std::optional<std::string> local_file_name = "";
+    FileUtils::SplitDirAndFileName(file, &dir, &local_file_name);
+    if (!dir.has_value()) {
+      dir = ".";
+    }
+
+    auto realpath = FileUtils::GetRealPath(dir.value().data());
+    CHECK_FAIL_RETURN_UNEXPECTED(
+      realpath.has_value(), "Invalid file, failed to get the realpath of mindrecord files. Please check file: " + file);
 
-      auto realpath = FileUtils::GetRealPath(dir.value().data());
-      CHECK_FAIL_RETURN_UNEXPECTED(
-        realpath.has_value(),
-        "Invalid file, failed to get the realpath of mindrecord files. Please check file: " + file);
+    std::optional<std::string> whole_path = "";
+    FileUtils::ConcatDirAndFileName(&realpath, &local_file_name, &whole_path);
 
-      std::optional<std::string> whole_path = "";
-      FileUtils::ConcatDirAndFileName(&realpath, &local_file_name, &whole_path);
+    if (use_mmap) {
+      auto rc = MapShardFile(whole_path.value(), static_cast<int>(shard_id));
+      if (rc.IsOk()) {
+        for (int j = 0; j < n_consumer; ++j) {
+          file_streams_random_[j].push_back(nullptr);
+        }
+        MS_LOG(INFO) << "Succeed to map file, path: " << file;
+        continue;
+      }
+      MS_LOG(WARNING) << "Failed to map file, read it by file streams instead, path: " << file << ", " << rc;
+    }
 
+    for (int j = 0; j < n_consumer; ++j) {
       std::shared_ptr<std::fstream> fs = std::make_shared<std::fstream>();
       fs->open(whole_path.value(), std::ios::in | std::ios::binary);
       if (!fs->good()) {
@@ -253,6 +273,71 @@ Status ShardReader::Open(int n_consumer) {
   return Status::OK();
 }
 
+Status ShardReader::MapShardFile(const std::string &file_path, int shard_id) {
+#if !defined(_WIN32) && !defined(_WIN64)
+  int fd = open(file_path.c_str(), O_RDONLY);
+  CHECK_FAIL_RETURN_UNEXPECTED(fd >= 0, "Failed to open file: " + file_path);
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    (void)close(fd);
+    RETURN_STATUS_UNEXPECTED("Failed to get the size of file: " + file_path);
+  }
+  auto file_size = static_cast<uint64_t>(file_stat.st_size);
+  void *addr = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  (void)close(fd);
+  CHECK_FAIL_RETURN_UNEXPECTED(addr != MAP_FAILED, "Failed to map file: " + file_path);
+  // the sampler decides the order of the blobs, the pages ahead are requested by PrefetchById instead of the kernel.
+  (void)madvise(addr, file_size, MADV_RANDOM);
+  file_maps_[shard_id] = static_cast<uint8_t *>(addr);
+  file_map_sizes_[shard_id] = file_size;
+  return Status::OK();
+#else
+  RETURN_STATUS_UNEXPECTED("Mapping file is not supported on this platform, file: " + file_path);
+#endif
+}
+
+void ShardReader::UnmapShardFiles() {
+#if !defined(_WIN32) && !defined(_WIN64)
+  for (size_t i = 0; i < file_maps_.size(); ++i) {
+    if (file_maps_[i] != nullptr) {
+      (void)munmap(file_maps_[i], file_map_sizes_[i]);
+      file_maps_[i] = nullptr;
+      file_map_sizes_[i] = 0;
+    }
+  }
+#endif
+}
+
+void ShardReader::PrefetchById(int64_t task_id) {
+#if !defined(_WIN32) && !defined(_WIN64)
+  // the blob offsets of a lazy loaded task are only known after querying the index
+  if (lazy_load_ || task_id < 0 || task_id >= tasks_.Size()) {
+    return;
+  }
+  const auto &task = tasks_.GetTaskByID(task_id);
+  if (std::get<0>(task) != TaskType::kCommonTask) {
+    return;
+  }
+  auto shard_id = std::get<0>(std::get<1>(task));
+  if (shard_id < 0 || shard_id >= static_cast<int>(file_maps_.size()) || file_maps_[shard_id] == nullptr) {
+    return;
+  }
+  std::shared_ptr<Page> page_ptr;
+  if (shard_header_->GetPageByGroupId(std::get<1>(std::get<1>(task)), shard_id, &page_ptr).IsError()) {
+    return;
+  }
+  auto page_offset = header_size_ + page_size_ * page_ptr->GetPageID();
+  auto blob_begin = page_offset + std::get<2>(task)[0];
+  auto blob_end = page_offset + std::get<2>(task)[1];
+  if (blob_begin >= blob_end || blob_end > file_map_sizes_[shard_id]) {
+    return;
+  }
+  static const uint64_t kSysPageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  auto aligned_begin = blob_begin / kSysPageSize * kSysPageSize;
+  (void)madvise(file_maps_[shard_id] + aligned_begin, blob_end - aligned_begin, MADV_WILLNEED);
+#endif
+}
+
 void ShardReader::FileStreamsOperator() {
   for (int i = static_cast<int>(file_streams_.size()) - 1; i >= 0; --i) {
     if (file_streams_[i] != nullptr) {
@@ -266,6 +351,7 @@ void ShardReader::FileStreamsOperator() {
       }
     }
   }
+  UnmapShardFiles();
   for (int i = static_cast<int>(database_paths_.size()) - 1; i >= 0; --i) {
     if (database_paths_[i] != nullptr) {
       auto ret = sqlite3_close(database_paths_[i]);
@@ -1288,7 +1374,7 @@ Status ShardReader::ConsumerOneTask(int64_t task_id, uint32_t consumer_id,
   uint32_t blob_end = 0;
   json var_fields;
   // Pick up task from task list
-  ShardTask task = tasks_.GetTaskByID(task_id);
+  const ShardTask &task = tasks_.GetTaskByID(task_id);
 
   // check task type
   auto task_type = std::get<0>(task);
@@ -1330,16 +1416,24 @@ Status ShardReader::ConsumerOneTask(int64_t task_id, uint32_t consumer_id,
   std::vector<uint8_t> images(blob_end - blob_start);
   auto file_offset = header_size_ + page_size_ * (page_ptr->GetPageID()) + blob_start;
 
-  auto &io_seekg = file_streams_random_[consumer_id][shard_id]->seekg(file_offset, std::ios::beg);
-  if (!io_seekg.good() || io_seekg.fail() || io_seekg.bad()) {
-    file_streams_random_[consumer_id][shard_id]->close();
-    RETURN_STATUS_UNEXPECTED("[Internal ERROR] Failed to seekg file.");
-  }
-  auto &io_read =
-    file_streams_random_[consumer_id][shard_id]->read(reinterpret_cast<char *>(&images[0]), blob_end - blob_start);
-  if (!io_read.good() || io_read.fail() || io_read.bad()) {
-    file_streams_random_[consumer_id][shard_id]->close();
-    RETURN_STATUS_UNEXPECTED("[Internal ERROR] Failed to read file.");
+  if (shard_id < file_maps_.size() && file_maps_[shard_id] != nullptr) {
+    CHECK_FAIL_RETURN_UNEXPECTED(file_offset + images.size() <= file_map_sizes_[shard_id],
+                                 "[Internal ERROR] Failed to read file, the blob exceeds the size of the file.");
+    std::copy_n(file_maps_[shard_id] + file_offset, images.size(), images.begin());
+  } else {
+    CHECK_FAIL_RETURN_UNEXPECTED(file_streams_random_[consumer_id][shard_id] != nullptr,
+                                 "[Internal ERROR] Failed to read file, the file is closed.");
+    auto &io_seekg = file_streams_random_[consumer_id][shard_id]->seekg(file_offset, std::ios::beg);
+    if (!io_seekg.good() || io_seekg.fail() || io_seekg.bad()) {
+      file_streams_random_[consumer_id][shard_id]->close();
+      RETURN_STATUS_UNEXPECTED("[Internal ERROR] Failed to seekg file.");
+    }
+    auto &io_read =
+      file_streams_random_[consumer_id][shard_id]->read(reinterpret_cast<char *>(&images[0]), blob_end - blob_start);
+    if (!io_read.good() || io_read.fail() || io_read.bad()) {
+      file_streams_random_[consumer_id][shard_id]->close();
+      RETURN_STATUS_UNEXPECTED("[Internal ERROR] Failed to read file.");
+    }
   }
 
   // Deliver batch data to output map
@@ -1368,6 +1462,10 @@ void ShardReader::ConsumerByRow(int consumer_id) {
     if (sample_id_pos >= static_cast<int>(tasks_.sample_ids_.size())) {
       return;
     }
+    // the pages of the sample the consumers will read next are loaded while this one is decoded
+    if (sample_id_pos + kNumReadAheadTask < static_cast<int>(tasks_.sample_ids_.size())) {
+      PrefetchById(tasks_.sample_ids_[sample_id_pos + kNumReadAheadTask]);
+    }
     auto task_content_ptr =
       std::make_shared<TASK_CONTENT>(TaskType::kCommonTask, std::vector<std::tuple<std::vector<uint8_t>, json>>());
     if (ConsumerOneTask(tasks_.sample_ids_[sample_id_pos], consumer_id, &task_content_ptr).IsError()) {
@@ -495,6 +495,39 @@ void ShardWriter::FillArray(int start, int end, std::map<uint64_t, vector<json>>
   }
 }
 
+void ShardWriter::CompressBlobSlice(int start, int end, std::vector<std::vector<uint8_t>> &blob_data) {
+  int64_t compression_bytes = 0;
+  for (int x = start; x < end; ++x) {
+    int64_t blob_compression_bytes = 0;
+    blob_data[x] = shard_column_->CompressBlob(blob_data[x], &blob_compression_bytes);
+    compression_bytes += blob_compression_bytes;
+  }
+  compression_size_ += compression_bytes;
+}
+
+Status ShardWriter::CompressBlobData(std::vector<std::vector<uint8_t>> &blob_data) {
+  if (!shard_column_->CheckCompressBlob() || blob_data.empty()) {
+    return Status::OK();
+  }
+  // define the number of thread
+  uint32_t thread_num = std::thread::hardware_concurrency();
+  if (thread_num == 0) {
+    thread_num = kThreadNumber;
+  }
+  uint32_t row_count = static_cast<uint32_t>(blob_data.size());
+  // Set the number of blobs compressed by each thread
+  uint32_t group_num = (row_count + thread_num - 1) / thread_num;
+  std::vector<std::thread> thread_set;
+  for (uint32_t start_num = 0; start_num < row_count; start_num += group_num) {
+    uint32_t end_num = std::min(start_num + group_num, row_count);
+    thread_set.emplace_back(&ShardWriter::CompressBlobSlice, this, start_num, end_num, std::ref(blob_data));
+  }
+  for (auto &thread : thread_set) {
+    thread.join();
+  }
+  return Status::OK();
+}
+
 Status ShardWriter::LockWriter(bool parallel_writer, std::unique_ptr<int> *fd_ptr) {
   if (!parallel_writer) {
     *fd_ptr = std::make_unique<int>(0);
@@ -567,15 +600,6 @@ Status ShardWriter::WriteRawDataPreCheck(std::map<uint64_t, std::vector<json>> &
   CHECK_FAIL_RETURN_UNEXPECTED(
     *size_ptr >= kMinFreeDiskSize,
     "No free disk to be used while writing mindrecord files, available free disk size: " + std::to_string(*size_ptr));
-  // compress blob
-  if (shard_column_->CheckCompressBlob()) {
-    for (auto &blob : blob_data) {
-      int64_t compression_bytes = 0;
-      blob = shard_column_->CompressBlob(blob, &compression_bytes);
-      compression_size_ += compression_bytes;
-    }
-  }
-
   // Add 4-bytes dummy blob data if no any blob fields
   if (blob_data.size() == 0 && raw_data.size() > 0) {
     blob_data = std::vector<std::vector<uint8_t>>(raw_data[0].size(), std::vector<uint8_t>(kUnsignedInt4, 0));
@@ -587,6 +611,8 @@ Status ShardWriter::WriteRawDataPreCheck(std::map<uint64_t, std::vector<json>> &
   }
   std::shared_ptr<std::pair<int, int>> count_ptr;
   RETURN_IF_NOT_OK(ValidateRawData(raw_data, blob_data, sign, &count_ptr));
+  // compress blob after the invalid rows are erased
+  RETURN_IF_NOT_OK(CompressBlobData(blob_data));
   *schema_count = (*count_ptr).first;
   *row_count = (*count_ptr).second;
   return Status::OK();
@@ -713,17 +739,24 @@ Status ShardWriter::ParallelWriteData(const std::vector<std::vector<uint8_t>> &b
     }
     // Start one thread for one shard
     std::vector<std::thread> thread_set(thread_num);
+    std::vector<Status> shard_status(thread_num);
     if (thread_num <= kMaxThreadCount) {
       for (int x = 0; x < thread_num; ++x) {
-        int start_row = shards[current_thread + x].first;
-        int end_row = shards[current_thread + x].second;
-        thread_set[x] = std::thread(&ShardWriter::WriteByShard, this, current_thread + x, start_row, end_row,
-                                    std::ref(blob_data), std::ref(bin_raw_data));
+        int shard_id = current_thread + x;
+        int start_row = shards[shard_id].first;
+        int end_row = shards[shard_id].second;
+        thread_set[x] = std::thread([this, x, shard_id, start_row, end_row, &shard_status, &blob_data,
+                                     &bin_raw_data]() {
+          shard_status[x] = WriteByShard(shard_id, start_row, end_row, blob_data, bin_raw_data);
+        });
       }
       // Wait for threads done
       for (int x = 0; x < thread_num; ++x) {
         thread_set[x].join();
       }
+      for (int x = 0; x < thread_num; ++x) {
+        RETURN_IF_NOT_OK(shard_status[x]);
+      }
       left_thread -= thread_num;
       current_thread += thread_num;
     }
@@ -808,7 +841,7 @@ Status ShardWriter::AppendBlobPage(const int &shard_id, const std::vector<std::v
     RETURN_STATUS_UNEXPECTED("[Internal ERROR] Failed to seekg file.");
   }
 
-  (void)FlushBlobChunk(file_streams_[shard_id], blob_data, blob_row);
+  RETURN_IF_NOT_OK(FlushBlobChunk(file_streams_[shard_id], blob_data, blob_row));
 
   // Update last blob page
   bytes_page += std::accumulate(blob_data_size_.begin() + blob_row.first, blob_data_size_.begin() + blob_row.second, 0);
@@ -836,7 +869,7 @@ Status ShardWriter::NewBlobPage(const int &shard_id, const std::vector<std::vect
       RETURN_STATUS_UNEXPECTED("[Internal ERROR] Failed to seekg file.");
     }
 
-    (void)FlushBlobChunk(file_streams_[shard_id], blob_data, blob_row);
+    RETURN_IF_NOT_OK(FlushBlobChunk(file_streams_[shard_id], blob_data, blob_row));
     // Create new page info for header
     auto page_size =
       std::accumulate(blob_data_size_.begin() + blob_row.first, blob_data_size_.begin() + blob_row.second, 0);
@@ -995,8 +1028,8 @@ Status ShardWriter::FlushBlobChunk(const std::shared_ptr<std::fstream> &out,
     }
 
     // Write the data of blob
-    auto line = blob_data[j];
-    auto &io_handle_data = out->write(reinterpret_cast<char *>(&line[0]), line_len);
+    const auto &line = blob_data[j];
+    auto &io_handle_data = out->write(reinterpret_cast<const char *>(line.data()), line_len);
     if (!io_handle_data.good() || io_handle_data.fail() || io_handle_data.bad()) {
       out->close();
       RETURN_STATUS_UNEXPECTED("[Internal ERROR] Failed to write file.");
@@ -1020,8 +1053,8 @@ Status ShardWriter::FlushRawChunk(const std::shared_ptr<std::fstream> &out,
     }
     // Write the data of multi schemas
     for (uint32_t j = 0; j < schema_count_; ++j) {
-      auto line = bin_raw_data[i * schema_count_ + j];
-      auto &io_handle = out->write(reinterpret_cast<char *>(&line[0]), line.size());
+      const auto &line = bin_raw_data[i * schema_count_ + j];
+      auto &io_handle = out->write(reinterpret_cast<const char *>(line.data()), line.size());
       if (!io_handle.good() || io_handle.fail() || io_handle.bad()) {
         out->close();
         RETURN_STATUS_UNEXPECTED("[Internal ERROR] Failed to write file.");
@@ -53,6 +53,9 @@
 #include "debug/trace.h"
 #include "debug/draw.h"
 #include "debug/common.h"
+#ifndef ENABLE_SECURITY
+#include "debug/data_dump/dump_json_parser.h"
+#endif
 #include "load_mindir/load_model.h"
 #include "vm/segment_runner.h"
 #include "backend/session/executor_manager.h"
@@ -1784,6 +1787,9 @@ void ClearResAtexit() {
 #endif
   session::ExecutorManager::Instance().Clear();
   runtime::GraphScheduler::GetInstance().Clear();
+#ifndef ENABLE_SECURITY
+  DumpJsonParser::GetInstance().Finalize();
+#endif
 
   MS_LOG(INFO) << "Start clear device context...";
   device::DeviceContextManager::GetInstance().ClearDeviceContexts();
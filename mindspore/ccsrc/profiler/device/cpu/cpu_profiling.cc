@@ -17,11 +17,15 @@
 #include "profiler/device/cpu/cpu_profiling.h"
 
 #include <cxxabi.h>
+#include <unistd.h>
 #include <cmath>
 #include <ctime>
+#include <exception>
 #include "profiler/device/cpu/cpu_data_saver.h"
 #include "pybind_api/api_register.h"
+#include "utils/convert_utils_base.h"
 #include "utils/log_adapter.h"
+#include "utils/ms_utils.h"
 #include "utils/utils.h"
 #include "utils/ms_context.h"
 
@@ -32,37 +36,89 @@ std::shared_ptr<CPUProfiler> CPUProfiler::profiler_inst_ = std::make_shared<CPUP
 
 std::shared_ptr<CPUProfiler> &CPUProfiler::GetInstance() { return profiler_inst_; }
 
+namespace {
+// Number of trace events each thread keeps between two drains of the trace recorder, about 40 bytes each.
+constexpr char kTraceRingSizeEnv[] = "MS_CPU_TRACE_RING_SIZE";
+constexpr size_t kDefaultTraceRingSize = 1 << 14;
+
+// The op being launched by each thread.
+thread_local TraceEvent t_op_event = {CPUProfiler::kInvalidOpId};
+
+size_t TraceRingCapacity() {
+  auto ring_size = common::GetEnv(kTraceRingSizeEnv);
+  if (ring_size.empty()) {
+    return kDefaultTraceRingSize;
+  }
+  size_t capacity = 0;
+  try {
+    capacity = std::stoul(ring_size);
+  } catch (const std::exception &) {
+    capacity = 0;
+  }
+  if (capacity > 0) {
+    return capacity;
+  }
+  MS_LOG(WARNING) << "The " << kTraceRingSizeEnv << " should be a positive integer, but got " << ring_size
+                  << ", use the default size " << kDefaultTraceRingSize;
+  return kDefaultTraceRingSize;
+}
+}  // namespace
+
 void CPUProfiler::Init(const std::string &profileDataPath = "") {
   MS_LOG(INFO) << "Initialize CPU Profiling";
   base_time_ = GetHostMonoTimeStamp();
   profile_data_path_ = profileDataPath;
   MS_LOG(INFO) << " Host start time(ns): " << base_time_ << " profile data path: " << profile_data_path_;
+  StartTrace();
 }
 
 void CPUProfiler::StepProfilingEnable(const bool enable_flag) {
   MS_LOG(INFO) << "CPU Profiler enable flag: " << enable_flag;
+  if (enable_flag && !trace_recorder_.running()) {
+    StartTrace();
+  }
   enable_flag_ = enable_flag;
 }
 
-void CPUProfiler::SetRunTimeData(const std::string &op_name, const uint32_t pid) {
-  auto iter = op_info_map_.find(op_name);
-  if (iter != op_info_map_.end()) {
-    iter->second.op_count += 1;
-  } else {
-    OpInfo op_info;
-    op_info.op_name = op_name;
-    op_info.pid = pid;
-    op_info.op_count = 1;
-    op_info_map_[op_name] = op_info;
+void CPUProfiler::StartTrace() {
+  std::string trace_file;
+  if (!profile_data_path_.empty()) {
+    trace_file = profile_data_path_ + "/cpu_trace_" + std::to_string(getpid()) + ".json";
   }
-  op_name_ = op_name;
-  pid_ = pid;
+  trace_recorder_.Start(trace_file, IntToUint(getpid()), TraceRingCapacity(),
+                        [this](const std::vector<TraceEvent> &events, const std::vector<std::string> &op_names) {
+                          SetRunTimeData(events, op_names);
+                        });
 }
 
-void CPUProfiler::OpDataProducerBegin(const std::string op_name, const uint32_t pid) {
-  op_time_start_ = GetHostMonoTimeStamp();
-  op_time_mono_start_ = GetHostMonoTimeStamp();
-  SetRunTimeData(op_name, pid);
+void CPUProfiler::SetRunTimeData(const std::vector<TraceEvent> &events, const std::vector<std::string> &op_names) {
+  auto pid = pid_.load(std::memory_order_relaxed);
+  for (const auto &event : events) {
+    if (event.kind != kTraceKernel || event.op_id >= op_names.size()) {
+      continue;
+    }
+    const auto &op_name = op_names[event.op_id];
+    auto iter = op_info_map_.find(op_name);
+    if (iter != op_info_map_.end()) {
+      iter->second.op_count += 1;
+    } else {
+      OpInfo op_info;
+      op_info.op_name = op_name;
+      op_info.pid = pid;
+      op_info.op_count = 1;
+      op_info_map_[op_name] = op_info;
+    }
+    float op_time_elapsed = (event.end - event.start) / kNanosecondToMillisecond;
+    MS_LOG(DEBUG) << "Host Time Elapsed(ms)," << op_name << "," << op_time_elapsed;
+    Profiler::SetRunTimeData(op_name, op_time_elapsed);
+    Profiler::SetRunTimeData(op_name, event.start, op_time_elapsed);
+  }
+}
+
+void CPUProfiler::OpDataProducerBegin(const uint32_t op_id, const uint32_t pid, const uint64_t bytes) {
+  pid_.store(pid, std::memory_order_relaxed);
+  t_op_event.op_id = op_id;
+  t_op_event.bytes = bytes;
 
 #if ENABLE_GPU
   if (MsContext::GetInstance()->get_param<bool>(MS_CTX_ENABLE_MINDRT)) {
@@ -70,23 +126,38 @@ void CPUProfiler::OpDataProducerBegin(const std::string op_name, const uint32_t
     auto gpu_profiler_inst = profiler::gpu::GPUProfiler::GetInstance();
     // For cpu network, no gpu profiler, do not to raise exception.
     if (gpu_profiler_inst && gpu_profiler_inst->GetEnableFlag()) {
-      gpu_profiler_inst->RecordOneStepStartEndInfo(op_name);
+      gpu_profiler_inst->RecordOneStepStartEndInfo(trace_recorder_.OpName(op_id));
     }
   }
 #endif
+  t_op_event.start = TraceRecorder::Now();
 }
 
 void CPUProfiler::OpDataProducerEnd() {
-  float op_time_elapsed = 0;
-  op_time_stop_ = GetHostMonoTimeStamp();
-  op_time_elapsed = (op_time_stop_ - op_time_start_) / kNanosecondToMillisecond;
-  MS_LOG(DEBUG) << "Host Time Elapsed(ms)," << op_name_ << "," << op_time_elapsed;
-  Profiler::SetRunTimeData(op_name_, op_time_elapsed);
-  Profiler::SetRunTimeData(op_name_, op_time_mono_start_, op_time_elapsed);
+  t_op_event.end = TraceRecorder::Now();
+  trace_recorder_.Record(t_op_event);
+  t_op_event.op_id = kInvalidOpId;
+}
+
+uint32_t CPUProfiler::CurrentOpId() const { return t_op_event.op_id; }
+
+void CPUProfiler::RecordSubTask(const uint32_t op_id, const int task_id, const uint64_t start) {
+  if (op_id == kInvalidOpId) {
+    return;
+  }
+  TraceEvent event;
+  event.op_id = op_id;
+  event.kind = kTraceSubTask;
+  event.task_id = task_id;
+  event.start = start;
+  event.end = TraceRecorder::Now();
+  trace_recorder_.Record(event);
 }
 
 void CPUProfiler::Stop() {
   MS_LOG(INFO) << "Stop CPU Profiling";
+  // The op timings are accumulated by the trace recorder, all of them are in once it stops.
+  trace_recorder_.Stop();
   SaveProfileData();
   ClearInst();
 }
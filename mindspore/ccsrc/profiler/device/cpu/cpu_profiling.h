@@ -17,13 +17,17 @@
 #ifndef MINDSPORE_CCSRC_PROFILER_DEVICE_CPU_PROFILING_H
 #define MINDSPORE_CCSRC_PROFILER_DEVICE_CPU_PROFILING_H
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstdio>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 #include "profiler/device/profiling.h"
+#include "profiler/device/cpu/cpu_trace.h"
 #if ENABLE_GPU
 #include "profiler/device/gpu/gpu_profiling.h"
 #endif
@@ -44,22 +48,31 @@ class CPUProfiler : public Profiler {
   void Init(const std::string &profileDataPath) override;
   void Stop() override;
   void StepProfilingEnable(const bool enable_flag) override;
-  void OpDataProducerBegin(const std::string op_name, const uint32_t pid);
+  // The id of an op in the trace, which stays the same while the process runs. Resolve it once per kernel.
+  uint32_t OpId(const std::string &op_name) { return trace_recorder_.OpId(op_name); }
+  // Begin and end the op launched by the calling thread, bytes is the size of its inputs and outputs.
+  void OpDataProducerBegin(const uint32_t op_id, const uint32_t pid, const uint64_t bytes = 0);
   void OpDataProducerEnd() override;
 
+  // The op launched by the calling thread, or kInvalidOpId if there is none.
+  uint32_t CurrentOpId() const;
+  // Record a sub-task of the parallel launch of an op, which runs on the calling thread.
+  void RecordSubTask(const uint32_t op_id, const int task_id, const uint64_t start);
+  static uint64_t TraceTime() { return TraceRecorder::Now(); }
+
+  static constexpr uint32_t kInvalidOpId = UINT32_MAX;
+
  private:
-  void SetRunTimeData(const std::string &op_name, const uint32_t pid);
+  // Accumulate the op timings from the trace events, on the flush thread of the trace recorder.
+  void SetRunTimeData(const std::vector<TraceEvent> &events, const std::vector<std::string> &op_names);
+  void StartTrace();
   void SaveProfileData() override;
   void ClearInst() override;
 
   static std::shared_ptr<CPUProfiler> profiler_inst_;
   uint64_t base_time_;
-  std::string op_name_;
-  uint32_t pid_;
-
-  uint64_t op_time_start_;
-  uint64_t op_time_mono_start_;
-  uint64_t op_time_stop_;
+  std::atomic<uint32_t> pid_{0};
+  TraceRecorder trace_recorder_;
 };
 }  // namespace cpu
 }  // namespace profiler
@@ -0,0 +1,269 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "profiler/device/cpu/cpu_trace.h"
+#include <ctime>
+#include <chrono>
+#include <utility>
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace profiler {
+namespace cpu {
+namespace {
+constexpr auto kTraceFlushInterval = std::chrono::milliseconds(200);
+constexpr uint64_t kNSecondInSecond = 1000000000;
+constexpr double kNSecondInUSecond = 1000.0;
+
+// The generations of all the recorders, so that a thread never takes the ring of a stopped run for a new one.
+std::atomic<uint64_t> g_trace_generation{0};
+
+struct ThreadTraceState {
+  uint64_t generation = 0;
+  std::shared_ptr<TraceRing> ring;
+};
+
+thread_local ThreadTraceState t_trace_state;
+
+std::string EscapeJson(const std::string &str) {
+  std::string escaped;
+  escaped.reserve(str.size());
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped.push_back('\\');
+    }
+    escaped.push_back(c);
+  }
+  return escaped;
+}
+
+size_t RoundUpPowerOfTwo(size_t n) {
+  size_t power = 1;
+  while (power < n) {
+    power <<= 1;
+  }
+  return power;
+}
+}  // namespace
+
+TraceRing::TraceRing(uint32_t tid, size_t capacity)
+    : tid_(tid), events_(RoundUpPowerOfTwo(capacity)), mask_(events_.size() - 1) {}
+
+bool TraceRing::Push(const TraceEvent &event) {
+  auto head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) >= events_.size()) {
+    (void)num_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  events_[head & mask_] = event;
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+void TraceRing::PopAll(std::vector<TraceEvent> *events) {
+  auto tail = tail_.load(std::memory_order_relaxed);
+  auto head = head_.load(std::memory_order_acquire);
+  for (; tail != head; ++tail) {
+    events->push_back(events_[tail & mask_]);
+  }
+  tail_.store(tail, std::memory_order_release);
+}
+
+TraceRecorder::~TraceRecorder() { Stop(); }
+
+void TraceRecorder::Start(const std::string &file_path, uint32_t pid, size_t ring_capacity, Consumer consumer) {
+  Stop();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_dropped_ = 0;
+    generation_.store(++g_trace_generation, std::memory_order_relaxed);
+  }
+  pid_ = pid;
+  ring_capacity_ = ring_capacity;
+  consumer_ = std::move(consumer);
+  base_time_ = Now();
+  first_event_ = true;
+  if (!file_path.empty()) {
+    trace_file_.open(file_path, std::ios::out | std::ios::trunc);
+    if (!trace_file_.is_open()) {
+      MS_LOG(WARNING) << "Open trace file '" << file_path << "' failed!";
+    } else {
+      trace_file_ << "{\"traceEvents\":[";
+    }
+  }
+  stop_ = false;
+  running_.store(true, std::memory_order_release);
+  flush_thread_ = std::thread(&TraceRecorder::Run, this);
+}
+
+void TraceRecorder::Stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(flush_mutex_);
+    stop_ = true;
+  }
+  stop_cond_.notify_all();
+  if (flush_thread_.joinable()) {
+    flush_thread_.join();
+  }
+  Drain();
+  if (trace_file_.is_open()) {
+    trace_file_ << "]}\n";
+    trace_file_.close();
+  }
+  // Release the rings, the threads take new ones in the next run.
+  uint64_t dropped = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &ring : rings_) {
+      dropped += ring->num_dropped();
+    }
+    rings_.clear();
+    num_dropped_ = dropped;
+    generation_.store(++g_trace_generation, std::memory_order_relaxed);
+  }
+  if (dropped > 0) {
+    MS_LOG(WARNING) << "The trace rings are full, " << dropped << " trace events are dropped.";
+  }
+  consumer_ = nullptr;
+}
+
+uint32_t TraceRecorder::OpId(const std::string &op_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = op_ids_.find(op_name);
+  if (iter != op_ids_.end()) {
+    return iter->second;
+  }
+  auto op_id = static_cast<uint32_t>(op_names_.size());
+  op_names_.push_back(op_name);
+  (void)op_ids_.emplace(op_name, op_id);
+  return op_id;
+}
+
+std::string TraceRecorder::OpName(uint32_t op_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return op_id < op_names_.size() ? op_names_[op_id] : std::string();
+}
+
+void TraceRecorder::Record(const TraceEvent &event) {
+  if (!running()) {
+    return;
+  }
+  auto ring = ThreadRing();
+  TraceEvent traced = event;
+  traced.tid = ring->tid();
+  (void)ring->Push(traced);
+}
+
+uint64_t TraceRecorder::num_dropped() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t dropped = num_dropped_;
+  for (const auto &ring : rings_) {
+    dropped += ring->num_dropped();
+  }
+  return dropped;
+}
+
+uint64_t TraceRecorder::Now() {
+  struct timespec ts;
+#if defined(_WIN32) || defined(_WIN64)
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+  // The same clock as Profiler::GetHostMonoTimeStamp, so that the events line up with the other host timestamps.
+  (void)clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#endif
+  return static_cast<uint64_t>(ts.tv_sec) * kNSecondInSecond + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+TraceRing *TraceRecorder::ThreadRing() {
+  auto &state = t_trace_state;
+  auto generation = generation_.load(std::memory_order_relaxed);
+  if (state.generation != generation) {
+    state = ThreadTraceState();
+    state.generation = generation;
+  }
+  if (state.ring == nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state.ring = std::make_shared<TraceRing>(static_cast<uint32_t>(rings_.size()), ring_capacity_);
+    rings_.push_back(state.ring);
+  }
+  return state.ring.get();
+}
+
+void TraceRecorder::Run() {
+  std::unique_lock<std::mutex> lock(flush_mutex_);
+  while (!stop_) {
+    (void)stop_cond_.wait_for(lock, kTraceFlushInterval, [this]() { return stop_; });
+    lock.unlock();
+    Drain();
+    lock.lock();
+  }
+}
+
+void TraceRecorder::Drain() {
+  std::vector<std::shared_ptr<TraceRing>> rings;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rings = rings_;
+  }
+  std::vector<TraceEvent> events;
+  for (const auto &ring : rings) {
+    ring->PopAll(&events);
+  }
+  if (events.empty()) {
+    return;
+  }
+  // The ops of the events popped are interned before they are pushed, take the names after popping.
+  std::vector<std::string> op_names;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    op_names = op_names_;
+  }
+  WriteEvents(events, op_names);
+  if (consumer_ != nullptr) {
+    consumer_(events, op_names);
+  }
+}
+
+void TraceRecorder::WriteEvents(const std::vector<TraceEvent> &events, const std::vector<std::string> &op_names) {
+  if (!trace_file_.is_open()) {
+    return;
+  }
+  for (const auto &event : events) {
+    if (!first_event_) {
+      trace_file_ << ",";
+    }
+    first_event_ = false;
+    auto start = event.start > base_time_ ? event.start - base_time_ : 0;
+    auto duration = event.end > event.start ? event.end - event.start : 0;
+    const std::string &op_name = event.op_id < op_names.size() ? op_names[event.op_id] : std::string();
+    trace_file_ << "\n{\"name\":\"" << EscapeJson(op_name) << "\",\"cat\":\""
+                << (event.kind == kTraceKernel ? "kernel" : "sub_task") << "\",\"ph\":\"X\",\"ts\":"
+                << std::fixed << start / kNSecondInUSecond << ",\"dur\":" << duration / kNSecondInUSecond
+                << ",\"pid\":" << pid_ << ",\"tid\":" << event.tid << ",\"args\":{";
+    if (event.kind == kTraceKernel) {
+      trace_file_ << "\"bytes\":" << event.bytes << "}}";
+    } else {
+      trace_file_ << "\"task_id\":" << event.task_id << "}}";
+    }
+  }
+  trace_file_.flush();
+}
+}  // namespace cpu
+}  // namespace profiler
+}  // namespace mindspore
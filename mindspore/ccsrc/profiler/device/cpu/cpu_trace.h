@@ -0,0 +1,134 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PROFILER_DEVICE_CPU_CPU_TRACE_H
+#define MINDSPORE_CCSRC_PROFILER_DEVICE_CPU_CPU_TRACE_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mindspore {
+namespace profiler {
+namespace cpu {
+enum TraceEventKind : uint32_t { kTraceKernel = 0, kTraceSubTask = 1 };
+
+// A fixed size trace event, the op is kept as an id so that recording it doesn't copy the name.
+struct TraceEvent {
+  uint32_t op_id = 0;
+  uint32_t kind = kTraceKernel;
+  uint32_t tid = 0;
+  int32_t task_id = -1;  // the sub-task of a parallel launch, -1 for a kernel
+  uint64_t start = 0;    // ns
+  uint64_t end = 0;      // ns
+  uint64_t bytes = 0;    // input and output bytes of a kernel
+};
+
+// Lock free ring of the events of one thread. The thread pushes and the flush thread pops, an event pushed when the
+// ring is full is dropped and counted. The capacity is rounded up to a power of two.
+class TraceRing {
+ public:
+  TraceRing(uint32_t tid, size_t capacity);
+  ~TraceRing() = default;
+  TraceRing(const TraceRing &) = delete;
+  TraceRing &operator=(const TraceRing &) = delete;
+
+  bool Push(const TraceEvent &event);
+  // Append all the events in the ring to events.
+  void PopAll(std::vector<TraceEvent> *events);
+  uint32_t tid() const { return tid_; }
+  size_t capacity() const { return events_.size(); }
+  uint64_t num_dropped() const { return num_dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  const uint32_t tid_;
+  std::vector<TraceEvent> events_;
+  const uint64_t mask_;
+  alignas(64) std::atomic<uint64_t> head_{0};  // next slot to push, written by the thread only
+  alignas(64) std::atomic<uint64_t> tail_{0};  // next slot to pop, written by the flush thread only
+  std::atomic<uint64_t> num_dropped_{0};
+};
+
+// Collects the trace events of all the threads. Each thread records into its own ring, which is created at its first
+// event, and a background thread drains the rings periodically into a Chrome trace file and hands the events to the
+// consumer, so that recording an event costs two clock reads and a store. The rings are released when the recorder
+// stops, a thread still holding one frees it at its next event or when it exits. The op ids stay the same for the life
+// of the recorder, so that a kernel interns its name once and keeps the id.
+class TraceRecorder {
+ public:
+  // Called on the flush thread with the events drained and the names of all the ops, indexed by op id.
+  using Consumer =
+    std::function<void(const std::vector<TraceEvent> &events, const std::vector<std::string> &op_names)>;
+
+  TraceRecorder() = default;
+  ~TraceRecorder();
+  TraceRecorder(const TraceRecorder &) = delete;
+  TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+  // Start the flush thread, each thread keeps up to ring_capacity events between two drains. The trace file is not
+  // written if file_path is empty.
+  void Start(const std::string &file_path, uint32_t pid, size_t ring_capacity, Consumer consumer);
+  // Drain the rings for the last time, then close the trace file.
+  void Stop();
+  bool running() const { return running_.load(std::memory_order_relaxed); }
+
+  // Intern the name of an op. It takes a lock, resolve the id once per kernel rather than at each launch.
+  uint32_t OpId(const std::string &op_name);
+  std::string OpName(uint32_t op_id);
+  void Record(const TraceEvent &event);
+  // The events dropped in the current run, or in the last one once it is stopped.
+  uint64_t num_dropped();
+
+  static uint64_t Now();
+
+ private:
+  TraceRing *ThreadRing();
+  void Run();
+  void Drain();
+  void WriteEvents(const std::vector<TraceEvent> &events, const std::vector<std::string> &op_names);
+
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> generation_{0};
+  uint32_t pid_{0};
+  size_t ring_capacity_{0};
+  Consumer consumer_;
+
+  std::mutex mutex_;  // guards the rings and the op names, only taken by a thread at its first event or op
+  std::vector<std::shared_ptr<TraceRing>> rings_;
+  uint64_t num_dropped_{0};  // events dropped by the rings of the last run, once they are released
+  std::unordered_map<std::string, uint32_t> op_ids_;
+  std::vector<std::string> op_names_;
+
+  std::mutex flush_mutex_;  // guards stop_
+  std::condition_variable stop_cond_;
+  bool stop_{false};
+  std::thread flush_thread_;
+  std::ofstream trace_file_;
+  bool first_event_{true};
+  uint64_t base_time_{0};
+};
+}  // namespace cpu
+}  // namespace profiler
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_PROFILER_DEVICE_CPU_CPU_TRACE_H
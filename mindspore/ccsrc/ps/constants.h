@@ -39,6 +39,9 @@ constexpr char kEnvSchedulerHost[] = "MS_SCHED_HOST";
 constexpr char kEnvSchedulerPort[] = "MS_SCHED_PORT";
 constexpr char kEnvSchedulerManagePort[] = "MS_SCHED_MANAGE_PORT";
 constexpr char kEnvNodeId[] = "MS_NODE_ID";
+constexpr char kEnvCacheEvictionPolicy[] = "MS_CACHE_EVICTION_POLICY";
+constexpr char kEnvGradCompression[] = "MS_GRAD_COMPRESSION";
+constexpr char kEnvGradCompressionTopKRatio[] = "MS_GRAD_COMPRESSION_TOPK_RATIO";
 
 constexpr char kCommTypeOfIBVerbs[] = "ibverbs";
 constexpr char kRoleOfPServer[] = "server";
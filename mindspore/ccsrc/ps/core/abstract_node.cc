@@ -455,6 +455,15 @@ uint16_t AbstractNode::scheduler_port() const { return scheduler_port_; }
 
 void AbstractNode::set_scheduler_port(const uint16_t &scheduler_port) { scheduler_port_ = scheduler_port; }
 
+std::string AbstractNode::GetNodeIp(const NodeRole &node_role, const uint32_t &rank_id) {
+  std::lock_guard<std::mutex> lock(client_mutex_);
+  auto iter = nodes_address_.find(std::make_pair(node_role, rank_id));
+  if (iter == nodes_address_.end()) {
+    return "";
+  }
+  return iter->second.first;
+}
+
 ClusterState AbstractNode::cluster_state() const { return current_cluster_state_; }
 
 void AbstractNode::set_handler(const RequestHandler &handler) { request_handler_ = handler; }
@@ -137,6 +137,9 @@ class AbstractNode : public Node {
   uint16_t scheduler_port() const;
   void set_scheduler_port(const uint16_t &scheduler_port);
 
+  // The ip of the node of node_role and rank_id in the cluster, empty if it's unknown.
+  std::string GetNodeIp(const NodeRole &node_role, const uint32_t &rank_id);
+
   ClusterState cluster_state() const;
 
   void set_handler(const RequestHandler &handler);
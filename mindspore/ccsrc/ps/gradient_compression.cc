@@ -0,0 +1,241 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ps/gradient_compression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include "base/float16.h"
+#include "utils/convert_utils_base.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace ps {
+namespace {
+constexpr float kInt8Max = 127.0;
+constexpr uint32_t kBf16Shift = 16;
+constexpr uint32_t kBf16RoundBias = 0x7FFF;
+constexpr uint16_t kBf16Nan = 0x7FC0;
+
+uint16_t FloatToBf16(float v) {
+  if (std::isnan(v)) {
+    return kBf16Nan;
+  }
+  uint32_t bits = 0;
+  (void)memcpy(&bits, &v, sizeof(bits));
+  // Round to the nearest, ties to even.
+  bits += kBf16RoundBias + ((bits >> kBf16Shift) & 1);
+  return static_cast<uint16_t>(bits >> kBf16Shift);
+}
+
+float Bf16ToFloat(uint16_t v) {
+  uint32_t bits = static_cast<uint32_t>(v) << kBf16Shift;
+  float f = 0;
+  (void)memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+void AppendHalf(uint16_t v, std::string *out) { out->append(reinterpret_cast<const char *>(&v), sizeof(v)); }
+
+uint16_t ReadHalf(const std::string &in, size_t pos) {
+  uint16_t v = 0;
+  (void)memcpy(&v, in.data() + pos, sizeof(v));
+  return v;
+}
+}  // namespace
+
+bool GradientCompressor::ParseCompressType(const std::string &name, CompressType *type) {
+  MS_EXCEPTION_IF_NULL(type);
+  if (name == "fp16") {
+    *type = FP16;
+  } else if (name == "bf16") {
+    *type = BF16;
+  } else if (name == "int8") {
+    *type = INT8;
+  } else if (name == "topk") {
+    *type = TOP_K;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void GradientCompressor::Compress(KVMessage *kvs) {
+  MS_EXCEPTION_IF_NULL(kvs);
+  if (type_ == NO_COMPRESS || kvs->values().empty() || kvs->keys_size() != kvs->len_size()) {
+    return;
+  }
+  const auto &values = kvs->values();
+  google::protobuf::RepeatedField<float> kept_values;
+  std::string compressed;
+  std::lock_guard<std::mutex> lock(residual_mutex_);
+  // The number of times each key is met so far, which is the index of the input of the key.
+  std::map<Key, size_t> input_indices;
+  int offset = 0;
+  for (int i = 0; i < kvs->keys_size(); ++i) {
+    auto len = static_cast<int>(kvs->len(i));
+    size_t input_index = input_indices[kvs->keys(i)]++;
+    if (offset + len > values.size()) {
+      MS_LOG(EXCEPTION) << "The values of the push message are less than the lengths of its keys.";
+    }
+    const float *grad = values.data() + offset;
+    offset += len;
+    CompressType type = IntToSize(len) < kMinCompressSize ? NO_COMPRESS : type_;
+    kvs->add_compress_types(type);
+    if (type == NO_COMPRESS) {
+      kept_values.Add(grad, grad + len);
+      continue;
+    }
+    if (type == FP16) {
+      for (int j = 0; j < len; ++j) {
+        auto half = float16(grad[j]);
+        uint16_t bits = 0;
+        (void)memcpy(&bits, &half, sizeof(bits));
+        AppendHalf(bits, &compressed);
+      }
+      continue;
+    }
+    if (type == BF16) {
+      for (int j = 0; j < len; ++j) {
+        AppendHalf(FloatToBf16(grad[j]), &compressed);
+      }
+      continue;
+    }
+    // Compress the gradient with the error left by the last push.
+    auto &residual = residuals_[{kvs->keys(i), input_index}];
+    residual.resize(IntToSize(len), 0);
+    for (int j = 0; j < len; ++j) {
+      residual[j] += grad[j];
+    }
+    if (type == INT8) {
+      float max_abs = 0;
+      for (int j = 0; j < len; ++j) {
+        max_abs = std::max(max_abs, std::fabs(residual[j]));
+      }
+      float scale = max_abs > 0 ? max_abs / kInt8Max : 1.0f;
+      kvs->add_scales(scale);
+      for (int j = 0; j < len; ++j) {
+        auto q = static_cast<int8_t>(std::max(-kInt8Max, std::min(kInt8Max, std::round(residual[j] / scale))));
+        compressed.push_back(static_cast<char>(q));
+        residual[j] -= q * scale;
+      }
+      continue;
+    }
+    // TOP_K sends the values of the largest magnitude in ascending order of position.
+    auto k = std::max<size_t>(1, static_cast<size_t>(std::ceil(len * topk_ratio_)));
+    k = std::min(k, IntToSize(len));
+    std::vector<uint32_t> indices(IntToSize(len));
+    std::iota(indices.begin(), indices.end(), 0);
+    std::nth_element(indices.begin(), indices.begin() + (k - 1), indices.end(), [&residual](uint32_t a, uint32_t b) {
+      return std::fabs(residual[a]) > std::fabs(residual[b]);
+    });
+    indices.resize(k);
+    std::sort(indices.begin(), indices.end());
+    kvs->add_topk_sizes(k);
+    for (auto index : indices) {
+      kvs->add_topk_indices(index);
+      kept_values.Add(residual[index]);
+      residual[index] = 0;
+    }
+  }
+  kvs->mutable_values()->Swap(&kept_values);
+  kvs->set_compressed_values(std::move(compressed));
+}
+
+bool GradientCompressor::Decompress(const KVMessage &kvs, Values *values) {
+  MS_EXCEPTION_IF_NULL(values);
+  if (kvs.compress_types().empty()) {
+    *values = {kvs.values().begin(), kvs.values().end()};
+    return true;
+  }
+  if (kvs.compress_types_size() != kvs.keys_size() || kvs.len_size() != kvs.keys_size()) {
+    MS_LOG(ERROR) << "The push message has " << kvs.keys_size() << " keys, " << kvs.len_size() << " lengths and "
+                  << kvs.compress_types_size() << " compression types.";
+    return false;
+  }
+  const auto &compressed = kvs.compressed_values();
+  size_t total_len = std::accumulate(kvs.len().begin(), kvs.len().end(), size_t(0));
+  values->clear();
+  values->reserve(total_len);
+  int value_pos = 0;
+  size_t byte_pos = 0;
+  int scale_pos = 0;
+  int index_pos = 0;
+  int topk_pos = 0;
+  for (int i = 0; i < kvs.keys_size(); ++i) {
+    auto len = static_cast<int>(kvs.len(i));
+    auto type = kvs.compress_types(i);
+    if (type == NO_COMPRESS) {
+      if (value_pos + len > kvs.values_size()) {
+        MS_LOG(ERROR) << "The push message has less values than its lengths.";
+        return false;
+      }
+      values->insert(values->end(), kvs.values().begin() + value_pos, kvs.values().begin() + value_pos + len);
+      value_pos += len;
+    } else if (type == FP16 || type == BF16) {
+      if (byte_pos + IntToSize(len) * sizeof(uint16_t) > compressed.size()) {
+        MS_LOG(ERROR) << "The push message has less compressed values than its lengths.";
+        return false;
+      }
+      for (int j = 0; j < len; ++j, byte_pos += sizeof(uint16_t)) {
+        uint16_t bits = ReadHalf(compressed, byte_pos);
+        if (type == BF16) {
+          values->push_back(Bf16ToFloat(bits));
+          continue;
+        }
+        float16 half;
+        (void)memcpy(static_cast<void *>(&half), &bits, sizeof(bits));
+        values->push_back(static_cast<float>(half));
+      }
+    } else if (type == INT8) {
+      if (byte_pos + IntToSize(len) > compressed.size() || scale_pos >= kvs.scales_size()) {
+        MS_LOG(ERROR) << "The push message has less compressed values than its lengths.";
+        return false;
+      }
+      float scale = kvs.scales(scale_pos++);
+      for (int j = 0; j < len; ++j) {
+        values->push_back(static_cast<int8_t>(compressed[byte_pos++]) * scale);
+      }
+    } else if (type == TOP_K) {
+      if (topk_pos >= kvs.topk_sizes_size()) {
+        MS_LOG(ERROR) << "The push message has no top k size for key " << kvs.keys(i);
+        return false;
+      }
+      auto k = static_cast<int>(kvs.topk_sizes(topk_pos++));
+      if (index_pos + k > kvs.topk_indices_size() || value_pos + k > kvs.values_size()) {
+        MS_LOG(ERROR) << "The push message has less top k values than its sizes.";
+        return false;
+      }
+      size_t start = values->size();
+      values->resize(start + IntToSize(len), 0);
+      for (int j = 0; j < k; ++j) {
+        auto index = kvs.topk_indices(index_pos++);
+        if (index >= IntToUint(len)) {
+          MS_LOG(ERROR) << "The top k index " << index << " is out of the length " << len;
+          return false;
+        }
+        (*values)[start + index] = kvs.values(value_pos++);
+      }
+    } else {
+      MS_LOG(ERROR) << "Unknown compression type " << type;
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace ps
+}  // namespace mindspore
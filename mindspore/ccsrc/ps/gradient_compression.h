@@ -0,0 +1,63 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PS_GRADIENT_COMPRESSION_H_
+#define MINDSPORE_CCSRC_PS_GRADIENT_COMPRESSION_H_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ps/constants.h"
+#include "proto/ps.pb.h"
+
+namespace mindspore {
+namespace ps {
+// The gradients of a key with fewer values are not worth compressing.
+constexpr size_t kMinCompressSize = 1024;
+constexpr float kDefaultTopKRatio = 0.01;
+
+// Compresses the gradients pushed by a worker. Each key of a push message is compressed on its own and the message
+// records how, so that the server restores it without knowing the setting of the worker. INT8 and TOP_K lose more
+// than rounding, the error left in a key is kept and added to the gradients of the key pushed next time. A key is
+// repeated in a message for each input of its optimizer, so the error is kept for each input of the key.
+class GradientCompressor {
+ public:
+  GradientCompressor(CompressType type, float topk_ratio) : type_(type), topk_ratio_(topk_ratio) {}
+  ~GradientCompressor() = default;
+
+  // Parse the compression name, one of "fp16", "bf16", "int8" and "topk". Return false for an unknown name.
+  static bool ParseCompressType(const std::string &name, CompressType *type);
+
+  // Compress the values of the keys of a push message in place.
+  void Compress(KVMessage *kvs);
+
+  // Restore the values of a push message, which may or may not be compressed.
+  static bool Decompress(const KVMessage &kvs, Values *values);
+
+  CompressType type() const { return type_; }
+
+ private:
+  CompressType type_;
+  float topk_ratio_;
+  std::mutex residual_mutex_;
+  // The error left in each (key, input index)
+  std::map<std::pair<Key, size_t>, std::vector<float>> residuals_;
+};
+}  // namespace ps
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_PS_GRADIENT_COMPRESSION_H_
@@ -924,7 +924,10 @@ void ParameterServer::ServerHandler::HandlePushReq(const DataPtr &data, size_t s
   KVMessage input;
   CHECK_RETURN_TYPE(input.ParseFromArray(data.get(), SizeToInt(size)));
   Keys keys = {input.keys().begin(), input.keys().end()};
-  Values values = {input.values().begin(), input.values().end()};
+  Values values;
+  if (!GradientCompressor::Decompress(input, &values)) {
+    MS_LOG(EXCEPTION) << "Decompress the gradients pushed by the worker failed.";
+  }
   Lengths lens = {input.len().begin(), input.len().end()};
   MS_LOG(DEBUG) << "The keys:" << keys << " the values:" << values << " the len:" << lens;
   ps_->AccumGrad(keys, values, lens);
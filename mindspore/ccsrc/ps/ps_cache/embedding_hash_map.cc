@@ -15,9 +15,78 @@
  */
 
 #include "ps/ps_cache/embedding_hash_map.h"
+#include <algorithm>
 
 namespace mindspore {
 namespace ps {
+namespace {
+constexpr uint8_t kMaxSketchCount = 15;
+constexpr size_t kMinSketchWidth = 16;
+constexpr size_t kSketchSampleFactor = 10;
+constexpr uint64_t kSketchSeeds[] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+                                     0x27D4EB2F165667C5ULL};
+}  // namespace
+
+bool ParseEvictionPolicy(const std::string &name, EvictionPolicy *policy) {
+  MS_EXCEPTION_IF_NULL(policy);
+  if (name == "lru") {
+    *policy = EvictionPolicy::kStepLru;
+  } else if (name == "lfu") {
+    *policy = EvictionPolicy::kLfu;
+  } else if (name == "tinylfu") {
+    *policy = EvictionPolicy::kTinyLfu;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+FrequencySketch::FrequencySketch(size_t capacity) : sample_size_(kSketchSampleFactor * capacity) {
+  size_t width = kMinSketchWidth;
+  while (width < capacity) {
+    width <<= 1;
+  }
+  width_mask_ = width - 1;
+  counters_ = std::make_unique<std::atomic<uint8_t>[]>(kRows * width);
+}
+
+size_t FrequencySketch::Slot(int id, size_t row) const {
+  uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(id)) ^ kSketchSeeds[row];
+  h = (h ^ (h >> 33)) * 0xFF51AFD7ED558CCDULL;
+  h = (h ^ (h >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return row * (width_mask_ + 1) + static_cast<size_t>(h & width_mask_);
+}
+
+void FrequencySketch::Add(int id) {
+  for (size_t row = 0; row < kRows; ++row) {
+    auto &counter = counters_[Slot(id, row)];
+    uint8_t count = counter.load(std::memory_order_relaxed);
+    while (count < kMaxSketchCount &&
+           !counter.compare_exchange_weak(count, static_cast<uint8_t>(count + 1), std::memory_order_relaxed)) {
+    }
+  }
+  (void)additions_.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t FrequencySketch::Estimate(int id) const {
+  uint32_t estimate = kMaxSketchCount;
+  for (size_t row = 0; row < kRows; ++row) {
+    estimate = std::min<uint32_t>(estimate, counters_[Slot(id, row)].load(std::memory_order_relaxed));
+  }
+  return estimate;
+}
+
+void FrequencySketch::AgeIfNeeded() {
+  if (additions_.load() < sample_size_) {
+    return;
+  }
+  for (size_t i = 0; i < kRows * (width_mask_ + 1); ++i) {
+    counters_[i].store(counters_[i].load(std::memory_order_relaxed) >> 1, std::memory_order_relaxed);
+  }
+  additions_.store(additions_.load() / 2);
+}
+
 int EmbeddingHashMap::ParseData(const int id, int *const swap_out_index, int *const swap_out_ids,
                                 const size_t data_step, const size_t graph_running_step, size_t *const swap_out_size,
                                 bool *const need_wait_graph) {
@@ -30,36 +99,86 @@ int EmbeddingHashMap::ParseData(const int id, int *const swap_out_index, int *co
     return hash_index;
   }
 
+  insert_count_++;
+  auto &element = hash_map_elements_[hash_index];
   if (!need_swap) {
     hash_count_++;
     (void)hash_id_to_index_.emplace(id, hash_index);
-    hash_map_elements_[hash_index].set_id(id);
-    hash_map_elements_[hash_index].set_step(data_step);
+    element.set_id(id);
+    element.set_step(data_step);
+    element.freq_ = 0;
+    element.freq_step_ = INVALID_STEP_VALUE;
+    RecordUse(&element, data_step);
     return hash_index;
   }
 
+  evict_count_++;
   swap_out_index[*swap_out_size] = hash_index;
-  swap_out_ids[*swap_out_size] = hash_map_elements_[hash_index].id_;
+  swap_out_ids[*swap_out_size] = element.id_;
   (*swap_out_size)++;
-  (void)hash_id_to_index_.erase(hash_map_elements_[hash_index].id_);
+  (void)hash_id_to_index_.erase(element.id_);
   (void)hash_id_to_index_.emplace(id, hash_index);
-  hash_map_elements_[hash_index].set_id(id);
-  hash_map_elements_[hash_index].set_step(data_step);
+  element.set_id(id);
+  element.set_step(data_step);
+  element.freq_ = 0;
+  element.freq_step_ = INVALID_STEP_VALUE;
+  RecordUse(&element, data_step);
   return hash_index;
 }
 
-int EmbeddingHashMap::FindInsertionPos(const size_t, const size_t graph_running_step, bool *const need_swap,
+void EmbeddingHashMap::set_hash_step(const int hash_index, const size_t step) {
+  hash_map_elements_[hash_index].set_step(step);
+  ++hit_count_;
+}
+
+void EmbeddingHashMap::RecordHit(const int hash_index, const size_t step) {
+  RecordUse(&hash_map_elements_[hash_index], step);
+}
+
+void EmbeddingHashMap::RecordUse(HashMapElement *element, size_t step) {
+  if (policy_ == EvictionPolicy::kStepLru || element->freq_step_ == step) {
+    return;
+  }
+  element->freq_step_ = step;
+  if (policy_ == EvictionPolicy::kLfu) {
+    element->freq_ = EvictionScore(*element, step) + 1;
+    element->freq_epoch_ = step / kFrequencyDecaySteps;
+  } else if (policy_ == EvictionPolicy::kTinyLfu) {
+    sketch_->Add(element->id_);
+  }
+}
+
+uint32_t EmbeddingHashMap::EvictionScore(const HashMapElement &element, size_t step) const {
+  if (policy_ == EvictionPolicy::kLfu) {
+    const size_t kMaxShift = 31;
+    size_t elapsed = step / kFrequencyDecaySteps - element.freq_epoch_;
+    return elapsed > kMaxShift ? 0 : element.freq_ >> elapsed;
+  }
+  if (policy_ == EvictionPolicy::kTinyLfu) {
+    return sketch_->Estimate(element.id_);
+  }
+  return 0;
+}
+
+int EmbeddingHashMap::FindInsertionPos(const size_t data_step, const size_t graph_running_step, bool *const need_swap,
                                        bool *const need_wait_graph) {
   MS_EXCEPTION_IF_NULL(need_swap);
   MS_EXCEPTION_IF_NULL(need_wait_graph);
+  // A candidate used again in this batch since the sweep passed it is no longer expired.
+  auto not_expired = [this, graph_running_step](int pos) {
+    return !hash_map_elements_[pos].IsExpired(graph_running_step);
+  };
+  (void)eviction_candidates_.erase(
+    std::remove_if(eviction_candidates_.begin(), eviction_candidates_.end(), not_expired), eviction_candidates_.end());
+  // The step LRU takes the first expired slot, a frequency policy compares a few of them.
+  const size_t samples = policy_ == EvictionPolicy::kStepLru ? 1 : kEvictionSamples;
   int hash_index = INVALID_INDEX_VALUE;
-  while (!expired_element_full_) {
+  while (!expired_element_full_ && eviction_candidates_.size() < samples) {
     if (hash_map_elements_[current_pos_].IsEmpty()) {
       hash_index = current_pos_;
       hash_count_++;
     } else if (hash_map_elements_[current_pos_].IsExpired(graph_running_step)) {
-      hash_index = current_pos_;
-      *need_swap = true;
+      eviction_candidates_.push_back(current_pos_);
     } else if (hash_map_elements_[current_pos_].IsStep(graph_running_step)) {
       graph_running_index_[graph_running_index_num_++] = current_pos_;
     }
@@ -74,6 +193,23 @@ int EmbeddingHashMap::FindInsertionPos(const size_t, const size_t graph_running_
     }
   }
 
+  if (!eviction_candidates_.empty()) {
+    size_t victim = 0;
+    uint32_t victim_score = EvictionScore(hash_map_elements_[eviction_candidates_[0]], data_step);
+    for (size_t i = 1; i < eviction_candidates_.size(); ++i) {
+      uint32_t score = EvictionScore(hash_map_elements_[eviction_candidates_[i]], data_step);
+      if (score < victim_score) {
+        victim = i;
+        victim_score = score;
+      }
+    }
+    hash_index = eviction_candidates_[victim];
+    eviction_candidates_[victim] = eviction_candidates_.back();
+    eviction_candidates_.pop_back();
+    *need_swap = true;
+    return hash_index;
+  }
+
   if (graph_running_index_pos_ != graph_running_index_num_) {
     *need_swap = true;
     *need_wait_graph = true;
@@ -103,6 +239,10 @@ void EmbeddingHashMap::Reset() {
   graph_running_index_num_ = 0;
   graph_running_index_pos_ = 0;
   expired_element_full_ = false;
+  eviction_candidates_.clear();
+  if (sketch_ != nullptr) {
+    sketch_->AgeIfNeeded();
+  }
 }
 }  // namespace ps
 }  // namespace mindspore
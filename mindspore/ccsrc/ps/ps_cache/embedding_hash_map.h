@@ -18,6 +18,8 @@
 #define MINDSPORE_CCSRC_PS_PS_CACHE_EMBEDDING_HASH_MAP_H_
 
 #include <math.h>
+#include <atomic>
+#include <string>
 #include <utility>
 #include <memory>
 #include <vector>
@@ -28,10 +30,30 @@ namespace mindspore {
 namespace ps {
 static const size_t INVALID_STEP_VALUE = 0;
 static const int INVALID_INDEX_VALUE = -1;
+// Number of expired slots compared by a frequency policy before one of them is swapped out
+constexpr size_t kEvictionSamples = 8;
+constexpr size_t kFrequencyDecaySteps = 100;
+
+// How the slot to swap out is chosen among the slots not used by the running graph.
+enum class EvictionPolicy {
+  // The first expired slot found by the sweep, which is the slot used the longest steps ago in a full sweep.
+  kStepLru = 0,
+  // The slot of the id used in the fewest steps, the count halves every kFrequencyDecaySteps steps.
+  kLfu,
+  // The slot of the id seen the fewest times lately, counted in a sketch which also remembers the ids not cached.
+  kTinyLfu,
+};
+
+// Parse the policy name, one of "lru", "lfu" and "tinylfu". Return false for an unknown name.
+bool ParseEvictionPolicy(const std::string &name, EvictionPolicy *policy);
 
 struct HashMapElement {
   int id_{INVALID_INDEX_VALUE};
   size_t step_{INVALID_STEP_VALUE};
+  uint32_t freq_{0};
+  size_t freq_epoch_{0};
+  // Last step counted in freq_, a step is counted once however many times the id is used in it
+  size_t freq_step_{INVALID_STEP_VALUE};
   bool IsEmpty() const { return step_ == INVALID_STEP_VALUE; }
   bool IsExpired(size_t graph_running_step) const { return graph_running_step > step_; }
   bool IsStep(size_t step) const { return step_ == step; }
@@ -39,12 +61,40 @@ struct HashMapElement {
   void set_step(size_t step) { step_ = step; }
 };
 
+// Count-min sketch of how often the ids are seen, with 4 bit counters. All the counters halve once the number of
+// additions reaches ten times the capacity, so that the ids seen long ago fade out. Add can be called from several
+// threads at once.
+class FrequencySketch {
+ public:
+  explicit FrequencySketch(size_t capacity);
+  ~FrequencySketch() = default;
+  void Add(int id);
+  uint32_t Estimate(int id) const;
+  // Halve the counters if it is due, must not run together with Add.
+  void AgeIfNeeded();
+
+ private:
+  size_t Slot(int id, size_t row) const;
+  static constexpr size_t kRows = 4;
+  size_t width_mask_;
+  size_t sample_size_;
+  std::unique_ptr<std::atomic<uint8_t>[]> counters_;
+  std::atomic<size_t> additions_{0};
+};
+
+struct EmbeddingHashMapStatistics {
+  size_t hit_count_{0};
+  size_t insert_count_{0};
+  size_t evict_count_{0};
+};
+
 // Hash table is held in device, HashMap is used to manage hash table in host.
 class EmbeddingHashMap {
  public:
-  EmbeddingHashMap(size_t hash_count, size_t hash_capacity)
+  EmbeddingHashMap(size_t hash_count, size_t hash_capacity, EvictionPolicy policy = EvictionPolicy::kStepLru)
       : hash_count_(hash_count),
         hash_capacity_(hash_capacity),
+        policy_(policy),
         current_pos_(0),
         current_batch_start_pos_(0),
         graph_running_index_num_(0),
@@ -57,22 +107,39 @@ class EmbeddingHashMap {
     hash_map_elements_.front().set_step(SIZE_MAX);
     hash_map_elements_.back().set_step(SIZE_MAX);
     graph_running_index_ = std::make_unique<int[]>(hash_capacity);
+    if (policy_ == EvictionPolicy::kTinyLfu) {
+      sketch_ = std::make_unique<FrequencySketch>(hash_capacity);
+    }
   }
   virtual ~EmbeddingHashMap() = default;
   int ParseData(const int id, int *const swap_out_index, int *const swap_out_ids, const size_t data_step,
                 const size_t graph_running_step, size_t *const swap_out_size, bool *const need_wait_graph);
   size_t hash_step(const int hash_index) const { return hash_map_elements_[hash_index].step_; }
-  void set_hash_step(const int hash_index, const size_t step) { hash_map_elements_[hash_index].set_step(step); }
+  // Mark the slot as used by the step, which is a cache hit of its id. Can be called from several threads at once
+  // for different slots, the hit is counted for the eviction policy by RecordHit afterwards.
+  void set_hash_step(const int hash_index, const size_t step);
+  // Count the step in the use of the id of the slot, for the frequency policies. Must not run together with
+  // set_hash_step, a slot counted twice in one step is counted once.
+  void RecordHit(const int hash_index, const size_t step);
   const mindspore::HashMap<int, int> &hash_id_to_index() const { return hash_id_to_index_; }
   size_t hash_capacity() const { return hash_capacity_; }
+  EvictionPolicy policy() const { return policy_; }
+  EmbeddingHashMapStatistics statistics() const {
+    return {hit_count_.load(), insert_count_, evict_count_};
+  }
   void DumpHashMap();
   void Reset();
 
  private:
   int FindInsertionPos(const size_t data_step, const size_t graph_running_step, bool *const need_swap,
                        bool *const need_wait_graph);
+  // Record one more step in which the id of the slot is used, if the step is not recorded yet.
+  void RecordUse(HashMapElement *element, size_t step);
+  // The lower, the sooner the slot is swapped out.
+  uint32_t EvictionScore(const HashMapElement &element, size_t step) const;
   size_t hash_count_;
   size_t hash_capacity_;
+  EvictionPolicy policy_;
   std::vector<HashMapElement> hash_map_elements_;
   mindspore::HashMap<int, int> hash_id_to_index_;
   size_t current_pos_;
@@ -81,6 +148,12 @@ class EmbeddingHashMap {
   size_t graph_running_index_pos_;
   std::unique_ptr<int[]> graph_running_index_;
   bool expired_element_full_;
+  // Expired slots passed by the sweep in this batch and not swapped out yet
+  std::vector<int> eviction_candidates_;
+  std::unique_ptr<FrequencySketch> sketch_;
+  std::atomic<size_t> hit_count_{0};
+  size_t insert_count_{0};
+  size_t evict_count_{0};
 };
 }  // namespace ps
 }  // namespace mindspore
@@ -15,6 +15,8 @@
  */
 
 #include <algorithm>
+#include <functional>
+#include <future>
 #include "ps/ps_cache/ps_cache_manager.h"
 #include "utils/log_adapter.h"
 #include "utils/ms_utils.h"
@@ -149,9 +151,16 @@ void PsCacheManager::Initialize() {
   if (!Worker::GetInstance().running()) {
     Worker::GetInstance().Run();
   }
-  embedding_device_cache_ = std::make_shared<EmbeddingDeviceCache>(batch_elements_, vocab_cache_size_);
+  EvictionPolicy policy = EvictionPolicy::kStepLru;
+  std::string policy_name = common::GetEnv(kEnvCacheEvictionPolicy);
+  if (!policy_name.empty() && !ParseEvictionPolicy(policy_name, &policy)) {
+    MS_LOG(EXCEPTION) << "The eviction policy of ps cache should be one of lru, lfu and tinylfu, but got "
+                      << policy_name;
+  }
+  MS_LOG(INFO) << "PS cache eviction policy: " << (policy_name.empty() ? "lru" : policy_name);
+  embedding_device_cache_ = std::make_shared<EmbeddingDeviceCache>(batch_elements_, vocab_cache_size_, policy);
   MS_ERROR_IF_NULL_WO_RET_VAL(embedding_device_cache_);
-  embedding_host_cache_ = std::make_shared<EmbeddingHostCache>(batch_elements_, host_vocab_cache_size_);
+  embedding_host_cache_ = std::make_shared<EmbeddingHostCache>(batch_elements_, host_vocab_cache_size_, policy);
   MS_ERROR_IF_NULL_WO_RET_VAL(embedding_host_cache_);
   AddEmbeddingTable();
   AllocMemForHashTable();
@@ -412,11 +421,18 @@ bool PsCacheManager::ProcessData() {
     MS_LOG(ERROR) << "Ps cache wait graph finish failed.";
     return false;
   }
+  std::vector<float> device_out_data;
   for (const auto &item : hash_tables_) {
     auto key = Worker::GetInstance().GetParamKey(item.first);
     auto hash_info = item.second;
-    RETURN_IF_FALSE_WITH_LOG(HashSwapHostToServer(key, hash_info), "HashSwapHostToServer failed.");
-    RETURN_IF_FALSE_WITH_LOG(HashSwapDeviceToHost(hash_info), "HashSwapDeviceToHost failed.");
+    // The rows evicted from the host cache are pushed to the parameter server while the rows evicted from the device
+    // cache are copied out of the device, both finish before any slot of the host cache is overwritten.
+    auto host_to_server =
+      std::async(std::launch::async, &PsCacheManager::HashSwapHostToServer, this, key, std::cref(hash_info));
+    bool device_out_ret = HashSwapDeviceOut(hash_info, &device_out_data);
+    RETURN_IF_FALSE_WITH_LOG(host_to_server.get(), "HashSwapHostToServer failed.");
+    RETURN_IF_FALSE_WITH_LOG(device_out_ret, "HashSwapDeviceOut failed.");
+    RETURN_IF_FALSE_WITH_LOG(HashSwapDeviceToHost(hash_info, device_out_data), "HashSwapDeviceToHost failed.");
     RETURN_IF_FALSE_WITH_LOG(HashSwapServerToHost(key, hash_info), "HashSwapServerToHost failed.");
     RETURN_IF_FALSE_WITH_LOG(HashSwapHostToDevice(hash_info), "HashSwapHostToDevice failed.");
   }
@@ -508,6 +524,17 @@ bool PsCacheManager::CheckCacheHitOrOutRange(const int *batch_ids, const size_t
   for (size_t j = 0; j < i; j++) {
     statistics_info_.hash_hit_count_ += hash_hit_count[j];
   }
+  // The frequencies of the eviction policy are counted here, once the check threads are done with the hash map.
+  MS_ERROR_IF_NULL(embedding_device_cache_);
+  auto &device_hash_map = embedding_device_cache_->device_hash_map_;
+  MS_ERROR_IF_NULL(device_hash_map);
+  if (device_hash_map->policy() != EvictionPolicy::kStepLru) {
+    for (size_t j = 0; j < task_offset; ++j) {
+      if (in_device[j]) {
+        device_hash_map->RecordHit(hash_index[j] - cache_indices_bounds_.first, data_step_);
+      }
+    }
+  }
   return true;
 }
 
@@ -592,6 +619,7 @@ bool PsCacheManager::ParseDeviceData(size_t id, bool *need_swap_device_to_host,
       statistics_info_.hash_hit_count_++;
       device_hash_map->set_hash_step(index, data_step_);
     }
+    device_hash_map->RecordHit(index, data_step_);
   } else {
     int *device_to_host_index = embedding_device_cache_->device_to_host_index.get();
     int *device_to_host_ids = embedding_device_cache_->device_to_host_ids.get();
@@ -634,6 +662,7 @@ bool PsCacheManager::ParseHostDataHostToDevice(size_t id) {
     if (host_hash_map->hash_step(index) != data_step_) {
       host_hash_map->set_hash_step(index, data_step_);
     }
+    host_hash_map->RecordHit(index, data_step_);
     host_to_device_index[statistics_info_.host_to_device_size_ - 1] = index;
   } else {
     int *host_to_server_index = embedding_host_cache_->host_to_server_index.get();
@@ -677,6 +706,7 @@ bool PsCacheManager::ParseHostDataDeviceToHost() {
     if (host_hash_map->hash_step(index) != data_step_) {
       host_hash_map->set_hash_step(index, data_step_);
     }
+    host_hash_map->RecordHit(index, data_step_);
     device_to_host_index[statistics_info_.device_to_host_size_ - 1] = index;
   } else {
     int *host_to_server_index = embedding_host_cache_->host_to_server_index.get();
@@ -841,21 +871,19 @@ bool PsCacheManager::HashSwapHostToDevice(const HashTableInfo &hash_info) {
   return true;
 }
 
-bool PsCacheManager::HashSwapDeviceToHost(const HashTableInfo &hash_info) {
+bool PsCacheManager::HashSwapDeviceOut(const HashTableInfo &hash_info, std::vector<float> *swap_out_data) {
+  MS_ERROR_IF_NULL(swap_out_data);
   MS_ERROR_IF_NULL(embedding_device_cache_);
   MS_ERROR_IF_NULL(embedding_device_cache_->cache_);
-  MS_ERROR_IF_NULL(embedding_host_cache_);
   auto swap_indices_size = statistics_info_.device_to_host_size_;
   auto device_cache_device_to_host_index = embedding_device_cache_->device_to_host_index.get();
-  auto host_cache_device_to_host_index = embedding_host_cache_->device_to_host_index.get();
   if (swap_indices_size == 0) {
     return true;
   }
   auto hash_table_addr = reinterpret_cast<float *>(hash_info.device_address.addr);
   auto cache_vocab_size = hash_info.cache_vocab_size;
-  auto host_hash_table_addr = reinterpret_cast<float *>(hash_info.host_address.get());
   auto embedding_size = hash_info.embedding_size;
-  auto swap_out_data = std::make_unique<float[]>(swap_indices_size * embedding_size);
+  swap_out_data->resize(swap_indices_size * embedding_size);
   RETURN_IF_FALSE(embedding_device_cache_->cache_->CopyHostMemToDevice(embedding_device_cache_->hash_swap_index_addr_,
                                                                        device_cache_device_to_host_index,
                                                                        swap_indices_size * sizeof(int)));
@@ -863,11 +891,27 @@ bool PsCacheManager::HashSwapDeviceToHost(const HashTableInfo &hash_info) {
     hash_table_addr, embedding_device_cache_->hash_swap_value_addr_, embedding_device_cache_->hash_swap_index_addr_,
     cache_vocab_size, embedding_size, swap_indices_size));
   RETURN_IF_FALSE(embedding_device_cache_->cache_->CopyDeviceMemToHost(
-    swap_out_data.get(), embedding_device_cache_->hash_swap_value_addr_,
+    swap_out_data->data(), embedding_device_cache_->hash_swap_value_addr_,
     swap_indices_size * embedding_size * sizeof(float)));
   RETURN_IF_FALSE(embedding_device_cache_->cache_->SynchronizeStream());
+  return true;
+}
+
+bool PsCacheManager::HashSwapDeviceToHost(const HashTableInfo &hash_info, const std::vector<float> &swap_out_data) {
+  MS_ERROR_IF_NULL(embedding_host_cache_);
+  auto swap_indices_size = statistics_info_.device_to_host_size_;
+  auto host_cache_device_to_host_index = embedding_host_cache_->device_to_host_index.get();
+  if (swap_indices_size == 0) {
+    return true;
+  }
+  auto host_hash_table_addr = reinterpret_cast<float *>(hash_info.host_address.get());
+  auto embedding_size = hash_info.embedding_size;
+  if (swap_out_data.size() < swap_indices_size * embedding_size) {
+    MS_LOG(ERROR) << "The data swapped out of device is less than " << swap_indices_size << " rows.";
+    return false;
+  }
   RETURN_IF_FALSE(InsertHostHashTable(embedding_size, IntToSize(swap_indices_size), host_cache_device_to_host_index,
-                                      swap_out_data.get(), host_hash_table_addr));
+                                      swap_out_data.data(), host_hash_table_addr));
   return true;
 }
 
@@ -1102,6 +1146,23 @@ void PsCacheManager::DumpStatisticsInfo(size_t each_print_step) {
                  << ", data repeat rate:" << (repeat_rate * kFloatToPercentSign)
                  << "%, device cache hit rate:" << (device_hit_rate * kFloatToPercentSign)
                  << "%, host cache hit rate:" << (host_hit_rate * kFloatToPercentSign) << ").";
+    auto dump_hash_map_statistics = [](const std::string &name, const std::shared_ptr<EmbeddingHashMap> &hash_map) {
+      if (hash_map == nullptr) {
+        return;
+      }
+      auto stat = hash_map->statistics();
+      auto total = stat.hit_count_ + stat.insert_count_;
+      auto hit_rate = total == 0 ? 0.0f : SizeToFloat(stat.hit_count_) / total;
+      MS_LOG(INFO) << "PS " << name << " cache accumulated statistics info(hit num:" << stat.hit_count_
+                   << ", insert num:" << stat.insert_count_ << ", evict num:" << stat.evict_count_
+                   << ", hit rate:" << (hit_rate * kFloatToPercentSign) << "%).";
+    };
+    if (embedding_device_cache_ != nullptr) {
+      dump_hash_map_statistics("device", embedding_device_cache_->device_hash_map_);
+    }
+    if (embedding_host_cache_ != nullptr) {
+      dump_hash_map_statistics("host", embedding_host_cache_->host_hash_map_);
+    }
   }
 }
 }  // namespace ps
@@ -58,13 +58,13 @@ struct HashTableInfo {
 };
 
 struct EmbeddingDeviceCache {
-  EmbeddingDeviceCache(size_t batch_elements, size_t cache_vocab_size)
+  EmbeddingDeviceCache(size_t batch_elements, size_t cache_vocab_size, EvictionPolicy policy)
       : hash_swap_index_addr_(nullptr), hash_swap_value_addr_(nullptr) {
     device_to_host_index = std::make_unique<int[]>(batch_elements);
     device_to_host_ids = std::make_unique<int[]>(batch_elements);
     host_to_device_index = std::make_unique<int[]>(batch_elements);
     host_to_device_ids = std::make_unique<int[]>(batch_elements);
-    device_hash_map_ = std::make_shared<EmbeddingHashMap>(0, cache_vocab_size);
+    device_hash_map_ = std::make_shared<EmbeddingHashMap>(0, cache_vocab_size, policy);
     auto context_ptr = MsContext::GetInstance();
     MS_EXCEPTION_IF_NULL(context_ptr);
     auto devcie_target = context_ptr->get_param<std::string>(MS_CTX_DEVICE_TARGET);
@@ -81,14 +81,14 @@ struct EmbeddingDeviceCache {
 };
 
 struct EmbeddingHostCache {
-  EmbeddingHostCache(size_t batch_elements, size_t host_cache_vocab_size) {
+  EmbeddingHostCache(size_t batch_elements, size_t host_cache_vocab_size, EvictionPolicy policy) {
     host_to_server_index = std::make_unique<int[]>(batch_elements);
     host_to_server_ids = std::make_unique<int[]>(batch_elements);
     server_to_host_index = std::make_unique<int[]>(batch_elements);
     server_to_host_ids = std::make_unique<int[]>(batch_elements);
     host_to_device_index = std::make_unique<int[]>(batch_elements);
     device_to_host_index = std::make_unique<int[]>(batch_elements);
-    host_hash_map_ = std::make_shared<EmbeddingHashMap>(0, host_cache_vocab_size);
+    host_hash_map_ = std::make_shared<EmbeddingHashMap>(0, host_cache_vocab_size, policy);
   }
   std::unique_ptr<int[]> host_to_server_index;
   std::unique_ptr<int[]> host_to_server_ids;
@@ -160,10 +160,11 @@ class PsCacheManager {
   bool ParseDeviceData(size_t id, bool *need_swap_device_to_host, bool *need_swap_host_to_device, int *hash_index);
   bool ParseHostDataHostToDevice(size_t id);
   bool ParseHostDataDeviceToHost();
-  bool HashSwapDeviceOut(int *swap_out_index, std::vector<float> *swap_out_data, const HashTableInfo &hash_info);
   bool HashSwapDeviceIn(const int *swap_in_ids, const int *swap_in_index, const HashTableInfo &hash_info, size_t key);
   bool HashSwapHostToDevice(const HashTableInfo &hash_info);
-  bool HashSwapDeviceToHost(const HashTableInfo &hash_info);
+  // Copy the rows evicted from the device cache to swap_out_data, then insert them into the host cache.
+  bool HashSwapDeviceOut(const HashTableInfo &hash_info, std::vector<float> *swap_out_data);
+  bool HashSwapDeviceToHost(const HashTableInfo &hash_info, const std::vector<float> &swap_out_data);
   bool HashSwapHostToServer(size_t key, const HashTableInfo &hash_info);
   bool HashSwapServerToHost(size_t key, const HashTableInfo &hash_info);
   bool InsertHostHashTable(size_t embedding_size, size_t insert_indices_size, const int *insert_indices,
@@ -16,6 +16,7 @@
 
 #include "ps/worker.h"
 #include "pipeline/jit/pipeline.h"
+#include "utils/ms_utils.h"
 
 namespace mindspore {
 namespace ps {
@@ -478,6 +479,25 @@ void Worker::Initialize() {
   broadcast_partitioner_ = [this](auto &&send, auto &&partition, auto &&attrs) {
     BroadcastPartitioner(send, partition, attrs);
   };
+
+  std::string compress_name = common::GetEnv(kEnvGradCompression);
+  if (!compress_name.empty()) {
+    CompressType compress_type = NO_COMPRESS;
+    if (!GradientCompressor::ParseCompressType(compress_name, &compress_type)) {
+      MS_LOG(EXCEPTION) << "The gradient compression should be one of fp16, bf16, int8 and topk, but got "
+                        << compress_name;
+    }
+    float topk_ratio = kDefaultTopKRatio;
+    std::string ratio = common::GetEnv(kEnvGradCompressionTopKRatio);
+    if (!ratio.empty()) {
+      topk_ratio = std::strtof(ratio.c_str(), nullptr);
+      if (topk_ratio <= 0 || topk_ratio > 1) {
+        MS_LOG(EXCEPTION) << "The top k ratio of gradient compression should be in (0, 1], but got " << ratio;
+      }
+    }
+    grad_compressor_ = std::make_unique<GradientCompressor>(compress_type, topk_ratio);
+    MS_LOG(INFO) << "The gradients pushed to the servers are compressed by " << compress_name;
+  }
 }
 
 bool Worker::IsKeyInit(const size_t key) {
@@ -699,7 +719,7 @@ void Worker::PushData(const std::vector<Key> &keys, const std::vector<float> &va
       worker_node_.Broadcast(core::NodeRole::SERVER, res, kv_data.length(), cmd);
     }
   } else {
-    SendForPush(cmd, kvs, round_robin_partitioner_, {});
+    SendForPush(cmd, kvs, round_robin_partitioner_, {}, cmd == kPushCmd);
   }
 }
 
@@ -984,7 +1004,7 @@ void Worker::BroadcastPartitioner(const KVMessage &send, PartitionKVMessages *pa
 }
 
 void Worker::SendForPush(int cmd, const KVMessage &send, const KVPartitioner &partitioner,
-                         const std::map<int64_t, int64_t> &attrs) {
+                         const std::map<int64_t, int64_t> &attrs, bool compress) {
   PartitionKVMessages messages;
   partitioner(send, &messages, attrs);
   std::vector<uint32_t> rank_ids;
@@ -993,6 +1013,9 @@ void Worker::SendForPush(int cmd, const KVMessage &send, const KVPartitioner &pa
   for (size_t i = 0; i < messages.size(); i++) {
     if (messages.at(i).first) {
       rank_ids.push_back(i);
+      if (compress && grad_compressor_ != nullptr) {
+        grad_compressor_->Compress(&messages.at(i).second);
+      }
       std::string kv_data = messages.at(i).second.SerializeAsString();
 
 #ifdef __APPLE__
@@ -37,6 +37,7 @@
 #include "ps/ps_cache/ps_data/ps_data_prefetch.h"
 #include "ps/core/worker_node.h"
 #include "ps/embedding_table_shard_metadata.h"
+#include "ps/gradient_compression.h"
 #include "proto/comm.pb.h"
 #include "proto/ps.pb.h"
 #include "ps/ps_context.h"
@@ -122,7 +123,7 @@ class Worker {
   void BroadcastPartitioner(const KVMessage &send, PartitionKVMessages *partition,
                             const std::map<int64_t, int64_t> &attrs);
   void SendForPush(int cmd, const KVMessage &send, const KVPartitioner &partitioner,
-                   const std::map<int64_t, int64_t> &attrs);
+                   const std::map<int64_t, int64_t> &attrs, bool compress = false);
   void SendForPull(int cmd, const KVMessage &send, const KVPartitioner &partitioner,
                    const std::map<int64_t, int64_t> &attrs, std::vector<float> *vals, std::vector<int> *lens);
 
@@ -147,6 +148,8 @@ class Worker {
   mindspore::HashMap<Key, size_t> embedding_row_cnt_;
 
   mindspore::HashMap<Key, std::shared_ptr<std::vector<EmbeddingTableShardMetadata>>> embedding_table_ranges_;
+  // Compresses the dense gradients pushed to the servers, nullptr if they are pushed as they are
+  std::unique_ptr<GradientCompressor> grad_compressor_;
 };
 }  // namespace ps
 }  // namespace mindspore
@@ -464,8 +464,20 @@ bool CPUKernelRuntime::Run(const session::KernelGraph &kernel_graph, bool) {
     auto profiler_inst = profiler::cpu::CPUProfiler::GetInstance();
     MS_EXCEPTION_IF_NULL(profiler_inst);
     if (profiler_inst->GetEnableFlag()) {
+      uint64_t bytes = 0;
+      for (const auto &address : kernel_inputs) {
+        bytes += address != nullptr ? address->size : 0;
+      }
+      for (const auto &address : kernel_outputs) {
+        bytes += address != nullptr ? address->size : 0;
+      }
+      auto op_id = kernel_mod->profiler_op_id();
+      if (op_id == profiler::cpu::CPUProfiler::kInvalidOpId) {
+        op_id = profiler_inst->OpId(kernel->fullname_with_scope());
+        kernel_mod->set_profiler_op_id(op_id);
+      }
       uint32_t pid = getpid();
-      profiler_inst->OpDataProducerBegin(kernel->fullname_with_scope(), pid);
+      profiler_inst->OpDataProducerBegin(op_id, pid, bytes);
     }
 #endif
 #ifdef ENABLE_DUMP_IR
@@ -264,6 +264,12 @@ void GraphScheduler::Initialize() {
   if (ret != MINDRT_OK) {
     MS_LOG(EXCEPTION) << "Actor manager init failed.";
   }
+  if (common::GetEnv("MS_ENABLE_ACTOR_WORK_STEALING") == "1") {
+    auto thread_pool = actor_manager->GetActorThreadPool();
+    MS_EXCEPTION_IF_NULL(thread_pool);
+    thread_pool->SetWorkStealing(true);
+    MS_LOG(INFO) << "Enable work stealing of the actor threads.";
+  }
   (void)common::SetOMPThreadNum();
   auto OMP_thread_num_used = common::GetEnv("OMP_NUM_THREADS");
   MS_LOG(INFO) << "The actor thread number: " << actor_thread_num
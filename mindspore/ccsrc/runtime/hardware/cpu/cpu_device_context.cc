@@ -340,16 +340,28 @@ bool CPUDeviceContext::LaunchKernelWithProfiling(const CNodePtr &kernel, const s
                                                  const std::vector<AddressPtr> &workspace,
                                                  const std::vector<AddressPtr> &outputs) const {
   MS_EXCEPTION_IF_NULL(kernel);
-  std::lock_guard<std::mutex> locker(launch_mutex_);
 
+  // The profiler records the launches of each thread apart, so the kernel actors keep launching in parallel.
   auto profiler_inst = profiler::cpu::CPUProfiler::GetInstance();
   MS_EXCEPTION_IF_NULL(profiler_inst);
 
   auto kernel_mod = AnfAlgo::GetKernelMod(kernel);
   MS_EXCEPTION_IF_NULL(kernel_mod);
 
+  uint64_t bytes = 0;
+  for (const auto &address : inputs) {
+    bytes += address != nullptr ? address->size : 0;
+  }
+  for (const auto &address : outputs) {
+    bytes += address != nullptr ? address->size : 0;
+  }
+  auto op_id = kernel_mod->profiler_op_id();
+  if (op_id == profiler::cpu::CPUProfiler::kInvalidOpId) {
+    op_id = profiler_inst->OpId(kernel->fullname_with_scope());
+    kernel_mod->set_profiler_op_id(op_id);
+  }
   uint32_t pid = IntToUint(getpid());
-  profiler_inst->OpDataProducerBegin(kernel->fullname_with_scope(), pid);
+  profiler_inst->OpDataProducerBegin(op_id, pid, bytes);
   bool ret = DoLaunchKernel(kernel_mod, inputs, workspace, outputs);
   profiler_inst->OpDataProducerEnd();
 
@@ -76,7 +76,6 @@ class CPUDeviceContext : public DeviceContext {
   bool DoLaunchKernel(KernelMod *const kernel_mod, const std::vector<AddressPtr> &inputs,
                       const std::vector<AddressPtr> &workspace, const std::vector<AddressPtr> &outputs) const;
 
-  mutable std::mutex launch_mutex_;
   std::shared_ptr<MemoryManager> mem_manager_;
   bool initialized_;
 };
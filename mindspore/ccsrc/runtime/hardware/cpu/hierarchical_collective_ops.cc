@@ -0,0 +1,396 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/hardware/cpu/hierarchical_collective_ops.h"
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <utility>
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+namespace {
+using fl::server::kCollectiveCommTimeout;
+
+// A token that no other process on the host draws, from the random device mixed with the process id and the time.
+uint64_t NewShmToken() {
+  std::random_device random_device;
+  uint64_t token = (static_cast<uint64_t>(random_device()) << 32) | random_device();
+  token ^= static_cast<uint64_t>(getpid()) << 16;
+  token ^= static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+  return token;
+}
+
+// Exchange a value of fixed size with a rank through the transport.
+template <typename V>
+bool SendValue(CollectiveTransport *transport, uint32_t rank, V value) {
+  auto send_req_id = transport->SendAsync(rank, &value, sizeof(value));
+  if (!transport->WaitSend(send_req_id)) {
+    MS_LOG(ERROR) << "Send to rank " << rank << " failed.";
+    return false;
+  }
+  return true;
+}
+
+template <typename V>
+bool RecvValue(CollectiveTransport *transport, uint32_t rank, V *value) {
+  std::shared_ptr<std::vector<unsigned char>> recv_str;
+  if (!transport->Receive(rank, sizeof(V), &recv_str)) {
+    return false;
+  }
+  (void)memcpy(value, recv_str->data(), sizeof(V));
+  return true;
+}
+
+// The transport among the leaders of the hosts, rank i of which is the leader leaders[i].
+class LeadersTransport : public CollectiveTransport {
+ public:
+  LeadersTransport(CollectiveTransport *transport, const std::vector<uint32_t> &leaders, uint32_t rank_id)
+      : CollectiveTransport(rank_id, SizeToUint(leaders.size())), transport_(transport), leaders_(leaders) {}
+  ~LeadersTransport() override = default;
+
+  uint64_t SendAsync(uint32_t rank_id, const void *data, size_t size) override {
+    return transport_->SendAsync(leaders_[rank_id], data, size);
+  }
+
+  bool WaitSend(uint64_t request_id) override { return transport_->WaitSend(request_id); }
+
+  bool ReceiveMessage(uint32_t rank_id, std::shared_ptr<std::vector<unsigned char>> *output) override {
+    return transport_->ReceiveMessage(leaders_[rank_id], output);
+  }
+
+ private:
+  CollectiveTransport *transport_;
+  const std::vector<uint32_t> &leaders_;
+};
+}  // namespace
+
+bool HierarchicalCollectiveOps::InitShmChannels(CollectiveTransport *transport, const std::string &prefix,
+                                                IntraHostGroup *intra_host_group) {
+  MS_ERROR_IF_NULL_W_RET_VAL(transport, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(intra_host_group, false);
+  if (intra_host_group->channels_initialized) {
+    return true;
+  }
+  intra_host_group->channels_initialized = true;
+  uint32_t rank_id = transport->rank_id();
+  std::vector<uint32_t> peers;
+  if (rank_id == intra_host_group->leader()) {
+    peers.assign(intra_host_group->local_ranks.begin() + 1, intra_host_group->local_ranks.end());
+  } else {
+    peers.push_back(intra_host_group->leader());
+  }
+  if (peers.empty()) {
+    return true;
+  }
+
+  // The leader draws a token for the segments of the group and gives it to the local ranks, so that the names of two
+  // jobs on the host never collide, even if their schedulers listen on the same address.
+  uint64_t token = 0;
+  if (rank_id == intra_host_group->leader()) {
+    token = NewShmToken();
+    for (uint32_t peer : peers) {
+      if (!SendValue(transport, peer, token)) {
+        return false;
+      }
+    }
+  } else if (!RecvValue(transport, intra_host_group->leader(), &token)) {
+    return false;
+  }
+  std::ostringstream token_hex;
+  token_hex << std::hex << token;
+  std::string token_prefix = prefix + token_hex.str() + "_";
+  auto channel_name = [&token_prefix](uint32_t src, uint32_t dst) {
+    return token_prefix + std::to_string(src) + "_" + std::to_string(dst);
+  };
+
+  // Each rank creates the channels it receives from, then opens the channels the peers created for it. The flags
+  // exchanged make both ends of a pair agree on whether it uses shared memory.
+  std::map<uint32_t, bool> ready;
+  for (uint32_t peer : peers) {
+    auto channel = ShmChannel::Create(channel_name(peer, rank_id), kShmChannelCapacity);
+    ready[peer] = channel != nullptr;
+    intra_host_group->recv_channels[peer] = std::move(channel);
+  }
+  for (uint32_t peer : peers) {
+    if (!SendValue<uint8_t>(transport, peer, ready[peer] ? 1 : 0)) {
+      return false;
+    }
+  }
+  for (uint32_t peer : peers) {
+    uint8_t peer_ready = 0;
+    if (!RecvValue(transport, peer, &peer_ready)) {
+      return false;
+    }
+    if (ready[peer] && peer_ready != 0) {
+      auto channel = ShmChannel::Open(channel_name(rank_id, peer));
+      ready[peer] = channel != nullptr;
+      intra_host_group->send_channels[peer] = std::move(channel);
+    } else {
+      ready[peer] = false;
+    }
+  }
+  for (uint32_t peer : peers) {
+    if (!SendValue<uint8_t>(transport, peer, ready[peer] ? 1 : 0)) {
+      return false;
+    }
+  }
+  for (uint32_t peer : peers) {
+    uint8_t peer_ready = 0;
+    if (!RecvValue(transport, peer, &peer_ready)) {
+      return false;
+    }
+    if (ready[peer] && peer_ready != 0) {
+      // Both ends have mapped the channels, the names are not needed any more.
+      intra_host_group->recv_channels[peer]->Unlink();
+      continue;
+    }
+    MS_LOG(WARNING) << "Set up shared memory channels between rank " << rank_id << " and rank " << peer
+                    << " failed, they communicate through TCP.";
+    (void)intra_host_group->recv_channels.erase(peer);
+    (void)intra_host_group->send_channels.erase(peer);
+  }
+  return true;
+}
+
+bool HierarchicalCollectiveOps::SendToLocalRank(CollectiveTransport *transport, const IntraHostGroup &intra_host_group,
+                                                uint32_t rank, const void *data, size_t size) {
+  if (size == 0) {
+    return true;
+  }
+  auto iter = intra_host_group.send_channels.find(rank);
+  if (iter != intra_host_group.send_channels.end()) {
+    return iter->second->Send(data, size, kCollectiveCommTimeout);
+  }
+  auto send_req_id = transport->SendAsync(rank, data, size);
+  if (!transport->WaitSend(send_req_id)) {
+    MS_LOG(ERROR) << "Send to rank " << rank << " failed.";
+    return false;
+  }
+  return true;
+}
+
+bool HierarchicalCollectiveOps::RecvFromLocalRank(CollectiveTransport *transport,
+                                                  const IntraHostGroup &intra_host_group, uint32_t rank, size_t size,
+                                                  const ShmChannel::Consumer &consumer) {
+  if (size == 0) {
+    return true;
+  }
+  auto iter = intra_host_group.recv_channels.find(rank);
+  if (iter != intra_host_group.recv_channels.end()) {
+    return iter->second->Receive(size, consumer, kCollectiveCommTimeout);
+  }
+  std::shared_ptr<std::vector<unsigned char>> recv_str;
+  if (!transport->Receive(rank, size, &recv_str)) {
+    return false;
+  }
+  consumer(recv_str->data(), 0, size);
+  return true;
+}
+
+template <typename T>
+bool HierarchicalCollectiveOps::AllReduce(CollectiveTransport *transport, const IntraHostGroup &intra_host_group,
+                                          const void *send_buff, void *recv_buff, size_t count) {
+  MS_ERROR_IF_NULL_W_RET_VAL(transport, false);
+  uint32_t rank_id = transport->rank_id();
+  uint32_t leader = intra_host_group.leader();
+  size_t size = count * sizeof(T);
+  uint8_t *output = static_cast<uint8_t *>(recv_buff);
+  auto copy_to_output = [output](const uint8_t *data, size_t offset, size_t len) {
+    (void)memcpy(output + offset, data, len);
+  };
+  if (rank_id != leader) {
+    return SendToLocalRank(transport, intra_host_group, leader, send_buff, size) &&
+           RecvFromLocalRank(transport, intra_host_group, leader, size, copy_to_output);
+  }
+
+  if (send_buff != recv_buff && size > 0) {
+    (void)memcpy(recv_buff, send_buff, size);
+  }
+  // The leader reduces the data of the local ranks straight out of the channels, then with the other hosts.
+  auto reduce_to_output = [output](const uint8_t *data, size_t offset, size_t len) {
+    fl::server::ReduceSum(reinterpret_cast<T *>(output + offset), reinterpret_cast<const T *>(data), len / sizeof(T));
+  };
+  for (size_t i = 1; i < intra_host_group.local_ranks.size(); i++) {
+    if (!RecvFromLocalRank(transport, intra_host_group, intra_host_group.local_ranks[i], size, reduce_to_output)) {
+      return false;
+    }
+  }
+  const auto &leaders = intra_host_group.leaders;
+  if (leaders.size() > 1) {
+    auto leader_index = std::find(leaders.begin(), leaders.end(), rank_id) - leaders.begin();
+    LeadersTransport leaders_transport(transport, leaders, SizeToUint(LongToSize(leader_index)));
+    if (!fl::server::CollectiveOpsImpl::AllReduce<T>(&leaders_transport, recv_buff, recv_buff, count)) {
+      return false;
+    }
+  }
+  for (size_t i = 1; i < intra_host_group.local_ranks.size(); i++) {
+    if (!SendToLocalRank(transport, intra_host_group, intra_host_group.local_ranks[i], recv_buff, size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool HierarchicalCollectiveOps::Broadcast(CollectiveTransport *transport, const IntraHostGroup &intra_host_group,
+                                          const void *send_buff, void *recv_buff, size_t count, uint32_t root) {
+  MS_ERROR_IF_NULL_W_RET_VAL(transport, false);
+  auto root_leader_iter = intra_host_group.rank_leaders.find(root);
+  if (root_leader_iter == intra_host_group.rank_leaders.end()) {
+    MS_LOG(ERROR) << "The root rank " << root << " is not in the group.";
+    return false;
+  }
+  uint32_t root_leader = root_leader_iter->second;
+  uint32_t rank_id = transport->rank_id();
+  uint32_t leader = intra_host_group.leader();
+  size_t size = count * sizeof(T);
+  uint8_t *output = static_cast<uint8_t *>(recv_buff);
+  auto copy_to_output = [output](const uint8_t *data, size_t offset, size_t len) {
+    (void)memcpy(output + offset, data, len);
+  };
+
+  if (rank_id == root && send_buff != recv_buff && size > 0) {
+    (void)memcpy(recv_buff, send_buff, size);
+  }
+  if (root_leader == leader && root != leader) {
+    if (rank_id == root && !SendToLocalRank(transport, intra_host_group, leader, recv_buff, size)) {
+      return false;
+    }
+    if (rank_id == leader && !RecvFromLocalRank(transport, intra_host_group, root, size, copy_to_output)) {
+      return false;
+    }
+  }
+  if (rank_id == root_leader) {
+    std::vector<uint64_t> send_req_ids;
+    for (uint32_t other : intra_host_group.leaders) {
+      if (other != root_leader) {
+        send_req_ids.push_back(transport->SendAsync(other, recv_buff, size));
+      }
+    }
+    for (uint64_t send_req_id : send_req_ids) {
+      if (!transport->WaitSend(send_req_id)) {
+        MS_LOG(ERROR) << "Broadcast to the leaders of the other hosts failed.";
+        return false;
+      }
+    }
+  } else if (rank_id == leader) {
+    std::shared_ptr<std::vector<unsigned char>> recv_str;
+    if (!transport->Receive(root_leader, size, &recv_str)) {
+      return false;
+    }
+    copy_to_output(recv_str->data(), 0, size);
+  }
+
+  // Then each leader passes it to the local ranks.
+  if (rank_id != leader) {
+    return rank_id == root || RecvFromLocalRank(transport, intra_host_group, leader, size, copy_to_output);
+  }
+  for (size_t i = 1; i < intra_host_group.local_ranks.size(); i++) {
+    uint32_t rank = intra_host_group.local_ranks[i];
+    if (rank != root && !SendToLocalRank(transport, intra_host_group, rank, recv_buff, size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool HierarchicalCollectiveOps::AllGather(CollectiveTransport *transport, const IntraHostGroup &intra_host_group,
+                                          const void *send_buff, void *recv_buff, size_t send_count) {
+  MS_ERROR_IF_NULL_W_RET_VAL(transport, false);
+  if (intra_host_group.leaders.size() != 1) {
+    MS_LOG(ERROR) << "The ranks of the group are on " << intra_host_group.leaders.size() << " hosts, not one.";
+    return false;
+  }
+  uint32_t rank_id = transport->rank_id();
+  uint32_t leader = intra_host_group.leader();
+  size_t size = send_count * sizeof(T);
+  size_t total_size = size * intra_host_group.local_ranks.size();
+  uint8_t *output = static_cast<uint8_t *>(recv_buff);
+  auto copy_to = [](uint8_t *dst) {
+    return [dst](const uint8_t *data, size_t offset, size_t len) { (void)memcpy(dst + offset, data, len); };
+  };
+  if (rank_id != leader) {
+    return SendToLocalRank(transport, intra_host_group, leader, send_buff, size) &&
+           RecvFromLocalRank(transport, intra_host_group, leader, total_size, copy_to(output));
+  }
+
+  // The leader gathers the data of the local ranks in their order, then passes the whole to them.
+  if (size > 0) {
+    (void)memcpy(output, send_buff, size);
+  }
+  for (size_t i = 1; i < intra_host_group.local_ranks.size(); i++) {
+    if (!RecvFromLocalRank(transport, intra_host_group, intra_host_group.local_ranks[i], size,
+                           copy_to(output + i * size))) {
+      return false;
+    }
+  }
+  for (size_t i = 1; i < intra_host_group.local_ranks.size(); i++) {
+    if (!SendToLocalRank(transport, intra_host_group, intra_host_group.local_ranks[i], recv_buff, total_size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template bool HierarchicalCollectiveOps::AllReduce<int>(CollectiveTransport *transport,
+                                                        const IntraHostGroup &intra_host_group, const void *send_buff,
+                                                        void *recv_buff, size_t count);
+template bool HierarchicalCollectiveOps::AllReduce<float16>(CollectiveTransport *transport,
+                                                            const IntraHostGroup &intra_host_group,
+                                                            const void *send_buff, void *recv_buff, size_t count);
+template bool HierarchicalCollectiveOps::AllReduce<float>(CollectiveTransport *transport,
+                                                          const IntraHostGroup &intra_host_group,
+                                                          const void *send_buff, void *recv_buff, size_t count);
+
+template bool HierarchicalCollectiveOps::Broadcast<char>(CollectiveTransport *transport,
+                                                         const IntraHostGroup &intra_host_group, const void *send_buff,
+                                                         void *recv_buff, size_t count, uint32_t root);
+template bool HierarchicalCollectiveOps::Broadcast<int32_t>(CollectiveTransport *transport,
+                                                            const IntraHostGroup &intra_host_group,
+                                                            const void *send_buff, void *recv_buff, size_t count,
+                                                            uint32_t root);
+template bool HierarchicalCollectiveOps::Broadcast<uint64_t>(CollectiveTransport *transport,
+                                                             const IntraHostGroup &intra_host_group,
+                                                             const void *send_buff, void *recv_buff, size_t count,
+                                                             uint32_t root);
+template bool HierarchicalCollectiveOps::Broadcast<float>(CollectiveTransport *transport,
+                                                          const IntraHostGroup &intra_host_group,
+                                                          const void *send_buff, void *recv_buff, size_t count,
+                                                          uint32_t root);
+
+template bool HierarchicalCollectiveOps::AllGather<char>(CollectiveTransport *transport,
+                                                         const IntraHostGroup &intra_host_group, const void *send_buff,
+                                                         void *recv_buff, size_t send_count);
+template bool HierarchicalCollectiveOps::AllGather<int32_t>(CollectiveTransport *transport,
+                                                            const IntraHostGroup &intra_host_group,
+                                                            const void *send_buff, void *recv_buff,
+                                                            size_t send_count);
+template bool HierarchicalCollectiveOps::AllGather<uint64_t>(CollectiveTransport *transport,
+                                                             const IntraHostGroup &intra_host_group,
+                                                             const void *send_buff, void *recv_buff,
+                                                             size_t send_count);
+template bool HierarchicalCollectiveOps::AllGather<float>(CollectiveTransport *transport,
+                                                          const IntraHostGroup &intra_host_group,
+                                                          const void *send_buff, void *recv_buff, size_t send_count);
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
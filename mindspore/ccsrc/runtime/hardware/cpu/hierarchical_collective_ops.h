@@ -0,0 +1,85 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_HIERARCHICAL_COLLECTIVE_OPS_H_
+#define MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_HIERARCHICAL_COLLECTIVE_OPS_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "runtime/hardware/cpu/shm_channel.h"
+#include "fl/server/collective_ops_impl.h"
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+using CollectiveTransport = mindspore::fl::server::CollectiveTransport;
+
+// The ranks of a group on the same host as this process, and the channels to them.
+struct IntraHostGroup {
+  // The global ranks of the group on this host, in the group order. The first one is the leader of the host.
+  std::vector<uint32_t> local_ranks;
+  // The global ranks of the leaders of all the hosts of the group, in the group order.
+  std::vector<uint32_t> leaders;
+  // The leader of the host of each global rank of the group.
+  std::map<uint32_t, uint32_t> rank_leaders;
+  // The shared memory channels to and from the local ranks, keyed by global rank. A leader has channels to all the
+  // other local ranks, the others only to the leader. They are set up at the first collective operation, the ranks
+  // without channels between them, e.g. because /dev/shm is full, communicate through the transport instead.
+  bool channels_initialized = false;
+  std::map<uint32_t, std::unique_ptr<ShmChannel>> send_channels;
+  std::map<uint32_t, std::unique_ptr<ShmChannel>> recv_channels;
+
+  uint32_t leader() const { return local_ranks.front(); }
+};
+
+// The collectives of a group whose ranks on the same host communicate through shared memory, via the leader of the
+// host, and only the leaders communicate through the transport. The ranks of the transport are the global ranks.
+class HierarchicalCollectiveOps {
+ public:
+  // Set up the shared memory channels between the local ranks once, all of them must call it together. The names of
+  // the segments start with prefix, followed by a token the leader draws so that two jobs on the host never collide.
+  static bool InitShmChannels(CollectiveTransport *transport, const std::string &prefix,
+                              IntraHostGroup *intra_host_group);
+
+  // AllReduce reduces on each host first, then across the leaders of the hosts, then passes the sum back.
+  template <typename T>
+  static bool AllReduce(CollectiveTransport *transport, const IntraHostGroup &intra_host_group, const void *send_buff,
+                        void *recv_buff, size_t count);
+
+  // The root passes the data to the leader of its host, which broadcasts it to the leaders of the other hosts, which
+  // pass it to their local ranks. The root is a global rank.
+  template <typename T>
+  static bool Broadcast(CollectiveTransport *transport, const IntraHostGroup &intra_host_group, const void *send_buff,
+                        void *recv_buff, size_t count, uint32_t root);
+
+  // AllGather of a group whose ranks are all on this host, in the order of the local ranks.
+  template <typename T>
+  static bool AllGather(CollectiveTransport *transport, const IntraHostGroup &intra_host_group, const void *send_buff,
+                        void *recv_buff, size_t send_count);
+
+ private:
+  // Send and receive between the local ranks, through the shared memory channel if there is one or the transport.
+  static bool SendToLocalRank(CollectiveTransport *transport, const IntraHostGroup &intra_host_group, uint32_t rank,
+                              const void *data, size_t size);
+  static bool RecvFromLocalRank(CollectiveTransport *transport, const IntraHostGroup &intra_host_group, uint32_t rank,
+                                size_t size, const ShmChannel::Consumer &consumer);
+};
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_HIERARCHICAL_COLLECTIVE_OPS_H_
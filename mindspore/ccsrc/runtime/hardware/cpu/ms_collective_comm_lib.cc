@@ -15,6 +15,10 @@
  */
 
 #include "runtime/hardware/cpu/ms_collective_comm_lib.h"
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <utility>
 
 namespace mindspore {
 namespace device {
@@ -37,6 +41,11 @@ bool MsCollectiveCommLib::Initialize(uint32_t global_rank, uint32_t global_rank_
   return true;
 }
 
+bool MsCollectiveCommLib::Finalize() {
+  intra_host_groups_.clear();
+  return CollectiveCommunicationLib::Finalize();
+}
+
 bool MsCollectiveCommLib::CreateCommunicationGroup(const std::string &group_name,
                                                    const std::vector<uint32_t> &group_ranks) {
   if (groups_.count(group_name) != 0) {
@@ -50,12 +59,47 @@ bool MsCollectiveCommLib::CreateCommunicationGroup(const std::string &group_name
   return true;
 }
 
+bool MsCollectiveCommLib::DestroyCommunicationGroup(const std::string &group_name) {
+  (void)intra_host_groups_.erase(group_name);
+  return CollectiveCommunicationLib::DestroyCommunicationGroup(group_name);
+}
+
 bool MsCollectiveCommLib::AllGather(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
                                     const std::string &group_name, void *stream) {
   CHECK_IF_NULL(send_buff);
   CHECK_IF_NULL(recv_buff);
   CHECK_IF_NULL(node_);
 
+  // The messages between the ranks go through the collective messages of the node like those of CollectiveOpsImpl, so
+  // its lock is held to keep them from being interleaved with the operations run on other threads.
+  std::unique_lock<std::mutex> lock(CollectiveOpsImpl::GetInstance().mutex());
+  // A group on a single host is gathered through shared memory.
+  auto intra_host_group = groups_.count(group_name) == 0 ? nullptr : GetIntraHostGroup(group_name);
+  if (intra_host_group != nullptr && intra_host_group->leaders.size() == 1 &&
+      intra_host_group->local_ranks.size() > 1) {
+    CHECK_IF_NULL(GetReadyIntraHostGroup(group_name));
+    NodeCollectiveTransport transport(node_, node_->role(), node_->rank_id(), global_rank_size_);
+    switch (data_type) {
+      case TypeId::kNumberTypeInt8:
+        return HierarchicalCollectiveOps::AllGather<char>(&transport, *intra_host_group, send_buff, recv_buff,
+                                                          send_count);
+      case TypeId::kNumberTypeInt32:
+      case TypeId::kNumberTypeInt:
+        return HierarchicalCollectiveOps::AllGather<int32_t>(&transport, *intra_host_group, send_buff, recv_buff,
+                                                             send_count);
+      case TypeId::kNumberTypeUInt64:
+        return HierarchicalCollectiveOps::AllGather<uint64_t>(&transport, *intra_host_group, send_buff, recv_buff,
+                                                              send_count);
+      case TypeId::kNumberTypeFloat32:
+      case TypeId::kNumberTypeFloat:
+        return HierarchicalCollectiveOps::AllGather<float>(&transport, *intra_host_group, send_buff, recv_buff,
+                                                           send_count);
+      default:
+        return false;
+    }
+  }
+  // The other groups are gathered by CollectiveOpsImpl, which takes the lock itself.
+  lock.unlock();
   switch (data_type) {
     case TypeId::kNumberTypeInt8:
       return CollectiveOpsImpl::GetInstance().AllGather<char>(send_buff, recv_buff, send_count, node_);
@@ -73,45 +117,129 @@ bool MsCollectiveCommLib::AllGather(const void *send_buff, void *recv_buff, size
   return true;
 }
 
-bool MsCollectiveCommLib::Broadcast(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
-                                    uint32_t root_rank, const std::string &group_name, void *stream) {
+bool MsCollectiveCommLib::AllReduce(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
+                                    CollectiveOpReduceType reduce_op, const std::string &group_name, void *stream) {
   CHECK_IF_NULL(send_buff);
   CHECK_IF_NULL(recv_buff);
   CHECK_IF_NULL(node_);
 
-  if (groups_.count(group_name) == 0) {
-    MS_LOG(ERROR) << "The group " << group_name << " does not exist.";
+  if (reduce_op != CollectiveOpReduceType::Reduce_Sum) {
+    MS_LOG(ERROR) << "The reduce type " << reduce_op << " is not supported, only Reduce_Sum is.";
     return false;
   }
+  std::unique_lock<std::mutex> lock(CollectiveOpsImpl::GetInstance().mutex());
+  auto intra_host_group = GetReadyIntraHostGroup(group_name);
+  CHECK_IF_NULL(intra_host_group);
+  NodeCollectiveTransport transport(node_, node_->role(), node_->rank_id(), global_rank_size_);
+  switch (data_type) {
+    case TypeId::kNumberTypeInt32:
+    case TypeId::kNumberTypeInt:
+      return HierarchicalCollectiveOps::AllReduce<int>(&transport, *intra_host_group, send_buff, recv_buff,
+                                                       send_count);
+    case TypeId::kNumberTypeFloat16:
+      return HierarchicalCollectiveOps::AllReduce<float16>(&transport, *intra_host_group, send_buff, recv_buff,
+                                                           send_count);
+    case TypeId::kNumberTypeFloat32:
+    case TypeId::kNumberTypeFloat:
+      return HierarchicalCollectiveOps::AllReduce<float>(&transport, *intra_host_group, send_buff, recv_buff,
+                                                         send_count);
+    default:
+      return false;
+  }
+  return true;
+}
 
-  auto group = groups_[group_name];
-  CommunicationGroupInfo group_info = {};
-  group_info.size = group->group_size();
-  group_info.global_rank = global_rank_id_;
-  group_info.group_ranks = group->group_ranks();
-  group_info.global_to_group_ranks = group->global_to_group_ranks();
-  group_info.group_to_global_ranks = group->group_to_global_ranks();
+bool MsCollectiveCommLib::Broadcast(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
+                                    uint32_t root_rank, const std::string &group_name, void *stream) {
+  CHECK_IF_NULL(send_buff);
+  CHECK_IF_NULL(recv_buff);
+  CHECK_IF_NULL(node_);
 
+  std::unique_lock<std::mutex> lock(CollectiveOpsImpl::GetInstance().mutex());
+  auto intra_host_group = GetReadyIntraHostGroup(group_name);
+  CHECK_IF_NULL(intra_host_group);
+  auto group_to_global_ranks = groups_[group_name]->group_to_global_ranks();
+  if (group_to_global_ranks.count(root_rank) == 0) {
+    MS_LOG(ERROR) << "The root rank " << root_rank << " is not in the group " << group_name;
+    return false;
+  }
+  uint32_t root = group_to_global_ranks[root_rank];
+  NodeCollectiveTransport transport(node_, node_->role(), node_->rank_id(), global_rank_size_);
   switch (data_type) {
     case TypeId::kNumberTypeInt8:
-      return CollectiveOpsImpl::GetInstance().Broadcast<char>(send_buff, recv_buff, send_count, root_rank, node_,
-                                                              group_info);
+      return HierarchicalCollectiveOps::Broadcast<char>(&transport, *intra_host_group, send_buff, recv_buff,
+                                                        send_count, root);
     case TypeId::kNumberTypeInt32:
     case TypeId::kNumberTypeInt:
-      return CollectiveOpsImpl::GetInstance().Broadcast<int32_t>(send_buff, recv_buff, send_count, root_rank, node_,
-                                                                 group_info);
+      return HierarchicalCollectiveOps::Broadcast<int32_t>(&transport, *intra_host_group, send_buff, recv_buff,
+                                                           send_count, root);
     case TypeId::kNumberTypeUInt64:
-      return CollectiveOpsImpl::GetInstance().Broadcast<uint64_t>(send_buff, recv_buff, send_count, root_rank, node_,
-                                                                  group_info);
+      return HierarchicalCollectiveOps::Broadcast<uint64_t>(&transport, *intra_host_group, send_buff, recv_buff,
+                                                            send_count, root);
     case TypeId::kNumberTypeFloat32:
     case TypeId::kNumberTypeFloat:
-      return CollectiveOpsImpl::GetInstance().Broadcast<float>(send_buff, recv_buff, send_count, root_rank, node_,
-                                                               group_info);
+      return HierarchicalCollectiveOps::Broadcast<float>(&transport, *intra_host_group, send_buff, recv_buff,
+                                                         send_count, root);
     default:
       return false;
   }
   return true;
 }
+
+IntraHostGroup *MsCollectiveCommLib::GetIntraHostGroup(const std::string &group_name) {
+  auto iter = intra_host_groups_.find(group_name);
+  if (iter != intra_host_groups_.end()) {
+    return &iter->second;
+  }
+  if (groups_.count(group_name) == 0) {
+    MS_LOG(ERROR) << "The group " << group_name << " does not exist.";
+    return nullptr;
+  }
+
+  // The ranks of the same ip are on the same host, a rank of unknown ip is alone on its host.
+  uint32_t rank_id = node_->rank_id();
+  auto role = node_->role();
+  std::string local_ip = node_->GetNodeIp(role, rank_id);
+  IntraHostGroup intra_host_group;
+  std::map<std::string, uint32_t> host_leaders;
+  for (uint32_t rank : groups_[group_name]->group_ranks()) {
+    std::string ip = node_->GetNodeIp(role, rank);
+    std::string host = ip.empty() ? "rank:" + std::to_string(rank) : ip;
+    if (host_leaders.count(host) == 0) {
+      host_leaders[host] = rank;
+      intra_host_group.leaders.push_back(rank);
+    }
+    intra_host_group.rank_leaders[rank] = host_leaders[host];
+    if (rank == rank_id || (!local_ip.empty() && ip == local_ip)) {
+      intra_host_group.local_ranks.push_back(rank);
+    }
+  }
+  if (std::find(intra_host_group.local_ranks.begin(), intra_host_group.local_ranks.end(), rank_id) ==
+      intra_host_group.local_ranks.end()) {
+    MS_LOG(ERROR) << "The rank " << rank_id << " is not in the group " << group_name;
+    return nullptr;
+  }
+  MS_LOG(INFO) << "The group " << group_name << " has " << intra_host_group.local_ranks.size()
+               << " ranks on this host, led by rank " << intra_host_group.leader() << ", and "
+               << intra_host_group.leaders.size() << " hosts.";
+  return &(intra_host_groups_[group_name] = std::move(intra_host_group));
+}
+
+IntraHostGroup *MsCollectiveCommLib::GetReadyIntraHostGroup(const std::string &group_name) {
+  auto intra_host_group = GetIntraHostGroup(group_name);
+  if (intra_host_group == nullptr) {
+    return nullptr;
+  }
+  // The segments of the group are named after the scheduler, the role and the group, the leader adds a token.
+  std::string scheduler = node_->scheduler_ip() + ":" + std::to_string(node_->scheduler_port());
+  std::string prefix = "/ms_" + std::to_string(std::hash<std::string>()(scheduler)) + "_" +
+                       std::to_string(node_->role()) + "_" + std::to_string(std::hash<std::string>()(group_name)) + "_";
+  NodeCollectiveTransport transport(node_, node_->role(), node_->rank_id(), global_rank_size_);
+  if (!HierarchicalCollectiveOps::InitShmChannels(&transport, prefix, intra_host_group)) {
+    return nullptr;
+  }
+  return intra_host_group;
+}
 }  // namespace cpu
 }  // namespace device
 }  // namespace mindspore
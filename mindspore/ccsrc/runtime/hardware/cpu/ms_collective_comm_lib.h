@@ -17,11 +17,13 @@
 #ifndef MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_MS_COLLECTIVE_COMM_LIB_H_
 #define MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_MS_COLLECTIVE_COMM_LIB_H_
 
+#include <map>
 #include <memory>
 #include <vector>
 #include <string>
 #include "runtime/hardware/collective/collective_communication_lib.h"
 #include "runtime/hardware/cpu/ms_communication_group.h"
+#include "runtime/hardware/cpu/hierarchical_collective_ops.h"
 #include "distributed/cluster/cluster_context.h"
 #include "fl/server/collective_ops_impl.h"
 
@@ -32,8 +34,11 @@ constexpr char kMSGlobalGroupName[] = "ms_world_group";
 using ClusterContext = mindspore::distributed::cluster::ClusterContext;
 using CollectiveOpsImpl = mindspore::fl::server::CollectiveOpsImpl;
 using CommunicationGroupInfo = mindspore::fl::server::CommunicationGroupInfo;
+using NodeCollectiveTransport = mindspore::fl::server::NodeCollectiveTransport;
 
 // The collective communication library for MindSpore self developed communication framework.
+// The ranks of a group on the same host communicate through shared memory, via the leader of the host, and only the
+// leaders communicate through TCP. So AllReduce is reduced on each host first, then across the hosts.
 class MsCollectiveCommLib : public CollectiveCommunicationLib {
  public:
   static MsCollectiveCommLib &GetInstance() {
@@ -43,15 +48,17 @@ class MsCollectiveCommLib : public CollectiveCommunicationLib {
 
   bool Initialize(uint32_t global_rank = UINT32_MAX, uint32_t global_rank_size = UINT32_MAX) override;
 
+  bool Finalize() override;
+
   bool CreateCommunicationGroup(const std::string &group_name, const std::vector<uint32_t> &group_ranks) override;
 
+  bool DestroyCommunicationGroup(const std::string &group_name) override;
+
   bool AllGather(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
                  const std::string &group_name, void *stream = nullptr) override;
 
   bool AllReduce(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type,
-                 CollectiveOpReduceType reduce_op, const std::string &group_name, void *stream = nullptr) override {
-    return true;
-  }
+                 CollectiveOpReduceType reduce_op, const std::string &group_name, void *stream = nullptr) override;
 
   bool Broadcast(const void *send_buff, void *recv_buff, size_t send_count, TypeId data_type, uint32_t root_rank,
                  const std::string &group_name, void *stream = nullptr) override;
@@ -65,7 +72,15 @@ class MsCollectiveCommLib : public CollectiveCommunicationLib {
   MsCollectiveCommLib();
   ~MsCollectiveCommLib() override = default;
 
+  // Return the ranks of the group on this host and the leaders of the hosts, found by the ips of the nodes at the
+  // first call. Return nullptr if the group doesn't exist.
+  IntraHostGroup *GetIntraHostGroup(const std::string &group_name);
+  // Return the group on this host with its shared memory channels set up, all the local ranks must call it together
+  // at the first collective operation of the group. It is called with the lock of CollectiveOpsImpl held.
+  IntraHostGroup *GetReadyIntraHostGroup(const std::string &group_name);
+
   std::shared_ptr<ps::core::AbstractNode> node_;
+  std::map<std::string, IntraHostGroup> intra_host_groups_;
 };
 }  // namespace cpu
 }  // namespace device
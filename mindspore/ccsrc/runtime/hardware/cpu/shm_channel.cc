@@ -0,0 +1,251 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/hardware/cpu/shm_channel.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+namespace {
+// The number of checks before sleeping on the futex, so that a peer which is just behind doesn't cost a syscall.
+constexpr size_t kShmSpinCount = 2000;
+#ifndef __linux__
+constexpr auto kShmPollInterval = std::chrono::microseconds(50);
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+size_t AlignUp(size_t size) {
+  return (size + ShmChannel::kShmAlignment - 1) / ShmChannel::kShmAlignment * ShmChannel::kShmAlignment;
+}
+
+size_t HeaderSize() { return AlignUp(sizeof(ShmRingHeader)); }
+
+void FutexWait(std::atomic<uint32_t> *word, uint32_t expected, Clock::duration timeout) {
+#ifdef __linux__
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+  struct timespec ts;
+  ts.tv_sec = static_cast<time_t>(ns / std::nano::den);
+  ts.tv_nsec = static_cast<long>(ns % std::nano::den);
+  // Not FUTEX_PRIVATE_FLAG, the word is shared with another process.
+  (void)syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+  if (word->load() == expected) {
+    std::this_thread::sleep_for(std::min<Clock::duration>(timeout, kShmPollInterval));
+  }
+#endif
+}
+
+void FutexWake(std::atomic<uint32_t> *word) {
+#ifdef __linux__
+  (void)syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+// Wait until ready() returns true. The other side bumps seq and wakes it if waiting is set after changing the state
+// checked by ready(); setting waiting before checking the state again makes sure that a wake up is not missed.
+template <typename Ready>
+bool WaitUntil(std::atomic<uint32_t> *seq, std::atomic<uint32_t> *waiting, const Ready &ready, uint32_t timeout) {
+  for (size_t i = 0; i < kShmSpinCount; ++i) {
+    if (ready()) {
+      return true;
+    }
+  }
+  auto deadline = Clock::now() + std::chrono::seconds(timeout);
+  while (true) {
+    uint32_t expected = seq->load();
+    waiting->store(1);
+    if (ready()) {
+      waiting->store(0);
+      return true;
+    }
+    auto now = Clock::now();
+    if (now >= deadline) {
+      waiting->store(0);
+      return false;
+    }
+    FutexWait(seq, expected, deadline - now);
+    waiting->store(0);
+  }
+}
+
+void Notify(std::atomic<uint32_t> *seq, const std::atomic<uint32_t> &waiting) {
+  (void)seq->fetch_add(1);
+  if (waiting.load() != 0) {
+    FutexWake(seq);
+  }
+}
+}  // namespace
+
+ShmChannel::ShmChannel(const std::string &name, int fd, void *addr, size_t mapped_size)
+    : name_(name),
+      fd_(fd),
+      addr_(addr),
+      mapped_size_(mapped_size),
+      unlinked_(false),
+      header_(static_cast<ShmRingHeader *>(addr)),
+      ring_(static_cast<uint8_t *>(addr) + HeaderSize()) {}
+
+ShmChannel::~ShmChannel() {
+  (void)munmap(addr_, mapped_size_);
+  (void)close(fd_);
+  Unlink();
+}
+
+std::unique_ptr<ShmChannel> ShmChannel::Create(const std::string &name, size_t capacity) {
+  capacity = AlignUp(capacity);
+  size_t mapped_size = HeaderSize() + capacity;
+  // Never take over a segment of the name, it may belong to another process.
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    MS_LOG(WARNING) << "Create shared memory " << name << " failed, errno: " << errno << ", " << strerror(errno);
+    return nullptr;
+  }
+#ifdef __linux__
+  // Reserve the pages, a full /dev/shm fails here instead of raising SIGBUS at the first write.
+  int ret = posix_fallocate(fd, 0, static_cast<off_t>(mapped_size));
+#else
+  int ret = ftruncate(fd, static_cast<off_t>(mapped_size));
+#endif
+  if (ret != 0) {
+    MS_LOG(WARNING) << "Allocate " << mapped_size << " bytes of shared memory " << name << " failed, error: " << ret;
+    (void)close(fd);
+    (void)shm_unlink(name.c_str());
+    return nullptr;
+  }
+  void *addr = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    MS_LOG(WARNING) << "Map shared memory " << name << " failed, errno: " << errno << ", " << strerror(errno);
+    (void)close(fd);
+    (void)shm_unlink(name.c_str());
+    return nullptr;
+  }
+  // The new pages are zero, which is the initial state of the positions and the futex words.
+  auto header = static_cast<ShmRingHeader *>(addr);
+  header->capacity = capacity;
+  return std::unique_ptr<ShmChannel>(new ShmChannel(name, fd, addr, mapped_size));
+}
+
+std::unique_ptr<ShmChannel> ShmChannel::Open(const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    MS_LOG(WARNING) << "Open shared memory " << name << " failed, errno: " << errno << ", " << strerror(errno);
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) <= HeaderSize()) {
+    MS_LOG(WARNING) << "The shared memory " << name << " is not initialized.";
+    (void)close(fd);
+    return nullptr;
+  }
+  size_t mapped_size = static_cast<size_t>(st.st_size);
+  void *addr = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    MS_LOG(WARNING) << "Map shared memory " << name << " failed, errno: " << errno << ", " << strerror(errno);
+    (void)close(fd);
+    return nullptr;
+  }
+  auto channel = std::unique_ptr<ShmChannel>(new ShmChannel(name, fd, addr, mapped_size));
+  // Only the receiver owns the name.
+  channel->unlinked_ = true;
+  if (channel->header_->capacity + HeaderSize() != mapped_size) {
+    MS_LOG(WARNING) << "The capacity of shared memory " << name << " is invalid.";
+    return nullptr;
+  }
+  return channel;
+}
+
+void ShmChannel::Unlink() {
+  if (!unlinked_) {
+    (void)shm_unlink(name_.c_str());
+    unlinked_ = true;
+  }
+}
+
+bool ShmChannel::Send(const void *data, size_t size, uint32_t timeout) {
+  const uint8_t *src = static_cast<const uint8_t *>(data);
+  size_t capacity = header_->capacity;
+  uint64_t head = header_->head.load(std::memory_order_relaxed);
+  size_t sent = 0;
+  while (sent < size) {
+    // The room is a multiple of the alignment, which is enough for the end of a message.
+    auto has_room = [this, head, capacity]() { return capacity - (head - header_->tail.load()) >= kShmAlignment; };
+    if (!WaitUntil(&header_->space_seq, &header_->sender_waiting, has_room, timeout)) {
+      MS_LOG(ERROR) << "Wait for room in shared memory " << name_ << " timeout, sent " << sent << " of " << size
+                    << " bytes.";
+      return false;
+    }
+    size_t offset = head % capacity;
+    size_t room = std::min(capacity - (head - header_->tail.load(std::memory_order_acquire)), capacity - offset);
+    size_t len = size - sent;
+    if (len > room) {
+      // Only the end of a message leaves the position unaligned.
+      len = room / kShmAlignment * kShmAlignment;
+    }
+    (void)memcpy(ring_ + offset, src + sent, len);
+    sent += len;
+    head += AlignUp(len);
+    header_->head.store(head);
+    Notify(&header_->data_seq, header_->receiver_waiting);
+  }
+  return true;
+}
+
+bool ShmChannel::Receive(size_t size, const Consumer &consumer, uint32_t timeout) {
+  size_t capacity = header_->capacity;
+  uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+  size_t received = 0;
+  while (received < size) {
+    auto has_data = [this, tail]() { return header_->head.load() != tail; };
+    if (!WaitUntil(&header_->data_seq, &header_->receiver_waiting, has_data, timeout)) {
+      MS_LOG(ERROR) << "Wait for data in shared memory " << name_ << " timeout, received " << received << " of "
+                    << size << " bytes.";
+      return false;
+    }
+    size_t offset = tail % capacity;
+    size_t available = std::min(header_->head.load(std::memory_order_acquire) - tail, capacity - offset);
+    size_t len = std::min(available, size - received);
+    consumer(ring_ + offset, received, len);
+    received += len;
+    tail += AlignUp(len);
+    header_->tail.store(tail);
+    Notify(&header_->space_seq, header_->sender_waiting);
+  }
+  return true;
+}
+
+bool ShmChannel::Receive(void *data, size_t size, uint32_t timeout) {
+  uint8_t *dst = static_cast<uint8_t *>(data);
+  return Receive(
+    size, [dst](const uint8_t *piece, size_t offset, size_t len) { (void)memcpy(dst + offset, piece, len); }, timeout);
+}
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
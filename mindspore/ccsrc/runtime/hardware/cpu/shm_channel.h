@@ -0,0 +1,88 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_SHM_CHANNEL_H_
+#define MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_SHM_CHANNEL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+// The capacity of the ring of a shared memory channel.
+constexpr size_t kShmChannelCapacity = 1 << 20;
+
+// The control block at the head of the shared memory segment of a channel, followed by the ring. The positions only
+// grow and are kept aligned to kShmAlignment, so that every message starts aligned in the ring.
+struct ShmRingHeader {
+  uint64_t capacity;
+  alignas(64) std::atomic<uint64_t> head;  // written by the sender
+  std::atomic<uint32_t> data_seq;          // futex word bumped by the sender after moving head
+  std::atomic<uint32_t> receiver_waiting;
+  alignas(64) std::atomic<uint64_t> tail;  // written by the receiver
+  std::atomic<uint32_t> space_seq;         // futex word bumped by the receiver after moving tail
+  std::atomic<uint32_t> sender_waiting;
+};
+
+// A one-way channel between two processes on the same host, through a byte ring in a POSIX shared memory segment.
+// Messages of any size are streamed through the ring, the sender and the receiver spin for a while and then sleep on a
+// futex when the ring is full or empty. The receiver creates the segment and the sender opens it, the name is unlinked
+// once both have mapped it so nothing is left behind if a process dies.
+class ShmChannel {
+ public:
+  // Called with the consecutive pieces of a message received, offset is the position of the piece in the message.
+  // The pieces of a message of elements of up to kShmAlignment bytes never split an element.
+  using Consumer = std::function<void(const uint8_t *data, size_t offset, size_t size)>;
+
+  static constexpr size_t kShmAlignment = 64;
+
+  // Create the segment of name for the receiver. Return nullptr on failure, including when the name is already taken.
+  static std::unique_ptr<ShmChannel> Create(const std::string &name, size_t capacity);
+  // Open the segment of name created by the receiver, for the sender. Return nullptr on failure.
+  static std::unique_ptr<ShmChannel> Open(const std::string &name);
+
+  ~ShmChannel();
+  ShmChannel(const ShmChannel &) = delete;
+  ShmChannel &operator=(const ShmChannel &) = delete;
+
+  // Remove the name of the segment, the mappings stay valid.
+  void Unlink();
+
+  // Send a message of size bytes, return false if the receiver doesn't make room within timeout seconds.
+  bool Send(const void *data, size_t size, uint32_t timeout);
+  // Receive a message of size bytes, return false if the sender doesn't fill it within timeout seconds.
+  bool Receive(size_t size, const Consumer &consumer, uint32_t timeout);
+  bool Receive(void *data, size_t size, uint32_t timeout);
+
+ private:
+  ShmChannel(const std::string &name, int fd, void *addr, size_t mapped_size);
+
+  std::string name_;
+  int fd_;
+  void *addr_;
+  size_t mapped_size_;
+  bool unlinked_;
+  ShmRingHeader *header_;
+  uint8_t *ring_;
+};
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_RUNTIME_HARDWARE_CPU_SHM_CHANNEL_H_
@@ -141,9 +141,14 @@ void ActorBase::Run() {
       msgs->clear();
     }
   } else {
-    while (auto msg = mailbox->GetMsg()) {
-      if (msgHandler(msg) == ACTOR_TERMINATED) {
-        return;
+    // drain several msgs per wakeup, the msgs left in the batch are released after the actor terminated.
+    std::unique_ptr<MessageBase> msgs[HQueMailBox::MAX_MSG_BATCH_SIZE];
+    while (size_t num = mailbox->GetMsgBatch(msgs, HQueMailBox::MAX_MSG_BATCH_SIZE)) {
+      for (size_t i = 0; i < num; ++i) {
+        if (msgHandler(msgs[i]) == ACTOR_TERMINATED) {
+          return;
+        }
+        msgs[i].reset();
       }
     }
   }
@@ -85,4 +85,17 @@ std::unique_ptr<MessageBase> HQueMailBox::GetMsg() {
   std::unique_ptr<MessageBase> msg(mailbox.Dequeue());
   return msg;
 }
+
+size_t HQueMailBox::GetMsgBatch(std::unique_ptr<MessageBase> *msgs, size_t max_num) {
+  if (msgs == nullptr || max_num == 0) {
+    return 0;
+  }
+  max_num = max_num < MAX_MSG_BATCH_SIZE ? max_num : MAX_MSG_BATCH_SIZE;
+  MessageBase *msgPtrs[MAX_MSG_BATCH_SIZE];
+  size_t num = mailbox.DequeueBatch(msgPtrs, max_num);
+  for (size_t i = 0; i < num; ++i) {
+    msgs[i].reset(msgPtrs[i]);
+  }
+  return num;
+}
 }  // namespace mindspore
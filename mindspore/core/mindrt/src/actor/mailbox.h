@@ -32,6 +32,18 @@ class MailBox {
   virtual int EnqueueMessage(std::unique_ptr<MessageBase> msg) = 0;
   virtual std::list<std::unique_ptr<MessageBase>> *GetMsgs() = 0;
   virtual std::unique_ptr<MessageBase> GetMsg() = 0;
+  // take at most max_num msgs each time, return the number of msgs taken.
+  virtual size_t GetMsgBatch(std::unique_ptr<MessageBase> *msgs, size_t max_num) {
+    size_t num = 0;
+    while (num < max_num) {
+      auto msg = GetMsg();
+      if (msg == nullptr) {
+        break;
+      }
+      msgs[num++] = std::move(msg);
+    }
+    return num;
+  }
   inline void SetNotifyHook(std::unique_ptr<std::function<void()>> &&hook) { notifyHook = std::move(hook); }
   inline bool TakeAllMsgsEachTime() { return takeAllMsgsEachTime; }
   void SwapMailBox(std::list<std::unique_ptr<MessageBase>> **box1, std::list<std::unique_ptr<MessageBase>> **box2) {
@@ -89,11 +101,13 @@ class NonblockingMailBox : public MailBox {
 
 class HQueMailBox : public MailBox {
  public:
+  static const size_t MAX_MSG_BATCH_SIZE = 32;
   HQueMailBox() { takeAllMsgsEachTime = false; }
   inline bool Init() { return mailbox.Init(MAX_MSG_QUE_SIZE); }
   int EnqueueMessage(std::unique_ptr<MessageBase> msg) override;
   std::list<std::unique_ptr<MessageBase>> *GetMsgs() override { return nullptr; }
   std::unique_ptr<MessageBase> GetMsg() override;
+  size_t GetMsgBatch(std::unique_ptr<MessageBase> *msgs, size_t max_num) override;
 
  private:
   HQueue<MessageBase> mailbox;
@@ -22,9 +22,27 @@
 
 namespace mindspore {
 constexpr size_t MAX_READY_ACTOR_NR = 4096;
-void ActorWorker::CreateThread(ActorThreadPool *pool) {
+constexpr size_t MAX_LOCAL_READY_ACTOR_NR = 1024;
+namespace {
+// the actor worker which the current thread belongs to, nullptr for the non actor thread
+thread_local ActorWorker *current_actor_worker = nullptr;
+
+inline uint32_t NextRandom(uint32_t *seed) {
+  // xorshift32
+  uint32_t x = *seed;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *seed = x;
+  return x;
+}
+}  // namespace
+
+void ActorWorker::CreateThread(ActorThreadPool *pool, size_t index) {
   THREAD_RETURN_IF_NULL(pool);
   pool_ = pool;
+  index_ = index;
+  steal_seed_ = static_cast<uint32_t>(index) * 2654435761U + 1;
   thread_ = std::thread(&ActorWorker::RunWithSpin, this);
 }
 
@@ -34,6 +52,7 @@ void ActorWorker::RunWithSpin() {
   static std::atomic_int index = {0};
   (void)pthread_setname_np(pthread_self(), ("ActorThread_" + std::to_string(index++)).c_str());
 #endif
+  current_actor_worker = this;
   while (alive_) {
     // only run either local KernelTask or PoolQueue ActorTask
     if (RunLocalKernelTask() || RunQueueActorTask()) {
@@ -50,14 +69,56 @@ void ActorWorker::RunWithSpin() {
 
 bool ActorWorker::RunQueueActorTask() {
   THREAD_ERROR_IF_NULL(pool_);
-  auto actor = pool_->PopActorFromQueue();
+  auto actor = PopActor();
   if (actor == nullptr) {
+    idle_spin_num_.fetch_add(1, std::memory_order_relaxed);
     return false;
   }
   actor->Run();
   return true;
 }
 
+ActorBase *ActorWorker::PopActor() {
+  if (!pool_->work_stealing()) {
+    return pool_->PopActorFromQueue();
+  }
+  // locality first: the local deque, then the shared queue, and steal from the others at last
+  auto actor = pool_->local_actor_queue(index_)->PopBottom();
+  if (actor != nullptr) {
+    return actor;
+  }
+  actor = pool_->PopActorFromQueue();
+  if (actor != nullptr) {
+    return actor;
+  }
+  actor = pool_->StealActor(index_, &steal_seed_);
+  if (actor != nullptr) {
+    steal_num_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return actor;
+}
+
+bool ActorWorker::PushLocalActor(ActorBase *actor) {
+  auto queue = pool_->local_actor_queue(index_);
+  if (!queue->PushBottom(actor)) {
+    return false;
+  }
+  size_t depth = queue->Size();
+  if (depth > max_queue_depth_.load(std::memory_order_relaxed)) {
+    max_queue_depth_.store(depth, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+ActorWorkerStat ActorWorker::GetStat() const {
+  ActorWorkerStat stat;
+  stat.steal_num = steal_num_.load(std::memory_order_relaxed);
+  stat.idle_spin_num = idle_spin_num_.load(std::memory_order_relaxed);
+  stat.queue_depth = pool_ == nullptr ? 0 : pool_->local_actor_queue(index_)->Size();
+  stat.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+  return stat;
+}
+
 bool ActorWorker::ActorActive() {
   if (status_ != kThreadIdle) {
     return false;
@@ -84,6 +145,7 @@ ActorThreadPool::~ActorThreadPool() {
       terminate = actor_queue_.empty();
 #endif
     }
+    terminate = terminate && LocalActorQueuesEmpty();
     if (!terminate) {
       for (auto &worker : workers_) {
         worker->Active();
@@ -99,6 +161,49 @@ ActorThreadPool::~ActorThreadPool() {
 #ifdef USE_HQUEUE
   actor_queue_.Clean();
 #endif
+  for (auto &queue : local_actor_queues_) {
+    delete queue;
+    queue = nullptr;
+  }
+  local_actor_queues_.clear();
+}
+
+bool ActorThreadPool::LocalActorQueuesEmpty() const {
+  for (const auto &queue : local_actor_queues_) {
+    if (!queue->Empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ActorBase *ActorThreadPool::StealActor(size_t thief_index, uint32_t *seed) const {
+  size_t queue_num = local_actor_queues_.size();
+  if (queue_num <= 1) {
+    return nullptr;
+  }
+  // start from a random victim to spread the thieves over the deques
+  size_t start = NextRandom(seed) % queue_num;
+  for (size_t i = 0; i < queue_num; ++i) {
+    size_t victim = (start + i) % queue_num;
+    if (victim == thief_index) {
+      continue;
+    }
+    auto actor = local_actor_queues_[victim]->Steal();
+    if (actor != nullptr) {
+      return actor;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<ActorWorkerStat> ActorThreadPool::GetActorWorkerStats() const {
+  std::vector<ActorWorkerStat> stats;
+  for (size_t i = 0; i < actor_thread_num_ && i < workers_.size(); ++i) {
+    auto worker = reinterpret_cast<ActorWorker *>(workers_[i]);
+    stats.push_back(worker->GetStat());
+  }
+  return stats;
 }
 
 ActorBase *ActorThreadPool::PopActorFromQueue() {
@@ -119,7 +224,10 @@ void ActorThreadPool::PushActorToQueue(ActorBase *actor) {
   if (!actor) {
     return;
   }
-  {
+  // the actor readied by an actor thread of this pool runs on the same thread first
+  auto curr = current_actor_worker;
+  bool pushed = work_stealing_ && curr != nullptr && curr->pool() == this && curr->PushLocalActor(actor);
+  if (!pushed) {
 #ifdef USE_HQUEUE
     while (!actor_queue_.Enqueue(actor)) {
     }
@@ -155,12 +263,21 @@ int ActorThreadPool::CreateThreads(size_t actor_thread_num, size_t all_thread_nu
     THREAD_ERROR("thread num is invalid");
     return THREAD_ERROR;
   }
+  for (size_t i = 0; i < actor_thread_num_; ++i) {
+    auto queue = new (std::nothrow) WorkStealingDeque<ActorBase>();
+    THREAD_ERROR_IF_NULL(queue);
+    local_actor_queues_.push_back(queue);
+    if (!queue->Init(MAX_LOCAL_READY_ACTOR_NR)) {
+      THREAD_ERROR("init local actor queue failed.");
+      return THREAD_ERROR;
+    }
+  }
   for (size_t i = 0; i < actor_thread_num_; ++i) {
     std::lock_guard<std::mutex> _l(pool_mutex_);
     auto worker = new (std::nothrow) ActorWorker();
     THREAD_ERROR_IF_NULL(worker);
     worker->InitWorkerMask(core_list, workers_.size());
-    worker->CreateThread(this);
+    worker->CreateThread(this, i);
     workers_.push_back(worker);
     THREAD_INFO("create actor thread[%zu]", i);
   }
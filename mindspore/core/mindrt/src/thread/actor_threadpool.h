@@ -26,19 +26,39 @@
 #include "thread/core_affinity.h"
 #include "actor/actor.h"
 #include "thread/hqueue.h"
+#include "thread/work_stealing_deque.h"
 #define USE_HQUEUE
 namespace mindspore {
+// scheduling statistics of one actor thread
+struct ActorWorkerStat {
+  uint64_t steal_num{0};      // actors stolen from the other actor threads
+  uint64_t idle_spin_num{0};  // rounds which found neither kernel task nor actor
+  size_t queue_depth{0};      // actors waiting in the local deque now
+  size_t max_queue_depth{0};  // peak of queue_depth
+};
+
 class ActorThreadPool;
 class ActorWorker : public Worker {
  public:
-  void CreateThread(ActorThreadPool *pool);
+  void CreateThread(ActorThreadPool *pool, size_t index);
   bool ActorActive();
+  // push the actor to the local deque, only called by the thread of this worker
+  bool PushLocalActor(ActorBase *actor);
+  ActorWorkerStat GetStat() const;
+  size_t index() const { return index_; }
+  const ActorThreadPool *pool() const { return pool_; }
 
  private:
   void RunWithSpin();
   bool RunQueueActorTask();
+  ActorBase *PopActor();
 
   ActorThreadPool *pool_{nullptr};
+  size_t index_{0};
+  uint32_t steal_seed_{0};
+  std::atomic<uint64_t> steal_num_{0};
+  std::atomic<uint64_t> idle_spin_num_{0};
+  std::atomic<size_t> max_queue_depth_{0};
 };
 
 class ActorThreadPool : public ThreadPool {
@@ -55,10 +75,22 @@ class ActorThreadPool : public ThreadPool {
   void PushActorToQueue(ActorBase *actor);
   ActorBase *PopActorFromQueue();
 
+  // in work stealing mode, the actors readied by an actor thread are pushed to the local deque of this thread and run
+  // by it first, the idle actor threads steal actors from a random victim when the shared queue is empty.
+  void SetWorkStealing(bool enable) { work_stealing_ = enable; }
+  bool work_stealing() const { return work_stealing_; }
+  WorkStealingDeque<ActorBase> *local_actor_queue(size_t index) const { return local_actor_queues_[index]; }
+  ActorBase *StealActor(size_t thief_index, uint32_t *seed) const;
+  std::vector<ActorWorkerStat> GetActorWorkerStats() const;
+
  private:
   ActorThreadPool() {}
   int CreateThreads(size_t actor_thread_num, size_t all_thread_num, const std::vector<int> &core_list);
+  bool LocalActorQueuesEmpty() const;
   size_t actor_thread_num_{0};
+  std::atomic_bool work_stealing_{false};
+  // owned by the pool rather than the workers, so that a thief never touches a released deque
+  std::vector<WorkStealingDeque<ActorBase> *> local_actor_queues_;
 
   std::mutex actor_mutex_;
   std::condition_variable actor_cond_;
@@ -17,155 +17,160 @@
 #ifndef MINDSPORE_CORE_MINDRT_RUNTIME_HQUEUE_H_
 #define MINDSPORE_CORE_MINDRT_RUNTIME_HQUEUE_H_
 #include <atomic>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 
 namespace mindspore {
-// implement a lock-free queue
-// refer to https://www.cs.rochester.edu/u/scott/papers/1996_PODC_queues.pdf
-template <typename T>
-class HQueue;
-struct Pointer {
-  int32_t index = -1;
-  uint32_t version = 0;
-  bool operator==(const Pointer &that) { return (index == that.index && version == that.version); }
-  bool operator!=(const Pointer &that) { return !(*this == that); }
-};
+constexpr size_t kHQCacheLineSize = 64;
 
+// every slot carries a sequence number which tells producers and consumers whose turn it is:
+//   sequence == pos           the slot is free and can be written by the producer which claims pos
+//   sequence == pos + 1       the slot holds a value and can be read by the consumer which claims pos
+//   sequence == pos + size    the slot has been consumed and is free again for the next round
 template <typename T>
-struct HQNode {
-  std::atomic<Pointer> next;
+struct alignas(kHQCacheLineSize) HQSlot {
+  std::atomic<size_t> sequence = {0};
   T *value = nullptr;
-  std::atomic_bool free = {true};
 };
 
+// implement a bounded lock-free multi-producer multi-consumer queue
+// refer to http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+// both enqueue and dequeue claim a position with a single CAS, so the cost does not depend on the queue occupancy.
 template <typename T>
 class HQueue {
  public:
   HQueue(const HQueue &) = delete;
   HQueue &operator=(const HQueue &) = delete;
   HQueue() {}
-  virtual ~HQueue() {}
+  virtual ~HQueue() { Clean(); }
 
+  // the capacity is rounded up to the power of two, so that position to slot mapping is a bit mask.
   bool Init(int32_t sz) {
-    for (int32_t i = 0; i < sz; i++) {
-      auto node = new HQNode<T>();
-      if (node == nullptr) {
-        Clean();
-        return false;
-      }
-      node->value = nullptr;
-      node->free = true;
-      node->next = {-1, 0};
-      nodes.emplace_back(node);
+    if (sz <= 0 || slots_ != nullptr) {
+      return false;
     }
-
-    // init first node as dummy head
-    qhead = {0, 0};
-    qtail = {0, 0};
-    nodes[0]->free = false;
+    size_t capacity = 1;
+    while (capacity < static_cast<size_t>(sz)) {
+      capacity <<= 1;
+    }
+    slots_ = new (std::nothrow) HQSlot<T>[capacity];
+    if (slots_ == nullptr) {
+      return false;
+    }
+    for (size_t i = 0; i < capacity; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+      slots_[i].value = nullptr;
+    }
+    mask_ = capacity - 1;
+    qhead_.store(0, std::memory_order_relaxed);
+    qtail_.store(0, std::memory_order_relaxed);
     return true;
   }
 
   void Clean() {
-    for (auto node : nodes) {
-      delete node;
-    }
-    nodes.clear();
+    delete[] slots_;
+    slots_ = nullptr;
+    mask_ = 0;
   }
 
+  size_t Capacity() const { return slots_ == nullptr ? 0 : mask_ + 1; }
+
+  // return false if the queue is full
   bool Enqueue(T *t) {
-    HQNode<T> *node = nullptr;
-    int32_t nodeIdx;
-    for (nodeIdx = 0; nodeIdx < static_cast<int32_t>(nodes.size()); nodeIdx++) {
-      bool expected = true;
-      if (nodes[nodeIdx]->free.compare_exchange_strong(expected, false)) {
-        node = nodes[nodeIdx];
-        break;
+    size_t pos = qtail_.load(std::memory_order_relaxed);
+    while (true) {
+      HQSlot<T> *slot = &slots_[pos & mask_];
+      size_t seq = slot->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (qtail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          slot->value = t;
+          slot->sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = qtail_.load(std::memory_order_relaxed);
       }
     }
-    if (node == nullptr) {
-      return false;
-    }
-    node->value = t;
-    node->next = {-1, 0};
+  }
 
+  // return nullptr if the queue is empty
+  T *Dequeue() {
+    size_t pos = qhead_.load(std::memory_order_relaxed);
     while (true) {
-      Pointer tail = qtail;
-      if (tail.index == -1) {
-        continue;
-      }
-      Pointer next = nodes[tail.index]->next;
-
-      if (tail != this->qtail) {
-        continue;
-      }
-
-      if (next.index != -1) {
-        this->qtail.compare_exchange_strong(tail, {next.index, tail.version + 1});
-        continue;
-      }
-
-      if (nodes[tail.index]->next.compare_exchange_strong(next, {nodeIdx, next.version + 1})) {
-        this->qtail.compare_exchange_strong(tail, {nodeIdx, tail.version + 1});
-        break;
+      HQSlot<T> *slot = &slots_[pos & mask_];
+      size_t seq = slot->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (qhead_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          T *ret = slot->value;
+          slot->value = nullptr;
+          slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return ret;
+        }
+      } else if (diff < 0) {
+        return nullptr;
+      } else {
+        pos = qhead_.load(std::memory_order_relaxed);
       }
     }
-
-    return true;
   }
 
-  T *Dequeue() {
+  // take at most max_num values at once, claiming the whole range of ready slots with one CAS.
+  // return the number of values written to out.
+  size_t DequeueBatch(T **out, size_t max_num) {
+    if (out == nullptr || max_num == 0) {
+      return 0;
+    }
+    size_t pos = qhead_.load(std::memory_order_relaxed);
+    size_t num = 0;
     while (true) {
-      T *ret = nullptr;
-      Pointer head = qhead;
-      Pointer tail = qtail;
-      if (head.index == -1) {
-        continue;
+      // count the consecutive ready slots starting from pos
+      num = 0;
+      while (num < max_num) {
+        size_t seq = slots_[(pos + num) & mask_].sequence.load(std::memory_order_acquire);
+        if (seq != pos + num + 1) {
+          break;
+        }
+        num++;
       }
-      Pointer next = nodes[head.index]->next;
-
-      if (head != this->qhead) {
+      if (num == 0) {
+        size_t seq = slots_[pos & mask_].sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+          return 0;
+        }
+        // another consumer took pos, retry from the new head
+        pos = qhead_.load(std::memory_order_relaxed);
         continue;
       }
-
-      if (head.index == tail.index) {
-        if (next.index == -1) {
-          return nullptr;
-        }
-        this->qtail.compare_exchange_strong(tail, {next.index, tail.version + 1});
-      } else {
-        if (next.index == -1) {
-          continue;
-        }
-        ret = nodes[next.index]->value;
-        if (this->qhead.compare_exchange_strong(head, {next.index, head.version + 1})) {
-          // free head
-          nodes[head.index]->free = true;
-          return ret;
-        }
+      if (qhead_.compare_exchange_weak(pos, pos + num, std::memory_order_relaxed)) {
+        break;
       }
     }
+    for (size_t i = 0; i < num; i++) {
+      HQSlot<T> *slot = &slots_[(pos + i) & mask_];
+      out[i] = slot->value;
+      slot->value = nullptr;
+      slot->sequence.store(pos + i + mask_ + 1, std::memory_order_release);
+    }
+    return num;
   }
 
   bool Empty() {
-    Pointer head = qhead;
-    Pointer tail = qtail;
-    if (head.index < 0) {
-      return false;
-    }
-    Pointer next = nodes[head.index]->next;
-
-    if (head == this->qhead && head.index == tail.index && next.index == -1) {
-      return true;
-    }
-
-    return false;
+    size_t pos = qhead_.load(std::memory_order_relaxed);
+    size_t seq = slots_[pos & mask_].sequence.load(std::memory_order_acquire);
+    return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0;
   }
 
  private:
-  std::atomic<Pointer> qhead;
-  std::atomic<Pointer> qtail;
-  std::vector<HQNode<T> *> nodes;
+  // head and tail are modified by different threads, keep them in different cache lines.
+  alignas(kHQCacheLineSize) std::atomic<size_t> qhead_ = {0};
+  alignas(kHQCacheLineSize) std::atomic<size_t> qtail_ = {0};
+  alignas(kHQCacheLineSize) HQSlot<T> *slots_ = nullptr;
+  size_t mask_ = 0;
 };
 }  // namespace mindspore
 
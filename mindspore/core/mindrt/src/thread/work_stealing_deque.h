@@ -0,0 +1,131 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CORE_MINDRT_RUNTIME_WORK_STEALING_DEQUE_H_
+#define MINDSPORE_CORE_MINDRT_RUNTIME_WORK_STEALING_DEQUE_H_
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace mindspore {
+constexpr size_t kWSDequeCacheLineSize = 64;
+
+// implement a bounded Chase-Lev work stealing deque
+// refer to https://fzn.fr/readings/ppopp13.pdf
+// only the owner thread can push and pop at the bottom, any other thread can steal from the top.
+template <typename T>
+class WorkStealingDeque {
+ public:
+  WorkStealingDeque(const WorkStealingDeque &) = delete;
+  WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+  WorkStealingDeque() {}
+  virtual ~WorkStealingDeque() { Clean(); }
+
+  // the capacity is rounded up to the power of two
+  bool Init(int32_t sz) {
+    if (sz <= 0 || buffer_ != nullptr) {
+      return false;
+    }
+    int64_t capacity = 1;
+    while (capacity < sz) {
+      capacity <<= 1;
+    }
+    buffer_ = new (std::nothrow) std::atomic<T *>[capacity];
+    if (buffer_ == nullptr) {
+      return false;
+    }
+    for (int64_t i = 0; i < capacity; i++) {
+      buffer_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    mask_ = capacity - 1;
+    return true;
+  }
+
+  void Clean() {
+    delete[] buffer_;
+    buffer_ = nullptr;
+    mask_ = 0;
+  }
+
+  // owner only, return false if the deque is full
+  bool PushBottom(T *t) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    if (b - top > mask_) {
+      return false;
+    }
+    buffer_[b & mask_].store(t, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // owner only, take the most recently pushed value, return nullptr if the deque is empty
+  T *PopBottom() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    T *ret = nullptr;
+    if (top <= b) {
+      ret = buffer_[b & mask_].load(std::memory_order_relaxed);
+      if (top == b) {
+        // the last one, race against the thieves
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+          ret = nullptr;
+        }
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return ret;
+  }
+
+  // any thread, take the oldest value, return nullptr if the deque is empty or another thief won the race
+  T *Steal() {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (top >= b) {
+      return nullptr;
+    }
+    T *ret = buffer_[top & mask_].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return ret;
+  }
+
+  size_t Size() const {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    return b > top ? static_cast<size_t>(b - top) : 0;
+  }
+
+  bool Empty() const { return Size() == 0; }
+
+ private:
+  // top is modified by the thieves and bottom by the owner, keep them in different cache lines.
+  alignas(kWSDequeCacheLineSize) std::atomic<int64_t> top_ = {0};
+  alignas(kWSDequeCacheLineSize) std::atomic<int64_t> bottom_ = {0};
+  alignas(kWSDequeCacheLineSize) std::atomic<T *> *buffer_ = nullptr;
+  int64_t mask_ = 0;
+};
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CORE_MINDRT_RUNTIME_WORK_STEALING_DEQUE_H_
@@ -80,6 +80,7 @@ struct Context {
   DeviceContextVector device_list_;
 #endif  // NOT_USE_STL
   DelegatePtr delegate = nullptr;
+  bool enable_work_stealing_ = false; /**< actor threads steal ready actors from each other when idle */
 };
 }  // namespace mindspore::lite
 #endif  // MINDSPORE_LITE_INCLUDE_CONTEXT_H_
@@ -23,8 +23,10 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <sys/mman.h>
 #endif
 
+#include <cerrno>
 #include <cstdlib>
 #include "securec/include/securec.h"
 
@@ -192,6 +194,56 @@ char *ReadFile(const char *file, size_t *size) {
   return buf.release();
 }
 
+char *MapFile(const char *file, size_t *size) {
+#ifdef _WIN32
+  return nullptr;
+#else
+  if (file == nullptr) {
+    MS_LOG(ERROR) << "File path is nullptr";
+    return nullptr;
+  }
+  MS_ASSERT(size != nullptr);
+  std::string real_path = RealPath(file);
+  if (real_path.empty()) {
+    MS_LOG(DEBUG) << "File path not regular: " << file;
+    return nullptr;
+  }
+  int fd = open(real_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    MS_LOG(DEBUG) << "Open file " << real_path << " failed, errno: " << errno;
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    MS_LOG(DEBUG) << "Get size of file " << real_path << " failed.";
+    close(fd);
+    return nullptr;
+  }
+  auto file_size = static_cast<size_t>(file_stat.st_size);
+  // writable but private: the pages written by the runtime are copied, the others stay shared between processes
+  auto buf = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  // the mapping keeps its own reference to the file
+  close(fd);
+  if (buf == MAP_FAILED) {
+    MS_LOG(DEBUG) << "Map file " << real_path << " failed, errno: " << errno;
+    return nullptr;
+  }
+  *size = file_size;
+  return static_cast<char *>(buf);
+#endif
+}
+
+void UnmapFile(char *buf, size_t size) {
+#ifndef _WIN32
+  if (buf == nullptr || size == 0) {
+    return;
+  }
+  if (munmap(buf, size) != 0) {
+    MS_LOG(WARNING) << "Unmap model buffer failed, errno: " << errno;
+  }
+#endif
+}
+
 std::string RealPath(const char *path) {
   if (path == nullptr) {
     MS_LOG(ERROR) << "path is nullptr";
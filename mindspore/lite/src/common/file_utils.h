@@ -43,6 +43,12 @@ char *ReadFileSegment(const std::string &file, int64_t offset, int64_t len);
 
 char *ReadFile(const char *file, size_t *size);
 
+// map the whole file privately, pages are shared with the page cache until written (copy-on-write).
+// return nullptr if the platform doesn't support mmap or mapping failed, then the caller should fall back to ReadFile.
+char *MapFile(const char *file, size_t *size);
+
+void UnmapFile(char *buf, size_t size);
+
 std::string RealPath(const char *path);
 
 int CreateOutputDir(std::string *dir);
@@ -0,0 +1,65 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "include/api/model_parallel_runner.h"
+#include "src/cxx_api/model_pool/model_pool.h"
+#include "src/common/log_adapter.h"
+
+namespace mindspore {
+Status ModelParallelRunner::Init(const std::vector<char> &model_path,
+                                 const std::shared_ptr<RunnerConfig> &runner_config) {
+  if (model_pool_ != nullptr) {
+    MS_LOG(ERROR) << "model parallel runner has been initialized.";
+    return kLiteError;
+  }
+  auto model_pool = std::make_shared<ModelPool>();
+  if (model_pool == nullptr) {
+    MS_LOG(ERROR) << "model pool is nullptr.";
+    return kLiteNullptr;
+  }
+  auto status = model_pool->Init(CharToString(model_path), runner_config);
+  if (status != kSuccess) {
+    MS_LOG(ERROR) << "model runner init failed.";
+    return status;
+  }
+  model_pool_ = model_pool;
+  return kSuccess;
+}
+
+std::vector<MSTensor> ModelParallelRunner::GetInputs() {
+  if (model_pool_ == nullptr) {
+    MS_LOG(ERROR) << "model parallel runner is not initialized.";
+    return {};
+  }
+  return model_pool_->GetInputs();
+}
+
+std::vector<MSTensor> ModelParallelRunner::GetOutputs() {
+  if (model_pool_ == nullptr) {
+    MS_LOG(ERROR) << "model parallel runner is not initialized.";
+    return {};
+  }
+  return model_pool_->GetOutputs();
+}
+
+Status ModelParallelRunner::Predict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
+                                   const MSKernelCallBack &before, const MSKernelCallBack &after) {
+  if (model_pool_ == nullptr) {
+    MS_LOG(ERROR) << "model parallel runner is not initialized.";
+    return kLiteUninitializedObj;
+  }
+  return model_pool_->Predict(inputs, outputs, before, after);
+}
+}  // namespace mindspore
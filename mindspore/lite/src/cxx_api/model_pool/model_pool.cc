@@ -0,0 +1,161 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "src/cxx_api/model_pool/model_pool.h"
+#include <algorithm>
+#include "src/common/log_adapter.h"
+
+namespace mindspore {
+namespace {
+constexpr int32_t kDefaultWorkerThreadNum = 2;
+
+// the description of a tensor that does not alias the buffers of any worker.
+std::vector<MSTensor> DescribeTensors(const std::vector<MSTensor> &tensors) {
+  std::vector<MSTensor> res;
+  for (auto &tensor : tensors) {
+    auto desc = MSTensor(tensor.Name(), tensor.DataType(), {}, nullptr, 0);
+    if (desc == nullptr) {
+      MS_LOG(ERROR) << "create description of tensor " << tensor.Name() << " failed.";
+      return {};
+    }
+    // the shape is set afterwards, since it may hold the unknown dims of a dynamic shape model.
+    desc.SetShape(tensor.Shape());
+    desc.SetFormat(tensor.format());
+    res.push_back(desc);
+  }
+  return res;
+}
+}  // namespace
+
+std::vector<std::shared_ptr<Context>> ModelPool::CreateWorkerContexts(
+  const std::shared_ptr<RunnerConfig> &runner_config) {
+  std::shared_ptr<Context> user_context = runner_config == nullptr ? nullptr : runner_config->context;
+  int32_t thread_num = kDefaultWorkerThreadNum;
+  if (user_context != nullptr && user_context->GetThreadNum() > 0) {
+    thread_num = user_context->GetThreadNum();
+  }
+  int32_t core_num = static_cast<int32_t>(std::thread::hardware_concurrency());
+  if (core_num <= 0) {
+    core_num = thread_num;
+  }
+  int32_t workers_num = runner_config == nullptr ? 0 : runner_config->workers_num;
+  if (workers_num <= 0) {
+    workers_num = std::max(core_num / thread_num, 1);
+  }
+  // unless the user binds the cores, every worker gets its own group of adjacent cores, so that the threads of one
+  // worker share the caches and do not migrate into the cores of the other workers.
+  bool bind_core_group = user_context == nullptr || user_context->GetThreadAffinityCoreList().empty();
+  bind_core_group = bind_core_group && workers_num * thread_num <= core_num;
+  std::vector<std::shared_ptr<Context>> contexts;
+  for (int32_t i = 0; i < workers_num; i++) {
+    auto context = std::make_shared<Context>();
+    if (context == nullptr) {
+      MS_LOG(ERROR) << "create context of worker " << i << " failed.";
+      return {};
+    }
+    context->SetThreadNum(thread_num);
+    if (user_context != nullptr) {
+      context->SetEnableParallel(user_context->GetEnableParallel());
+      context->SetDelegate(user_context->GetDelegate());
+      context->SetThreadAffinity(user_context->GetThreadAffinityMode());
+      context->SetThreadAffinity(user_context->GetThreadAffinityCoreList());
+      context->MutableDeviceInfo() = user_context->MutableDeviceInfo();
+    } else {
+      context->MutableDeviceInfo().push_back(std::make_shared<CPUDeviceInfo>());
+    }
+    if (bind_core_group) {
+      std::vector<int> core_list;
+      for (int32_t j = 0; j < thread_num; j++) {
+        core_list.push_back(i * thread_num + j);
+      }
+      context->SetThreadAffinity(core_list);
+    }
+    contexts.push_back(context);
+  }
+  return contexts;
+}
+
+Status ModelPool::Init(const std::string &model_path, const std::shared_ptr<RunnerConfig> &runner_config) {
+  if (!model_workers_.empty()) {
+    MS_LOG(ERROR) << "model pool has been initialized.";
+    return kLiteError;
+  }
+  if (runner_config != nullptr && runner_config->context != nullptr &&
+      runner_config->context->MutableDeviceInfo().empty()) {
+    MS_LOG(ERROR) << "the device info of context is empty.";
+    return kLiteParamInvalid;
+  }
+  size_t max_batch_size = 1;
+  if (runner_config != nullptr && runner_config->max_batch_size > 1) {
+    max_batch_size = static_cast<size_t>(runner_config->max_batch_size);
+  }
+  auto contexts = CreateWorkerContexts(runner_config);
+  if (contexts.empty()) {
+    MS_LOG(ERROR) << "create worker contexts failed.";
+    return kLiteError;
+  }
+  // all the workers map the same model file, so the weights are loaded into the page cache only once.
+  for (size_t i = 0; i < contexts.size(); i++) {
+    auto model_worker = std::make_shared<ModelWorker>();
+    if (model_worker == nullptr) {
+      MS_LOG(ERROR) << "create model worker failed.";
+      return kLiteNullptr;
+    }
+    auto status = model_worker->Init(model_path, contexts[i], max_batch_size);
+    if (status != kSuccess) {
+      MS_LOG(ERROR) << "init model worker " << i << " failed.";
+      return status;
+    }
+    model_workers_.push_back(model_worker);
+  }
+  model_inputs_ = DescribeTensors(model_workers_.front()->GetInputs());
+  model_outputs_ = DescribeTensors(model_workers_.front()->GetOutputs());
+  for (auto &model_worker : model_workers_) {
+    worker_threads_.push_back(std::thread(&ModelWorker::Run, model_worker.get(), &predict_task_queue_));
+  }
+  MS_LOG(INFO) << "model pool runs " << model_workers_.size() << " workers with "
+               << contexts.front()->GetThreadNum() << " threads each.";
+  return kSuccess;
+}
+
+std::vector<MSTensor> ModelPool::GetInputs() { return model_inputs_; }
+
+std::vector<MSTensor> ModelPool::GetOutputs() { return model_outputs_; }
+
+Status ModelPool::Predict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
+                          const MSKernelCallBack &before, const MSKernelCallBack &after) {
+  if (outputs == nullptr) {
+    MS_LOG(ERROR) << "outputs is nullptr.";
+    return kLiteNullptr;
+  }
+  if (worker_threads_.empty()) {
+    MS_LOG(ERROR) << "model pool is not initialized.";
+    return kLiteUninitializedObj;
+  }
+  PredictTask task(&inputs, outputs, before, after);
+  predict_task_queue_.PushPredictTask(&task);
+  predict_task_queue_.WaitUntilPredictActive(&task);
+  return task.status;
+}
+
+ModelPool::~ModelPool() {
+  predict_task_queue_.SetPredictTaskDone();
+  for (auto &th : worker_threads_) {
+    if (th.joinable()) {
+      th.join();
+    }
+  }
+}
+}  // namespace mindspore
@@ -0,0 +1,54 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_LITE_SRC_CXX_API_MODEL_POOL_MODEL_POOL_H_
+#define MINDSPORE_LITE_SRC_CXX_API_MODEL_POOL_MODEL_POOL_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include "include/api/status.h"
+#include "include/api/context.h"
+#include "include/api/model_parallel_runner.h"
+#include "src/cxx_api/model_pool/model_worker.h"
+#include "src/cxx_api/model_pool/predict_task_queue.h"
+
+namespace mindspore {
+class ModelPool {
+ public:
+  ModelPool() = default;
+  ~ModelPool();
+
+  Status Init(const std::string &model_path, const std::shared_ptr<RunnerConfig> &runner_config = nullptr);
+
+  std::vector<MSTensor> GetInputs();
+
+  std::vector<MSTensor> GetOutputs();
+
+  Status Predict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
+                 const MSKernelCallBack &before = nullptr, const MSKernelCallBack &after = nullptr);
+
+ private:
+  std::vector<std::shared_ptr<Context>> CreateWorkerContexts(const std::shared_ptr<RunnerConfig> &runner_config);
+
+  std::vector<std::thread> worker_threads_;
+  std::vector<std::shared_ptr<ModelWorker>> model_workers_;
+  PredictTaskQueue predict_task_queue_;
+  std::vector<MSTensor> model_inputs_;
+  std::vector<MSTensor> model_outputs_;
+};
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_SRC_CXX_API_MODEL_POOL_MODEL_POOL_H_
@@ -0,0 +1,209 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "src/cxx_api/model_pool/model_worker.h"
+#include <cstring>
+#include "src/common/log_adapter.h"
+
+namespace mindspore {
+namespace {
+// the lite tensor takes over the buffer it is created with, so the data is copied into a buffer it mallocs itself.
+MSTensor CreateTensorWithData(const std::string &name, DataType type, const std::vector<int64_t> &shape,
+                              const void *data, size_t data_len) {
+  auto tensor = MSTensor(name, type, shape, nullptr, 0);
+  if (tensor == nullptr) {
+    return MSTensor(nullptr);
+  }
+  if (data_len == 0) {
+    return tensor;
+  }
+  auto dst = tensor.MutableData();
+  if (dst == nullptr || tensor.DataSize() != data_len) {
+    MS_LOG(ERROR) << "malloc data of tensor " << name << " failed.";
+    return MSTensor(nullptr);
+  }
+  if (data != nullptr) {
+    memcpy(dst, data, data_len);
+  }
+  return tensor;
+}
+
+// the tensors returned by the model are reused by the next inference, so the caller gets its own copy.
+Status CopyOutputs(const std::vector<MSTensor> &model_outputs, std::vector<MSTensor> *outputs) {
+  outputs->clear();
+  for (auto &model_output : model_outputs) {
+    auto output = CreateTensorWithData(model_output.Name(), model_output.DataType(), model_output.Shape(),
+                                       model_output.Data().get(), model_output.DataSize());
+    if (output == nullptr) {
+      MS_LOG(ERROR) << "copy output " << model_output.Name() << " failed.";
+      outputs->clear();
+      return kLiteNullptr;
+    }
+    outputs->push_back(output);
+  }
+  return kSuccess;
+}
+}  // namespace
+
+Status ModelWorker::Init(const std::string &model_path, const std::shared_ptr<Context> &model_context,
+                         size_t max_batch_size) {
+  model_ = std::make_shared<Model>();
+  if (model_ == nullptr) {
+    MS_LOG(ERROR) << "model is nullptr.";
+    return kLiteNullptr;
+  }
+  auto status = model_->Build(model_path, ModelType::kMindIR, model_context);
+  if (status != kSuccess) {
+    MS_LOG(ERROR) << "model build failed in ModelPool Init";
+    return status;
+  }
+  max_batch_size_ = max_batch_size == 0 ? 1 : max_batch_size;
+  return kSuccess;
+}
+
+std::vector<MSTensor> ModelWorker::GetInputs() { return model_->GetInputs(); }
+
+std::vector<MSTensor> ModelWorker::GetOutputs() { return model_->GetOutputs(); }
+
+Status ModelWorker::ResizeIfNeeded(const std::vector<MSTensor> &inputs) {
+  auto model_inputs = model_->GetInputs();
+  if (model_inputs.size() != inputs.size()) {
+    MS_LOG(ERROR) << "input size " << inputs.size() << " is not equal to model input size " << model_inputs.size();
+    return kLiteInputTensorError;
+  }
+  bool need_resize = false;
+  std::vector<std::vector<int64_t>> dims;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    auto shape = inputs[i].Shape();
+    if (shape != model_inputs[i].Shape()) {
+      need_resize = true;
+    }
+    dims.push_back(shape);
+  }
+  if (!need_resize) {
+    return kSuccess;
+  }
+  auto status = model_->Resize(model_inputs, dims);
+  if (status != kSuccess) {
+    MS_LOG(ERROR) << "model resize failed.";
+  }
+  return status;
+}
+
+Status ModelWorker::Predict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
+                            const MSKernelCallBack &before, const MSKernelCallBack &after) {
+  auto status = ResizeIfNeeded(inputs);
+  if (status != kSuccess) {
+    return status;
+  }
+  std::vector<MSTensor> model_outputs;
+  status = model_->Predict(inputs, &model_outputs, before, after);
+  if (status != kSuccess) {
+    MS_LOG(ERROR) << "model predict failed.";
+    return status;
+  }
+  return CopyOutputs(model_outputs, outputs);
+}
+
+Status ModelWorker::BatchPredict(const std::vector<PredictTask *> &tasks) {
+  auto &first_inputs = *(tasks.front()->inputs);
+  std::vector<int64_t> batch_sizes;
+  int64_t total_batch = 0;
+  for (auto task : tasks) {
+    auto batch = GetInputsBatchSize(*task->inputs);
+    if (batch <= 0 || !PredictTaskQueue::CanBatch(tasks.front(), task)) {
+      MS_LOG(ERROR) << "the inputs of the requests can not be merged into batch.";
+      return kLiteInputTensorError;
+    }
+    batch_sizes.push_back(batch);
+    total_batch += batch;
+  }
+  std::vector<MSTensor> batch_inputs;
+  for (size_t i = 0; i < first_inputs.size(); i++) {
+    auto shape = first_inputs[i].Shape();
+    shape[0] = total_batch;
+    auto batch_input = MSTensor(first_inputs[i].Name(), first_inputs[i].DataType(), shape, nullptr, 0);
+    auto dst = batch_input == nullptr ? nullptr : static_cast<uint8_t *>(batch_input.MutableData());
+    if (dst == nullptr) {
+      MS_LOG(ERROR) << "malloc batch input " << first_inputs[i].Name() << " failed.";
+      return kLiteNullptr;
+    }
+    size_t offset = 0;
+    for (auto task : tasks) {
+      auto &input = task->inputs->at(i);
+      if (input.Data() == nullptr || offset + input.DataSize() > batch_input.DataSize()) {
+        MS_LOG(ERROR) << "input " << input.Name() << " can not be merged into batch.";
+        return kLiteInputTensorError;
+      }
+      memcpy(dst + offset, input.Data().get(), input.DataSize());
+      offset += input.DataSize();
+    }
+    batch_inputs.push_back(batch_input);
+  }
+  std::vector<MSTensor> batch_outputs;
+  auto status = Predict(batch_inputs, &batch_outputs);
+  if (status != kSuccess) {
+    return status;
+  }
+  for (auto &output : batch_outputs) {
+    auto shape = output.Shape();
+    if (shape.empty() || shape.front() != total_batch) {
+      MS_LOG(ERROR) << "the first dim of output " << output.Name() << " is not the batch, can not split it.";
+      return kLiteNotSupport;
+    }
+  }
+  std::vector<size_t> offsets(batch_outputs.size(), 0);
+  for (size_t t = 0; t < tasks.size(); t++) {
+    auto *outputs = tasks[t]->outputs;
+    outputs->clear();
+    for (size_t i = 0; i < batch_outputs.size(); i++) {
+      auto &batch_output = batch_outputs[i];
+      auto shape = batch_output.Shape();
+      auto split_size =
+        batch_output.DataSize() / static_cast<size_t>(total_batch) * static_cast<size_t>(batch_sizes[t]);
+      shape[0] = batch_sizes[t];
+      auto src = static_cast<const uint8_t *>(batch_output.Data().get()) + offsets[i];
+      auto output = CreateTensorWithData(batch_output.Name(), batch_output.DataType(), shape, src, split_size);
+      if (output == nullptr) {
+        MS_LOG(ERROR) << "split output " << batch_output.Name() << " failed.";
+        return kLiteNullptr;
+      }
+      offsets[i] += split_size;
+      outputs->push_back(output);
+    }
+  }
+  return kSuccess;
+}
+
+void ModelWorker::Run(PredictTaskQueue *task_queue) {
+  std::vector<PredictTask *> tasks;
+  while (task_queue->PopPredictTasks(&tasks, max_batch_size_) > 0) {
+    if (tasks.size() > 1) {
+      auto status = BatchPredict(tasks);
+      if (status == kSuccess) {
+        for (auto task : tasks) {
+          task_queue->ActiveTask(task, kSuccess);
+        }
+        continue;
+      }
+      MS_LOG(WARNING) << "batch predict failed, predict the " << tasks.size() << " requests one by one.";
+    }
+    for (auto task : tasks) {
+      auto status = Predict(*task->inputs, task->outputs, task->before, task->after);
+      task_queue->ActiveTask(task, status);
+    }
+  }
+}
+}  // namespace mindspore
@@ -0,0 +1,51 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_LITE_SRC_CXX_API_MODEL_POOL_MODEL_WORKER_H_
+#define MINDSPORE_LITE_SRC_CXX_API_MODEL_POOL_MODEL_WORKER_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "include/api/model.h"
+#include "include/api/context.h"
+#include "src/cxx_api/model_pool/predict_task_queue.h"
+
+namespace mindspore {
+class ModelWorker {
+ public:
+  ModelWorker() = default;
+  ~ModelWorker() = default;
+
+  Status Init(const std::string &model_path, const std::shared_ptr<Context> &model_context, size_t max_batch_size);
+
+  std::vector<MSTensor> GetInputs();
+
+  std::vector<MSTensor> GetOutputs();
+
+  // serve the tasks of the queue until it is stopped.
+  void Run(PredictTaskQueue *task_queue);
+
+ private:
+  Status Predict(const std::vector<MSTensor> &inputs, std::vector<MSTensor> *outputs,
+                 const MSKernelCallBack &before = nullptr, const MSKernelCallBack &after = nullptr);
+  Status BatchPredict(const std::vector<PredictTask *> &tasks);
+  Status ResizeIfNeeded(const std::vector<MSTensor> &inputs);
+
+  std::shared_ptr<Model> model_ = nullptr;
+  size_t max_batch_size_ = 1;
+};
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_SRC_CXX_API_MODEL_POOL_MODEL_WORKER_H_
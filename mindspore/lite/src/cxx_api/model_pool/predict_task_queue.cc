@@ -0,0 +1,134 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "src/cxx_api/model_pool/predict_task_queue.h"
+#include "src/common/log_adapter.h"
+
+namespace mindspore {
+int64_t GetInputsBatchSize(const std::vector<MSTensor> &inputs) {
+  if (inputs.empty()) {
+    return -1;
+  }
+  int64_t batch = -1;
+  for (auto &input : inputs) {
+    auto shape = input.Shape();
+    if (shape.empty() || shape.front() <= 0) {
+      return -1;
+    }
+    if (batch != -1 && shape.front() != batch) {
+      return -1;
+    }
+    batch = shape.front();
+  }
+  return batch;
+}
+
+PredictTaskQueue::~PredictTaskQueue() { SetPredictTaskDone(); }
+
+void PredictTaskQueue::PushPredictTask(PredictTask *task) {
+  {
+    std::unique_lock<std::mutex> task_lock(mtx_predict_task_);
+    predict_task_.push_back(task);
+  }
+  task_push_cond_.notify_one();
+}
+
+bool PredictTaskQueue::CanBatch(const PredictTask *first, const PredictTask *task) {
+  // the callbacks observe the tensors of one request, so such requests always run alone.
+  if (first->before != nullptr || first->after != nullptr || task->before != nullptr || task->after != nullptr) {
+    return false;
+  }
+  if (first->inputs->size() != task->inputs->size()) {
+    return false;
+  }
+  // the batch is cut along the first dim, so it has to be the same for all the inputs of a request.
+  if (GetInputsBatchSize(*first->inputs) <= 0 || GetInputsBatchSize(*task->inputs) <= 0) {
+    return false;
+  }
+  for (size_t i = 0; i < first->inputs->size(); i++) {
+    auto &first_input = first->inputs->at(i);
+    auto &input = task->inputs->at(i);
+    if (first_input.DataType() != input.DataType() || first_input.DataType() == DataType::kObjectTypeString) {
+      return false;
+    }
+    auto first_shape = first_input.Shape();
+    auto shape = input.Shape();
+    if (first_shape.size() != shape.size()) {
+      return false;
+    }
+    for (size_t j = 1; j < shape.size(); j++) {
+      if (first_shape[j] != shape[j]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+size_t PredictTaskQueue::PopPredictTasks(std::vector<PredictTask *> *tasks, size_t max_num) {
+  MS_ASSERT(tasks != nullptr);
+  tasks->clear();
+  std::unique_lock<std::mutex> task_lock(mtx_predict_task_);
+  task_push_cond_.wait(task_lock, [this] { return !predict_task_.empty() || predict_task_done_; });
+  if (predict_task_done_) {
+    return 0;
+  }
+  auto first = predict_task_.front();
+  predict_task_.pop_front();
+  tasks->push_back(first);
+  for (auto iter = predict_task_.begin(); iter != predict_task_.end() && tasks->size() < max_num;) {
+    if (CanBatch(first, *iter)) {
+      tasks->push_back(*iter);
+      iter = predict_task_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  return tasks->size();
+}
+
+void PredictTaskQueue::WaitUntilPredictActive(PredictTask *task) {
+  std::unique_lock<std::mutex> result_lock(mtx_predict_task_);
+  (void)waiting_tasks_.insert(task);
+  task->ready_cond.wait(result_lock, [task, this] { return task->ready || predict_task_done_; });
+  (void)waiting_tasks_.erase(task);
+  if (!task->ready) {
+    task->status = kLiteError;
+  }
+}
+
+void PredictTaskQueue::ActiveTask(PredictTask *task, const Status &status) {
+  std::unique_lock<std::mutex> result_lock(mtx_predict_task_);
+  task->status = status;
+  task->ready = true;
+  // notify under the lock, the caller may destroy the task as soon as it sees it ready.
+  task->ready_cond.notify_one();
+}
+
+void PredictTaskQueue::SetPredictTaskDone() {
+  std::unique_lock<std::mutex> task_lock(mtx_predict_task_);
+  predict_task_done_ = true;
+  // every worker and every waiting caller has to leave.
+  task_push_cond_.notify_all();
+  for (auto task : waiting_tasks_) {
+    task->ready_cond.notify_one();
+  }
+}
+
+bool PredictTaskQueue::IsPredictTaskDone() {
+  std::unique_lock<std::mutex> task_lock(mtx_predict_task_);
+  return predict_task_done_;
+}
+}  // namespace mindspore
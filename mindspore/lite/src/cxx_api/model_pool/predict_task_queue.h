@@ -0,0 +1,69 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_LITE_SRC_CXX_API_MODEL_POOL_PREDICT_TASK_QUEUE_H_
+#define MINDSPORE_LITE_SRC_CXX_API_MODEL_POOL_PREDICT_TASK_QUEUE_H_
+
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+#include <condition_variable>
+#include "include/api/types.h"
+#include "include/api/status.h"
+
+namespace mindspore {
+struct PredictTask {
+  PredictTask(const std::vector<MSTensor> *in, std::vector<MSTensor> *out, const MSKernelCallBack &before,
+              const MSKernelCallBack &after)
+      : inputs(in), outputs(out), before(before), after(after) {}
+  const std::vector<MSTensor> *inputs;
+  std::vector<MSTensor> *outputs;
+  MSKernelCallBack before;
+  MSKernelCallBack after;
+  Status status = kSuccess;
+  bool ready = false;
+  // only the caller of the task waits on it, so activating the task wakes that caller alone.
+  std::condition_variable ready_cond;
+};
+
+// return the first dim shared by all the inputs, or -1 if some input is a scalar or the first dims differ.
+int64_t GetInputsBatchSize(const std::vector<MSTensor> &inputs);
+
+class PredictTaskQueue {
+ public:
+  PredictTaskQueue() = default;
+  ~PredictTaskQueue();
+
+  void PushPredictTask(PredictTask *task);
+  // block until a task is queued, then pop it together with at most max_num - 1 queued tasks that can be merged into
+  // one batch with it. Return 0 once the queue is stopped.
+  size_t PopPredictTasks(std::vector<PredictTask *> *tasks, size_t max_num);
+  void WaitUntilPredictActive(PredictTask *task);
+  void ActiveTask(PredictTask *task, const Status &status);
+  void SetPredictTaskDone();
+  bool IsPredictTaskDone();
+  static bool CanBatch(const PredictTask *first, const PredictTask *task);
+
+ private:
+  std::deque<PredictTask *> predict_task_;
+  std::mutex mtx_predict_task_;
+  std::condition_variable task_push_cond_;
+  // the tasks whose callers are waiting, woken when the queue is stopped.
+  std::unordered_set<PredictTask *> waiting_tasks_;
+  bool predict_task_done_ = false;
+};
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_SRC_CXX_API_MODEL_POOL_PREDICT_TASK_QUEUE_H_
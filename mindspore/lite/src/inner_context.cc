@@ -51,6 +51,7 @@ InnerContext::InnerContext(const Context *context) {
     this->allocator = context->allocator;
     this->thread_num_ = context->thread_num_;
     this->enable_parallel_ = context->enable_parallel_;
+    this->enable_work_stealing_ = context->enable_work_stealing_;
     this->affinity_core_list_ = context->affinity_core_list_;
     SetContextDevice(context);
     this->delegate = context->delegate;
@@ -130,6 +131,7 @@ int InnerContext::Init() {
         ActorThreadPool::CreateThreadPool(actor_parallel_thread, this->thread_num_, this->affinity_core_list_);
       MS_CHECK_TRUE_MSG(thread_pool_ != nullptr, RET_NULL_PTR, "Create Allocator failed");
     }
+    static_cast<ActorThreadPool *>(thread_pool_)->SetWorkStealing(this->enable_work_stealing_);
 #else
     thread_pool_ = ThreadPool::CreateThreadPool(thread_num_ - 1);
     thread_pool_->SetCpuAffinity(static_cast<mindspore::BindMode>(bind_mode));
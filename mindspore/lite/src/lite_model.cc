@@ -106,7 +106,12 @@ int LiteModel::ConvertAttrToTensors() {
 
 void LiteModel::Free() {
   if (this->buf != nullptr) {
-    delete[](this->buf);
+    if (this->buf_mapped_) {
+      UnmapFile(this->buf, this->buf_size_);
+      this->buf_mapped_ = false;
+    } else {
+      delete[](this->buf);
+    }
     this->buf = nullptr;
   }
   auto nodes_size = this->all_nodes_.size();
@@ -527,11 +532,49 @@ SchemaTensorWrapper *LiteModel::GetSchemaTensor(const size_t &tensor_index) cons
   return this->inner_all_tensors_.at(tensor_index);
 }
 
+LiteModel *LiteImportFromMappedFile(const char *model_path) {
+  if (model_path == nullptr) {
+    MS_LOG(ERROR) << "The model path is nullptr";
+    return nullptr;
+  }
+  size_t size = 0;
+  auto buf = MapFile(model_path, &size);
+  if (buf == nullptr) {
+    return nullptr;
+  }
+  flatbuffers::Verifier verify(reinterpret_cast<const uint8_t *>(buf), size);
+  if (LiteModel::VersionVerify(&verify) == SCHEMA_INVALID) {
+    MS_LOG(DEBUG) << "The mapped file is not a mslite model: " << model_path;
+    UnmapFile(buf, size);
+    return nullptr;
+  }
+  auto *model = new (std::nothrow) LiteModel(model_path);
+  if (model == nullptr) {
+    MS_LOG(ERROR) << "new model fail!";
+    UnmapFile(buf, size);
+    return nullptr;
+  }
+  // const tensors refer to the mapping directly, only those cast or copied by the runtime leave the page cache.
+  auto status = model->ConstructModel(buf, size, true);
+  if (status != RET_OK) {
+    MS_LOG(ERROR) << "construct model failed.";
+    UnmapFile(buf, size);
+    delete model;
+    return nullptr;
+  }
+  model->set_buf_mapped(true);
+  return model;
+}
+
 LiteModel *LiteImportFromPath(const char *model_path) {
   if (model_path == nullptr) {
     MS_LOG(ERROR) << "The model path is nullptr";
     return nullptr;
   }
+  auto *mapped_model = LiteImportFromMappedFile(model_path);
+  if (mapped_model != nullptr) {
+    return mapped_model;
+  }
   size_t size = 0;
   auto buf = ReadFile(model_path, &size);
   if (buf == nullptr) {
@@ -55,6 +55,11 @@ class LiteModel : public Model {
 
   bool keep_model_buf() const { return this->keep_model_buf_; }
 
+  // the model buffer is a private file mapping, which is released by munmap instead of delete[]
+  bool buf_mapped() const { return this->buf_mapped_; }
+
+  void set_buf_mapped(bool mapped) { this->buf_mapped_ = mapped; }
+
   void set_keep_model_buf(bool keep) { this->keep_model_buf_ = keep; }
 
   int GetSchemaVersion() const { return schema_version_; }
@@ -319,6 +324,7 @@ class LiteModel : public Model {
  protected:
   std::vector<char *> attr_tensor_bufs_;
   bool keep_model_buf_ = false;
+  bool buf_mapped_ = false;
   int schema_version_ = SCHEMA_VERSION::SCHEMA_CUR;
   // tensor_index --- external_data
   std::vector<SchemaTensorWrapper *> inner_all_tensors_;
@@ -327,6 +333,8 @@ class LiteModel : public Model {
 
 Model *ImportFromBuffer(const char *model_buf, size_t size, bool take_buf);
 LiteModel *LiteImportFromPath(const char *model_path);
+// return nullptr if the file can't be mapped or isn't a mslite model, the caller should fall back to reading the file.
+LiteModel *LiteImportFromMappedFile(const char *model_path);
 Model *ImportFromPath(const char *model_path);
 }  // namespace lite
 }  // namespace mindspore
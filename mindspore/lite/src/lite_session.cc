@@ -1724,16 +1724,27 @@ int lite::LiteSession::LoadModelAndCompileByBuf(const char *model_buf, mindspore
 }
 
 int lite::LiteSession::LoadModelAndCompileByPath(const std::string &model_path, mindspore::ModelType model_type) {
-  size_t model_size;
-  auto model_buf = LoadModelByPath(model_path, model_type, &model_size);
-  if (model_buf == nullptr) {
-    MS_LOG(ERROR) << "Read model file failed";
-    return RET_ERROR;
+  lite::Model *model = nullptr;
+  if (model_type == mindspore::ModelType::kMindIR || model_type == mindspore::ModelType::kMindIR_Opt) {
+    // map a mslite model instead of reading it, so that processes loading the same model share the weights
+    model = lite::LiteImportFromMappedFile(model_path.c_str());
+    if (model == nullptr) {
+      // a MindIR model has to be converted at runtime, the result lives in memory whatever the source is
+      MS_LOG(INFO) << "Model " << model_path << " is not a mappable mslite model, read it into memory instead.";
+    }
   }
-  auto *model = lite::ImportFromBuffer(model_buf, model_size, true);
   if (model == nullptr) {
-    MS_LOG(ERROR) << "Import model failed";
-    return RET_ERROR;
+    size_t model_size;
+    auto model_buf = LoadModelByPath(model_path, model_type, &model_size);
+    if (model_buf == nullptr) {
+      MS_LOG(ERROR) << "Read model file failed";
+      return RET_ERROR;
+    }
+    model = lite::ImportFromBuffer(model_buf, model_size, true);
+    if (model == nullptr) {
+      MS_LOG(ERROR) << "Import model failed";
+      return RET_ERROR;
+    }
   }
 
   (reinterpret_cast<lite::LiteModel *>(model))->set_keep_model_buf(true);
@@ -1748,16 +1759,27 @@ int lite::LiteSession::LoadModelAndCompileByPath(const std::string &model_path,
 
 int lite::LiteSession::LoadModelAndCompileByPath(const std::string &model_path, mindspore::ModelType model_type,
                                                  const std::shared_ptr<mindspore::Context> &ms_context) {
-  size_t model_size;
-  auto model_buf = LoadModelByPath(model_path, model_type, &model_size, ms_context);
-  if (model_buf == nullptr) {
-    MS_LOG(ERROR) << "Read model file failed";
-    return RET_ERROR;
+  lite::Model *model = nullptr;
+  if (model_type == mindspore::ModelType::kMindIR || model_type == mindspore::ModelType::kMindIR_Opt) {
+    // map a mslite model instead of reading it, so that processes loading the same model share the weights
+    model = lite::LiteImportFromMappedFile(model_path.c_str());
+    if (model == nullptr) {
+      // a MindIR model has to be converted at runtime, the result lives in memory whatever the source is
+      MS_LOG(INFO) << "Model " << model_path << " is not a mappable mslite model, read it into memory instead.";
+    }
   }
-  auto *model = lite::ImportFromBuffer(model_buf, model_size, true);
   if (model == nullptr) {
-    MS_LOG(ERROR) << "Import model failed";
-    return RET_ERROR;
+    size_t model_size;
+    auto model_buf = LoadModelByPath(model_path, model_type, &model_size, ms_context);
+    if (model_buf == nullptr) {
+      MS_LOG(ERROR) << "Read model file failed";
+      return RET_ERROR;
+    }
+    model = lite::ImportFromBuffer(model_buf, model_size, true);
+    if (model == nullptr) {
+      MS_LOG(ERROR) << "Import model failed";
+      return RET_ERROR;
+    }
   }
 
   (reinterpret_cast<lite::LiteModel *>(model))->set_keep_model_buf(true);
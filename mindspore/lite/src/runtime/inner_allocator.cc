@@ -15,6 +15,7 @@
  */
 
 #include "src/runtime/inner_allocator.h"
+#include <new>
 #include <utility>
 #include "src/common/log_adapter.h"
 #include "src/common/utils.h"
@@ -22,7 +23,15 @@
 namespace mindspore {
 std::shared_ptr<Allocator> Allocator::Create() { return std::make_shared<DefaultAllocator>(); }
 
-DefaultAllocator::DefaultAllocator(size_t aligned_size) { aligned_size_ = aligned_size; }
+DefaultAllocator::DefaultAllocator(size_t aligned_size) {
+  aligned_size_ = aligned_size;
+  slab_header_size_ = (sizeof(SlabBuf) + aligned_size_ - 1) & (~(aligned_size_ - 1));
+  for (auto &slab_class : slab_classes_) {
+    if (!slab_class.free_bufs.Init(kSlabFreeQueueSize)) {
+      MS_LOG(WARNING) << "Init slab free queue failed, small buffers fall back to the overflow list.";
+    }
+  }
+}
 
 DefaultAllocator::~DefaultAllocator() { Clear(); }
 
@@ -57,6 +66,12 @@ void *DefaultAllocator::Malloc(size_t size) {
     MS_LOG(ERROR) << "Memory pool is exhausted";
     return nullptr;
   }
+  if (size <= kSlabMaxSize) {
+    auto buf = SlabMalloc(size);
+    if (buf != nullptr) {
+      return buf;
+    }
+  }
   Lock();
   auto iter = freeList_.lower_bound(size);
   if (iter != freeList_.end() && ReuseMemory(iter->second->size, size)) {
@@ -89,6 +104,11 @@ void DefaultAllocator::Free(void *buf) {
   if (buf == nullptr) {
     return;
   }
+  auto slab_buf = FindSlabBuf(buf);
+  if (slab_buf != nullptr) {
+    SlabFree(slab_buf);
+    return;
+  }
   Lock();
   auto iter = allocatedList_.find(buf);
   if (iter != allocatedList_.end()) {
@@ -107,6 +127,10 @@ int DefaultAllocator::RefCount(void *buf) {
   if (buf == nullptr) {
     return -1;
   }
+  auto slab_buf = FindSlabBuf(buf);
+  if (slab_buf != nullptr) {
+    return std::atomic_load(&slab_buf->ref_count_);
+  }
   Lock();
   auto iter = allocatedList_.find(buf);
   if (iter != allocatedList_.end()) {
@@ -122,6 +146,11 @@ int DefaultAllocator::SetRefCount(void *buf, int ref_count) {
   if (buf == nullptr) {
     return -1;
   }
+  auto slab_buf = FindSlabBuf(buf);
+  if (slab_buf != nullptr) {
+    std::atomic_store(&slab_buf->ref_count_, ref_count);
+    return ref_count;
+  }
   Lock();
   auto iter = allocatedList_.find(buf);
   if (iter != allocatedList_.end()) {
@@ -137,6 +166,10 @@ int DefaultAllocator::IncRefCount(void *buf, int ref_count) {
   if (buf == nullptr) {
     return -1;
   }
+  auto slab_buf = FindSlabBuf(buf);
+  if (slab_buf != nullptr) {
+    return std::atomic_fetch_add(&slab_buf->ref_count_, ref_count) + ref_count;
+  }
   Lock();
   auto iter = allocatedList_.find(buf);
   if (iter != allocatedList_.end()) {
@@ -152,6 +185,10 @@ int DefaultAllocator::DecRefCount(void *buf, int ref_count) {
   if (buf == nullptr) {
     return -1;
   }
+  auto slab_buf = FindSlabBuf(buf);
+  if (slab_buf != nullptr) {
+    return std::atomic_fetch_sub(&slab_buf->ref_count_, ref_count) - ref_count;
+  }
   Lock();
   auto iter = allocatedList_.find(buf);
   if (iter != allocatedList_.end()) {
@@ -164,6 +201,7 @@ int DefaultAllocator::DecRefCount(void *buf, int ref_count) {
   return -1;
 }
 void DefaultAllocator::Clear() {
+  ClearSlab();
   Lock();
 
   for (auto &it : allocatedList_) {
@@ -177,4 +215,144 @@ void DefaultAllocator::Clear() {
   freeList_.clear();
   UnLock();
 }
+
+size_t DefaultAllocator::SlabBufSize(size_t size_class) const {
+  return slab_header_size_ + (static_cast<size_t>(1) << (kSlabMinShift + size_class));
+}
+
+void *DefaultAllocator::SlabMalloc(size_t size) {
+  size_t size_class = 0;
+  while ((static_cast<size_t>(1) << (kSlabMinShift + size_class)) < size) {
+    size_class++;
+  }
+  auto slab_buf = slab_classes_[size_class].free_bufs.Dequeue();
+  if (slab_buf == nullptr) {
+    slab_buf = RefillSlabBuf(size_class);
+    if (slab_buf == nullptr) {
+      return nullptr;
+    }
+  }
+  slab_buf->ref_count_ = 0;
+  return reinterpret_cast<char *>(slab_buf) + slab_header_size_;
+}
+
+void DefaultAllocator::SlabFree(SlabBuf *slab_buf) {
+  slab_buf->ref_count_ = 0;
+  auto &slab_class = slab_classes_[slab_buf->size_class];
+  if (slab_class.free_bufs.Enqueue(slab_buf)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(slab_class.lock);
+  slab_class.overflow_bufs.push_back(slab_buf);
+}
+
+DefaultAllocator::SlabBuf *DefaultAllocator::RefillSlabBuf(size_t size_class) {
+  auto &slab_class = slab_classes_[size_class];
+  std::lock_guard<std::mutex> lock(slab_class.lock);
+  if (!slab_class.overflow_bufs.empty()) {
+    auto slab_buf = slab_class.overflow_bufs.back();
+    slab_class.overflow_bufs.pop_back();
+    return slab_buf;
+  }
+  size_t buf_size = SlabBufSize(size_class);
+  if (slab_class.cursor == nullptr || slab_class.cursor + buf_size > slab_class.end) {
+    if (!AddSlabChunk(size_class)) {
+      return nullptr;
+    }
+  }
+  // the header lives until ClearSlab releases the chunk, the buffer is recycled through the free lists until then
+  auto slab_buf = new (slab_class.cursor) SlabBuf();
+  slab_class.cursor += buf_size;
+  slab_buf->size_class = size_class;
+  this->total_size_ += buf_size;
+  return slab_buf;
+}
+
+bool DefaultAllocator::AddSlabChunk(size_t size_class) {
+  std::lock_guard<std::mutex> lock(slab_chunk_lock_);
+  auto chunk = malloc(kSlabChunkSize + aligned_size_);
+  if (chunk == nullptr) {
+    MS_LOG(ERROR) << "malloc slab chunk return nullptr";
+    return false;
+  }
+  auto begin = (reinterpret_cast<uintptr_t>(chunk) + aligned_size_ - 1) & (~(aligned_size_ - 1));
+  // a chunk covers two windows at most, register it to the probe sequence of each of them
+  uintptr_t windows[] = {begin >> kSlabChunkShift, (begin + kSlabChunkSize - 1) >> kSlabChunkShift};
+  size_t slots[] = {kSlabChunkTableSize, kSlabChunkTableSize};
+  for (size_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++) {
+    for (size_t probe = 0; probe < kSlabChunkTableSize; probe++) {
+      size_t slot = (windows[i] + probe) % kSlabChunkTableSize;
+      if (slab_chunk_table_[slot].load(std::memory_order_relaxed) == 0 && slot != slots[0]) {
+        slots[i] = slot;
+        break;
+      }
+    }
+    if (slots[i] == kSlabChunkTableSize) {
+      MS_LOG(WARNING) << "Slab chunk table is full, malloc from the free list instead.";
+      free(chunk);
+      return false;
+    }
+  }
+  for (auto slot : slots) {
+    slab_chunk_table_[slot].store(begin, std::memory_order_release);
+  }
+  slab_chunks_.push_back({chunk, reinterpret_cast<char *>(begin), size_class});
+  auto &slab_class = slab_classes_[size_class];
+  slab_class.cursor = reinterpret_cast<char *>(begin);
+  slab_class.end = slab_class.cursor + kSlabChunkSize;
+  return true;
+}
+
+DefaultAllocator::SlabBuf *DefaultAllocator::FindSlabBuf(void *buf) const {
+  auto addr = reinterpret_cast<uintptr_t>(buf);
+  uintptr_t window = addr >> kSlabChunkShift;
+  for (size_t probe = 0; probe < kSlabChunkTableSize; probe++) {
+    auto begin = slab_chunk_table_[(window + probe) % kSlabChunkTableSize].load(std::memory_order_acquire);
+    if (begin == 0) {
+      return nullptr;
+    }
+    if (addr >= begin + slab_header_size_ && addr < begin + kSlabChunkSize) {
+      return reinterpret_cast<SlabBuf *>(addr - slab_header_size_);
+    }
+  }
+  return nullptr;
+}
+
+void DefaultAllocator::ClearSlab() {
+  // take the locks in the same order as RefillSlabBuf
+  for (size_t size_class = 0; size_class < kSlabClassNum; size_class++) {
+    auto &slab_class = slab_classes_[size_class];
+    std::lock_guard<std::mutex> class_lock(slab_class.lock);
+    while (slab_class.free_bufs.Dequeue() != nullptr) {
+    }
+    slab_class.overflow_bufs.clear();
+    // end the lifetime of the headers carved from the chunks of this class, the last chunk is carved up to the cursor
+    size_t buf_size = SlabBufSize(size_class);
+    {
+      std::lock_guard<std::mutex> lock(slab_chunk_lock_);
+      for (auto &chunk : slab_chunks_) {
+        if (chunk.size_class != size_class) {
+          continue;
+        }
+        char *carved_end = chunk.begin + kSlabChunkSize / buf_size * buf_size;
+        if (slab_class.end == chunk.begin + kSlabChunkSize) {
+          carved_end = slab_class.cursor;
+        }
+        for (char *addr = chunk.begin; addr + buf_size <= carved_end; addr += buf_size) {
+          reinterpret_cast<SlabBuf *>(addr)->~SlabBuf();
+        }
+      }
+    }
+    slab_class.cursor = nullptr;
+    slab_class.end = nullptr;
+  }
+  std::lock_guard<std::mutex> lock(slab_chunk_lock_);
+  for (auto &slot : slab_chunk_table_) {
+    slot.store(0, std::memory_order_relaxed);
+  }
+  for (auto &chunk : slab_chunks_) {
+    free(chunk.mem);
+  }
+  slab_chunks_.clear();
+}
 }  // namespace mindspore
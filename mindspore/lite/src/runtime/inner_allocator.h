@@ -26,6 +26,7 @@
 #include <unordered_set>
 #include <atomic>
 #include "include/api/allocator.h"
+#include "thread/hqueue.h"
 
 namespace mindspore {
 struct AllocatorContext {
@@ -57,8 +58,50 @@ class DefaultAllocator : public Allocator {
     void *buf = nullptr;
   };
 
+  // buffers no larger than kSlabMaxSize are carved from slab chunks by power-of-two size classes. the header lies just
+  // before the buffer, so that malloc, free and ref count of them never take the lock_.
+  static constexpr size_t kSlabMinShift = 6;
+  static constexpr size_t kSlabClassNum = 13;
+  static constexpr size_t kSlabMaxSize = static_cast<size_t>(1) << (kSlabMinShift + kSlabClassNum - 1);
+  static constexpr size_t kSlabChunkShift = 22;
+  static constexpr size_t kSlabChunkSize = static_cast<size_t>(1) << kSlabChunkShift;
+  static constexpr size_t kSlabChunkTableSize = 4096;
+  static constexpr int32_t kSlabFreeQueueSize = 4096;
+  struct SlabBuf {
+    std::atomic_int ref_count_ = {0};
+    size_t size_class = 0;
+  };
+  struct SlabClass {
+    // lock-free free list shared by all threads
+    HQueue<SlabBuf> free_bufs;
+    // refill and overflow path, taken only when free_bufs is empty or full
+    std::mutex lock;
+    std::vector<SlabBuf *> overflow_bufs;
+    char *cursor = nullptr;
+    char *end = nullptr;
+  };
+  void *SlabMalloc(size_t size);
+  void SlabFree(SlabBuf *slab_buf);
+  SlabBuf *RefillSlabBuf(size_t size_class);
+  bool AddSlabChunk(size_t size_class);
+  SlabBuf *FindSlabBuf(void *buf) const;
+  void ClearSlab();
+  size_t SlabBufSize(size_t size_class) const;
+
+  SlabClass slab_classes_[kSlabClassNum];
+  // open addressing table of slab chunks, indexed by every kSlabChunkSize window which a chunk covers
+  std::atomic<uintptr_t> slab_chunk_table_[kSlabChunkTableSize] = {};
+  std::mutex slab_chunk_lock_;
+  struct SlabChunk {
+    void *mem = nullptr;
+    char *begin = nullptr;
+    size_t size_class = 0;
+  };
+  std::vector<SlabChunk> slab_chunks_;
+  size_t slab_header_size_ = 0;
+
   std::mutex lock_;
-  size_t total_size_ = 0;
+  std::atomic<size_t> total_size_ = {0};
   // <membuf->buf, membuf>
   std::unordered_map<void *, MemBuf *> allocatedList_;
   std::multimap<size_t, MemBuf *> freeList_;
@@ -15,6 +15,11 @@
  */
 
 #include "src/runtime/runtime_allocator.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include "src/common/log_adapter.h"
 
 namespace mindspore {
 RuntimeAllocator::RuntimeAllocator(size_t aligned_size) {
@@ -31,11 +36,62 @@ RuntimeAllocator::~RuntimeAllocator() {
 
 void *RuntimeAllocator::MallocOptData() {
   if (data_ == nullptr) {
+    PlanOffsets();
     data_ = malloc(total_size_);
   }
   return data_;
 }
 
+void RuntimeAllocator::PlanOffsets() {
+  if (blocks_.empty()) {
+    return;
+  }
+  std::vector<size_t> order(blocks_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [this](size_t a, size_t b) { return blocks_[a].size > blocks_[b].size; });
+
+  std::vector<size_t> planned_offset(blocks_.size(), 0);
+  std::vector<size_t> placed;
+  size_t planned_size = 0;
+  for (auto index : order) {
+    const auto &block = blocks_[index];
+    /* the placed blocks alive at the same time, by offset */
+    std::vector<std::pair<size_t, size_t>> busy; /* offset, end */
+    for (auto other : placed) {
+      const auto &other_block = blocks_[other];
+      if (block.malloc_time < other_block.free_time && other_block.malloc_time < block.free_time) {
+        busy.emplace_back(planned_offset[other], planned_offset[other] + other_block.size);
+      }
+    }
+    std::sort(busy.begin(), busy.end());
+    size_t offset = 0;
+    for (const auto &range : busy) {
+      if (range.first >= offset + block.size) {
+        break;
+      }
+      offset = std::max(offset, range.second);
+    }
+    planned_offset[index] = offset;
+    planned_size = std::max(planned_size, offset + block.size);
+    placed.push_back(index);
+  }
+
+  MS_LOG(INFO) << "Runtime allocator: " << blocks_.size() << " blocks of " << tensors_size_
+               << " bytes, peak of planned offsets " << planned_size << " bytes, peak of first fit " << total_size_
+               << " bytes.";
+  if (planned_size >= total_size_) {
+    return;
+  }
+  for (auto &iter : offset_map_) {
+    auto block = tensor_block_.find(iter.first);
+    if (block != tensor_block_.end()) {
+      iter.second = planned_offset[block->second];
+    }
+  }
+  total_size_ = planned_size;
+}
+
 size_t RuntimeAllocator::FindMinFree(size_t size) {
   size_t min_size = total_size_ + 1;
   size_t min_addr = total_size_ + 1;
@@ -52,6 +108,11 @@ void RuntimeAllocator::FreeTensorData(lite::Tensor *tensor) {
   size_t offset = offset_map_[tensor];
   free_list_[offset] = used_list_[offset];
   used_list_.erase(offset);
+  auto block = used_block_.find(offset);
+  if (block != used_block_.end()) {
+    blocks_[block->second].free_time = time_++;
+    used_block_.erase(block);
+  }
 
   size_t length = free_list_[offset];
 
@@ -76,6 +137,10 @@ void RuntimeAllocator::FreeTensorData(lite::Tensor *tensor) {
 
 void RuntimeAllocator::SetDataOffset(lite::Tensor *tensor, size_t offset) {
   offset_map_[tensor] = offset;
+  auto block = used_block_.find(offset);
+  if (block != used_block_.end()) {
+    tensor_block_[tensor] = block->second;
+  }
   return;
 }
 
@@ -92,6 +157,11 @@ void RuntimeAllocator::Clear(AllocatorPtr default_allocator) {
   offset_map_.clear();
   free_list_.clear();
   used_list_.clear();
+  used_block_.clear();
+  tensor_block_.clear();
+  blocks_.clear();
+  tensors_size_ = 0;
+  time_ = 0;
 }
 
 void RuntimeAllocator::MallocTensorData(lite::Tensor *tensor) {
@@ -119,5 +189,9 @@ void RuntimeAllocator::MallocTensorData(lite::Tensor *tensor) {
 
   used_list_[offset] = size;
   offset_map_[tensor] = offset;
+  used_block_[offset] = blocks_.size();
+  tensor_block_[tensor] = blocks_.size();
+  blocks_.push_back({size, time_++, SIZE_MAX});
+  tensors_size_ += size;
 }
 }  // namespace mindspore
@@ -20,6 +20,7 @@
 #include <memory>
 #include <map>
 #include <unordered_map>
+#include <vector>
 #include "include/api/allocator.h"
 #include "include/errorcode.h"
 #include "src/tensor.h"
@@ -45,16 +46,34 @@ class RuntimeAllocator : public Allocator {
   void *MallocOptData();
   const std::unordered_map<lite::Tensor *, size_t> &GetOffsetMap() const { return offset_map_; }
   void Clear(AllocatorPtr default_allocator);
+  /* size of the data after planning, and the size the tensors would take without sharing any memory */
+  size_t total_size() const { return total_size_; }
+  size_t tensors_size() const { return tensors_size_; }
 
  private:
+  /* A piece of data, which is shared by the tensors set to the same offset while it is in use. */
+  struct Block {
+    size_t size;
+    size_t malloc_time;
+    size_t free_time;
+  };
+
   size_t FindMinFree(size_t size);
+  /* Place the blocks again knowing all their lifetimes, biggest first, each at the lowest offset clear of the blocks
+   * placed that are alive at the same time. The plan is kept if it takes less memory than the one made on the fly. */
+  void PlanOffsets();
 
  private:
   void *data_ = nullptr;
   size_t total_size_ = 0;
+  size_t tensors_size_ = 0;
+  size_t time_ = 0; /* counts the mallocs and frees, which give the lifetimes of the blocks */
   std::unordered_map<lite::Tensor *, size_t> offset_map_;
   std::map<size_t, size_t> free_list_; /* offset, size */
   std::map<size_t, size_t> used_list_; /* offset, size */
+  std::map<size_t, size_t> used_block_; /* offset, block */
+  std::unordered_map<lite::Tensor *, size_t> tensor_block_;
+  std::vector<Block> blocks_;
 };
 
 using RuntimeAllocatorPtr = std::shared_ptr<RuntimeAllocator>;
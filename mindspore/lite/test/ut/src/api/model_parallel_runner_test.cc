@@ -0,0 +1,224 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include "schema/inner/model_generated.h"
+#include "common/common_test.h"
+#include "include/api/model_parallel_runner.h"
+#include "src/cxx_api/model_pool/model_worker.h"
+#include "src/cxx_api/model_pool/predict_task_queue.h"
+
+namespace mindspore {
+namespace {
+constexpr int64_t kChannel = 4;
+const char kAddModelPath[] = "./model_pool_add_model.ms";
+
+// out = x + y, both inputs are [batch, kChannel]
+void WriteAddModel(const std::string &path) {
+  auto meta_graph = std::make_shared<schema::MetaGraphT>();
+  meta_graph->name = "graph";
+  auto node = std::make_unique<schema::CNodeT>();
+  node->inputIndex = {0, 1};
+  node->outputIndex = {2};
+  node->primitive = std::make_unique<schema::PrimitiveT>();
+  node->primitive->value.type = schema::PrimitiveType_AddFusion;
+  node->primitive->value.value = new schema::AddFusionT;
+  node->name = "Add";
+  meta_graph->nodes.emplace_back(std::move(node));
+  meta_graph->inputIndex = {0, 1};
+  meta_graph->outputIndex = {2};
+  for (int i = 0; i < 3; i++) {
+    auto tensor = std::make_unique<schema::TensorT>();
+    tensor->nodeType = lite::NodeType_Parameter;
+    tensor->format = schema::Format_NHWC;
+    tensor->dataType = TypeId::kNumberTypeFloat32;
+    if (i < 2) {
+      tensor->dims = {1, kChannel};
+    }
+    tensor->offset = -1;
+    meta_graph->allTensors.emplace_back(std::move(tensor));
+  }
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto offset = schema::MetaGraph::Pack(builder, meta_graph.get());
+  builder.Finish(offset);
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  ofs.write(reinterpret_cast<const char *>(builder.GetBufferPointer()), builder.GetSize());
+}
+
+MSTensor CreateInput(const std::string &name, const std::vector<int64_t> &shape, float start) {
+  auto tensor = MSTensor(name, DataType::kNumberTypeFloat32, shape, nullptr, 0);
+  auto data = static_cast<float *>(tensor.MutableData());
+  for (int64_t i = 0; i < tensor.ElementNum(); i++) {
+    data[i] = start + i;
+  }
+  return tensor;
+}
+
+std::vector<MSTensor> CreateAddInputs(int64_t batch, float start) {
+  return {CreateInput("x", {batch, kChannel}, start), CreateInput("y", {batch, kChannel}, 2 * start)};
+}
+
+void CheckAddOutputs(const std::vector<MSTensor> &outputs, int64_t batch, float start) {
+  ASSERT_EQ(outputs.size(), 1);
+  std::vector<int64_t> expect_shape = {batch, kChannel};
+  ASSERT_EQ(outputs[0].Shape(), expect_shape);
+  auto data = static_cast<const float *>(outputs[0].Data().get());
+  ASSERT_NE(data, nullptr);
+  for (int64_t i = 0; i < batch * kChannel; i++) {
+    ASSERT_LE(std::fabs(data[i] - (3 * start + 2 * i)), 0.001);
+  }
+}
+
+std::shared_ptr<Context> CreateWorkerContext() {
+  auto context = std::make_shared<Context>();
+  context->SetThreadNum(1);
+  context->MutableDeviceInfo().push_back(std::make_shared<CPUDeviceInfo>());
+  return context;
+}
+}  // namespace
+
+class ModelParallelRunnerTest : public mindspore::CommonTest {
+ public:
+  ModelParallelRunnerTest() {}
+  void SetUp() override { WriteAddModel(kAddModelPath); }
+  void TearDown() override { (void)std::remove(kAddModelPath); }
+};
+
+/// Feature: PredictTaskQueue
+/// Description: pop the queued requests whose inputs only differ in the first dim
+/// Expectation: the compatible requests are merged up to the max num, the others stay queued
+TEST_F(ModelParallelRunnerTest, PopBatchTasks) {
+  auto inputs0 = CreateAddInputs(1, 0);
+  auto inputs1 = CreateAddInputs(2, 0);
+  std::vector<MSTensor> other_shape = {CreateInput("x", {1, kChannel + 1}, 0), CreateInput("y", {1, kChannel + 1}, 0)};
+  auto inputs3 = CreateAddInputs(3, 0);
+  std::vector<MSTensor> outputs[4];
+  PredictTask task0(&inputs0, &outputs[0], nullptr, nullptr);
+  PredictTask task1(&inputs1, &outputs[1], nullptr, nullptr);
+  PredictTask task2(&other_shape, &outputs[2], nullptr, nullptr);
+  PredictTask task3(&inputs3, &outputs[3], nullptr, nullptr);
+  PredictTaskQueue queue;
+  queue.PushPredictTask(&task0);
+  queue.PushPredictTask(&task2);
+  queue.PushPredictTask(&task1);
+  queue.PushPredictTask(&task3);
+
+  std::vector<PredictTask *> tasks;
+  ASSERT_EQ(queue.PopPredictTasks(&tasks, 2), 2);
+  ASSERT_EQ(tasks[0], &task0);
+  ASSERT_EQ(tasks[1], &task1);
+  ASSERT_EQ(queue.PopPredictTasks(&tasks, 4), 1);
+  ASSERT_EQ(tasks[0], &task2);
+  ASSERT_EQ(queue.PopPredictTasks(&tasks, 4), 1);
+  ASSERT_EQ(tasks[0], &task3);
+  queue.SetPredictTaskDone();
+  ASSERT_EQ(queue.PopPredictTasks(&tasks, 4), 0);
+}
+
+/// Feature: PredictTaskQueue
+/// Description: check the requests that can not be merged into one batch
+/// Expectation: inputs with different dims except the first one, different first dims inside one request, different
+/// data types and callbacks are refused
+TEST_F(ModelParallelRunnerTest, RefuseIncompatibleTasks) {
+  auto inputs = CreateAddInputs(2, 0);
+  std::vector<MSTensor> outputs;
+  PredictTask task(&inputs, &outputs, nullptr, nullptr);
+  auto same_layout = CreateAddInputs(5, 1);
+  PredictTask same_layout_task(&same_layout, &outputs, nullptr, nullptr);
+  ASSERT_TRUE(PredictTaskQueue::CanBatch(&task, &same_layout_task));
+
+  std::vector<MSTensor> second_input_differs = {CreateInput("x", {2, kChannel}, 0), CreateInput("y", {2, 1}, 0)};
+  PredictTask second_input_task(&second_input_differs, &outputs, nullptr, nullptr);
+  ASSERT_FALSE(PredictTaskQueue::CanBatch(&task, &second_input_task));
+
+  std::vector<MSTensor> batch_differs = {CreateInput("x", {2, kChannel}, 0), CreateInput("y", {3, kChannel}, 0)};
+  PredictTask batch_task(&batch_differs, &outputs, nullptr, nullptr);
+  ASSERT_EQ(GetInputsBatchSize(batch_differs), -1);
+  ASSERT_FALSE(PredictTaskQueue::CanBatch(&task, &batch_task));
+  ASSERT_FALSE(PredictTaskQueue::CanBatch(&batch_task, &task));
+
+  std::vector<MSTensor> type_differs = {CreateInput("x", {2, kChannel}, 0),
+                                        MSTensor("y", DataType::kNumberTypeInt32, {2, kChannel}, nullptr, 0)};
+  PredictTask type_task(&type_differs, &outputs, nullptr, nullptr);
+  ASSERT_FALSE(PredictTaskQueue::CanBatch(&task, &type_task));
+
+  MSKernelCallBack callback = [](const std::vector<MSTensor> &, const std::vector<MSTensor> &,
+                                 const MSCallBackParam &) { return true; };
+  PredictTask callback_task(&same_layout, &outputs, callback, nullptr);
+  ASSERT_FALSE(PredictTaskQueue::CanBatch(&task, &callback_task));
+}
+
+/// Feature: ModelWorker
+/// Description: merge the queued requests into one inference and split the outputs back
+/// Expectation: every request gets the outputs of its own inputs with its own first dim
+TEST_F(ModelParallelRunnerTest, SplitBatchOutputs) {
+  ModelWorker worker;
+  ASSERT_TRUE(worker.Init(kAddModelPath, CreateWorkerContext(), 4) == kSuccess);
+  const std::vector<int64_t> batches = {1, 3, 2};
+  std::vector<std::vector<MSTensor>> inputs;
+  std::vector<std::vector<MSTensor>> outputs(batches.size());
+  for (size_t i = 0; i < batches.size(); i++) {
+    inputs.push_back(CreateAddInputs(batches[i], 10.0f * i));
+  }
+  std::vector<std::shared_ptr<PredictTask>> tasks;
+  PredictTaskQueue queue;
+  for (size_t i = 0; i < batches.size(); i++) {
+    tasks.push_back(std::make_shared<PredictTask>(&inputs[i], &outputs[i], nullptr, nullptr));
+    queue.PushPredictTask(tasks.back().get());
+  }
+  // all the requests are queued before the worker starts, so they are served as one batch
+  std::thread worker_thread([&worker, &queue]() { worker.Run(&queue); });
+  for (size_t i = 0; i < batches.size(); i++) {
+    queue.WaitUntilPredictActive(tasks[i].get());
+    ASSERT_TRUE(tasks[i]->status == kSuccess);
+    CheckAddOutputs(outputs[i], batches[i], 10.0f * i);
+  }
+  queue.SetPredictTaskDone();
+  worker_thread.join();
+}
+
+/// Feature: ModelParallelRunner
+/// Description: predict from several threads with dynamic batching enabled
+/// Expectation: every caller gets the outputs of its own inputs
+TEST_F(ModelParallelRunnerTest, PredictFromThreads) {
+  auto runner_config = std::make_shared<RunnerConfig>();
+  runner_config->context = CreateWorkerContext();
+  runner_config->workers_num = 2;
+  runner_config->max_batch_size = 4;
+  ModelParallelRunner runner;
+  ASSERT_TRUE(runner.Init(kAddModelPath, runner_config) == kSuccess);
+  const int thread_num = 8;
+  std::vector<Status> status(thread_num, kLiteError);
+  std::vector<std::vector<MSTensor>> outputs(thread_num);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; i++) {
+    threads.emplace_back([i, &runner, &status, &outputs]() {
+      auto inputs = CreateAddInputs(i % 3 + 1, 1.0f * i);
+      status[i] = runner.Predict(inputs, &outputs[i]);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < thread_num; i++) {
+    ASSERT_TRUE(status[i] == kSuccess);
+    CheckAddOutputs(outputs[i], i % 3 + 1, 1.0f * i);
+  }
+}
+}  // namespace mindspore
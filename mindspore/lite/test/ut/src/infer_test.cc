@@ -15,6 +15,9 @@
  */
 
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <memory>
 #include "schema/inner/model_generated.h"
 #include "mindspore/lite/include/model.h"
@@ -24,6 +27,7 @@
 #include "include/errorcode.h"
 #include "src/common/log_adapter.h"
 #include "src/lite_session.h"
+#include "src/lite_model.h"
 #include "src/common/file_utils.h"
 
 namespace mindspore {
@@ -251,4 +255,115 @@ TEST_F(InferTest, TestModel) {
   MS_LOG(INFO) << "Passed";
 }
 
+TEST_F(InferTest, TestMappedModel) {
+  auto meta_graph = std::make_shared<schema::MetaGraphT>();
+  meta_graph->name = "graph";
+
+  auto node = std::make_unique<schema::CNodeT>();
+  node->inputIndex = {0, 1};
+  node->outputIndex = {2};
+  node->primitive = std::make_unique<schema::PrimitiveT>();
+  node->primitive->value.type = schema::PrimitiveType_AddFusion;
+  auto primitive = new schema::AddFusionT;
+  node->primitive->value.value = primitive;
+  node->name = "Add";
+  meta_graph->nodes.emplace_back(std::move(node));
+  meta_graph->inputIndex = {0};
+  meta_graph->outputIndex = {2};
+
+  auto input0 = std::make_unique<schema::TensorT>();
+  input0->nodeType = lite::NodeType_Parameter;
+  input0->format = schema::Format_NHWC;
+  input0->dataType = TypeId::kNumberTypeFloat32;
+  input0->dims = {1, 2, 2, 3};
+  input0->offset = -1;
+  meta_graph->allTensors.emplace_back(std::move(input0));
+
+  const int element_num = 12;
+  float weight_data[element_num];
+  for (int i = 0; i < element_num; i++) {
+    weight_data[i] = 0.5f * i;
+  }
+  auto weight = std::make_unique<schema::TensorT>();
+  weight->nodeType = lite::NodeType_ValueNode;
+  weight->format = schema::Format_NHWC;
+  weight->dataType = TypeId::kNumberTypeFloat32;
+  weight->dims = {1, 2, 2, 3};
+  weight->data.resize(sizeof(weight_data));
+  memcpy(weight->data.data(), weight_data, sizeof(weight_data));
+  weight->offset = -1;
+  meta_graph->allTensors.emplace_back(std::move(weight));
+
+  auto output = std::make_unique<schema::TensorT>();
+  output->nodeType = lite::NodeType_Parameter;
+  output->format = schema::Format_NHWC;
+  output->dataType = TypeId::kNumberTypeFloat32;
+  output->offset = -1;
+  meta_graph->allTensors.emplace_back(std::move(output));
+
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto offset = schema::MetaGraph::Pack(builder, meta_graph.get());
+  builder.Finish(offset);
+  const std::string model_path = "./mapped_add_model.ms";
+  std::ofstream ofs(model_path, std::ios::binary | std::ios::trunc);
+  ASSERT_TRUE(ofs.good());
+  ofs.write(reinterpret_cast<const char *>(builder.GetBufferPointer()), builder.GetSize());
+  ofs.close();
+
+  auto model = lite::LiteImportFromMappedFile(model_path.c_str());
+  ASSERT_NE(nullptr, model);
+  ASSERT_TRUE(model->buf_mapped());
+  auto context = new lite::InnerContext;
+  context->device_list_[0].device_info_.cpu_device_info_.cpu_bind_mode_ = lite::NO_BIND;
+  context->thread_num_ = 2;
+  ASSERT_EQ(lite::RET_OK, context->Init());
+  auto session = session::LiteSession::CreateSession(context);
+  ASSERT_NE(nullptr, session);
+  auto ret = session->CompileGraph(model);
+  ASSERT_EQ(lite::RET_OK, ret);
+  auto inputs = session->GetInputs();
+  ASSERT_EQ(inputs.size(), 1);
+  auto in_data = reinterpret_cast<float *>(inputs.front()->MutableData());
+  ASSERT_NE(nullptr, in_data);
+  for (int i = 0; i < element_num; i++) {
+    in_data[i] = 1.0f + i;
+  }
+  ret = session->RunGraph();
+  ASSERT_EQ(lite::RET_OK, ret);
+  auto outputs = session->GetOutputs();
+  ASSERT_EQ(outputs.size(), 1);
+  auto out_tensor = outputs.begin()->second;
+  ASSERT_EQ(element_num, out_tensor->ElementsNum());
+  auto out_data = reinterpret_cast<float *>(out_tensor->MutableData());
+  ASSERT_NE(nullptr, out_data);
+  for (int i = 0; i < element_num; i++) {
+    ASSERT_LE(std::fabs(out_data[i] - (1.0f + i + 0.5f * i)), 0.001);
+  }
+  delete session;
+  delete model;
+
+  // loading by path treats the file as kMindIR_Opt, which maps it as well
+  lite::Context path_context;
+  path_context.device_list_[0].device_info_.cpu_device_info_.cpu_bind_mode_ = lite::NO_BIND;
+  path_context.thread_num_ = 2;
+  auto path_session = lite::LiteSession::CreateSession(model_path, &path_context);
+  ASSERT_NE(nullptr, path_session);
+  auto path_inputs = path_session->GetInputs();
+  ASSERT_EQ(path_inputs.size(), 1);
+  in_data = reinterpret_cast<float *>(path_inputs.front()->MutableData());
+  ASSERT_NE(nullptr, in_data);
+  for (int i = 0; i < element_num; i++) {
+    in_data[i] = 2.0f;
+  }
+  ASSERT_EQ(lite::RET_OK, path_session->RunGraph());
+  out_data = reinterpret_cast<float *>(path_session->GetOutputs().begin()->second->MutableData());
+  ASSERT_NE(nullptr, out_data);
+  for (int i = 0; i < element_num; i++) {
+    ASSERT_LE(std::fabs(out_data[i] - (2.0f + 0.5f * i)), 0.001);
+  }
+  delete path_session;
+  (void)std::remove(model_path.c_str());
+  MS_LOG(INFO) << "Passed";
+}
+
 }  // namespace mindspore
@@ -20,6 +20,7 @@
 #include "async/future.h"
 #include "src/lite_mindrt.h"
 #include "thread/hqueue.h"
+#include "thread/work_stealing_deque.h"
 #include "thread/actor_threadpool.h"
 #include "common/common_test.h"
 #include "schema/model_generated.h"
@@ -31,71 +32,112 @@ class LiteMindRtTest : public mindspore::CommonTest {
   LiteMindRtTest() {}
 };
 
-// TEST_F(LiteMindRtTest, HQueueTest) {
-//  HQueue<int *> hq;
-//  hq.Init();
-//  std::vector<int *> v1(2000);
-//  int d1 = 1;
-//  for (size_t s = 0; s < v1.size(); s++) {
-//    v1[s] = new int(d1);
-//  }
-//  std::vector<int *> v2(2000);
-//  int d2 = 2;
-//  for (size_t s = 0; s < v2.size(); s++) {
-//    v2[s] = new int(d2);
-//  }
-//
-//  std::thread t1([&]() {
-//    for (size_t s = 0; s < v1.size(); s++) {
-//      hq.Enqueue(v1[s]);
-//    }
-//  });
-//  std::thread t2([&]() {
-//    for (size_t s = 0; s < v2.size(); s++) {
-//      hq.Enqueue(v2[s]);
-//    }
-//  });
-//
-//  int c1 = 0;
-//  int c2 = 0;
-//
-//  std::thread t3([&]() {
-//    size_t loop = v1.size() + v2.size();
-//    while (loop) {
-//      int *val = nullptr;
-//      hq.Dequeue(&val);
-//      if (val == nullptr) {
-//        continue;
-//      }
-//      loop--;
-//      if (*val == d1) {
-//        c1++;
-//      } else if (*val == d2) {
-//        c2++;
-//      } else {
-//        // should never come here
-//        ASSERT_EQ(0, 1);
-//      }
-//    }
-//  });
-//
-//  t1.join();
-//  t2.join();
-//  t3.join();
-//
-//  ASSERT_EQ(c1, v1.size());
-//  ASSERT_EQ(c2, v2.size());
-//  int *tmp = nullptr;
-//  ASSERT_EQ(hq.Dequeue(&tmp), false);
-//
-//  for (size_t s = 0; s < v1.size(); s++) {
-//    delete v1[s];
-//  }
-//
-//  for (size_t s = 0; s < v2.size(); s++) {
-//    delete v2[s];
-//  }
-//}
+TEST_F(LiteMindRtTest, HQueueTest) {
+  HQueue<int> hq;
+  ASSERT_EQ(hq.Init(1000), true);
+  ASSERT_EQ(hq.Capacity(), static_cast<size_t>(1024));
+  std::vector<int *> v1(2000);
+  int d1 = 1;
+  for (size_t s = 0; s < v1.size(); s++) {
+    v1[s] = new int(d1);
+  }
+  std::vector<int *> v2(2000);
+  int d2 = 2;
+  for (size_t s = 0; s < v2.size(); s++) {
+    v2[s] = new int(d2);
+  }
+
+  std::thread t1([&]() {
+    for (size_t s = 0; s < v1.size(); s++) {
+      while (!hq.Enqueue(v1[s])) {
+      }
+    }
+  });
+  std::thread t2([&]() {
+    for (size_t s = 0; s < v2.size(); s++) {
+      while (!hq.Enqueue(v2[s])) {
+      }
+    }
+  });
+
+  size_t c1 = 0;
+  size_t c2 = 0;
+
+  std::thread t3([&]() {
+    size_t loop = v1.size() + v2.size();
+    int *vals[16];
+    while (loop) {
+      size_t num = hq.DequeueBatch(vals, 16);
+      for (size_t i = 0; i < num; i++) {
+        loop--;
+        if (*vals[i] == d1) {
+          c1++;
+        } else if (*vals[i] == d2) {
+          c2++;
+        } else {
+          // should never come here
+          ASSERT_EQ(0, 1);
+        }
+      }
+    }
+  });
+
+  t1.join();
+  t2.join();
+  t3.join();
+
+  ASSERT_EQ(c1, v1.size());
+  ASSERT_EQ(c2, v2.size());
+  ASSERT_EQ(hq.Empty(), true);
+  ASSERT_EQ(hq.Dequeue(), nullptr);
+
+  for (size_t s = 0; s < v1.size(); s++) {
+    delete v1[s];
+  }
+
+  for (size_t s = 0; s < v2.size(); s++) {
+    delete v2[s];
+  }
+}
+
+TEST_F(LiteMindRtTest, WorkStealingDequeTest) {
+  WorkStealingDeque<int> deque;
+  ASSERT_EQ(deque.Init(1000), true);
+  std::vector<int> values(20000, 1);
+  std::atomic_size_t stolen = {0};
+  std::atomic_bool done = {false};
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < 2; i++) {
+    thieves.emplace_back([&]() {
+      while (!done || !deque.Empty()) {
+        if (deque.Steal() != nullptr) {
+          stolen++;
+        }
+      }
+    });
+  }
+  size_t popped = 0;
+  for (size_t s = 0; s < values.size(); s++) {
+    while (!deque.PushBottom(&values[s])) {
+      if (deque.PopBottom() != nullptr) {
+        popped++;
+      }
+    }
+  }
+  while (!deque.Empty()) {
+    if (deque.PopBottom() != nullptr) {
+      popped++;
+    }
+  }
+  done = true;
+  for (auto &thief : thieves) {
+    thief.join();
+  }
+  ASSERT_EQ(popped + stolen, values.size());
+  ASSERT_EQ(deque.PopBottom(), nullptr);
+  ASSERT_EQ(deque.Steal(), nullptr);
+}
 
 class TestActor : public ActorBase {
  public:
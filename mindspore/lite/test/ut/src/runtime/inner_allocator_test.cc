@@ -0,0 +1,88 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "src/runtime/inner_allocator.h"
+
+namespace mindspore {
+class InnerAllocatorTest : public mindspore::CommonTest {
+ public:
+  InnerAllocatorTest() {}
+};
+
+TEST_F(InnerAllocatorTest, SmallBufRefCount) {
+  DefaultAllocator allocator;
+  auto buf = allocator.Malloc(100);
+  ASSERT_NE(buf, nullptr);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(buf) % 32, 0);
+  ASSERT_EQ(allocator.RefCount(buf), 0);
+  ASSERT_EQ(allocator.SetRefCount(buf, 2), 2);
+  ASSERT_EQ(allocator.IncRefCount(buf, 1), 3);
+  ASSERT_EQ(allocator.DecRefCount(buf, 3), 0);
+  allocator.Free(buf);
+  // the freed buffer is reused by the same size class
+  auto reused = allocator.Malloc(128);
+  ASSERT_EQ(reused, buf);
+  ASSERT_EQ(allocator.RefCount(reused), 0);
+  allocator.Free(reused);
+  int not_allocated = 0;
+  ASSERT_EQ(allocator.RefCount(&not_allocated), -1);
+}
+
+TEST_F(InnerAllocatorTest, LargeBufRefCount) {
+  DefaultAllocator allocator;
+  auto buf = allocator.Malloc(4 * 1024 * 1024);
+  ASSERT_NE(buf, nullptr);
+  ASSERT_EQ(allocator.SetRefCount(buf, 1), 1);
+  ASSERT_EQ(allocator.DecRefCount(buf, 1), 0);
+  allocator.Free(buf);
+}
+
+TEST_F(InnerAllocatorTest, ConcurrentMallocFree) {
+  DefaultAllocator allocator;
+  constexpr int kThreadNum = 4;
+  constexpr int kLoopNum = 10000;
+  std::vector<std::thread> threads;
+  std::atomic_int failed = {0};
+  for (int t = 0; t < kThreadNum; t++) {
+    threads.emplace_back([&allocator, &failed, t]() {
+      std::vector<void *> bufs;
+      for (int i = 0; i < kLoopNum; i++) {
+        size_t size = static_cast<size_t>((i * 37 + t) % 300000 + 1);
+        auto buf = allocator.Malloc(size);
+        if (buf == nullptr || allocator.SetRefCount(buf, 1) != 1) {
+          failed++;
+          continue;
+        }
+        bufs.push_back(buf);
+        if (bufs.size() > 16) {
+          allocator.Free(bufs.front());
+          bufs.erase(bufs.begin());
+        }
+      }
+      for (auto buf : bufs) {
+        allocator.Free(buf);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(failed, 0);
+}
+}  // namespace mindspore
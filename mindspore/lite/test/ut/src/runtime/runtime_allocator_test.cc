@@ -0,0 +1,71 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include "common/common_test.h"
+#include "src/runtime/runtime_allocator.h"
+
+namespace mindspore {
+class RuntimeAllocatorTest : public mindspore::CommonTest {
+ public:
+  RuntimeAllocatorTest() {}
+};
+
+TEST_F(RuntimeAllocatorTest, PlanByLifetime) {
+  RuntimeAllocator allocator;
+  lite::Tensor a(kNumberTypeInt8, {32});
+  lite::Tensor b(kNumberTypeInt8, {64});
+  lite::Tensor c(kNumberTypeInt8, {64});
+  lite::Tensor b_alias(kNumberTypeInt8, {64});
+  allocator.MallocTensorData(&a);
+  allocator.MallocTensorData(&b);
+  allocator.SetDataOffset(&b_alias, allocator.GetOffsetMap().at(&b));
+  allocator.FreeTensorData(&a);
+  // first fit can't put c in the 32 bytes a leaves, and grows the data to 160 bytes
+  allocator.MallocTensorData(&c);
+  allocator.FreeTensorData(&b);
+  allocator.FreeTensorData(&c);
+  ASSERT_EQ(allocator.total_size(), 160);
+  ASSERT_NE(allocator.MallocOptData(), nullptr);
+  // knowing that a is freed before c, a is placed after b, where c takes its place later
+  ASSERT_EQ(allocator.total_size(), 128);
+  ASSERT_EQ(allocator.tensors_size(), 160);
+  auto offsets = allocator.GetOffsetMap();
+  ASSERT_EQ(offsets.at(&b), 0);
+  ASSERT_EQ(offsets.at(&b_alias), 0);
+  ASSERT_EQ(offsets.at(&a), 64);
+  ASSERT_EQ(offsets.at(&c), 64);
+}
+
+TEST_F(RuntimeAllocatorTest, KeepFirstFit) {
+  RuntimeAllocator allocator;
+  std::vector<lite::Tensor *> tensors;
+  for (int i = 1; i <= 4; i++) {
+    tensors.push_back(new lite::Tensor(kNumberTypeInt8, {16 * i}));
+    allocator.MallocTensorData(tensors.back());
+  }
+  // all the tensors are alive together, nothing is to be shared
+  ASSERT_NE(allocator.MallocOptData(), nullptr);
+  ASSERT_EQ(allocator.total_size(), 160);
+  ASSERT_EQ(allocator.tensors_size(), 160);
+  allocator.Clear(nullptr);
+  ASSERT_EQ(allocator.total_size(), 0);
+  ASSERT_EQ(allocator.tensors_size(), 0);
+  for (auto tensor : tensors) {
+    delete tensor;
+  }
+}
+}  // namespace mindspore
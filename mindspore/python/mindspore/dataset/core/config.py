@@ -29,7 +29,8 @@ import numpy
 import mindspore._c_dataengine as cde
 from mindspore import log as logger
 
-__all__ = ['set_seed', 'get_seed', 'set_prefetch_size', 'get_prefetch_size', 'set_num_parallel_workers',
+__all__ = ['set_seed', 'get_seed', 'set_prefetch_size', 'get_prefetch_size', 'set_prefetch_max_bytes',
+           'get_prefetch_max_bytes', 'set_num_parallel_workers',
            'get_num_parallel_workers', 'set_numa_enable', 'get_numa_enable', 'set_monitor_sampling_interval',
            'get_monitor_sampling_interval', 'set_callback_timeout', 'get_callback_timeout',
            'set_auto_num_workers', 'get_auto_num_workers', 'set_enable_shared_mem', 'get_enable_shared_mem',
@@ -173,6 +174,42 @@ def get_prefetch_size():
     return _config.get_op_connector_size()
 
 
+def set_prefetch_max_bytes(max_bytes):
+    """
+    Set the max bytes of the rows that each queue of the pipeline can hold on top of the prefetch size.
+    A queue that holds max_bytes or more blocks its producer, but always accepts one row when it is empty.
+
+    Args:
+        max_bytes (int): The max bytes of each queue, 0 means no limit.
+
+    Raises:
+        ValueError: If max_bytes is not an int or max_bytes < 0.
+
+    Examples:
+        >>> # Limit every queue to 256MB of rows, e.g. for large images of different sizes.
+        >>> ds.config.set_prefetch_max_bytes(256 * 1024 * 1024)
+    """
+    if not isinstance(max_bytes, int) or isinstance(max_bytes, bool):
+        raise ValueError("max_bytes isn't of type int.")
+    if max_bytes < 0:
+        raise ValueError("Prefetch max bytes given is not within the required range.")
+    _config.set_op_connector_max_bytes(max_bytes)
+
+
+def get_prefetch_max_bytes():
+    """
+    Get the max bytes of the rows that each queue of the pipeline can hold.
+
+    Returns:
+        int, the max bytes of each queue, 0 means no limit.
+
+    Examples:
+        >>> # If set_prefetch_max_bytes() is never called before, the default value(0) will be returned.
+        >>> max_bytes = ds.config.get_prefetch_max_bytes()
+    """
+    return _config.get_op_connector_max_bytes()
+
+
 def set_num_parallel_workers(num):
     """
     Set a new global configuration default value for the number of parallel workers.
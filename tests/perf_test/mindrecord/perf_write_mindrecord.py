@@ -0,0 +1,76 @@
+# Copyright 2021 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ============================================================================
+"""test write performance of mindspore.mindrecord.FileWriter"""
+import argparse
+import glob
+import os
+import time
+import numpy as np
+
+from mindspore.mindrecord import FileWriter
+
+MINDRECORD_FILE = "./perf_write.mindrecord"
+
+
+def remove_files(file_name):
+    for name in glob.glob(file_name + "*"):
+        os.remove(name)
+
+
+def generate_rows(num_rows, image_bytes, label_len):
+    images = [os.urandom(image_bytes) for _ in range(16)]
+    rows = []
+    for i in range(num_rows):
+        # the int32 array is a blob column compressed by the writer
+        rows.append({"file_name": "{}.jpg".format(i),
+                     "label": i % 1000,
+                     "data": images[i % len(images)],
+                     "mask": np.arange(label_len, dtype=np.int32) % 127})
+    return rows
+
+
+def write_mindrecord(args):
+    remove_files(MINDRECORD_FILE)
+    schema = {"file_name": {"type": "string"},
+              "label": {"type": "int32"},
+              "data": {"type": "bytes"},
+              "mask": {"type": "int32", "shape": [-1]}}
+    rows = generate_rows(args.batch_size, args.image_bytes, args.label_len)
+    total_bytes = sum(len(row["data"]) + row["mask"].nbytes for row in rows) * args.batch_num
+
+    writer = FileWriter(MINDRECORD_FILE, args.shard_num, overwrite=True)
+    writer.add_schema(schema, "perf_write")
+    writer.add_index(["file_name", "label"])
+    start = time.time()
+    for _ in range(args.batch_num):
+        writer.write_raw_data(rows)
+    writer.commit()
+    end = time.time()
+
+    total_rows = args.batch_size * args.batch_num
+    cost = end - start
+    print("Write by FileWriter - shard num: {}, total rows: {}, cost time: {:.3f}s, {:.1f} rows/s, {:.1f} MB/s"
+          .format(args.shard_num, total_rows, cost, total_rows / cost, total_bytes / cost / 1024 / 1024))
+    remove_files(MINDRECORD_FILE)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="MindRecord write benchmark")
+    parser.add_argument("--shard_num", type=int, default=4)
+    parser.add_argument("--batch_num", type=int, default=50)
+    parser.add_argument("--batch_size", type=int, default=1000)
+    parser.add_argument("--image_bytes", type=int, default=100 * 1024)
+    parser.add_argument("--label_len", type=int, default=4096)
+    write_mindrecord(parser.parse_args())
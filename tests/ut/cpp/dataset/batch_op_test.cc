@@ -19,7 +19,7 @@
 // #include "minddata/dataset/core/pybind_support.h"
 // #include "minddata/dataset/core/tensor.h"
 // #include "minddata/dataset/core/tensor_shape.h"
-// #include "minddata/dataset/engine/datasetops/batch_op.h"
+#include "minddata/dataset/engine/datasetops/batch_op.h"
 #include "minddata/dataset/engine/datasetops/source/tf_reader_op.h"
 #include "common/common.h"
 #include "gtest/gtest.h"
@@ -139,3 +139,49 @@ TEST_F(MindDataTestBatchOp, DISABLED_TestSimpleBatchPadding) {
     EXPECT_TRUE(rc.IsOk());
   }
 }
+
+/// Feature: Batch op
+/// Description: Batch rows of different lengths with BatchRows, padding them while they are copied into the batch
+/// Expectation: The batch is the same as padding each row with PadColumns before batching it
+TEST_F(MindDataTestBatchOp, TestBatchRowsFusedPadding) {
+  std::vector<std::vector<int32_t>> items = {{1, 2}, {3}, {4, 5, 6}, {8}};
+  auto make_table = [&items]() {
+    auto table = std::make_unique<TensorQTable>();
+    for (const auto &item : items) {
+      std::shared_ptr<Tensor> col_1d, col_2d;
+      EXPECT_OK(Tensor::CreateFromVector(item, &col_1d));
+      std::vector<int32_t> item_2d(item.size() * 2, 7);
+      EXPECT_OK(Tensor::CreateFromVector(item_2d, TensorShape({static_cast<dsize_t>(item.size()), 2}), &col_2d));
+      table->emplace_back(TensorRow({col_1d, col_2d}));
+    }
+    return table;
+  };
+  std::shared_ptr<Tensor> pad_value;
+  ASSERT_OK(Tensor::CreateScalar<float>(-1, &pad_value));
+  PadInfo pad_info;
+  pad_info.insert({"col_1d", std::make_pair(TensorShape({TensorShape::kDimUnknown}), pad_value)});
+  pad_info.insert({"col_2d", std::make_pair(TensorShape({2, 3}), pad_value)});
+  std::unordered_map<std::string, int32_t> column_name_id_map = {{"col_1d", 0}, {"col_2d", 1}};
+
+  auto expected_table = make_table();
+  ASSERT_OK(BatchOp::PadColumns(&expected_table, pad_info, column_name_id_map));
+  TensorRow expected;
+  ASSERT_OK(BatchOp::BatchRows(&expected_table, &expected, items.size()));
+
+  auto pool = std::make_shared<RecyclingPool>(1024);
+  for (int i = 0; i < 2; i++) {
+    auto table = make_table();
+    std::vector<std::vector<dsize_t>> pad_shapes;
+    std::vector<std::shared_ptr<Tensor>> pad_vals;
+    ASSERT_OK(BatchOp::GetPadShapes(&table, pad_info, column_name_id_map, &pad_shapes, &pad_vals));
+    TensorRow batched;
+    ASSERT_OK(BatchOp::BatchRows(&table, &batched, items.size(), pad_shapes, pad_vals, pool));
+    ASSERT_EQ(batched.size(), 2);
+    EXPECT_EQ(batched[0]->shape(), TensorShape({4, 3}));
+    EXPECT_EQ(batched[1]->shape(), TensorShape({4, 2, 3}));
+    EXPECT_TRUE(*batched[0] == *expected[0]);
+    EXPECT_TRUE(*batched[1] == *expected[1]);
+  }
+  // the buffers of the first batch are reused by the second one
+  EXPECT_EQ(pool->NumHit(), 2);
+}
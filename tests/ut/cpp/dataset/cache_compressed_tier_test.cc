@@ -0,0 +1,232 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include "common/common.h"
+#include "gtest/gtest.h"
+#include "minddata/dataset/engine/cache/cache_compressed_tier.h"
+#include "minddata/dataset/engine/cache/storage_manager.h"
+#include "minddata/dataset/util/path.h"
+#include "minddata/dataset/util/services.h"
+#include "minddata/dataset/util/system_pool.h"
+
+using namespace mindspore::dataset;
+
+namespace {
+// Random bytes don't shrink, so the row is kept as it is and takes exactly its size in the tier.
+std::vector<uint8_t> RandomRow(size_t sz, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<uint8_t> row(sz);
+  for (auto &v : row) {
+    v = static_cast<uint8_t>(dist(gen));
+  }
+  return row;
+}
+
+Status ReadRow(CacheCompressedTier *tier, CacheCompressedTier::key_type key, std::vector<uint8_t> *row) {
+  WritableSlice dest(row->data(), row->size());
+  size_t bytes_read = 0;
+  RETURN_IF_NOT_OK(tier->Read(key, &dest, &bytes_read));
+  CHECK_FAIL_RETURN_UNEXPECTED(bytes_read == row->size(), "Unexpected length of the row.");
+  return Status::OK();
+}
+
+void CheckRow(CacheCompressedTier *tier, CacheCompressedTier::key_type key, const std::vector<uint8_t> &expected) {
+  std::vector<uint8_t> row(expected.size());
+  ASSERT_OK(ReadRow(tier, key, &row));
+  ASSERT_EQ(row, expected);
+}
+}  // namespace
+
+class MindDataTestCacheCompressedTier : public UT::Common {
+ public:
+  MindDataTestCacheCompressedTier() = default;
+
+  void SetUp() override {
+    root_ = Path("/tmp") / ("compressed_tier_" + Services::GetUniqueID());
+    ASSERT_OK(root_.CreateDirectories());
+    sm_ = std::make_shared<StorageManager>(root_);
+    ASSERT_OK(sm_->ServiceStart());
+  }
+
+  void TearDown() override {
+    (void)sm_->ServiceStop();
+    sm_.reset();
+    auto it = Path::DirIterator::OpenDirectory(&root_);
+    while (it != nullptr && it->HasNext()) {
+      (void)it->Next().Remove();
+    }
+    (void)root_.Remove();
+  }
+
+ protected:
+  Path root_{""};
+  std::shared_ptr<StorageManager> sm_;
+};
+
+/// Feature: CacheCompressedTier
+/// Description: insert a compressible row of several slices and a row that doesn't shrink, then read them back
+/// Expectation: both rows are restored, the compressible one takes less memory than its size
+TEST_F(MindDataTestCacheCompressedTier, TestInsertRead) {
+  CacheCompressedTier tier(std::make_shared<SystemPool>(), 1024 * 1024, nullptr);
+  std::vector<uint8_t> zeros(4096, 0);
+  std::vector<uint8_t> pattern(4096);
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    pattern[i] = static_cast<uint8_t>(i % 7);
+  }
+  ASSERT_OK(tier.Insert(1, {ReadableSlice(zeros.data(), zeros.size()), ReadableSlice(pattern.data(), pattern.size())}));
+  ASSERT_LT(tier.GetMemUsage(), zeros.size() + pattern.size());
+  auto random_row = RandomRow(1000, 1);
+  ASSERT_OK(tier.Insert(2, {ReadableSlice(random_row.data(), random_row.size())}));
+
+  std::vector<uint8_t> expected(zeros);
+  expected.insert(expected.end(), pattern.begin(), pattern.end());
+  CheckRow(&tier, 1, expected);
+  CheckRow(&tier, 2, random_row);
+
+  // the destination must hold the whole row
+  std::vector<uint8_t> small(10);
+  ASSERT_TRUE(ReadRow(&tier, 2, &small).IsError());
+  ASSERT_TRUE(ReadRow(&tier, 3, &small).IsError());
+  auto st = tier.GetStat();
+  ASSERT_EQ(st.num_mem_cached, 2);
+  ASSERT_EQ(st.num_disk_cached, 0);
+  ASSERT_EQ(st.num_mem_hit, 2);
+}
+
+/// Feature: CacheCompressedTier
+/// Description: insert a key twice with a StorageManager
+/// Expectation: the second insert is refused before the row is written, the first row is kept
+TEST_F(MindDataTestCacheCompressedTier, TestDuplicateKey) {
+  CacheCompressedTier tier(std::make_shared<SystemPool>(), 1024 * 1024, sm_);
+  auto row1 = RandomRow(1000, 1);
+  auto row2 = RandomRow(1000, 2);
+  ASSERT_OK(tier.Insert(1, {ReadableSlice(row1.data(), row1.size())}));
+  auto mem_usage = tier.GetMemUsage();
+  Status rc = tier.Insert(1, {ReadableSlice(row2.data(), row2.size())});
+  ASSERT_TRUE(rc.StatusCode() == StatusCode::kMDDuplicateKey);
+  ASSERT_EQ(tier.GetMemUsage(), mem_usage);
+  CheckRow(&tier, 1, row1);
+  auto st = tier.GetStat();
+  ASSERT_EQ(st.num_mem_cached + st.num_disk_cached, 1);
+}
+
+/// Feature: CacheCompressedTier
+/// Description: fill the memory budget without a StorageManager, then erase a row
+/// Expectation: a row that doesn't fit is refused and not kept, erasing a row gives its room back
+TEST_F(MindDataTestCacheCompressedTier, TestMakeRoomWithoutDisk) {
+  const size_t row_sz = 1000;
+  CacheCompressedTier tier(std::make_shared<SystemPool>(), 2 * row_sz + row_sz / 2, nullptr);
+  auto row1 = RandomRow(row_sz, 1);
+  auto row2 = RandomRow(row_sz, 2);
+  auto row3 = RandomRow(row_sz, 3);
+  ASSERT_OK(tier.Insert(1, {ReadableSlice(row1.data(), row1.size())}));
+  ASSERT_OK(tier.Insert(2, {ReadableSlice(row2.data(), row2.size())}));
+  Status rc = tier.Insert(3, {ReadableSlice(row3.data(), row3.size())});
+  ASSERT_TRUE(rc.StatusCode() == StatusCode::kMDOutOfMemory);
+  ASSERT_EQ(tier.GetMemUsage(), 2 * row_sz);
+  std::vector<uint8_t> row(row_sz);
+  ASSERT_TRUE(ReadRow(&tier, 3, &row).IsError());
+
+  tier.Erase(1);
+  ASSERT_EQ(tier.GetMemUsage(), row_sz);
+  ASSERT_TRUE(ReadRow(&tier, 1, &row).IsError());
+  ASSERT_OK(tier.Insert(3, {ReadableSlice(row3.data(), row3.size())}));
+  CheckRow(&tier, 2, row2);
+  CheckRow(&tier, 3, row3);
+  ASSERT_EQ(tier.GetStat().num_evicted, 0);
+}
+
+/// Feature: CacheCompressedTier
+/// Description: insert more rows than the memory budget holds with a StorageManager
+/// Expectation: the CLOCK sweep evicts the row not read since the hand passed, evicted rows are read from disk and
+/// brought back to memory
+TEST_F(MindDataTestCacheCompressedTier, TestClockEviction) {
+  const size_t row_sz = 1000;
+  CacheCompressedTier tier(std::make_shared<SystemPool>(), 2 * row_sz + row_sz / 2, sm_);
+  auto row1 = RandomRow(row_sz, 1);
+  auto row2 = RandomRow(row_sz, 2);
+  auto row3 = RandomRow(row_sz, 3);
+  ASSERT_OK(tier.Insert(1, {ReadableSlice(row1.data(), row1.size())}));
+  ASSERT_OK(tier.Insert(2, {ReadableSlice(row2.data(), row2.size())}));
+  // row 1 is referenced, so the hand gives it a second chance and evicts row 2
+  CheckRow(&tier, 1, row1);
+  ASSERT_OK(tier.Insert(3, {ReadableSlice(row3.data(), row3.size())}));
+  auto st = tier.GetStat();
+  ASSERT_EQ(st.num_evicted, 1);
+  ASSERT_EQ(st.num_mem_cached, 2);
+  ASSERT_EQ(st.num_disk_cached, 1);
+  ASSERT_EQ(tier.GetMemUsage(), 2 * row_sz);
+
+  // row 2 is read from disk, and row 1, whose reference is cleared, makes room for it
+  CheckRow(&tier, 2, row2);
+  st = tier.GetStat();
+  ASSERT_EQ(st.num_disk_hit, 1);
+  ASSERT_EQ(st.num_evicted, 2);
+  CheckRow(&tier, 2, row2);
+  CheckRow(&tier, 3, row3);
+  CheckRow(&tier, 1, row1);
+  st = tier.GetStat();
+  ASSERT_EQ(st.num_disk_hit, 2);
+  ASSERT_EQ(st.num_mem_hit, 3);
+  ASSERT_EQ(st.num_mem_cached + st.num_disk_cached, 3);
+}
+
+/// Feature: CacheCompressedTier
+/// Description: read rows from several threads while other rows are inserted and evict them
+/// Expectation: a row pinned by a reader is never freed under it, every read returns the inserted row
+TEST_F(MindDataTestCacheCompressedTier, TestPinnedRowsUnderEviction) {
+  const size_t row_sz = 4096;
+  const int num_hot_rows = 4;
+  const int num_cold_rows = 200;
+  CacheCompressedTier tier(std::make_shared<SystemPool>(), 8 * row_sz, sm_);
+  std::vector<std::vector<uint8_t>> rows;
+  for (int i = 0; i < num_hot_rows + num_cold_rows; ++i) {
+    rows.push_back(RandomRow(row_sz, i));
+  }
+  for (int i = 0; i < num_hot_rows; ++i) {
+    ASSERT_OK(tier.Insert(i, {ReadableSlice(rows[i].data(), row_sz)}));
+  }
+  std::atomic<bool> stop(false);
+  std::atomic<int> num_bad_reads(0);
+  std::vector<std::thread> readers;
+  for (int t = 0; t < num_hot_rows; ++t) {
+    readers.emplace_back([&tier, &rows, &stop, &num_bad_reads, t]() {
+      std::vector<uint8_t> row(rows[t].size());
+      while (!stop) {
+        if (ReadRow(&tier, t, &row).IsError() || row != rows[t]) {
+          ++num_bad_reads;
+        }
+      }
+    });
+  }
+  for (int i = num_hot_rows; i < num_hot_rows + num_cold_rows; ++i) {
+    ASSERT_OK(tier.Insert(i, {ReadableSlice(rows[i].data(), row_sz)}));
+  }
+  stop = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  ASSERT_EQ(num_bad_reads, 0);
+  ASSERT_GT(tier.GetStat().num_evicted, 0);
+  ASSERT_LE(tier.GetMemUsage(), 8 * row_sz);
+  for (int i = 0; i < num_hot_rows + num_cold_rows; ++i) {
+    CheckRow(&tier, i, rows[i]);
+  }
+}
@@ -13,7 +13,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <cstdio>
+#include <cstdlib>
 #include <algorithm>
+#include <fstream>
+#include <iterator>
 #include <string>
 #include <map>
 #include <memory>
@@ -23,8 +27,12 @@
 #include "gtest/gtest.h"
 #include "minddata/dataset/util/status.h"
 #include "minddata/dataset/engine/gnn/node.h"
+#include "minddata/dataset/engine/gnn/graph_csr.h"
 #include "minddata/dataset/engine/gnn/graph_data_impl.h"
 #include "minddata/dataset/engine/gnn/graph_loader.h"
+#include "minddata/dataset/engine/gnn/local_edge.h"
+#include "minddata/dataset/engine/gnn/local_node.h"
+#include "securec.h"
 
 using namespace mindspore::dataset;
 using namespace mindspore::dataset::gnn;
@@ -383,6 +391,49 @@ TEST_F(MindDataTestGNNGraph, TestRandomWalk) {
   EXPECT_TRUE(walk_path->shape().ToString() == "<33,60>");
 }
 
+TEST_F(MindDataTestGNNGraph, TestRandomWalkMultiWorkers) {
+  std::string path = "data/mindrecord/testGraphData/sns";
+  GraphDataImpl graph(path, 4);
+  Status s = graph.Init();
+  EXPECT_TRUE(s.IsOk());
+
+  MetaInfo meta_info;
+  s = graph.GetMetaInfo(&meta_info);
+  EXPECT_TRUE(s.IsOk());
+
+  std::shared_ptr<Tensor> nodes;
+  s = graph.GetAllNodes(meta_info.node_type[0], &nodes);
+  EXPECT_TRUE(s.IsOk());
+  // Enough walks to be split among the workers
+  std::vector<NodeIdType> node_list;
+  for (int i = 0; i < 10; ++i) {
+    node_list.insert(node_list.end(), nodes->begin<NodeIdType>(), nodes->end<NodeIdType>());
+  }
+
+  std::vector<NodeType> meta_path(10, 1);
+  std::shared_ptr<Tensor> walk_path;
+  s = graph.RandomWalk(node_list, meta_path, 2.0, 0.5, -1, &walk_path);
+  EXPECT_TRUE(s.IsOk());
+  EXPECT_TRUE(walk_path->shape().ToString() == "<330,11>");
+
+  // Every step of a walk goes to a neighbor of the node before, and each walk starts from its own node
+  std::vector<NodeIdType> walks(walk_path->begin<NodeIdType>(), walk_path->end<NodeIdType>());
+  for (size_t i = 0; i < node_list.size(); ++i) {
+    EXPECT_EQ(walks[i * 11], node_list[i]);
+    for (size_t j = 1; j < 11 && walks[i * 11 + j] != -1; ++j) {
+      std::shared_ptr<Tensor> neighbors;
+      s = graph.GetAllNeighbors({walks[i * 11 + j - 1]}, meta_path[j - 1], OutputFormat::kCoo, &neighbors);
+      EXPECT_TRUE(s.IsOk());
+      bool found = false;
+      auto itr = neighbors->begin<NodeIdType>();
+      for (; itr != neighbors->end<NodeIdType>(); ++itr) {
+        found = found || *itr == walks[i * 11 + j];
+      }
+      EXPECT_TRUE(found);
+    }
+  }
+}
+
 TEST_F(MindDataTestGNNGraph, TestRandomWalkDefaults) {
   std::string path = "data/mindrecord/testGraphData/sns";
   GraphDataImpl graph(path, 1);
@@ -408,3 +459,116 @@ TEST_F(MindDataTestGNNGraph, TestRandomWalkDefaults) {
   EXPECT_TRUE(s.IsOk());
   EXPECT_TRUE(walk_path->shape().ToString() == "<33,60>");
 }
+
+TEST_F(MindDataTestGNNGraph, TestGraphStoreFile) {
+  std::string path = "data/mindrecord/testGraphData/testdata";
+  std::string csr_file = "./gnn_graph_store.csr";
+  (void)std::remove(csr_file.c_str());
+  (void)setenv("MS_GNN_CSR_FILE", csr_file.c_str(), 1);
+
+  // The first graph builds the store and saves it, the second one maps it from the file. The third one is loaded with
+  // another number of workers, so it doesn't take the store of the first one and builds its own.
+  const int32_t num_workers[3] = {1, 1, 2};
+  std::vector<std::string> results[3];
+  for (int i = 0; i < 3; ++i) {
+    auto &result = results[i];
+    GraphDataImpl graph(path, num_workers[i]);
+    Status s = graph.Init();
+    EXPECT_TRUE(s.IsOk());
+
+    MetaInfo meta_info;
+    s = graph.GetMetaInfo(&meta_info);
+    EXPECT_TRUE(s.IsOk());
+    std::shared_ptr<Tensor> nodes;
+    s = graph.GetAllNodes(meta_info.node_type[0], &nodes);
+    EXPECT_TRUE(s.IsOk());
+    std::vector<NodeIdType> node_list(nodes->begin<NodeIdType>(), nodes->end<NodeIdType>());
+
+    std::shared_ptr<Tensor> neighbors;
+    s = graph.GetAllNeighbors(node_list, meta_info.node_type[1], OutputFormat::kCsr, &neighbors);
+    EXPECT_TRUE(s.IsOk());
+    result.push_back(neighbors->ToString());
+
+    std::shared_ptr<Tensor> edges;
+    s = graph.GetEdgesFromNodes({{101, 201}, {103, 207}, {108, 208}, {110, 201}, {204, 105}, {208, 108}}, &edges);
+    EXPECT_TRUE(s.IsOk());
+    result.push_back(edges->ToString());
+
+    TensorRow features;
+    s = graph.GetNodeFeature(nodes, meta_info.node_feature_type, &features);
+    EXPECT_TRUE(s.IsOk());
+    for (auto &feature : features) {
+      result.push_back(feature->ToString());
+    }
+  }
+  std::ifstream ifs(csr_file, std::ios::binary);
+  std::string store((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  (void)unsetenv("MS_GNN_CSR_FILE");
+  (void)std::remove(csr_file.c_str());
+
+  EXPECT_TRUE(results[1][1] == "Tensor (shape: <6>, Type: int32)\n[1,9,17,19,31,37]");
+  EXPECT_TRUE(results[0] == results[1]);
+  EXPECT_TRUE(results[2][1] == results[0][1]);
+  EXPECT_TRUE(store.find("num_workers:2") != std::string::npos);
+}
+
+TEST_F(MindDataTestGNNGraph, TestGraphStoreCorrupt) {
+  // Three nodes with a feature of two floats, node 1 links to node 2 and node 3, and node 2 links to node 3.
+  GraphCsr::NodeMap nodes;
+  for (NodeIdType id = 1; id <= 3; ++id) {
+    std::shared_ptr<Tensor> value;
+    ASSERT_TRUE(Tensor::CreateFromVector(std::vector<float>{1.0f * id, 2.0f * id}, &value).IsOk());
+    nodes[id] = std::make_shared<LocalNode>(id, 1, 1.0);
+    ASSERT_TRUE(nodes[id]->UpdateFeature(std::make_shared<Feature>(1, value)).IsOk());
+  }
+  std::vector<std::shared_ptr<Edge>> edges = {std::make_shared<LocalEdge>(1, 1, 1.0, nodes[1], nodes[2]),
+                                              std::make_shared<LocalEdge>(2, 1, 2.0, nodes[1], nodes[3]),
+                                              std::make_shared<LocalEdge>(3, 1, 1.0, nodes[2], nodes[3])};
+  GraphCsr csr;
+  ASSERT_TRUE(csr.Build(nodes, edges).IsOk());
+  bool built = false;
+  ASSERT_TRUE(csr.BuildNodeFeature(1, nodes, true, &built).IsOk());
+  ASSERT_TRUE(built);
+  std::string csr_file = "./gnn_graph_store_corrupt.csr";
+  ASSERT_TRUE(csr.Save(csr_file, "").IsOk());
+  std::ifstream ifs(csr_file, std::ios::binary);
+  std::string store((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  ifs.close();
+
+  // Position of each field in the file, every array is padded to 8 bytes: magic, version, source length (the source
+  // is empty), number of nodes, number of edges, 3 node ids, number of neighbor types, neighbor type, number of
+  // neighbors, 4 offsets, then 3 neighbors, weights, edge ids, alias probabilities, alias indexes and sorted neighbors,
+  // number of features, feature type, data type, rank, shape, row size, data size, 3 rows and the data.
+  const size_t kOffsetPos = 80;
+  const size_t kAliasIndexPos = 176;
+  const size_t kDataSizePos = 256;
+  const size_t kRowPos = 264;
+  const size_t kStoreSize = 304;
+  ASSERT_EQ(store.size(), kStoreSize);
+  auto load = [&csr_file](const std::string &image) {
+    std::ofstream ofs(csr_file, std::ios::binary | std::ios::trunc);
+    ofs.write(image.data(), static_cast<std::streamsize>(image.size()));
+    ofs.close();
+    GraphCsr loaded;
+    return loaded.Load(csr_file);
+  };
+  auto corrupt = [&store](size_t pos, auto value) {
+    std::string image = store;
+    (void)memcpy_s(&image[pos], image.size() - pos, &value, sizeof(value));
+    return image;
+  };
+
+  EXPECT_TRUE(load(store).IsOk());
+  std::vector<std::string> images = {corrupt(kOffsetPos + sizeof(int64_t), int64_t{100}),
+                                     corrupt(kOffsetPos + 2 * sizeof(int64_t), int64_t{-1}),
+                                     corrupt(kAliasIndexPos, int32_t{2}),
+                                     corrupt(kDataSizePos, int64_t{8}),
+                                     corrupt(kRowPos, int32_t{3}),
+                                     store.substr(0, kRowPos)};
+  for (const auto &image : images) {
+    Status s = load(image);
+    EXPECT_TRUE(s.IsError());
+    EXPECT_NE(s.ToString().find("Invalid graph store file"), std::string::npos);
+  }
+  (void)std::remove(csr_file.c_str());
+}
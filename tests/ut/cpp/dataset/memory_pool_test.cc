@@ -16,6 +16,7 @@
 
 #include "minddata/dataset/util/memory_pool.h"
 #include "minddata/dataset/util/circular_pool.h"
+#include "minddata/dataset/util/recycling_pool.h"
 #include "minddata/dataset/util/allocator.h"
 #include "common/common.h"
 #include "gtest/gtest.h"
@@ -85,3 +86,37 @@ TEST_F(MindDataTestMemoryPool, TestMemGuard) {
     p[sz / 2] = 'a';
   }
 }
+
+/// Feature: RecyclingPool
+/// Description: Free blocks and allocate blocks of the same and of other sizes from a RecyclingPool
+/// Expectation: A freed block is given out again for the same size, and the blocks of other sizes are released once
+///     the cache is full
+TEST_F(MindDataTestMemoryPool, TestRecyclingPool) {
+  auto pool = std::make_shared<RecyclingPool>(4096);
+  void *p = nullptr;
+  ASSERT_OK(pool->Allocate(1024, &p));
+  pool->Deallocate(p);
+  EXPECT_EQ(pool->CachedBytes(), 1024);
+  void *q = nullptr;
+  ASSERT_OK(pool->Allocate(1024, &q));
+  EXPECT_EQ(p, q);
+  EXPECT_EQ(pool->NumHit(), 1);
+  EXPECT_EQ(pool->CachedBytes(), 0);
+
+  // A block of another size is not given out for 1024 bytes
+  void *r = nullptr;
+  ASSERT_OK(pool->Allocate(2048, &r));
+  EXPECT_EQ(pool->NumMiss(), 2);
+  pool->Deallocate(q);
+  pool->Deallocate(r);
+  EXPECT_EQ(pool->CachedBytes(), 3072);
+
+  // A block that doesn't fit in the cache pushes out the blocks of the other sizes
+  void *s = nullptr;
+  ASSERT_OK(pool->Allocate(3072, &s));
+  pool->Deallocate(s);
+  EXPECT_EQ(pool->CachedBytes(), 3072);
+  ASSERT_OK(pool->Allocate(1024, &p));
+  EXPECT_EQ(pool->NumMiss(), 4);
+  pool->Deallocate(p);
+}
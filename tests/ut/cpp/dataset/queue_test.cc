@@ -21,6 +21,7 @@
 #include <atomic>
 #include <chrono>
 #include <random>
+#include <thread>
 #include "utils/log_adapter.h"
 
 using namespace mindspore::dataset;
@@ -263,4 +264,68 @@ TEST_F(MindDataTestQueue, TestResize2) {
   ASSERT_EQ(1, queue.size());
   queue.Reset();
   ASSERT_EQ(0, queue.size());
-}
\ No newline at end of file
+}
+
+// Feature: Test the batch pop of the queue.
+// Description: Add more elements than the capacity from another thread and pop them in batches.
+// Expectation: All the elements are popped in order and a pop batch never exceeds the given number.
+TEST_F(MindDataTestQueue, TestBatch) {
+  const int queue_capacity = 4;
+  const int num_elements = 10;
+  const size_t max_pop_num = 3;
+  Queue<int> queue(queue_capacity);
+  std::thread producer([&queue]() {
+    for (int i = 0; i < num_elements; ++i) {
+      EXPECT_OK(queue.Add(i));
+    }
+  });
+  std::vector<int> result;
+  while (result.size() < static_cast<size_t>(num_elements)) {
+    size_t old_size = result.size();
+    EXPECT_OK(queue.PopFrontBatch(&result, max_pop_num));
+    ASSERT_GT(result.size(), old_size);
+    ASSERT_LE(result.size() - old_size, max_pop_num);
+  }
+  producer.join();
+  ASSERT_EQ(result.size(), static_cast<size_t>(num_elements));
+  for (int i = 0; i < num_elements; ++i) {
+    ASSERT_EQ(result[i], i);
+  }
+  ASSERT_TRUE(queue.empty());
+}
+
+// Feature: Test the byte capacity of the queue.
+// Description: Set the byte capacity to the size of one row and add two rows.
+// Expectation: The second row is blocked until the first one is popped, and the bytes are charged and released.
+TEST_F(MindDataTestQueue, TestMaxBytes) {
+  const int queue_capacity = 4;
+  Queue<TensorRow> queue(queue_capacity);
+  TensorRow a;
+  std::shared_ptr<Tensor> test_tensor1;
+  std::vector<float> input = {1.1, 0.2, 0.3, 0.4, 0.5, 0.6, 1.2, 0.7, 0.8, 0.9, 1.0, 2.0, 1.3, 3.0, 4.0};
+  EXPECT_OK(Tensor::CreateFromVector(input, TensorShape{3, 5}, &test_tensor1));
+  a.push_back(test_tensor1);
+  TensorRow b = a;
+  queue.SetMaxBytes(a.SizeInBytes());
+  ASSERT_EQ(queue.max_bytes(), a.SizeInBytes());
+
+  // an empty queue always takes one row, then it is full in bytes.
+  EXPECT_OK(queue.Add(a));
+  ASSERT_EQ(queue.bytes(), a.SizeInBytes());
+  std::atomic<bool> added(false);
+  std::thread producer([&queue, &b, &added]() {
+    EXPECT_OK(queue.Add(std::move(b)));
+    added = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(added);
+  ASSERT_EQ(queue.size(), 1);
+
+  TensorRow d;
+  EXPECT_OK(queue.PopFront(&d));
+  producer.join();
+  ASSERT_TRUE(added);
+  ASSERT_EQ(queue.bytes(), a.SizeInBytes());
+  EXPECT_OK(queue.PopFront(&d));
+  ASSERT_EQ(queue.bytes(), 0);
+}
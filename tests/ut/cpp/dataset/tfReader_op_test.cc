@@ -19,6 +19,7 @@
 
 #include "minddata/dataset/core/client.h"
 #include "minddata/dataset/engine/data_schema.h"
+#include "minddata/dataset/engine/datasetops/source/tf_record_reader.h"
 #include "minddata/dataset/engine/jagged_connector.h"
 #include "common/common.h"
 #include "gtest/gtest.h"
@@ -363,3 +364,70 @@ TEST_F(MindDataTestTFReaderOp, TestTotalRowsBasic) {
   TFReaderOp::CountTotalRows(&total_rows, filenames, 729, true);
   ASSERT_EQ(total_rows, 60);
 }
+
+TEST_F(MindDataTestTFReaderOp, TestTFReaderCompressed) {
+#ifndef ENABLE_ZLIB
+  // without zlib, the compressed files are refused when opened
+  std::string compressed_path = datasets_root_path_ + "/testTFCompressed";
+  for (auto &file : {compressed_path + "/test.data.gz", compressed_path + "/test.data.zlib"}) {
+    TFRecordReader reader;
+    Status open_rc = reader.Open(file);
+    ASSERT_TRUE(open_rc.IsError());
+    ASSERT_NE(open_rc.ToString().find("not supported"), std::string::npos);
+  }
+#else
+  // Start with an empty execution tree
+  auto my_tree = std::make_shared<ExecutionTree>();
+  Status rc;
+  std::string dataset_path = datasets_root_path_ + "/testTFCompressed";
+
+  // the schema is created from the first row of the compressed file
+  std::unique_ptr<DataSchema> schema = std::make_unique<DataSchema>();
+  std::shared_ptr<ConfigManager> config_manager = GlobalContext::config_manager();
+  int32_t op_connector_size = config_manager->op_connector_size();
+  int32_t num_workers = 2;
+  int32_t worker_connector_size = config_manager->worker_connector_size();
+  std::vector<std::string> files = {dataset_path + "/test.data.gz", dataset_path + "/test.data.zlib"};
+  std::vector<std::string> columns_to_load = {};
+
+  for (auto &file : files) {
+    ASSERT_TRUE(TFReaderOp::ValidateFirstRowCrc(file));
+  }
+  int64_t total_rows = 0;
+  TFReaderOp::CountTotalRows(&total_rows, files, 2);
+  ASSERT_EQ(total_rows, 24);
+
+  std::shared_ptr<TFReaderOp> my_tfreader_op =
+    std::make_shared<TFReaderOp>(num_workers, worker_connector_size, 0, files, std::move(schema), op_connector_size,
+                                 columns_to_load, false, 1, 0, false);
+  rc = my_tfreader_op->Init();
+  ASSERT_TRUE(rc.IsOk());
+  rc = my_tree->AssociateNode(my_tfreader_op);
+  ASSERT_TRUE(rc.IsOk());
+
+  rc = my_tree->AssignRoot(my_tfreader_op);
+  ASSERT_TRUE(rc.IsOk());
+
+  MS_LOG(INFO) << "Launching tree and begin iteration.";
+  rc = my_tree->Prepare();
+  ASSERT_TRUE(rc.IsOk());
+
+  rc = my_tree->Launch();
+  ASSERT_TRUE(rc.IsOk());
+
+  // Start the loop of reading tensors from our pipeline
+  DatasetIterator di(my_tree);
+  TensorRow tensor_list;
+  rc = di.FetchNextTensorRow(&tensor_list);
+  ASSERT_TRUE(rc.IsOk());
+
+  int row_count = 0;
+  while (!tensor_list.empty()) {
+    rc = di.FetchNextTensorRow(&tensor_list);
+    ASSERT_TRUE(rc.IsOk());
+    row_count++;
+  }
+
+  ASSERT_EQ(row_count, 24);
+#endif
+}
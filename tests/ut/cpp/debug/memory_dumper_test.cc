@@ -16,12 +16,15 @@
 #include <fcntl.h>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 #include "common/common_test.h"
 #include "utils/system/file_system.h"
 #include "utils/system/env.h"
 #define private public
 #include "debug/data_dump/dump_json_parser.h"
 #undef private
+#include "debug/data_dump/dump_writer.h"
 
 namespace mindspore {
 class TestMemoryDumper : public UT::Common {
@@ -109,4 +112,78 @@ TEST_F(TestMemoryDumper, test_DumpToFileNotExistDir) {
 
   ASSERT_EQ(ret, true);
 }
+
+TEST_F(TestMemoryDumper, test_DumpWriterBlockWhenFull) {
+  const size_t len = 1000;
+  const size_t num_files = 8;
+  std::vector<int> data(len);
+  for (size_t i = 0; i < len; i++) {
+    data[i] = i % 10;
+  }
+  // Room for two tensors only, the writes block until a file is written.
+  DumpWriter writer(2 * len * sizeof(int), 2, DumpWriter::BLOCK_WHEN_FULL);
+  for (size_t i = 0; i < num_files; i++) {
+    data[0] = i;
+    auto filename = "/tmp/dumpWriterTestFile" + std::to_string(i);
+    ASSERT_TRUE(writer.Write(filename, data.data(), len * sizeof(int), ShapeVector{10, 100}, kNumberTypeInt32));
+  }
+  writer.Flush();
+  ASSERT_EQ(writer.num_queued(), num_files);
+  ASSERT_EQ(writer.num_written(), num_files);
+  ASSERT_EQ(writer.num_dropped(), 0);
+  ASSERT_EQ(writer.num_failed(), 0);
+
+  std::shared_ptr<system::FileSystem> fs = system::Env::GetFileSystem();
+  const size_t header_size = 32;
+  for (size_t i = 0; i < num_files; i++) {
+    auto filename = "/tmp/dumpWriterTestFile" + std::to_string(i) + ".npy";
+    int fd = open(filename.c_str(), O_RDONLY);
+    std::vector<int> read_back(len + header_size);
+    auto read_size = read(fd, read_back.data(), read_back.size() * sizeof(int));
+    (void)close(fd);
+    ASSERT_EQ(read_size, read_back.size() * sizeof(int));
+    // The staging buffers are reused, each file keeps its own data.
+    ASSERT_EQ(read_back[header_size], i);
+    for (size_t j = 1; j < len; j++) {
+      ASSERT_EQ(read_back[header_size + j], data[j]);
+    }
+    if (fs->FileExist(filename)) {
+      fs->DeleteFile(filename);
+    }
+  }
+}
+
+TEST_F(TestMemoryDumper, test_DumpWriterDropWhenFull) {
+  const size_t len = 1000;
+  const size_t num_files = 16;
+  std::vector<int> data(len, 1);
+  DumpWriter writer(len * sizeof(int), 1, DumpWriter::DROP_WHEN_FULL);
+  for (size_t i = 0; i < num_files; i++) {
+    auto filename = "/tmp/dumpWriterDropTestFile" + std::to_string(i);
+    // A dropped tensor is not a failure.
+    ASSERT_TRUE(writer.Write(filename, data.data(), len * sizeof(int), ShapeVector{1000}, kNumberTypeInt32));
+  }
+  size_t num_accepted = writer.num_queued();
+  // A tensor larger than the staging buffers is written by the caller.
+  std::vector<int> large(2 * len, 1);
+  ASSERT_TRUE(writer.Write("/tmp/dumpWriterDropTestFileLarge", large.data(), large.size() * sizeof(int),
+                           ShapeVector{2000}, kNumberTypeInt32));
+  writer.Flush();
+  ASSERT_GE(num_accepted, 1);
+  ASSERT_EQ(writer.num_queued(), num_accepted);
+  ASSERT_EQ(writer.num_dropped(), num_files - num_accepted);
+  ASSERT_EQ(writer.num_written(), num_accepted + 1);
+  ASSERT_EQ(writer.num_blocked(), 0);
+
+  std::shared_ptr<system::FileSystem> fs = system::Env::GetFileSystem();
+  for (size_t i = 0; i < num_files; i++) {
+    auto filename = "/tmp/dumpWriterDropTestFile" + std::to_string(i) + ".npy";
+    if (fs->FileExist(filename)) {
+      fs->DeleteFile(filename);
+    }
+  }
+  if (fs->FileExist("/tmp/dumpWriterDropTestFileLarge.npy")) {
+    fs->DeleteFile("/tmp/dumpWriterDropTestFileLarge.npy");
+  }
+}
 }  // namespace mindspore
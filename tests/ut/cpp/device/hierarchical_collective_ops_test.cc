@@ -0,0 +1,288 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "common/common_test.h"
+#include "runtime/hardware/cpu/hierarchical_collective_ops.h"
+
+namespace mindspore::device::cpu {
+class TestHierarchicalCollectiveOps : public UT::Common {
+ public:
+  TestHierarchicalCollectiveOps() = default;
+};
+
+namespace {
+using fl::server::kCollectiveCommTimeout;
+
+// The messages in flight between the ranks of one test, queued for each pair of ranks.
+class MessageQueues {
+ public:
+  void Push(uint32_t from, uint32_t to, const void *data, size_t size) {
+    auto message = std::make_shared<std::vector<unsigned char>>(static_cast<const unsigned char *>(data),
+                                                                static_cast<const unsigned char *>(data) + size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    queues_[{from, to}].push_back(message);
+    cond_.notify_all();
+  }
+
+  bool Pop(uint32_t from, uint32_t to, std::shared_ptr<std::vector<unsigned char>> *message) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto &queue = queues_[{from, to}];
+    if (!cond_.wait_for(lock, std::chrono::seconds(kCollectiveCommTimeout), [&queue]() { return !queue.empty(); })) {
+      return false;
+    }
+    *message = queue.front();
+    queue.pop_front();
+    return true;
+  }
+
+  size_t num_pending() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t num = 0;
+    for (const auto &queue : queues_) {
+      num += queue.second.size();
+    }
+    return num;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::map<std::pair<uint32_t, uint32_t>, std::deque<std::shared_ptr<std::vector<unsigned char>>>> queues_;
+};
+
+class LocalTransport : public CollectiveTransport {
+ public:
+  LocalTransport(MessageQueues *queues, uint32_t rank_id, uint32_t rank_size)
+      : CollectiveTransport(rank_id, rank_size), queues_(queues) {}
+  ~LocalTransport() override = default;
+
+  uint64_t SendAsync(uint32_t rank_id, const void *data, size_t size) override {
+    queues_->Push(this->rank_id(), rank_id, data, size);
+    return ++num_sent_;
+  }
+
+  bool WaitSend(uint64_t request_id) override { return request_id > 0 && request_id <= num_sent_; }
+
+  bool ReceiveMessage(uint32_t rank_id, std::shared_ptr<std::vector<unsigned char>> *output) override {
+    return queues_->Pop(rank_id, this->rank_id(), output);
+  }
+
+ private:
+  MessageQueues *queues_;
+  uint64_t num_sent_{0};
+};
+
+// The global ranks on each host of a group of ranks 0 to n - 1, in the group order.
+using Hosts = std::vector<std::vector<uint32_t>>;
+using RankFunc = std::function<bool(CollectiveTransport *, const IntraHostGroup &)>;
+
+uint32_t RankSize(const Hosts &hosts) {
+  size_t rank_size = 0;
+  for (const auto &host : hosts) {
+    rank_size += host.size();
+  }
+  return static_cast<uint32_t>(rank_size);
+}
+
+// The group as seen by the rank, the hosts are led by their first rank.
+IntraHostGroup MakeIntraHostGroup(const Hosts &hosts, uint32_t rank) {
+  IntraHostGroup intra_host_group;
+  for (const auto &host : hosts) {
+    intra_host_group.leaders.push_back(host.front());
+    for (uint32_t local_rank : host) {
+      intra_host_group.rank_leaders[local_rank] = host.front();
+    }
+    if (std::find(host.begin(), host.end(), rank) != host.end()) {
+      intra_host_group.local_ranks = host;
+    }
+  }
+  std::sort(intra_host_group.leaders.begin(), intra_host_group.leaders.end());
+  return intra_host_group;
+}
+
+// Run func on a thread for each rank. With use_shm the local ranks set up their shared memory channels first,
+// otherwise all the messages go through the local transport.
+void RunRanks(const Hosts &hosts, bool use_shm, const RankFunc &func) {
+  static uint32_t run_id = 0;
+  std::string prefix = "/ms_ut_hierarchical_" + std::to_string(getpid()) + "_" + std::to_string(run_id++) + "_";
+  uint32_t rank_size = RankSize(hosts);
+  MessageQueues queues;
+  std::vector<char> success(rank_size, 0);
+  std::vector<size_t> num_channels(rank_size, 0);
+  std::vector<std::thread> threads;
+  for (uint32_t rank = 0; rank < rank_size; ++rank) {
+    threads.emplace_back([&, rank]() {
+      LocalTransport transport(&queues, rank, rank_size);
+      auto intra_host_group = MakeIntraHostGroup(hosts, rank);
+      if (use_shm) {
+        if (!HierarchicalCollectiveOps::InitShmChannels(&transport, prefix, &intra_host_group)) {
+          return;
+        }
+        num_channels[rank] = intra_host_group.send_channels.size();
+      } else {
+        intra_host_group.channels_initialized = true;
+      }
+      success[rank] = func(&transport, intra_host_group);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &host : hosts) {
+    for (uint32_t rank : host) {
+      ASSERT_TRUE(success[rank]) << "rank " << rank << ", use_shm " << use_shm;
+      if (use_shm) {
+        EXPECT_EQ(num_channels[rank], rank == host.front() ? host.size() - 1 : 1) << "rank " << rank;
+      }
+    }
+  }
+  EXPECT_EQ(queues.num_pending(), 0);
+}
+
+// Small integers, so that the float sums are exact.
+template <typename T>
+T Input(uint32_t rank, size_t i) {
+  return static_cast<T>((rank * 7 + i * 3) % 11);
+}
+
+const std::vector<Hosts> kHostsCases = {
+  {{0, 1, 2, 3}}, {{0, 2, 4}, {1, 3}}, {{0}, {1}, {2}}, {{0, 3}, {1, 4}, {2, 5}}};
+
+template <typename T>
+void CheckAllReduce(const Hosts &hosts, bool use_shm, size_t count) {
+  uint32_t rank_size = RankSize(hosts);
+  std::vector<std::vector<T>> outputs(rank_size, std::vector<T>(count));
+  RunRanks(hosts, use_shm, [&](CollectiveTransport *transport, const IntraHostGroup &intra_host_group) {
+    uint32_t rank = transport->rank_id();
+    std::vector<T> input(count);
+    for (size_t i = 0; i < count; ++i) {
+      input[i] = Input<T>(rank, i);
+    }
+    return HierarchicalCollectiveOps::AllReduce<T>(transport, intra_host_group, input.data(), outputs[rank].data(),
+                                                   count);
+  });
+  for (uint32_t rank = 0; rank < rank_size; ++rank) {
+    for (size_t i = 0; i < count; ++i) {
+      T expected = 0;
+      for (uint32_t src = 0; src < rank_size; ++src) {
+        expected += Input<T>(src, i);
+      }
+      ASSERT_EQ(outputs[rank][i], expected) << "count " << count << ", rank " << rank << ", index " << i;
+    }
+  }
+}
+
+template <typename T>
+void CheckBroadcast(const Hosts &hosts, bool use_shm, size_t count, uint32_t root) {
+  uint32_t rank_size = RankSize(hosts);
+  std::vector<std::vector<T>> outputs(rank_size, std::vector<T>(count));
+  RunRanks(hosts, use_shm, [&](CollectiveTransport *transport, const IntraHostGroup &intra_host_group) {
+    uint32_t rank = transport->rank_id();
+    std::vector<T> input(count);
+    for (size_t i = 0; i < count; ++i) {
+      input[i] = Input<T>(rank, i);
+    }
+    return HierarchicalCollectiveOps::Broadcast<T>(transport, intra_host_group, input.data(), outputs[rank].data(),
+                                                   count, root);
+  });
+  for (uint32_t rank = 0; rank < rank_size; ++rank) {
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_EQ(outputs[rank][i], Input<T>(root, i)) << "root " << root << ", rank " << rank << ", index " << i;
+    }
+  }
+}
+}  // namespace
+
+/// Feature: Hierarchical collectives of MsCollectiveCommLib
+/// Description: AllReduce on one host, on hosts of interleaved ranks, on hosts of one rank, through shared memory
+/// or the transport, with messages larger than the ring of a channel
+/// Expectation: Every rank gets the sum of all the ranks, no message is left unread
+TEST_F(TestHierarchicalCollectiveOps, test_hierarchical_all_reduce) {
+  const size_t large_count = kShmChannelCapacity / sizeof(float) + 1001;
+  for (const auto &hosts : kHostsCases) {
+    for (bool use_shm : {false, true}) {
+      for (size_t count : {static_cast<size_t>(1), static_cast<size_t>(1001), large_count}) {
+        CheckAllReduce<float>(hosts, use_shm, count);
+      }
+      CheckAllReduce<int>(hosts, use_shm, 1001);
+    }
+  }
+}
+
+/// Feature: Hierarchical collectives of MsCollectiveCommLib
+/// Description: Broadcast from every rank, leader or not, on one or several hosts
+/// Expectation: Every rank gets the data of the root, no message is left unread
+TEST_F(TestHierarchicalCollectiveOps, test_hierarchical_broadcast) {
+  for (const auto &hosts : kHostsCases) {
+    for (bool use_shm : {false, true}) {
+      for (uint32_t root = 0; root < RankSize(hosts); ++root) {
+        CheckBroadcast<float>(hosts, use_shm, 1001, root);
+      }
+      CheckBroadcast<uint64_t>(hosts, use_shm, 1, RankSize(hosts) - 1);
+    }
+  }
+}
+
+/// Feature: Hierarchical collectives of MsCollectiveCommLib
+/// Description: AllGather of a group on one host, through shared memory or the transport
+/// Expectation: Every rank gets the data of all the ranks in the group order, a group on several hosts is refused
+TEST_F(TestHierarchicalCollectiveOps, test_intra_host_all_gather) {
+  const Hosts hosts = {{0, 1, 2, 3}};
+  const uint32_t rank_size = RankSize(hosts);
+  for (bool use_shm : {false, true}) {
+    for (size_t count : {static_cast<size_t>(1), static_cast<size_t>(1001)}) {
+      std::vector<std::vector<int32_t>> outputs(rank_size, std::vector<int32_t>(count * rank_size));
+      RunRanks(hosts, use_shm, [&](CollectiveTransport *transport, const IntraHostGroup &intra_host_group) {
+        uint32_t rank = transport->rank_id();
+        std::vector<int32_t> input(count);
+        for (size_t i = 0; i < count; ++i) {
+          input[i] = Input<int32_t>(rank, i);
+        }
+        return HierarchicalCollectiveOps::AllGather<int32_t>(transport, intra_host_group, input.data(),
+                                                             outputs[rank].data(), count);
+      });
+      for (uint32_t rank = 0; rank < rank_size; ++rank) {
+        for (uint32_t src = 0; src < rank_size; ++src) {
+          for (size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(outputs[rank][src * count + i], Input<int32_t>(src, i)) << "rank " << rank << ", src " << src;
+          }
+        }
+      }
+    }
+  }
+
+  MessageQueues queues;
+  LocalTransport transport(&queues, 0, 4);
+  auto intra_host_group = MakeIntraHostGroup({{0, 2}, {1, 3}}, 0);
+  intra_host_group.channels_initialized = true;
+  int32_t input = 0;
+  std::vector<int32_t> output(4);
+  EXPECT_FALSE(HierarchicalCollectiveOps::AllGather<int32_t>(&transport, intra_host_group, &input, output.data(), 1));
+}
+}  // namespace mindspore::device::cpu
@@ -0,0 +1,120 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "runtime/hardware/cpu/shm_channel.h"
+
+namespace mindspore::device::cpu {
+class TestShmChannel : public UT::Common {
+ public:
+  TestShmChannel() : name_("/ms_ut_shm_channel_" + std::to_string(getpid())) {}
+
+ protected:
+  std::string name_;
+};
+
+/// Feature: ShmChannel
+/// Description: Stream messages smaller and larger than the ring from another thread
+/// Expectation: The messages are received in order and intact, the float pieces don't split an element
+TEST_F(TestShmChannel, test_shm_channel_send_receive) {
+  constexpr size_t kCapacity = 4096;
+  auto receiver = ShmChannel::Create(name_, kCapacity);
+  ASSERT_NE(receiver, nullptr);
+  auto sender = ShmChannel::Open(name_);
+  ASSERT_NE(sender, nullptr);
+  receiver->Unlink();
+
+  std::vector<size_t> sizes = {1, 63, 64, 1000, kCapacity, kCapacity * 10 + 3};
+  std::thread send_thread([&sender, &sizes]() {
+    for (size_t size : sizes) {
+      std::vector<uint8_t> data(size);
+      for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(i * 7 + size);
+      }
+      EXPECT_TRUE(sender->Send(data.data(), size, 10));
+    }
+    std::vector<float> floats(kCapacity);
+    for (size_t i = 0; i < floats.size(); ++i) {
+      floats[i] = static_cast<float>(i);
+    }
+    EXPECT_TRUE(sender->Send(floats.data(), floats.size() * sizeof(float), 10));
+  });
+  for (size_t size : sizes) {
+    std::vector<uint8_t> data(size);
+    ASSERT_TRUE(receiver->Receive(data.data(), size, 10));
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_EQ(data[i], static_cast<uint8_t>(i * 7 + size));
+    }
+  }
+  std::vector<float> sums(kCapacity, 1.0);
+  ASSERT_TRUE(receiver->Receive(
+    sums.size() * sizeof(float),
+    [&sums](const uint8_t *data, size_t offset, size_t len) {
+      ASSERT_EQ(offset % sizeof(float), 0);
+      ASSERT_EQ(len % sizeof(float), 0);
+      auto floats = reinterpret_cast<const float *>(data);
+      for (size_t i = 0; i < len / sizeof(float); ++i) {
+        sums[offset / sizeof(float) + i] += floats[i];
+      }
+    },
+    10));
+  send_thread.join();
+  for (size_t i = 0; i < sums.size(); ++i) {
+    ASSERT_EQ(sums[i], static_cast<float>(i) + 1);
+  }
+}
+
+/// Feature: ShmChannel
+/// Description: Receive from a channel nobody sends to, send to a full channel nobody receives from
+/// Expectation: Both time out
+TEST_F(TestShmChannel, test_shm_channel_timeout) {
+  constexpr size_t kCapacity = 1024;
+  auto receiver = ShmChannel::Create(name_, kCapacity);
+  ASSERT_NE(receiver, nullptr);
+  auto sender = ShmChannel::Open(name_);
+  ASSERT_NE(sender, nullptr);
+
+  uint8_t byte = 0;
+  EXPECT_FALSE(receiver->Receive(&byte, sizeof(byte), 1));
+  std::vector<uint8_t> data(kCapacity * 2);
+  EXPECT_FALSE(sender->Send(data.data(), data.size(), 1));
+}
+
+/// Feature: ShmChannel
+/// Description: Create a channel of a name that another channel holds, then again after the name is unlinked
+/// Expectation: The taken name is refused and the first channel still works, the name is free after the unlink
+TEST_F(TestShmChannel, test_shm_channel_name_taken) {
+  constexpr size_t kCapacity = 1024;
+  auto receiver = ShmChannel::Create(name_, kCapacity);
+  ASSERT_NE(receiver, nullptr);
+  EXPECT_EQ(ShmChannel::Create(name_, kCapacity), nullptr);
+  auto sender = ShmChannel::Open(name_);
+  ASSERT_NE(sender, nullptr);
+  uint8_t byte = 1;
+  ASSERT_TRUE(sender->Send(&byte, sizeof(byte), 1));
+  byte = 0;
+  ASSERT_TRUE(receiver->Receive(&byte, sizeof(byte), 1));
+  EXPECT_EQ(byte, 1);
+
+  receiver->Unlink();
+  auto other = ShmChannel::Create(name_, kCapacity);
+  EXPECT_NE(other, nullptr);
+}
+}  // namespace mindspore::device::cpu
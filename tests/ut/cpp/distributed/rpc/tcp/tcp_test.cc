@@ -16,10 +16,18 @@
 
 #include <sys/resource.h>
 #include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
 #include <atomic>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 #include <csignal>
 
 #include <gtest/gtest.h>
@@ -27,6 +35,7 @@
 #include "actor/iomgr.h"
 #include "async/async.h"
 #include "distributed/rpc/tcp/tcp_comm.h"
+#include "distributed/rpc/tcp/connection_pool.h"
 #include "common/common_test.h"
 
 namespace mindspore {
@@ -34,6 +43,7 @@ namespace distributed {
 namespace rpc {
 int g_recv_num = 0;
 int g_exit_msg_num = 0;
+size_t g_recv_body_size = 0;
 
 TCPComm *m_io = nullptr;
 std::atomic<int> m_sendNum(0);
@@ -44,10 +54,91 @@ void msgHandle(std::unique_ptr<MessageBase> &&msg) {
   if (msg->GetType() == MessageBase::Type::KEXIT) {
     g_exit_msg_num++;
   } else {
+    g_recv_body_size += msg->body.size();
     g_recv_num++;
   }
 }
 
+// A message which tells when it is destroyed.
+class TrackedMessage : public MessageBase {
+ public:
+  TrackedMessage(size_t body_size, std::atomic<bool> *destroyed) : destroyed_(destroyed) {
+    body.assign(body_size, 'B');
+  }
+  ~TrackedMessage() override { *destroyed_ = true; }
+
+ private:
+  std::atomic<bool> *destroyed_;
+};
+
+// A bare TCP server which counts the bytes it receives.
+class ByteSink {
+ public:
+  ~ByteSink() { Stop(); }
+
+  bool Start(const std::string &ip, uint16_t port) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+      return false;
+    }
+    int on = 1;
+    (void)setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1 ||
+        bind(listen_fd_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0 || listen(listen_fd_, 1) != 0) {
+      return false;
+    }
+    thread_ = std::thread([this]() { Run(); });
+    return true;
+  }
+
+  void Stop() {
+    stop_ = true;
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+      (void)close(listen_fd_);
+      listen_fd_ = -1;
+    }
+  }
+
+  size_t received() const { return received_; }
+
+ private:
+  void Run() {
+    int conn_fd = -1;
+    char buf[4096];
+    while (!stop_) {
+      struct pollfd event = {conn_fd >= 0 ? conn_fd : listen_fd_, POLLIN, 0};
+      if (poll(&event, 1, 100) <= 0) {
+        continue;
+      }
+      if (conn_fd < 0) {
+        conn_fd = accept(listen_fd_, nullptr, nullptr);
+        continue;
+      }
+      ssize_t len = read(conn_fd, buf, sizeof(buf));
+      if (len <= 0) {
+        (void)close(conn_fd);
+        conn_fd = -1;
+        continue;
+      }
+      received_ += static_cast<size_t>(len);
+    }
+    if (conn_fd >= 0) {
+      (void)close(conn_fd);
+    }
+  }
+
+  int listen_fd_{-1};
+  std::atomic<bool> stop_{false};
+  std::atomic<size_t> received_{0};
+  std::thread thread_;
+};
+
 class TCPTest : public UT::Common {
  public:
   static void SendMsg(std::string &_localUrl, std::string &_remoteUrl, int msgsize, bool remoteLink = false,
@@ -82,6 +173,7 @@ class TCPTest : public UT::Common {
     }
     g_recv_num = 0;
     g_exit_msg_num = 0;
+    g_recv_body_size = 0;
     m_sendNum = 0;
 
     m_io = new TCPComm();
@@ -257,6 +349,184 @@ TEST_F(TCPTest, send1Msg) {
   shutdownTcpServer(pid1);
   pid1 = 0;
 }
+
+/// Feature: test sending messages in batches and with zero copy.
+/// Description: send many small messages at once and a large message, which may be sent with MSG_ZEROCOPY.
+/// Expectation: the server received all the messages and bodies, the large message is released after sent.
+TEST_F(TCPTest, SendBatchAndLargeBody) {
+  std::string from = "tcp://" + m_localIP + ":2223";
+  std::string to = "tcp://" + m_localIP + ":2225";
+  const int msg_num = 200;
+  const int msg_size = 100;
+  for (int i = 0; i < msg_num; ++i) {
+    SendMsg(from, to, msg_size);
+  }
+
+  const size_t large_size = 4 * 1024 * 1024;
+  std::atomic<bool> destroyed(false);
+  auto message = std::make_unique<TrackedMessage>(large_size, &destroyed);
+  message->name = "testname";
+  message->from = AID("testserver", from);
+  message->to = AID("testserver", to);
+  m_io->Send(std::move(message));
+
+  bool ret = CheckRecvNum(msg_num + 1, 5);
+  ASSERT_TRUE(ret);
+  ASSERT_EQ(g_recv_body_size, msg_num * msg_size + large_size);
+  // The message may be kept until the next send finds that the kernel is done with its pages.
+  SendMsg(from, to, msg_size);
+  for (int i = 0; i < 50 && !destroyed; ++i) {
+    usleep(100000);
+  }
+  ASSERT_TRUE(destroyed);
+  ASSERT_TRUE(CheckRecvNum(msg_num + 2, 5));
+
+  Unlink(to);
+}
+
+/// Feature: test sending through several event loops.
+/// Description: send messages from several threads at once to two destinations owned by different event loops, then
+/// unlink one of them, whose accepted connection is owned by another event loop than the one running the unlink.
+/// Expectation: all the messages are received, the event loops counted the bytes received and sent, both connections
+/// of the unlinked destination are closed and the other destination still receives.
+TEST_F(TCPTest, SendThroughEventLoops) {
+  const size_t loop_num = 4;
+  (void)setenv("LITERPC_EVENT_LOOP_NUM", std::to_string(loop_num).c_str(), 1);
+  std::unique_ptr<TCPComm> io = std::make_unique<TCPComm>();
+  bool ret = io->Initialize();
+  (void)unsetenv("LITERPC_EVENT_LOOP_NUM");
+  ASSERT_TRUE(ret);
+  ASSERT_EQ(io->GetEventLoopMetrics().size(), loop_num);
+
+  // The sink is not a TCPComm, whose accepted connections would be pooled under the same advertised url.
+  ByteSink sink;
+  std::string sink_url = "tcp://" + m_localIP + ":2227";
+  ASSERT_TRUE(sink.Start(m_localIP, 2227));
+
+  // Choose the port of the server so that the connections to it and to the sink are owned by different event loops.
+  EventLoop *sink_loop = io->GetEventLoop(AID("testserver", sink_url).Url());
+  std::string url;
+  for (int port = 2228; port < 2260 && url.empty(); ++port) {
+    std::string candidate = "tcp://" + m_localIP + ":" + std::to_string(port);
+    if (io->GetEventLoop(AID("testserver", candidate).Url()) != sink_loop) {
+      url = candidate;
+    }
+  }
+  ASSERT_FALSE(url.empty());
+  ASSERT_TRUE(io->StartServerSocket(url, url));
+
+  const int thread_num = 4;
+  const int msg_num = 500;
+  const int msg_size = 100;
+  auto send = [&io, &url](const std::string &to, int num) {
+    for (int i = 0; i < num; ++i) {
+      auto message = std::make_unique<MessageBase>();
+      message->name = "testname";
+      message->from = AID("testserver", url);
+      message->to = AID("testserver", to);
+      message->body = std::string(msg_size, 'A');
+      io->Send(std::move(message));
+    }
+  };
+  auto check_sink = [&sink](size_t expected_size) {
+    for (int i = 0; i < 50 && sink.received() < expected_size; ++i) {
+      usleep(100000);
+    }
+    return sink.received() >= expected_size;
+  };
+  auto check_closed = [](int fd1, int fd2) {
+    for (int i = 0; i < 50 && (fcntl(fd1, F_GETFD) != -1 || fcntl(fd2, F_GETFD) != -1); ++i) {
+      usleep(100000);
+    }
+    return fcntl(fd1, F_GETFD) == -1 && fcntl(fd2, F_GETFD) == -1;
+  };
+  // Connect first, the messages queued while connecting are limited.
+  send(sink_url, 1);
+  ASSERT_TRUE(check_sink(msg_size));
+
+  // The connection the server accepts is owned by the event loop of its fd. Connect again with one more fd held until
+  // that is another event loop than the one of the connection to the server, for the unlink across the loops below.
+  AID to("testserver", url);
+  std::string key = to.Url();
+  int url_msg_num = 0;
+  int conn_fd = -1;
+  int accepted_fd = -1;
+  std::vector<int> held_fds;
+  for (size_t i = 0; i < loop_num; ++i) {
+    send(url, 1);
+    ASSERT_TRUE(CheckRecvNum(++url_msg_num, 5));
+    bool same_loop = false;
+    int fd = -1;
+    {
+      std::lock_guard<std::mutex> lock(Connection::conn_mutex);
+      Connection *conn = ConnectionPool::GetConnectionPool()->ExactFindConnection(key, false);
+      Connection *accepted = ConnectionPool::GetConnectionPool()->ExactFindConnection(key, true);
+      ASSERT_NE(conn, nullptr);
+      ASSERT_NE(accepted, nullptr);
+      ASSERT_EQ(conn->recv_event_loop, io->GetEventLoop(key));
+      same_loop = accepted->recv_event_loop == conn->recv_event_loop;
+      conn_fd = conn->socket_fd;
+      fd = accepted->socket_fd;
+    }
+    if (!same_loop) {
+      accepted_fd = fd;
+      break;
+    }
+    io->UnLink(to);
+    ASSERT_TRUE(check_closed(conn_fd, fd));
+    held_fds.push_back(socket(AF_INET, SOCK_STREAM, 0));
+    ASSERT_GE(held_fds.back(), 0);
+  }
+  ASSERT_GE(accepted_fd, 0);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back(send, i % 2 == 0 ? url : sink_url, msg_num);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  url_msg_num += (thread_num + 1) / 2 * msg_num;
+  const size_t sink_msg_num = thread_num / 2 * msg_num + 1;
+  ASSERT_TRUE(CheckRecvNum(url_msg_num, 5));
+  ASSERT_TRUE(check_sink(sink_msg_num * msg_size));
+
+  uint64_t handled_tasks = 0;
+  uint64_t recv_bytes = 0;
+  uint64_t send_bytes = 0;
+  for (const auto &metrics : io->GetEventLoopMetrics()) {
+    handled_tasks += metrics.handled_tasks;
+    recv_bytes += metrics.recv_bytes;
+    send_bytes += metrics.send_bytes;
+  }
+  ASSERT_GE(handled_tasks, thread_num * msg_num);
+  ASSERT_GE(recv_bytes, url_msg_num * msg_size);
+  ASSERT_GE(send_bytes, (url_msg_num + sink_msg_num) * msg_size);
+  io->CollectMetrics();
+
+  // The unlink runs in the event loop of the url, which hangs up the accepted connection for its own loop to close.
+  io->UnLink(to);
+  ASSERT_TRUE(check_closed(conn_fd, accepted_fd));
+  {
+    std::lock_guard<std::mutex> lock(Connection::conn_mutex);
+    ASSERT_EQ(ConnectionPool::GetConnectionPool()->ExactFindConnection(key, false), nullptr);
+    ASSERT_EQ(ConnectionPool::GetConnectionPool()->ExactFindConnection(key, true), nullptr);
+  }
+
+  // The connection to the sink is left alone, the url is connected again on the next message.
+  send(sink_url, msg_num);
+  ASSERT_TRUE(check_sink((sink_msg_num + msg_num) * msg_size));
+  send(url, 1);
+  ASSERT_TRUE(CheckRecvNum(url_msg_num + 1, 5));
+
+  io->UnLink(to);
+  usleep(100000);
+  io->Finalize();
+  sink.Stop();
+  for (int fd : held_fds) {
+    (void)close(fd);
+  }
+}
 }  // namespace rpc
 }  // namespace distributed
 }  // namespace mindspore
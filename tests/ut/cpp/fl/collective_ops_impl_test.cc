@@ -0,0 +1,192 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "common/common_test.h"
+#include "fl/server/collective_ops_impl.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+class TestCollectiveOpsImpl : public UT::Common {
+ public:
+  TestCollectiveOpsImpl() = default;
+  virtual ~TestCollectiveOpsImpl() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+namespace {
+// The messages in flight between the ranks of one test, queued for each pair of ranks.
+class MessageQueues {
+ public:
+  void Push(uint32_t from, uint32_t to, const void *data, size_t size) {
+    auto message = std::make_shared<std::vector<unsigned char>>(static_cast<const unsigned char *>(data),
+                                                                static_cast<const unsigned char *>(data) + size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    queues_[{from, to}].push_back(message);
+    cond_.notify_all();
+  }
+
+  bool Pop(uint32_t from, uint32_t to, std::shared_ptr<std::vector<unsigned char>> *message) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto &queue = queues_[{from, to}];
+    if (!cond_.wait_for(lock, std::chrono::seconds(kCollectiveCommTimeout), [&queue]() { return !queue.empty(); })) {
+      return false;
+    }
+    *message = queue.front();
+    queue.pop_front();
+    return true;
+  }
+
+  size_t num_pending() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t num = 0;
+    for (const auto &queue : queues_) {
+      num += queue.second.size();
+    }
+    return num;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::map<std::pair<uint32_t, uint32_t>, std::deque<std::shared_ptr<std::vector<unsigned char>>>> queues_;
+};
+
+class LocalTransport : public CollectiveTransport {
+ public:
+  LocalTransport(MessageQueues *queues, uint32_t rank_id, uint32_t rank_size)
+      : CollectiveTransport(rank_id, rank_size), queues_(queues) {}
+  ~LocalTransport() override = default;
+
+  uint64_t SendAsync(uint32_t rank_id, const void *data, size_t size) override {
+    queues_->Push(this->rank_id(), rank_id, data, size);
+    return ++num_sent_;
+  }
+
+  bool WaitSend(uint64_t request_id) override { return request_id > 0 && request_id <= num_sent_; }
+
+  bool ReceiveMessage(uint32_t rank_id, std::shared_ptr<std::vector<unsigned char>> *output) override {
+    return queues_->Pop(rank_id, this->rank_id(), output);
+  }
+
+ private:
+  MessageQueues *queues_;
+  uint64_t num_sent_{0};
+};
+
+using AllReduceFunc = std::function<bool(CollectiveTransport *, const void *, void *, size_t)>;
+
+// Run the AllReduce on rank_size threads. The inputs are small integers so that the float sums are exact.
+template <typename T>
+void CheckAllReduce(const AllReduceFunc &all_reduce, uint32_t rank_size, size_t count) {
+  auto input = [](uint32_t rank, size_t i) { return static_cast<T>((rank * 7 + i * 3) % 11); };
+  std::vector<std::vector<T>> inputs(rank_size, std::vector<T>(count));
+  std::vector<std::vector<T>> outputs(rank_size, std::vector<T>(count));
+  for (uint32_t rank = 0; rank < rank_size; ++rank) {
+    for (size_t i = 0; i < count; ++i) {
+      inputs[rank][i] = input(rank, i);
+    }
+  }
+  MessageQueues queues;
+  std::vector<char> success(rank_size, 0);
+  std::vector<std::thread> threads;
+  for (uint32_t rank = 0; rank < rank_size; ++rank) {
+    threads.emplace_back([&, rank]() {
+      LocalTransport transport(&queues, rank, rank_size);
+      success[rank] = all_reduce(&transport, inputs[rank].data(), outputs[rank].data(), count);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (uint32_t rank = 0; rank < rank_size; ++rank) {
+    ASSERT_TRUE(success[rank]) << "rank_size " << rank_size << ", count " << count << ", rank " << rank;
+    for (size_t i = 0; i < count; ++i) {
+      T expected = 0;
+      for (uint32_t src = 0; src < rank_size; ++src) {
+        expected += input(src, i);
+      }
+      ASSERT_EQ(outputs[rank][i], expected) << "rank_size " << rank_size << ", count " << count << ", rank " << rank
+                                            << ", index " << i;
+    }
+  }
+  EXPECT_EQ(queues.num_pending(), 0);
+}
+}  // namespace
+
+/// Feature: Server collective communication.
+/// Description: Run the pipelined ring AllReduce among 2 to 7 ranks, with counts that split neither into the ranks
+/// nor into the pipeline pieces.
+/// Expectation: Every rank gets the sum of all the ranks, no message is left unread.
+TEST_F(TestCollectiveOpsImpl, RingAllReduce) {
+  const size_t piece_count = kRingPipelinePieceBytes / sizeof(float);
+  for (uint32_t rank_size = 2; rank_size <= 7; ++rank_size) {
+    for (size_t count : {static_cast<size_t>(rank_size), 2 * static_cast<size_t>(rank_size) + 1,
+                         static_cast<size_t>(1001)}) {
+      CheckAllReduce<float>(CollectiveOpsImpl::RingAllReduce<float>, rank_size, count);
+    }
+  }
+  // The chunks of the ranks are of one and a half pieces.
+  for (uint32_t rank_size : {3, 5}) {
+    CheckAllReduce<float>(CollectiveOpsImpl::RingAllReduce<float>, rank_size, rank_size * piece_count * 3 / 2 + 7);
+    CheckAllReduce<int>(CollectiveOpsImpl::RingAllReduce<int>, rank_size, piece_count + 3);
+  }
+}
+
+/// Feature: Server collective communication.
+/// Description: Run the recursive halving and doubling AllReduce among 2 to 7 ranks, the ranks beyond a power of two
+/// are folded into their neighbours, the counts are not a multiple of the rank size.
+/// Expectation: Every rank gets the sum of all the ranks, no message is left unread.
+TEST_F(TestCollectiveOpsImpl, HalvingDoublingAllReduce) {
+  for (uint32_t rank_size = 2; rank_size <= 7; ++rank_size) {
+    for (size_t count : {static_cast<size_t>(1), static_cast<size_t>(rank_size) + 1, static_cast<size_t>(1001),
+                         static_cast<size_t>(60013)}) {
+      CheckAllReduce<float>(CollectiveOpsImpl::HalvingDoublingAllReduce<float>, rank_size, count);
+      CheckAllReduce<int>(CollectiveOpsImpl::HalvingDoublingAllReduce<int>, rank_size, count);
+    }
+  }
+}
+
+/// Feature: Server collective communication.
+/// Description: AllReduce messages smaller than the rank size, below and above the halving and doubling limit.
+/// Expectation: Every rank gets the sum of all the ranks whichever algorithm is chosen.
+TEST_F(TestCollectiveOpsImpl, AllReduceBySize) {
+  const size_t halving_doubling_count = kHalvingDoublingMaxBytes / sizeof(float);
+  for (uint32_t rank_size : {3, 5, 8}) {
+    for (size_t count : {static_cast<size_t>(rank_size) - 1, halving_doubling_count - 1, halving_doubling_count + 1}) {
+      CheckAllReduce<float>(
+        [](CollectiveTransport *transport, const void *sendbuff, void *recvbuff, size_t size) {
+          return CollectiveOpsImpl::AllReduce<float>(transport, sendbuff, recvbuff, size);
+        },
+        rank_size, count);
+    }
+  }
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
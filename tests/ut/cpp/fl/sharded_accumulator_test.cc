@@ -0,0 +1,123 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "fl/server/kernel/sharded_accumulator.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace kernel {
+class TestShardedAccumulator : public UT::Common {
+ public:
+  TestShardedAccumulator() = default;
+  virtual ~TestShardedAccumulator() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+namespace {
+// Each client uploads its weight a few times, the sums are small integers so that the float sums are exact.
+template <typename T, typename AddFunc>
+double RunClients(size_t num_clients, size_t num_uploads, size_t count, std::vector<T> *weight, const AddFunc &add) {
+  std::vector<std::vector<T>> client_weights;
+  for (size_t client = 0; client < num_clients; ++client) {
+    client_weights.emplace_back(count, static_cast<T>(client + 1));
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> clients;
+  for (size_t client = 0; client < num_clients; ++client) {
+    clients.emplace_back([&, client]() {
+      for (size_t i = 0; i < num_uploads; ++i) {
+        add(weight->data(), client_weights[client].data());
+      }
+    });
+  }
+  for (auto &client : clients) {
+    client.join();
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}  // namespace
+
+/// Feature: Federated average aggregation.
+/// Description: Clients add their weights into a weight of several shards at the same time.
+/// Expectation: The weight is the sum of all the uploads, including the last partial shard.
+TEST_F(TestShardedAccumulator, AddFromClients) {
+  const size_t count = 3 * kAccumulateShardSize + 7;
+  const size_t num_clients = 8;
+  const size_t num_uploads = 4;
+  ShardedAccumulator<float> accumulator;
+  accumulator.Init(count);
+  EXPECT_EQ(accumulator.num_shards(), 4);
+  std::vector<float> weight(count, 0);
+  (void)RunClients<float>(num_clients, num_uploads, count, &weight,
+                          [&accumulator](float *dst, const float *src) { accumulator.Add(dst, src); });
+  const float expected = num_uploads * num_clients * (num_clients + 1) / 2;
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(weight[i], expected);
+  }
+
+  ShardedAccumulator<size_t> size_accumulator;
+  size_accumulator.Init(count);
+  std::vector<size_t> size_weight(count, 0);
+  (void)RunClients<size_t>(num_clients, num_uploads, count, &size_weight,
+                           [&size_accumulator](size_t *dst, const size_t *src) { size_accumulator.Add(dst, src); });
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(size_weight[i], expected);
+  }
+}
+
+/// Feature: Federated average aggregation.
+/// Description: Microbenchmark of many clients adding into a large weight, with the sharded accumulator and with a
+/// single lock over a scalar loop as the kernel did before.
+/// Expectation: Both give the same weight, the times are logged.
+TEST_F(TestShardedAccumulator, ThroughputWithClients) {
+  const size_t count = 1 << 20;
+  const size_t num_clients = 32;
+  const size_t num_uploads = 4;
+
+  std::mutex weight_mutex;
+  std::vector<float> locked_weight(count, 0);
+  double locked_ms = RunClients<float>(num_clients, num_uploads, count, &locked_weight,
+                                       [&weight_mutex, count](float *dst, const float *src) {
+                                         std::lock_guard<std::mutex> lock(weight_mutex);
+                                         for (size_t i = 0; i < count; ++i) {
+                                           dst[i] += src[i];
+                                         }
+                                       });
+
+  ShardedAccumulator<float> accumulator;
+  accumulator.Init(count);
+  std::vector<float> sharded_weight(count, 0);
+  double sharded_ms = RunClients<float>(num_clients, num_uploads, count, &sharded_weight,
+                                        [&accumulator](float *dst, const float *src) { accumulator.Add(dst, src); });
+
+  MS_LOG(INFO) << num_clients << " clients uploading " << num_uploads << " times a weight of " << count
+               << " floats, single lock: " << locked_ms << " ms, " << accumulator.num_shards()
+               << " shards: " << sharded_ms << " ms";
+  EXPECT_EQ(locked_weight, sharded_weight);
+}
+}  // namespace kernel
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
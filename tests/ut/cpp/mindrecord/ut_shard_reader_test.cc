@@ -243,5 +243,37 @@ TEST_F(TestShardReader, TestShardReaderConsumer) {
   }
   dataset.Close();
 }
+
+TEST_F(TestShardReader, TestShardReaderMmap) {
+  MS_LOG(INFO) << common::SafeCStr(FormatInfo("Test read imageNet by mapped files"));
+  std::string file_name = "./imagenet.shard01";
+  auto column_list = std::vector<std::string>{"file_name", "data"};
+
+  auto read_all = [&file_name, &column_list]() {
+    std::vector<std::tuple<std::vector<uint8_t>, json>> rows;
+    ShardReader dataset;
+    EXPECT_TRUE(dataset.Open({file_name}, true, 4, column_list).IsOk());
+    EXPECT_TRUE(dataset.Launch().IsOk());
+    while (true) {
+      auto x = dataset.GetNext();
+      if (x.empty()) break;
+      rows.insert(rows.end(), x.begin(), x.end());
+    }
+    dataset.Close();
+    return rows;
+  };
+
+  auto stream_rows = read_all();
+  setenv("MS_MINDRECORD_READ_MODE", "mmap", 1);
+  auto mmap_rows = read_all();
+  unsetenv("MS_MINDRECORD_READ_MODE");
+
+  ASSERT_FALSE(stream_rows.empty());
+  ASSERT_EQ(stream_rows.size(), mmap_rows.size());
+  for (size_t i = 0; i < stream_rows.size(); ++i) {
+    EXPECT_EQ(std::get<0>(stream_rows[i]), std::get<0>(mmap_rows[i]));
+    EXPECT_EQ(std::get<1>(stream_rows[i]), std::get<1>(mmap_rows[i]));
+  }
+}
 }  // namespace mindrecord
 }  // namespace mindspore
@@ -0,0 +1,116 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdlib>
+#include <vector>
+#include "backend/optimizer/mem_reuse/mem_dynamic_allocator.h"
+#include "common/common_test.h"
+
+namespace mindspore {
+namespace device {
+// The memory pool on host memory, which holds at most one memory block of kHostMemSize.
+class HostMemoryPool : public DynamicMemPoolBestFit {
+ public:
+  static constexpr size_t kHostMemSize = 16 << 20;
+  HostMemoryPool() { SetMemAllocUintSize(kHostMemSize, kHostMemSize); }
+  ~HostMemoryPool() override { ReleaseDeviceRes(); }
+
+  size_t AllocDeviceMem(size_t size, DeviceMemPtr *addr) override {
+    *addr = malloc(size);
+    used_size_ += size;
+    return size;
+  }
+  bool FreeDeviceMem(const DeviceMemPtr &addr) override {
+    free(addr);
+    return true;
+  }
+  size_t free_mem_size() override { return kHostMemSize - used_size_; }
+
+ private:
+  size_t used_size_{0};
+};
+
+class TestMemDynamicAllocator : public UT::Common {
+ public:
+  TestMemDynamicAllocator() {}
+};
+
+/// Feature: size class cache of dynamic memory pool.
+/// Description: free and alloc the memory of the same size with the cache enabled.
+/// Expectation: the freed memory is reused without being combined, and is combined when the memory runs out.
+TEST_F(TestMemDynamicAllocator, test_mem_cache) {
+  HostMemoryPool pool;
+  pool.SetMemCacheSize(1 << 20);
+  constexpr size_t kSmallSize = 1000;
+  auto addr = pool.AllocTensorMem(kSmallSize);
+  ASSERT_NE(addr, nullptr);
+  pool.FreeTensorMem(addr);
+  auto report = pool.MemPoolReport();
+  ASSERT_EQ(report.used_mem_size_, 0);
+  ASSERT_EQ(report.cached_mem_size_, 1024);
+  ASSERT_EQ(pool.AllocTensorMem(kSmallSize), addr);
+  ASSERT_EQ(pool.MemPoolReport().cached_mem_size_, 0);
+  pool.FreeTensorMem(addr);
+
+  // The memory buf bigger than the cache limit is combined at once.
+  auto big_addr = pool.AllocTensorMem(2 << 20);
+  ASSERT_NE(big_addr, nullptr);
+  pool.FreeTensorMem(big_addr);
+  ASSERT_EQ(pool.MemPoolReport().cached_mem_size_, 1024);
+
+  // The whole block can only be allocated after the cached memory buf is combined.
+  auto whole_addr = pool.AllocTensorMem(HostMemoryPool::kHostMemSize);
+  ASSERT_NE(whole_addr, nullptr);
+  report = pool.MemPoolReport();
+  ASSERT_EQ(report.cached_mem_size_, 0);
+  ASSERT_EQ(report.block_idle_mem_size_.size(), 1);
+  pool.FreeTensorMem(whole_addr);
+}
+
+/// Feature: fragmentation report of dynamic memory pool.
+/// Description: free every other memory buf of a memory block.
+/// Expectation: the report shows the idle memory split into pieces.
+TEST_F(TestMemDynamicAllocator, test_mem_pool_report) {
+  HostMemoryPool pool;
+  pool.SetMemCacheSize(0);
+  constexpr size_t kBufSize = 1 << 20;
+  constexpr size_t kBufNum = 8;
+  std::vector<DeviceMemPtr> addrs;
+  for (size_t i = 0; i < kBufNum; ++i) {
+    addrs.push_back(pool.AllocTensorMem(kBufSize));
+    ASSERT_NE(addrs.back(), nullptr);
+  }
+  for (size_t i = 0; i < kBufNum; i += 2) {
+    pool.FreeTensorMem(addrs[i]);
+  }
+  auto report = pool.MemPoolReport();
+  ASSERT_EQ(report.total_mem_size_, HostMemoryPool::kHostMemSize);
+  ASSERT_EQ(report.used_mem_size_, kBufSize * kBufNum / 2);
+  ASSERT_EQ(report.used_mem_peak_size_, kBufSize * kBufNum);
+  ASSERT_EQ(report.idle_mem_buf_count_, kBufNum / 2 + 1);
+  ASSERT_EQ(report.max_idle_mem_buf_size_, HostMemoryPool::kHostMemSize - kBufSize * kBufNum);
+  ASSERT_EQ(report.idle_mem_size_, HostMemoryPool::kHostMemSize - kBufSize * kBufNum / 2);
+  ASSERT_GT(report.fragmentation_, 0);
+
+  for (size_t i = 1; i < kBufNum; i += 2) {
+    pool.FreeTensorMem(addrs[i]);
+  }
+  report = pool.MemPoolReport();
+  ASSERT_EQ(report.idle_mem_buf_count_, 1);
+  ASSERT_EQ(report.fragmentation_, 0);
+  ASSERT_EQ(report.used_mem_peak_size_, kBufSize * kBufNum);
+}
+}  // namespace device
+}  // namespace mindspore
@@ -0,0 +1,105 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include "common/common_test.h"
+#include "ps/ps_cache/embedding_hash_map.h"
+
+namespace mindspore {
+namespace ps {
+class TestEmbeddingHashMap : public UT::Common {
+ public:
+  TestEmbeddingHashMap() = default;
+  virtual ~TestEmbeddingHashMap() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+namespace {
+// Slots 0 and 9 are reserved, so the map holds 8 ids.
+constexpr size_t kCapacity = 10;
+constexpr int kNumIds = 8;
+
+// Insert the ids 1 to 8 at step 1, then use the ids 1 to 4 again at steps 2 and 3. Return the id swapped out to make
+// room for a new id at step 5.
+int EvictAfterHits(EmbeddingHashMap *hash_map) {
+  std::vector<int> swap_out_index(kCapacity);
+  std::vector<int> swap_out_ids(kCapacity);
+  size_t swap_out_size = 0;
+  bool need_wait_graph = false;
+  for (int id = 1; id <= kNumIds; ++id) {
+    EXPECT_NE(hash_map->ParseData(id, swap_out_index.data(), swap_out_ids.data(), 1, 0, &swap_out_size,
+                                  &need_wait_graph),
+              INVALID_INDEX_VALUE);
+  }
+  EXPECT_EQ(swap_out_size, 0);
+  for (size_t step = 2; step <= 3; ++step) {
+    hash_map->Reset();
+    for (int id = 1; id <= kNumIds / 2; ++id) {
+      int index = hash_map->hash_id_to_index().at(id);
+      hash_map->set_hash_step(index, step);
+      // an id used twice in a step is counted once
+      hash_map->RecordHit(index, step);
+      hash_map->RecordHit(index, step);
+    }
+  }
+  hash_map->Reset();
+  const size_t data_step = 5;
+  const size_t graph_running_step = 4;
+  EXPECT_NE(hash_map->ParseData(100, swap_out_index.data(), swap_out_ids.data(), data_step, graph_running_step,
+                                &swap_out_size, &need_wait_graph),
+            INVALID_INDEX_VALUE);
+  EXPECT_EQ(swap_out_size, 1);
+  EXPECT_FALSE(need_wait_graph);
+  return swap_out_ids[0];
+}
+}  // namespace
+
+/// Feature: EmbeddingHashMap eviction policy.
+/// Description: evict an id after some ids are used more often than the others.
+/// Expectation: the step LRU swaps out the first slot swept, the frequency policies swap out an id used once.
+TEST_F(TestEmbeddingHashMap, TestEvictionPolicy) {
+  EmbeddingHashMap lru_map(0, kCapacity, EvictionPolicy::kStepLru);
+  EXPECT_EQ(EvictAfterHits(&lru_map), 1);
+
+  EmbeddingHashMap lfu_map(0, kCapacity, EvictionPolicy::kLfu);
+  EXPECT_GT(EvictAfterHits(&lfu_map), kNumIds / 2);
+
+  EmbeddingHashMap tiny_lfu_map(0, kCapacity, EvictionPolicy::kTinyLfu);
+  EXPECT_GT(EvictAfterHits(&tiny_lfu_map), kNumIds / 2);
+
+  auto stat = lfu_map.statistics();
+  EXPECT_EQ(stat.hit_count_, kNumIds);
+  EXPECT_EQ(stat.insert_count_, kNumIds + 1);
+  EXPECT_EQ(stat.evict_count_, 1);
+}
+
+/// Feature: EmbeddingHashMap eviction policy.
+/// Description: parse the policy names.
+/// Expectation: the known names are parsed and an unknown name fails.
+TEST_F(TestEmbeddingHashMap, TestParseEvictionPolicy) {
+  EvictionPolicy policy = EvictionPolicy::kStepLru;
+  EXPECT_TRUE(ParseEvictionPolicy("tinylfu", &policy));
+  EXPECT_EQ(policy, EvictionPolicy::kTinyLfu);
+  EXPECT_TRUE(ParseEvictionPolicy("lfu", &policy));
+  EXPECT_EQ(policy, EvictionPolicy::kLfu);
+  EXPECT_TRUE(ParseEvictionPolicy("lru", &policy));
+  EXPECT_EQ(policy, EvictionPolicy::kStepLru);
+  EXPECT_FALSE(ParseEvictionPolicy("fifo", &policy));
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,161 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <vector>
+#include "common/common_test.h"
+#include "ps/gradient_compression.h"
+
+namespace mindspore {
+namespace ps {
+class TestGradientCompression : public UT::Common {
+ public:
+  TestGradientCompression() = default;
+  virtual ~TestGradientCompression() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+namespace {
+// A small key which is never compressed, followed by a large one.
+constexpr size_t kSmallLen = 4;
+constexpr size_t kLargeLen = 2048;
+
+KVMessage MakePushMessage(std::vector<float> *grads) {
+  grads->resize(kSmallLen + kLargeLen);
+  for (size_t i = 0; i < grads->size(); ++i) {
+    (*grads)[i] = std::sin(static_cast<float>(i)) * (i % 7 + 1);
+  }
+  KVMessage kvs;
+  kvs.add_keys(0);
+  kvs.add_keys(1);
+  kvs.add_len(kSmallLen);
+  kvs.add_len(kLargeLen);
+  *kvs.mutable_values() = {grads->begin(), grads->end()};
+  return kvs;
+}
+
+// Compress and restore a push message, return the largest error of the large key.
+float RoundTrip(GradientCompressor *compressor, const std::vector<float> &grads, KVMessage kvs) {
+  compressor->Compress(&kvs);
+  EXPECT_EQ(kvs.compress_types_size(), 2);
+  EXPECT_EQ(kvs.compress_types(0), NO_COMPRESS);
+  EXPECT_EQ(kvs.compress_types(1), compressor->type());
+  Values values;
+  EXPECT_TRUE(GradientCompressor::Decompress(kvs, &values));
+  EXPECT_EQ(values.size(), grads.size());
+  for (size_t i = 0; i < kSmallLen; ++i) {
+    EXPECT_EQ(values[i], grads[i]);
+  }
+  float max_error = 0;
+  for (size_t i = kSmallLen; i < grads.size(); ++i) {
+    max_error = std::max(max_error, std::fabs(values[i] - grads[i]));
+  }
+  return max_error;
+}
+}  // namespace
+
+/// Feature: Gradient compression of ps worker.
+/// Description: compress a push message by fp16, bf16 and int8, then restore it.
+/// Expectation: the small key is sent as it is, the large key is restored within the precision of its type.
+TEST_F(TestGradientCompression, TestCastAndQuantize) {
+  std::vector<float> grads;
+  KVMessage kvs = MakePushMessage(&grads);
+
+  GradientCompressor fp16_compressor(FP16, kDefaultTopKRatio);
+  EXPECT_LT(RoundTrip(&fp16_compressor, grads, kvs), 0.01);
+  GradientCompressor bf16_compressor(BF16, kDefaultTopKRatio);
+  EXPECT_LT(RoundTrip(&bf16_compressor, grads, kvs), 0.05);
+  GradientCompressor int8_compressor(INT8, kDefaultTopKRatio);
+  EXPECT_LT(RoundTrip(&int8_compressor, grads, kvs), 0.05);
+}
+
+/// Feature: Gradient compression of ps worker.
+/// Description: push the same gradients many times compressed by top k.
+/// Expectation: the error feedback makes the sum of the pushed gradients follow the sum of the gradients.
+TEST_F(TestGradientCompression, TestTopKErrorFeedback) {
+  std::vector<float> grads;
+  KVMessage kvs = MakePushMessage(&grads);
+  const float ratio = 0.1;
+  const size_t kPushTimes = 50;
+  GradientCompressor compressor(TOP_K, ratio);
+  std::vector<float> sum(grads.size(), 0);
+  for (size_t t = 0; t < kPushTimes; ++t) {
+    KVMessage push = kvs;
+    compressor.Compress(&push);
+    EXPECT_EQ(push.topk_sizes(0), static_cast<uint64_t>(std::ceil(kLargeLen * ratio)));
+    EXPECT_LT(push.values_size(), kSmallLen + kLargeLen / 5);
+    Values values;
+    EXPECT_TRUE(GradientCompressor::Decompress(push, &values));
+    for (size_t i = 0; i < sum.size(); ++i) {
+      sum[i] += values[i];
+    }
+  }
+  // What is not sent yet is only the residual, which doesn't grow with the number of pushes.
+  float total = 0;
+  float unsent = 0;
+  for (size_t i = kSmallLen; i < grads.size(); ++i) {
+    total += std::fabs(grads[i] * kPushTimes);
+    unsent += std::fabs(sum[i] - grads[i] * kPushTimes);
+  }
+  EXPECT_LT(unsent, total * 0.25);
+}
+
+/// Feature: Gradient compression of ps worker.
+/// Description: push a key with two inputs by top k, the first input has many values left unsent, the second is zero.
+/// Expectation: the error of the first input is not added to the second one.
+TEST_F(TestGradientCompression, TestResidualOfEachInput) {
+  KVMessage kvs;
+  kvs.add_keys(1);
+  kvs.add_keys(1);
+  kvs.add_len(kLargeLen);
+  kvs.add_len(kLargeLen);
+  std::vector<float> grads(kLargeLen, 1);
+  grads.resize(2 * kLargeLen, 0);
+  *kvs.mutable_values() = {grads.begin(), grads.end()};
+  GradientCompressor compressor(TOP_K, kDefaultTopKRatio);
+  for (size_t t = 0; t < 2; ++t) {
+    KVMessage push = kvs;
+    compressor.Compress(&push);
+    Values values;
+    EXPECT_TRUE(GradientCompressor::Decompress(push, &values));
+    EXPECT_EQ(values.size(), grads.size());
+    for (size_t i = kLargeLen; i < values.size(); ++i) {
+      EXPECT_EQ(values[i], 0);
+    }
+  }
+}
+
+/// Feature: Gradient compression of ps worker.
+/// Description: restore a push message whose compressed values are cut.
+/// Expectation: the message is rejected.
+TEST_F(TestGradientCompression, TestBrokenMessage) {
+  std::vector<float> grads;
+  KVMessage kvs = MakePushMessage(&grads);
+  GradientCompressor compressor(FP16, kDefaultTopKRatio);
+  compressor.Compress(&kvs);
+  kvs.mutable_compressed_values()->resize(kLargeLen);
+  Values values;
+  EXPECT_FALSE(GradientCompressor::Decompress(kvs, &values));
+
+  CompressType type = NO_COMPRESS;
+  EXPECT_TRUE(GradientCompressor::ParseCompressType("int8", &type));
+  EXPECT_EQ(type, INT8);
+  EXPECT_FALSE(GradientCompressor::ParseCompressType("fp8", &type));
+}
+}  // namespace ps
+}  // namespace mindspore
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2021 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "profiler/device/cpu/cpu_trace.h"
+
+namespace mindspore {
+namespace profiler {
+namespace cpu {
+class TestCpuTrace : public UT::Common {
+ public:
+  TestCpuTrace() = default;
+  virtual ~TestCpuTrace() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+namespace {
+TraceEvent MakeEvent(uint32_t op_id, uint64_t start) {
+  TraceEvent event;
+  event.op_id = op_id;
+  event.start = start;
+  event.end = start + 1;
+  return event;
+}
+}  // namespace
+
+/// Feature: CPU profiler trace ring.
+/// Description: push and pop across the end of the ring, then push more events than it holds.
+/// Expectation: the events come out in order after the wrap around, the events pushed when full are dropped and
+/// counted.
+TEST_F(TestCpuTrace, TestRingWrapAround) {
+  TraceRing ring(0, 3);
+  EXPECT_EQ(ring.capacity(), 4);
+  std::vector<TraceEvent> events;
+  for (uint64_t i = 0; i < 3; ++i) {
+    EXPECT_TRUE(ring.Push(MakeEvent(0, i)));
+  }
+  ring.PopAll(&events);
+  EXPECT_EQ(events.size(), 3);
+
+  // The head goes past the end of the storage.
+  events.clear();
+  for (uint64_t i = 3; i < 7; ++i) {
+    EXPECT_TRUE(ring.Push(MakeEvent(0, i)));
+  }
+  EXPECT_FALSE(ring.Push(MakeEvent(0, 7)));
+  EXPECT_FALSE(ring.Push(MakeEvent(0, 8)));
+  EXPECT_EQ(ring.num_dropped(), 2);
+  ring.PopAll(&events);
+  ASSERT_EQ(events.size(), 4);
+  for (uint64_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(events[i].start, i + 3);
+  }
+
+  // Popping makes room again.
+  EXPECT_TRUE(ring.Push(MakeEvent(0, 9)));
+  events.clear();
+  ring.PopAll(&events);
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_EQ(events[0].start, 9);
+}
+
+/// Feature: CPU profiler trace recorder.
+/// Description: record events from several threads, stop the recorder, then run it again.
+/// Expectation: the consumer gets every event with the thread of its ring, the op ids stay the same across the runs
+/// and the trace file is a complete json array.
+TEST_F(TestCpuTrace, TestRecorderCollect) {
+  const size_t kThreads = 4;
+  const size_t kEventsPerThread = 100;
+  const std::string trace_file = "./cpu_trace_test.json";
+  TraceRecorder recorder;
+  std::mutex mutex;
+  std::vector<TraceEvent> collected;
+  std::vector<std::string> names;
+  auto consumer = [&mutex, &collected, &names](const std::vector<TraceEvent> &events,
+                                               const std::vector<std::string> &op_names) {
+    std::lock_guard<std::mutex> lock(mutex);
+    collected.insert(collected.end(), events.begin(), events.end());
+    names = op_names;
+  };
+  recorder.Start(trace_file, 1, kEventsPerThread, consumer);
+  EXPECT_TRUE(recorder.running());
+  uint32_t op_a = recorder.OpId("Default/a");
+  uint32_t op_b = recorder.OpId("Default/b");
+  EXPECT_NE(op_a, op_b);
+  EXPECT_EQ(recorder.OpId("Default/a"), op_a);
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&recorder, op_a, op_b, t]() {
+      for (size_t i = 0; i < kEventsPerThread; ++i) {
+        recorder.Record(MakeEvent(t % 2 == 0 ? op_a : op_b, TraceRecorder::Now()));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  recorder.Stop();
+  EXPECT_FALSE(recorder.running());
+  EXPECT_EQ(recorder.num_dropped(), 0);
+  ASSERT_EQ(collected.size(), kThreads * kEventsPerThread);
+  ASSERT_GT(names.size(), op_b);
+  EXPECT_EQ(names[op_a], "Default/a");
+  EXPECT_EQ(names[op_b], "Default/b");
+  std::set<uint32_t> tids;
+  for (const auto &event : collected) {
+    tids.insert(event.tid);
+  }
+  EXPECT_EQ(tids.size(), kThreads);
+  // Recording after the stop is ignored.
+  recorder.Record(MakeEvent(op_a, TraceRecorder::Now()));
+
+  std::ifstream ifs(trace_file);
+  std::string trace((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  EXPECT_EQ(trace.find("{\"traceEvents\":["), 0);
+  EXPECT_EQ(trace.substr(trace.size() - 3), "]}\n");
+  (void)std::remove(trace_file.c_str());
+
+  // The ids of the first run still hold, the events of the first run are not seen again.
+  collected.clear();
+  recorder.Start("", 1, kEventsPerThread, consumer);
+  EXPECT_EQ(recorder.OpId("Default/b"), op_b);
+  recorder.Record(MakeEvent(op_b, TraceRecorder::Now()));
+  recorder.Stop();
+  ASSERT_EQ(collected.size(), 1);
+  EXPECT_EQ(collected[0].op_id, op_b);
+}
+}  // namespace cpu
+}  // namespace profiler
+}  // namespace mindspore
@@ -224,4 +224,15 @@ cmd="${CACHE_ADMIN} --start -l"
 CacheAdminCmd "${cmd}" 1
 HandleRcExit $? 0 0
 
+# illegal compressed ratio
+cmd="${CACHE_ADMIN} --start -c 1"
+CacheAdminCmd "${cmd}" 1
+HandleRcExit $? 0 0
+cmd="${CACHE_ADMIN} --start -c -0.5"
+CacheAdminCmd "${cmd}" 1
+HandleRcExit $? 0 0
+cmd="${CACHE_ADMIN} --start -c"
+CacheAdminCmd "${cmd}" 1
+HandleRcExit $? 0 0
+
 exit ${failed_tests}
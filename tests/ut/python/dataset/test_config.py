@@ -394,6 +394,40 @@ def test_auto_num_workers():
     assert saved_config == ds.config.get_auto_num_workers()
 
 
+def test_prefetch_max_bytes():
+    """
+    Test prefetch_max_bytes can be set and bounds the queues without dropping rows.
+    """
+    saved_config = ds.config.get_prefetch_max_bytes()
+    assert saved_config == 0
+
+    ds.config.set_prefetch_max_bytes(256 * 1024 * 1024)
+    assert ds.config.get_prefetch_max_bytes() == 256 * 1024 * 1024
+
+    for invalid_value in [-1, 1.5, True, "1024"]:
+        err_msg = ""
+        try:
+            ds.config.set_prefetch_max_bytes(invalid_value)
+        except ValueError as e:
+            err_msg = str(e)
+        assert err_msg != ""
+    assert ds.config.get_prefetch_max_bytes() == 256 * 1024 * 1024
+
+    # every row is larger than the limit, a queue still takes one row at a time.
+    ds.config.set_prefetch_max_bytes(1)
+    data = np.arange(64 * 100, dtype=np.float32).reshape((100, 64))
+    dataset = ds.NumpySlicesDataset(data, column_names=["col"], shuffle=False)
+    dataset = dataset.map(operations=[lambda x: x + 1], input_columns=["col"], num_parallel_workers=2)
+    num_rows = 0
+    for i, row in enumerate(dataset.create_tuple_iterator(num_epochs=1, output_numpy=True)):
+        np.testing.assert_array_equal(row[0], data[i] + 1)
+        num_rows += 1
+    assert num_rows == 100
+
+    ds.config.set_prefetch_max_bytes(saved_config)
+    assert ds.config.get_prefetch_max_bytes() == saved_config
+
+
 if __name__ == '__main__':
     test_basic()
     test_get_seed()
@@ -406,3 +440,4 @@ if __name__ == '__main__':
     test_deterministic_python_seed_multi_thread()
     test_auto_num_workers_error()
     test_auto_num_workers()
+    test_prefetch_max_bytes()